@@ -0,0 +1,85 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Fits the columns of a sheet with a mix of numbers, dates, formatted numbers and strings
+void auto_fit(xlnt::row_t rows)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    const auto date = xlnt::date(2020, 1, 1).to_number(wb.base_date());
+
+    for (auto row = xlnt::row_t(1); row <= rows; ++row)
+    {
+        ws.cell(1, row).value(static_cast<int>(row));
+        ws.cell(2, row).value(row * 0.25);
+        ws.cell(3, row).value("customer " + std::to_string(row % 1000));
+        ws.cell(4, row).value(date + row % 28);
+    }
+
+    ws.range(xlnt::range_reference(2, 1, 2, rows)).number_format(xlnt::number_format::from_builtin_id(4));
+    ws.range(xlnt::range_reference(4, 1, 4, rows)).number_format(xlnt::number_format::date_xlsx14());
+
+    auto serial_time = time_ms([&]() { ws.auto_fit_columns(); });
+    auto parallel_time = time_ms([&]() { ws.auto_fit_columns(true); });
+
+    std::cout << rows << " rows, widths";
+
+    for (auto column = xlnt::column_t(1); column <= 4; ++column)
+    {
+        std::cout << ' ' << ws.column_width(column);
+    }
+
+    std::cout << '\n'
+              << "serial: " << serial_time << " ms" << '\n'
+              << "parallel: " << parallel_time << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    auto_fit(10000);
+    auto_fit(1000000);
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Compares summing a numeric column through the per-cell API with range::statistics
+void column_statistics(xlnt::row_t rows)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        ws.cell(1, row).value(static_cast<double>(row % 1000));
+        ws.cell(2, row).value("label");
+    }
+
+    std::cout << rows << " rows" << std::endl;
+
+    auto column = ws.range(xlnt::range_reference(1, 1, 1, rows));
+    auto per_cell_sum = 0.0;
+
+    auto per_cell = time_ms([&]() {
+        for (auto row : column)
+        {
+            for (auto cell : row)
+            {
+                if (cell.data_type() == xlnt::cell::type::number)
+                {
+                    per_cell_sum += cell.value<double>();
+                }
+            }
+        }
+    });
+
+    xlnt::range_statistics serial, parallel;
+    auto serial_time = time_ms([&]() { serial = column.statistics(); });
+    auto parallel_time = time_ms([&]() { parallel = column.statistics(true); });
+
+    std::cout << "per cell:            " << per_cell << " ms (sum " << per_cell_sum << ")" << '\n'
+              << "statistics:          " << serial_time << " ms (sum " << serial.sum << ")" << '\n'
+              << "statistics parallel: " << parallel_time << " ms (sum " << parallel.sum << ")" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    column_statistics(100000);
+    column_statistics(1000000);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Writes a heat map with one conditional format per cell drawn from a small palette
+void heat_map(xlnt::row_t size, std::size_t palette_size)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    std::vector<std::string> palette;
+
+    for (auto i = std::size_t(0); i < palette_size; ++i)
+    {
+        const auto level = static_cast<std::uint8_t>(255 * i / palette_size);
+        palette.push_back(xlnt::rgb_color(level, 0, static_cast<std::uint8_t>(255 - level)).hex_string());
+    }
+
+    std::cout << size << "x" << size << " cells, " << palette_size << " colours" << std::endl;
+
+    auto add_time = time_ms([&]() {
+        for (xlnt::row_t row = 1; row <= size; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= size; ++column)
+            {
+                const auto &colour = palette[(row / 8 + column / 8) % palette_size];
+                const auto ref = xlnt::cell_reference(column, row);
+                ws.cell(ref).value(colour);
+                ws.conditional_format(xlnt::range_reference(ref, ref), xlnt::condition::text_contains(colour))
+                    .fill(xlnt::pattern_fill().background(xlnt::rgb_color(colour)));
+            }
+        }
+    });
+
+    std::vector<std::uint8_t> data;
+    auto save_time = time_ms([&]() { wb.save(data); });
+
+    std::cout << "add rules: " << add_time << " ms" << '\n'
+              << "save:      " << save_time << " ms (" << data.size() << " bytes)" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    heat_map(100, 16);
+    heat_map(300, 16);
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Compares converting serial numbers one at a time with the bulk conversions
+void date_conversion(std::size_t count)
+{
+    std::vector<double> numbers(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        numbers[i] = 30000 + static_cast<double>(i) * 0.0137;
+    }
+
+    std::cout << count << " numbers" << std::endl;
+
+    std::vector<xlnt::datetime> scalar(count, xlnt::datetime(1900, 1, 1));
+    std::vector<xlnt::datetime> bulk(count, xlnt::datetime(1900, 1, 1));
+    std::vector<double> scalar_numbers(count), bulk_numbers(count);
+    std::vector<std::int64_t> unix_times(count);
+    const auto base_date = xlnt::calendar::windows_1900;
+
+    auto from_scalar = time_ms([&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scalar[i] = xlnt::datetime::from_number(numbers[i], base_date);
+        }
+    });
+    auto from_bulk = time_ms([&]() { xlnt::datetime::from_numbers(numbers.data(), count, bulk.data(), base_date); });
+
+    auto to_scalar = time_ms([&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scalar_numbers[i] = scalar[i].to_number(base_date);
+        }
+    });
+    auto to_bulk = time_ms([&]() { xlnt::datetime::to_numbers(bulk.data(), count, bulk_numbers.data(), base_date); });
+    auto to_unix = time_ms([&]() { xlnt::datetime::to_unix_microseconds(numbers.data(), count, unix_times.data(), base_date); });
+
+    std::cout << "from_number:          " << from_scalar << " ms" << '\n'
+              << "from_numbers:         " << from_bulk << " ms (identical: " << (scalar == bulk) << ")" << '\n'
+              << "to_number:            " << to_scalar << " ms" << '\n'
+              << "to_numbers:           " << to_bulk << " ms (identical: " << (scalar_numbers == bulk_numbers) << ")" << '\n'
+              << "to_unix_microseconds: " << to_unix << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    date_conversion(100000);
+    date_conversion(1000000);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Clears a column of formulae from a sheet next to a second, formula-free sheet of data
+void formula_clearing(xlnt::row_t rows)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+    auto data = wb.create_sheet();
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        ws.cell(1, row).value(static_cast<double>(row));
+        ws.cell(2, row).formula("=A" + std::to_string(row) + "*2");
+        data.cell(1, row).value("label");
+    }
+
+    std::cout << rows << " rows" << std::endl;
+
+    auto clear_time = time_ms([&]() {
+        for (xlnt::row_t row = 1; row <= rows; ++row)
+        {
+            ws.cell(2, row).clear_formula();
+        }
+    });
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        ws.cell(2, row).formula("=A" + std::to_string(row) + "*2");
+    }
+
+    auto delete_time = time_ms([&]() { ws.delete_columns(2, 1); });
+
+    std::cout << "clear_formula: " << clear_time << " ms" << '\n'
+              << "delete_columns: " << delete_time << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    formula_clearing(10000);
+    formula_clearing(100000);
+
+    return 0;
+}
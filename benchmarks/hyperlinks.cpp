@@ -0,0 +1,77 @@
+// Copyright (c) 2017-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Add one hyperlink per row. Every "distinct"th link points to the same URL
+// so that both registration of new relationships and reuse of existing ones
+// are measured.
+void hyperlinks(int links, int distinct)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (int index = 0; index < links; index++)
+    {
+        const auto url = "https://example.com/item/" + std::to_string(index % distinct);
+        ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1))).hyperlink(url);
+    }
+}
+
+// Time from the average of three runs is taken. Time per link should stay
+// roughly constant as the number of links grows.
+void timer(std::function<void(int, int)> fn, int links, int distinct)
+{
+    const auto repeat = std::size_t(3);
+    std::chrono::duration<double, std::milli> time{};
+    std::cout << links << " links " << distinct << " distinct targets" << std::endl;
+
+    for (std::size_t i = 0; i < repeat; i++)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn(links, distinct);
+        time += std::chrono::high_resolution_clock::now() - start;
+    }
+
+    std::cout << time.count() / repeat << " ms per iteration, "
+              << time.count() * 1000 / repeat / links << " us per link" << '\n' << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    timer(&hyperlinks, 10000, 10000);
+    timer(&hyperlinks, 50000, 50000);
+    timer(&hyperlinks, 200000, 200000);
+    timer(&hyperlinks, 200000, 100);
+
+    return 0;
+}
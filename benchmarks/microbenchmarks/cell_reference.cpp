@@ -0,0 +1,98 @@
+// The producer writes a reference string for the r attribute of every cell and the
+// consumer parses one back, so both directions are on the hot path of (de)serialisation
+// - to_string allocates a string per call unless the result fits the small string buffer
+// - to_chars writes into a caller buffer and never allocates
+
+#include "benchmark/benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+
+#include <xlnt/cell/cell_reference.hpp>
+
+namespace {
+
+// setup a large quantity of random cell references
+class RandomReferences : public benchmark::Fixture
+{
+    static constexpr size_t Number_of_Elements = 1 << 20;
+
+    std::vector<xlnt::cell_reference> inputs;
+    std::vector<std::string> strings;
+
+    size_t index = 0;
+
+public:
+    void SetUp(const ::benchmark::State &state)
+    {
+        std::mt19937 gen(42);
+        // most sheets are narrow and tall
+        std::uniform_int_distribution<xlnt::column_t::index_t> columns(1, 100);
+        std::uniform_int_distribution<xlnt::row_t> rows(1, 1'000'000);
+        inputs.reserve(Number_of_Elements);
+        strings.reserve(Number_of_Elements);
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            inputs.emplace_back(columns(gen), rows(gen));
+            strings.push_back(inputs.back().to_string());
+        }
+    }
+
+    void TearDown(const ::benchmark::State &state)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        inputs = std::vector<xlnt::cell_reference>{};
+        strings = std::vector<std::string>{};
+    }
+
+    const xlnt::cell_reference &get_rand()
+    {
+        return inputs[++index & (Number_of_Elements - 1)];
+    }
+
+    const std::string &get_rand_string()
+    {
+        return strings[++index & (Number_of_Elements - 1)];
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(RandomReferences, reference_to_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(get_rand().to_string());
+    }
+}
+
+BENCHMARK_F(RandomReferences, reference_to_chars)
+(benchmark::State &state)
+{
+    char buf[xlnt::cell_reference::max_string_length];
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(get_rand().to_chars(buf, buf + sizeof(buf)));
+    }
+}
+
+BENCHMARK_F(RandomReferences, reference_from_split_reference)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        auto split = xlnt::cell_reference::split_reference(get_rand_string());
+        benchmark::DoNotOptimize(xlnt::cell_reference(split.first, split.second));
+    }
+}
+
+BENCHMARK_F(RandomReferences, reference_from_chars)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        const auto &s = get_rand_string();
+        benchmark::DoNotOptimize(xlnt::cell_reference::from_chars(s.data(), s.data() + s.size()));
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Fills, saves, loads and reads back a sheet keeping at most limit cells in memory
+void paged_cells(std::size_t limit, xlnt::row_t rows)
+{
+    const auto columns = xlnt::column_t::index_t(10);
+    std::vector<std::uint8_t> data;
+
+    xlnt::workbook wb;
+    wb.max_resident_cells(limit);
+    auto ws = wb.active_sheet();
+
+    auto fill_time = time_ms([&]() {
+        for (auto row = xlnt::row_t(1); row <= rows; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+
+            for (auto column = xlnt::column_t::index_t(2); column <= columns; ++column)
+            {
+                ws.cell(column, row).value(static_cast<double>(row) * column);
+            }
+        }
+    });
+
+    auto save_time = time_ms([&]() { wb.save(data); });
+
+    xlnt::workbook loaded;
+    loaded.max_resident_cells(limit);
+    auto load_time = time_ms([&]() { loaded.load(data); });
+
+    auto sum = 0.0;
+    auto read_time = time_ms([&]() {
+        auto loaded_ws = loaded.active_sheet();
+
+        for (auto row = xlnt::row_t(1); row <= rows; ++row)
+        {
+            sum += loaded_ws.cell(columns, row).value<double>();
+        }
+    });
+
+    std::cout << (limit == 0 ? std::string("all resident") : std::to_string(limit) + " resident")
+              << ", " << rows * columns << " cells" << '\n'
+              << "fill: " << fill_time << " ms" << '\n'
+              << "save: " << save_time << " ms" << '\n'
+              << "load: " << load_time << " ms" << '\n'
+              << "read: " << read_time << " ms (" << sum << ")" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    for (auto limit : {std::size_t(0), std::size_t(1000000), std::size_t(100000)})
+    {
+        paged_cells(limit, xlnt::row_t(200000));
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Loads a workbook whose shared string table is large compared to its single sheet
+void shared_strings_load(std::size_t strings, std::size_t formatted_every)
+{
+    xlnt::workbook wb;
+    wb.active_sheet().cell("A1").value("first");
+
+    xlnt::font bold;
+    bold.bold(true);
+
+    for (auto i = std::size_t(0); i < strings; ++i)
+    {
+        auto text = xlnt::rich_text("string & <value> " + std::to_string(i));
+
+        if (formatted_every != 0 && i % formatted_every == 0)
+        {
+            text.add_run(xlnt::rich_text_run{" formatted", bold, true});
+        }
+
+        wb.add_shared_string(text, true);
+    }
+
+    std::vector<std::uint8_t> data;
+    wb.save(data);
+
+    xlnt::workbook loaded;
+    auto load_time = time_ms([&]() { loaded.load(data); });
+
+    std::cout << loaded.shared_strings().size() << " shared strings, "
+              << (formatted_every == 0 ? std::string("none") : "1 in " + std::to_string(formatted_every))
+              << " formatted" << '\n'
+              << "load: " << load_time << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    shared_strings_load(200000, 0);
+    shared_strings_load(1000000, 0);
+    shared_strings_load(1000000, 10);
+
+    return 0;
+}
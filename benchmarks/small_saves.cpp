@@ -0,0 +1,78 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Repeatedly saves a small report so that the fixed cost of each save dominates
+void small_saves(int saves)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (xlnt::row_t row = 1; row <= 10; ++row)
+    {
+        ws.cell(1, row).value("item " + std::to_string(row));
+        ws.cell(2, row).value(static_cast<double>(row) * 1.5);
+    }
+
+    std::vector<std::uint8_t> data;
+
+    auto save_time = time_ms([&]() {
+        for (auto i = 0; i < saves; ++i)
+        {
+            data.clear();
+            wb.save(data);
+        }
+    });
+
+    std::cout << saves << " saves of " << data.size() << " bytes" << '\n'
+              << "per save: " << save_time / saves << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    small_saves(100);
+    small_saves(1000);
+
+    return 0;
+}
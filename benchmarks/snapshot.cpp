@@ -0,0 +1,99 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Compares loading a workbook from an XLSX file with loading it from a snapshot
+void snapshot(xlnt::row_t rows)
+{
+    const auto columns = xlnt::column_t::index_t(10);
+
+    std::vector<std::uint8_t> xlsx;
+    std::vector<std::uint8_t> snapshot;
+    auto save_time = 0.0;
+    auto save_snapshot_time = 0.0;
+
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = xlnt::row_t(1); row <= rows; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+            ws.cell(2, row).value("group " + std::to_string(row % 100));
+
+            for (auto column = xlnt::column_t::index_t(3); column <= columns; ++column)
+            {
+                ws.cell(column, row).value(static_cast<double>(row) * column);
+            }
+        }
+
+        save_time = time_ms([&]() { wb.save(xlsx); });
+        save_snapshot_time = time_ms([&]() { wb.save_snapshot(snapshot); });
+    }
+
+    xlnt::workbook from_xlsx;
+    auto load_time = time_ms([&]() { from_xlsx.load(xlsx); });
+
+    xlnt::workbook from_snapshot;
+    auto load_snapshot_time = time_ms([&]() { from_snapshot.load_snapshot(snapshot); });
+
+    const auto same = from_snapshot.active_sheet().cell(columns, rows).value<double>()
+        == from_xlsx.active_sheet().cell(columns, rows).value<double>();
+
+    std::cout << rows * columns << " cells" << (same ? "" : " (MISMATCH)") << '\n'
+              << "xlsx: " << xlsx.size() << " bytes, save " << save_time << " ms, load " << load_time << " ms" << '\n'
+              << "snapshot: " << snapshot.size() << " bytes, save " << save_snapshot_time << " ms, load "
+              << load_snapshot_time << " ms" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    for (auto rows : {xlnt::row_t(10000), xlnt::row_t(100000)})
+    {
+        snapshot(rows);
+    }
+
+    return 0;
+}
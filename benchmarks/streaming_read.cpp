@@ -0,0 +1,125 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Compares reading a worksheet cell by cell with reading it row by row into a row_view
+void streaming_read(xlnt::row_t rows)
+{
+    std::vector<std::uint8_t> data;
+
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= rows; ++row)
+        {
+            ws.cell(1, row).value(static_cast<double>(row));
+            ws.cell(2, row).value(row % 2 == 0 ? "even" : "odd");
+            ws.cell(3, row).value(row % 3 == 0);
+            ws.cell(4, row).value(static_cast<int>(row % 1000));
+        }
+
+        wb.save(data);
+    }
+
+    std::cout << rows << " rows" << std::endl;
+
+    auto cell_sum = 0.0;
+    auto cell_text = std::size_t(0);
+
+    auto per_cell = time_ms([&]() {
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet("Sheet1");
+
+        while (reader.has_cell())
+        {
+            auto cell = reader.read_cell();
+
+            if (cell.data_type() == xlnt::cell::type::number)
+            {
+                cell_sum += cell.value<double>();
+            }
+            else if (cell.data_type() == xlnt::cell::type::shared_string)
+            {
+                cell_text += cell.value<std::string>().size();
+            }
+        }
+    });
+
+    auto row_sum = 0.0;
+    auto row_text = std::size_t(0);
+
+    auto per_row = time_ms([&]() {
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet("Sheet1");
+        xlnt::row_view row;
+
+        while (reader.read_row(row))
+        {
+            for (const auto &cell : row)
+            {
+                if (cell.data_type() == xlnt::cell_type::number)
+                {
+                    row_sum += cell.value<double>();
+                }
+                else if (cell.data_type() == xlnt::cell_type::shared_string)
+                {
+                    row_text += cell.value<xlnt::string_view>().size();
+                }
+            }
+        }
+    });
+
+    std::cout << "read_cell: " << per_cell << " ms (sum " << cell_sum << ", text " << cell_text << ")" << '\n'
+              << "read_row:  " << per_row << " ms (sum " << row_sum << ", text " << row_text << ")" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    streaming_read(100000);
+    streaming_read(500000);
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Fills and saves a sheet with a unique id column, a free text column and a
+// repetitive category column, storing strings as given by storage
+void string_storage(xlnt::string_storage storage, const std::string &name, xlnt::row_t rows)
+{
+    xlnt::workbook wb;
+    wb.default_string_storage(storage);
+    auto ws = wb.active_sheet();
+
+    auto fill_time = time_ms([&]() {
+        for (auto row = xlnt::row_t(1); row <= rows; ++row)
+        {
+            ws.cell(1, row).value("ID-" + std::to_string(1000000 + row));
+            ws.cell(2, row).value("note " + std::to_string(row * 7919 % 1000003) + " for customer");
+            ws.cell(3, row).value("category " + std::to_string(row % 12));
+            ws.cell(4, row).value(static_cast<double>(row) * 0.5);
+        }
+    });
+
+    std::vector<std::uint8_t> data;
+    auto save_time = time_ms([&]() { wb.save(data); });
+
+    std::cout << name << ", " << rows << " rows" << '\n'
+              << "fill: " << fill_time << " ms" << '\n'
+              << "save: " << save_time << " ms" << '\n'
+              << "size: " << data.size() << " bytes" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    for (auto rows : {xlnt::row_t(10000), xlnt::row_t(200000)})
+    {
+        string_storage(xlnt::string_storage::shared, "shared", rows);
+        string_storage(xlnt::string_storage::inline_string, "inline", rows);
+        string_storage(xlnt::string_storage::adaptive, "adaptive", rows);
+    }
+
+    return 0;
+}
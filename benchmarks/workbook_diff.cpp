@@ -0,0 +1,107 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void fill(xlnt::workbook &wb, std::size_t sheets, xlnt::row_t rows)
+{
+    for (auto index = std::size_t(0); index < sheets; ++index)
+    {
+        auto ws = index == 0 ? wb.active_sheet() : wb.create_sheet();
+
+        for (xlnt::row_t row = 1; row <= rows; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+            ws.cell(2, row).value("row " + std::to_string(row % 100));
+            ws.cell(3, row).value(row * 0.5);
+        }
+    }
+}
+
+// Compares full equality with fingerprint diffs of two nearly identical workbooks
+void workbook_diff(std::size_t sheets, xlnt::row_t rows)
+{
+    xlnt::workbook lhs, rhs;
+    fill(lhs, sheets, rows);
+    fill(rhs, sheets, rows);
+    // changed in the last sheet so that operator== can't stop early
+    rhs.sheet_by_index(sheets - 1).cell(2, rows / 2).value("changed");
+
+    std::cout << sheets << " sheets x " << rows << " rows" << std::endl;
+
+    auto equal = true;
+    auto equality_time = time_ms([&]() { equal = lhs == rhs; });
+
+    xlnt::workbook_diff serial, parallel;
+    auto serial_time = time_ms([&]() { serial = lhs.diff(rhs); });
+    auto parallel_time = time_ms([&]() { parallel = lhs.diff(rhs, true); });
+
+    // fingerprints of the earlier snapshot are usually computed once and kept
+    std::vector<xlnt::worksheet_fingerprint> kept;
+
+    for (auto ws : lhs)
+    {
+        kept.push_back(ws.fingerprint());
+    }
+
+    auto changed_cells = std::size_t(0);
+    auto kept_time = time_ms([&]() {
+        for (auto index = std::size_t(0); index < sheets; ++index)
+        {
+            auto ws = rhs.sheet_by_index(index);
+            changed_cells += lhs.sheet_by_index(index).diff(ws, kept[index], ws.fingerprint()).changed_cells.size();
+        }
+    });
+
+    std::cout << "operator==:        " << equality_time << " ms (equal " << equal << ")" << '\n'
+              << "diff:              " << serial_time << " ms (" << serial.worksheets.size() << " changed sheets)" << '\n'
+              << "diff parallel:     " << parallel_time << " ms (" << parallel.worksheets.size() << " changed sheets)" << '\n'
+              << "diff, fingerprint: " << kept_time << " ms (" << changed_cells << " changed cells)" << '\n'
+              << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    workbook_diff(10, 10000);
+    workbook_diff(50, 20000);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+template <typename Function>
+double time_ms(Function fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return milliseconds(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void report(const std::string &name, xlnt::workbook &wb, int saves)
+{
+    std::vector<std::uint8_t> data;
+
+    auto save_time = time_ms([&]() {
+        for (auto i = 0; i < saves; ++i)
+        {
+            data.clear();
+            wb.save(data);
+        }
+    });
+
+    std::cout << name << ": " << data.size() << " bytes, " << save_time / saves << " ms per save" << '\n';
+}
+
+// Many distinct formats, so the styles part is large relative to the cell data
+void styles_heavy(int formats)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (auto i = 0; i < formats; ++i)
+    {
+        auto cell = ws.cell(1, static_cast<xlnt::row_t>(i + 1));
+        cell.value(i);
+        cell.font(xlnt::font().size(8 + i % 12).bold(i % 2 == 0).color(xlnt::rgb_color(
+            static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i / 256), 128)));
+        cell.fill(xlnt::fill::solid(xlnt::rgb_color(128, static_cast<std::uint8_t>(i), 64)));
+        cell.number_format(xlnt::number_format("0." + std::string(static_cast<std::size_t>(i % 8 + 1), '0')));
+    }
+
+    report(std::to_string(formats) + " formats", wb, 20);
+}
+
+// Many sheets and custom properties, so the workbook and docProps parts dominate
+void metadata_heavy(int sheets, int properties)
+{
+    xlnt::workbook wb;
+
+    for (auto i = 1; i < sheets; ++i)
+    {
+        wb.create_sheet().cell("A1").value("sheet");
+    }
+
+    for (auto i = 0; i < properties; ++i)
+    {
+        wb.custom_property("property " + std::to_string(i), "value " + std::to_string(i));
+    }
+
+    report(std::to_string(sheets) + " sheets, " + std::to_string(properties) + " properties", wb, 20);
+}
+
+} // namespace
+
+int main()
+{
+    styles_heavy(500);
+    styles_heavy(5000);
+    metadata_heavy(50, 500);
+    metadata_heavy(200, 5000);
+
+    return 0;
+}
@@ -652,6 +652,12 @@ private:
     /// A pointer to this cell's implementation.
     /// </summary>
     detail::cell_impl *d_;
+
+    /// <summary>
+    /// Keeps the rows of this cell in memory while this object exists if its
+    /// worksheet has a limit on resident cells, so that d_ stays valid.
+    /// </summary>
+    std::shared_ptr<const void> pin_;
 };
 
 /// <summary>
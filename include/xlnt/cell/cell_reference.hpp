@@ -180,6 +180,26 @@ public:
     /// </summary>
     std::string to_string() const;
 
+    /// <summary>
+    /// The maximum number of characters to_chars can write, e.g. for "$FXSHRXW$4294967295".
+    /// </summary>
+    static const std::size_t max_string_length = 19;
+
+    /// <summary>
+    /// Writes a string like "A1" for cell_reference(1, 1) to the buffer [first, last)
+    /// without allocating and returns a pointer one past the last character written.
+    /// No terminating null character is written. Throws invalid_parameter if the
+    /// buffer is too small.
+    /// </summary>
+    char *to_chars(char *first, char *last) const;
+
+    /// <summary>
+    /// Parses a reference string like "A1" or "$B$12" in [first, last) without allocating.
+    /// Throws invalid_cell_reference if it is malformed and invalid_column_index if
+    /// the column part has more than three letters.
+    /// </summary>
+    static cell_reference from_chars(const char *first, const char *last);
+
     /// <summary>
     /// Returns a 1x1 range_reference containing only this cell_reference.
     /// </summary>
@@ -72,6 +72,32 @@ public:
     /// </remarks>
     static std::string column_string_from_index(index_t column_index);
 
+    /// <summary>
+    /// The maximum number of letters column_string_from_index can produce.
+    /// </summary>
+    static const std::size_t max_string_length = 7;
+
+    /// <summary>
+    /// Writes the letters of column_index (3 -> 'C') to the buffer [first, last)
+    /// without allocating and returns a pointer one past the last letter written.
+    /// No terminating null character is written.
+    /// </summary>
+    /// <remarks>
+    /// Columns A to ZZZ are copied from a precomputed table. Throws invalid_column_index
+    /// if column_index is 0 and invalid_parameter if the buffer is too small.
+    /// </remarks>
+    static char *to_chars(index_t column_index, char *first, char *last);
+
+    /// <summary>
+    /// Convert the column letters in [first, last) into a column number (e.g. B -> 2)
+    /// without allocating. Letters may be upper or lower case.
+    /// </summary>
+    /// <remarks>
+    /// As with column_index_from_string, 1 - 3 letters are accepted and anything else
+    /// will throw invalid_column_index.
+    /// </remarks>
+    static index_t column_index_from_chars(const char *first, const char *last);
+
     /// <summary>
     /// Default constructor. The column points to the "A" column.
     /// </summary>
@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +35,13 @@
 
 namespace xlnt {
 
+namespace detail {
+
+class font_pool;
+struct rich_text_access;
+
+} // namespace detail
+
 /// <summary>
 /// Encapsulates zero or more formatted text runs where a text run
 /// is a string of text with the same defined formatting.
@@ -152,28 +161,81 @@ public:
     bool operator!=(const std::string &rhs) const;
 
 private:
+    friend struct detail::rich_text_access;
+
+    /// <summary>
+    /// A run as it is stored. Fonts are immutable and shared between copies of the
+    /// text and, once interned, between every run in the workbook with the same font.
+    /// </summary>
+    struct run_impl
+    {
+        std::string text;
+        std::shared_ptr<const font> text_font;
+        bool preserve_space;
+    };
+
+    /// <summary>
+    /// How the textual content is currently held.
+    /// </summary>
+    enum class storage : std::uint8_t
+    {
+        empty,
+        plain,
+        runs
+    };
+
+    /// <summary>
+    /// Appends a run whose font has already been interned.
+    /// </summary>
+    void add_run(const std::string &text, std::shared_ptr<const font> text_font, bool preserve_space);
+
+    /// <summary>
+    /// Replaces the font of each run with its equivalent from pool.
+    /// </summary>
+    void intern_fonts(detail::font_pool &pool);
+
+    /// <summary>
+    /// Calls f(text, font, preserve_space) for each run in order without copying.
+    /// A null font pointer means the run has no formatting.
+    /// </summary>
+    template <typename F>
+    void for_each_run(F f) const
+    {
+        if (storage_ == storage::plain)
+        {
+            f(plain_text_, static_cast<const font *>(nullptr), plain_preserve_space_);
+        }
+        else
+        {
+            for (const auto &run : runs_)
+            {
+                f(run.text, run.text_font.get(), run.preserve_space);
+            }
+        }
+    }
+
     /// <summary>
-    /// The runs that make up this rich text.
+    /// Text of the only run when it has no font, which is by far the most common case.
     /// </summary>
-    std::vector<rich_text_run> runs_;
+    std::string plain_text_;
+
+    /// <summary>
+    /// The runs that make up this rich text when it is not a single unformatted run.
+    /// </summary>
+    std::vector<run_impl> runs_;
     std::vector<phonetic_run> phonetic_runs_;
     optional<phonetic_pr> phonetic_properties_;
+    storage storage_ = storage::empty;
+    bool plain_preserve_space_ = false;
 };
 
+/// <summary>
+/// Hashes the textual content of rich text so it can key unordered containers.
+/// </summary>
 class XLNT_API rich_text_hash
 {
 public:
-    std::size_t operator()(const rich_text &k) const
-    {
-        std::size_t res = 0;
-
-        for (auto r : k.runs())
-        {
-            res ^= std::hash<std::string>()(r.first);
-        }
-
-        return res;
-    }
+    std::size_t operator()(const rich_text &k) const;
 };
 
 } // namespace xlnt
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <xlnt/xlnt_config.hpp>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -46,8 +47,20 @@ class XLNT_API spreadsheet_drawing
 {
 public:
     spreadsheet_drawing(xml::parser &parser);
+
+    /// <summary>
+    /// Keeps the markup of a drawing part exactly as it was read. Embed ids are
+    /// found by scanning the markup rather than parsing it.
+    /// </summary>
+    explicit spreadsheet_drawing(const std::string &serialized);
+
     void serialize(xml::serializer &serializer);
 
+    /// <summary>
+    /// Writes the drawing part markup verbatim to stream.
+    /// </summary>
+    void serialize(std::ostream &stream) const;
+
     std::vector<std::string> get_embed_ids();
 
 private:
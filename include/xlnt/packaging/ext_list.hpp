@@ -26,6 +26,7 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/packaging/uri.hpp>
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -50,13 +51,31 @@ public:
         ext(const uri &ID, const std::string &serialised);
         void serialise(xml::serializer &serialiser, const std::string &ns);
 
+        /// <summary>
+        /// Writes the ext element verbatim to stream. The enclosing element must
+        /// declare the ext_list namespace as the default namespace.
+        /// </summary>
+        void serialise(std::ostream &stream) const;
+
         uri extension_ID_;
+
+        /// <summary>
+        /// The complete ext element as markup, declaring any namespaces it uses
+        /// other than the default namespace of the enclosing part.
+        /// </summary>
         std::string serialised_value_;
     };
     ext_list() = default; // default ctor required by xlnt::optional
     explicit ext_list(xml::parser &parser, const std::string &ns);
     void serialize(xml::serializer &serialiser, const std::string &ns);
 
+    /// <summary>
+    /// Writes the extLst element and its extensions verbatim to stream. This must
+    /// only be called between elements of a part whose default namespace is the one
+    /// the list was read with.
+    /// </summary>
+    void serialize(std::ostream &stream) const;
+
     void add_extension(const uri &ID, const std::string &element);
 
     bool has_extension(const uri &extension_uri) const;
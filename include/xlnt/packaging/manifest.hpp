@@ -30,6 +30,7 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/packaging/relationship.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/utils/scoped_enum_hash.hpp>
 
 namespace xlnt {
 
@@ -63,6 +64,12 @@ public:
     /// </summary>
     bool has_relationship(const path &source, const std::string &rel_id) const;
 
+    /// <summary>
+    /// Returns true if the manifest contains a relationship with the given type with part as the source
+    /// and with a target of "target".
+    /// </summary>
+    bool has_relationship(const path &source, relationship_type type, const uri &target) const;
+
     /// <summary>
     /// Returns the relationship with "source" as the source and with a type of "type".
     /// Throws a key_not_found exception if no such relationship is found.
@@ -75,6 +82,13 @@ public:
     /// </summary>
     class relationship relationship(const path &source, const std::string &rel_id) const;
 
+    /// <summary>
+    /// Returns the first registered relationship with "source" as the source, with a type of "type"
+    /// and with a target of "target".
+    /// Throws a key_not_found exception if no such relationship is found.
+    /// </summary>
+    class relationship relationship(const path &source, relationship_type type, const uri &target) const;
+
     /// <summary>
     /// Returns all relationship with "source" as the source.
     /// </summary>
@@ -178,7 +192,18 @@ private:
     /// <summary>
     /// Returns the lowest rId for the given part that hasn't already been registered.
     /// </summary>
-    std::string next_relationship_id(const path &part) const;
+    std::string next_relationship_id(const path &part);
+
+    /// <summary>
+    /// Adds rel to the target index of its source part if no relationship of the
+    /// same type and target was indexed before.
+    /// </summary>
+    void index_relationship(const class relationship &rel);
+
+    /// <summary>
+    /// Rebuilds the target index of the given part from its registered relationships.
+    /// </summary>
+    void reindex_relationships(const path &part);
 
     /// <summary>
     /// The map of extensions to default content types.
@@ -194,6 +219,21 @@ private:
     /// The map of package parts to their registered relationships.
     /// </summary>
     std::unordered_map<path, std::unordered_map<std::string, xlnt::relationship>> relationships_;
+
+    /// <summary>
+    /// The map of package parts to the lowest relationship index that may still be free.
+    /// Every index below this value is known to be taken which makes next_relationship_id
+    /// amortized constant time instead of linear in the number of relationships of the part.
+    /// </summary>
+    std::unordered_map<path, std::size_t> next_relationship_indices_;
+
+    /// <summary>
+    /// The map of package parts to relationship types to target paths to the ID of the first
+    /// relationship registered for that target. Used to find existing relationships (e.g. for
+    /// hyperlinks to the same URL) without scanning every relationship of the part.
+    /// </summary>
+    std::unordered_map<path, std::unordered_map<relationship_type,
+        std::unordered_map<std::string, std::string>, scoped_enum_hash<relationship_type>>> relationship_targets_;
 };
 
 } // namespace xlnt
@@ -26,9 +26,11 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/worksheet/range_reference.hpp>
 
 namespace xlnt {
 
@@ -59,6 +61,7 @@ public:
     }
 
 private:
+    friend struct detail::stylesheet;
     friend class detail::xlsx_producer;
 
     enum class type
@@ -142,6 +145,17 @@ public:
     /// </summary>
     conditional_format font(const xlnt::font &new_font);
 
+    /// <summary>
+    /// Returns the range this format was created for.
+    /// </summary>
+    range_reference range() const;
+
+    /// <summary>
+    /// Returns every range on the sheet with the same condition and format as this one,
+    /// including range(). These are written as a single rule.
+    /// </summary>
+    std::vector<range_reference> ranges() const;
+
     /// <summary>
     /// Returns true if this format is equivalent to other.
     /// </summary>
@@ -159,12 +173,18 @@ private:
     /// <summary>
     ///
     /// </summary>
-    conditional_format(detail::conditional_format_impl *d);
+    conditional_format(detail::conditional_format_impl *d, const range_reference &range);
 
     /// <summary>
     ///
     /// </summary>
     detail::conditional_format_impl *d_;
+
+    /// <summary>
+    /// The range this handle was created for. Setting a component moves it to the
+    /// rule with the new format.
+    /// </summary>
+    range_reference range_;
 };
 
 } // namespace xlnt
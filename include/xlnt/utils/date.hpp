@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <xlnt/xlnt_config.hpp>
@@ -48,6 +49,18 @@ struct XLNT_API date
     /// </summary>
     static date from_number(int days_since_base_year, calendar base_date);
 
+    /// <summary>
+    /// Converts count numbers of days since base_date into results, giving the same
+    /// dates as calling from_number on each but converting a block at a time.
+    /// </summary>
+    static void from_numbers(const int *days_since_base_year, std::size_t count, date *results, calendar base_date);
+
+    /// <summary>
+    /// Converts count dates into numbers of days since base_date, giving the same
+    /// numbers as calling to_number on each but converting a block at a time.
+    /// </summary>
+    static void to_numbers(const date *dates, std::size_t count, int *results, calendar base_date);
+
     /// <summary>
     /// Constructs a data from a given year, month, and day.
     /// </summary>
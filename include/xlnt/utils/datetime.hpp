@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <xlnt/xlnt_config.hpp>
@@ -56,6 +58,34 @@ struct XLNT_API datetime
     /// </summary>
     static datetime from_number(double number, calendar base_date);
 
+    /// <summary>
+    /// Converts count serial numbers relative to base_date into results, giving the
+    /// same datetimes as calling from_number on each but converting a block at a time.
+    /// The numbers must be finite.
+    /// </summary>
+    static void from_numbers(const double *numbers, std::size_t count, datetime *results, calendar base_date);
+
+    /// <summary>
+    /// Converts count datetimes into serial numbers relative to base_date, giving the
+    /// same numbers as calling to_number on each but converting a block at a time.
+    /// </summary>
+    static void to_numbers(const datetime *datetimes, std::size_t count, double *results, calendar base_date);
+
+    /// <summary>
+    /// Converts count serial numbers relative to base_date into microseconds since
+    /// 1970-01-01T00:00:00, treating the datetimes from_number would return as UTC.
+    /// The numbers must be finite. The nonexistent 1900-02-29 of the 1900 calendar
+    /// is converted to 1900-03-01.
+    /// </summary>
+    static void to_unix_microseconds(const double *numbers, std::size_t count, std::int64_t *results, calendar base_date);
+
+    /// <summary>
+    /// Converts count times in microseconds since 1970-01-01T00:00:00 UTC into serial
+    /// numbers relative to base_date, giving the same numbers as to_number would for
+    /// the corresponding datetimes.
+    /// </summary>
+    static void from_unix_microseconds(const std::int64_t *microseconds, std::size_t count, double *results, calendar base_date);
+
     /// <summary>
     /// Returns a datetime equivalent to the ISO-formatted string iso_string.
     /// </summary>
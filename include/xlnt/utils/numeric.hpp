@@ -185,6 +185,23 @@ public:
         ptrdiff_t ignore;
         return deserialise(s, &ignore);
     }
+
+    // for text that isn't null-terminated, e.g. in a reader's buffer
+    double deserialise(const char *s, std::size_t length) const
+    {
+        char buf[64];
+        if (length >= sizeof(buf))
+        {
+            return deserialise(std::string(s, length));
+        }
+        *std::copy(s, s + length, buf) = '\0';
+        if (should_convert_comma)
+        {
+            convert_pt_to_comma(buf, length);
+        }
+        char *end_of_convert;
+        return strtod(buf, &end_of_convert);
+    }
 };
 
 } // namespace detail
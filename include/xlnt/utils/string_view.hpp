@@ -0,0 +1,158 @@
+// Copyright (c) 2016-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// A non-owning reference to a contiguous sequence of characters, e.g. text held
+/// in a buffer of a streaming reader. The referenced characters must outlive the view.
+/// This is a small subset of std::string_view which isn't available before C++17.
+/// </summary>
+class string_view
+{
+public:
+    /// <summary>
+    /// Constructs an empty view.
+    /// </summary>
+    string_view() = default;
+
+    /// <summary>
+    /// Constructs a view of the size characters starting at data.
+    /// </summary>
+    string_view(const char *data, std::size_t size)
+        : data_(data), size_(size)
+    {
+    }
+
+    /// <summary>
+    /// Constructs a view of the null-terminated string c_str.
+    /// </summary>
+    string_view(const char *c_str)
+        : data_(c_str), size_(std::strlen(c_str))
+    {
+    }
+
+    /// <summary>
+    /// Constructs a view of the characters of string.
+    /// </summary>
+    string_view(const std::string &string)
+        : data_(string.data()), size_(string.size())
+    {
+    }
+
+    /// <summary>
+    /// Returns a pointer to the first character. The sequence isn't null-terminated.
+    /// </summary>
+    const char *data() const
+    {
+        return data_;
+    }
+
+    /// <summary>
+    /// Returns the number of characters in the view.
+    /// </summary>
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// <summary>
+    /// Returns true if the view has no characters.
+    /// </summary>
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// <summary>
+    /// Returns a pointer to the first character.
+    /// </summary>
+    const char *begin() const
+    {
+        return data_;
+    }
+
+    /// <summary>
+    /// Returns a pointer one past the last character.
+    /// </summary>
+    const char *end() const
+    {
+        return data_ + size_;
+    }
+
+    /// <summary>
+    /// Returns the character at index without bounds checking.
+    /// </summary>
+    char operator[](std::size_t index) const
+    {
+        return data_[index];
+    }
+
+    /// <summary>
+    /// Returns a copy of the characters as a string.
+    /// </summary>
+    std::string to_string() const
+    {
+        return std::string(data_, size_);
+    }
+
+    /// <summary>
+    /// Returns true if both views have the same characters.
+    /// </summary>
+    bool operator==(const string_view &rhs) const
+    {
+        return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+    }
+
+    /// <summary>
+    /// Returns true if the views have different characters.
+    /// </summary>
+    bool operator!=(const string_view &rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/// <summary>
+/// Writes the characters of view to stream.
+/// </summary>
+inline std::ostream &operator<<(std::ostream &stream, const string_view &view)
+{
+    return stream.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+
+} // namespace xlnt
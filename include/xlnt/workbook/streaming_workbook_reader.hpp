@@ -30,10 +30,7 @@
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
-
-namespace xml {
-class parser;
-}
+#include <xlnt/workbook/streaming_worksheet_cursor.hpp>
 
 namespace xlnt {
 
@@ -41,6 +38,7 @@ class cell;
 template <typename T>
 class optional;
 class path;
+class row_view;
 class workbook;
 class worksheet;
 
@@ -71,6 +69,15 @@ public:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the next row of the current worksheet into row and returns true, or
+    /// returns false if the last row has already been read. The cells of row point
+    /// into buffers that row reuses, so no cell objects are created for them and
+    /// they remain valid until row is read into again. Rows and single cells
+    /// shouldn't be read from the same worksheet.
+    /// </summary>
+    bool read_row(row_view &row);
+
     bool has_worksheet(const std::string &name);
 
     /// <summary>
@@ -86,6 +93,15 @@ public:
     /// </summary>
     worksheet end_worksheet();
 
+    /// <summary>
+    /// Opens a cursor over the rows of the worksheet with the given title, independent
+    /// of begin_worksheet() and of other cursors. Cursors share this reader's archive
+    /// and shared strings but have their own decompressor and parser, so several
+    /// worksheets can be streamed at once, e.g. one per thread. At most one cursor
+    /// should be open per worksheet. Throws xlnt::exception if there is no such sheet.
+    /// </summary>
+    streaming_worksheet_cursor open_worksheet_cursor(const std::string &title);
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -135,9 +151,6 @@ private:
     std::unique_ptr<workbook> workbook_;
     std::unique_ptr<std::istream> stream_;
     std::unique_ptr<std::streambuf> stream_buffer_;
-    std::unique_ptr<std::istream> part_stream_;
-    std::unique_ptr<std::streambuf> part_stream_buffer_;
-    std::unique_ptr<xml::parser> parser_;
 };
 
 } // namespace xlnt
@@ -25,22 +25,24 @@
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
-
-namespace xml {
-class serializer;
-}
+#include <xlnt/workbook/streaming_worksheet_writer.hpp>
 
 namespace xlnt {
 
 class cell;
 class cell_reference;
+class path;
+class workbook;
 class worksheet;
 
 namespace detail {
+class ozstream;
 class xlsx_producer;
 } // namespace detail
 
@@ -56,7 +58,9 @@ public:
     /// <summary>
     /// Finishes writing of the remaining contents of the workbook and closes
     /// currently open write stream. This will be called automatically by the
-    /// destructor if it hasn't already been called manually.
+    /// destructor if it hasn't already been called manually. The worksheets
+    /// are assembled into the archive here, so no handle returned by
+    /// add_worksheet_writer may be in use any longer.
     /// </summary>
     void close();
 
@@ -73,6 +77,15 @@ public:
     /// </summary>
     worksheet add_worksheet(const std::string &title);
 
+    /// <summary>
+    /// Adds a worksheet with the given title and returns a handle which writes its
+    /// cells. Handles must be created from the thread that owns this writer, but
+    /// each can then be filled from its own thread while the others are filled.
+    /// The properties of the workbook and of worksheets which are being filled
+    /// must not be changed meanwhile.
+    /// </summary>
+    streaming_worksheet_writer add_worksheet_writer(const std::string &title);
+
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the bytes into
     /// byte vector data.
@@ -104,13 +117,35 @@ public:
     /// </summary>
     void open(std::ostream &stream);
 
-    std::unique_ptr<xlnt::detail::xlsx_producer> producer_;
+private:
+    /// <summary>
+    /// The workbook being written. Streamed styles and shared strings are merged into it.
+    /// </summary>
     std::unique_ptr<workbook> workbook_;
+
+    /// <summary>
+    /// One producer per worksheet being streamed. All but the first own a spool of their worksheet.
+    /// </summary>
+    std::vector<std::unique_ptr<detail::xlsx_producer>> worksheet_producers_;
+
+    /// <summary>
+    /// The worksheet written by add_cell, or null before the first call to add_worksheet or add_cell.
+    /// </summary>
+    detail::xlsx_producer *current_producer_ = nullptr;
+
+    /// <summary>
+    /// Guards the sheets, manifest, styles and shared strings of workbook_ between worksheet producers.
+    /// </summary>
+    std::mutex mutex_;
+
+    /// <summary>
+    /// The archive being written. The first worksheet is written into it directly,
+    /// the rest of the workbook on close.
+    /// </summary>
+    std::unique_ptr<detail::ozstream> archive_;
+
     std::unique_ptr<std::ostream> stream_;
     std::unique_ptr<std::streambuf> stream_buffer_;
-    std::unique_ptr<std::ostream> part_stream_;
-    std::unique_ptr<std::streambuf> part_stream_buffer_;
-    std::unique_ptr<xml::serializer> serializer_;
 };
 
 } // namespace xlnt
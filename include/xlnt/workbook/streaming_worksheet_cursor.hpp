@@ -0,0 +1,95 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+// Copyright (c) 2010-2015 openpyxl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class row_view;
+
+namespace detail {
+class xlsx_consumer;
+}
+
+/// <summary>
+/// Streams the rows of one worksheet of a workbook opened by a streaming_workbook_reader.
+/// Every cursor has its own decompressor and parser over the reader's archive, so any
+/// number of cursors can be open at once and each can be read from its own thread.
+/// Cursors should be opened from the thread that owns the reader and must not outlive it.
+/// </summary>
+class XLNT_API streaming_worksheet_cursor
+{
+public:
+    /// <summary>
+    /// Move constructor.
+    /// </summary>
+    streaming_worksheet_cursor(streaming_worksheet_cursor &&other);
+
+    /// <summary>
+    /// Move assignment operator.
+    /// </summary>
+    streaming_worksheet_cursor &operator=(streaming_worksheet_cursor &&other);
+
+    /// <summary>
+    /// Destructor.
+    /// </summary>
+    ~streaming_worksheet_cursor();
+
+    /// <summary>
+    /// Returns the title of the worksheet this cursor reads.
+    /// </summary>
+    const std::string &title() const;
+
+    /// <summary>
+    /// Reads the next row of the worksheet into row and returns true, or returns
+    /// false if the last row has already been read.
+    /// See streaming_workbook_reader::read_row.
+    /// </summary>
+    bool read_row(row_view &row);
+
+private:
+    friend class streaming_workbook_reader;
+
+    /// <summary>
+    /// Constructs a cursor reading through consumer. Only streaming_workbook_reader
+    /// creates cursors.
+    /// </summary>
+    streaming_worksheet_cursor(const std::string &title, std::unique_ptr<detail::xlsx_consumer> &&consumer);
+
+    /// <summary>
+    /// The title of the worksheet.
+    /// </summary>
+    std::string title_;
+
+    /// <summary>
+    /// Reads the worksheet. It owns the part's stream and parser.
+    /// </summary>
+    std::unique_ptr<detail::xlsx_consumer> consumer_;
+};
+
+} // namespace xlnt
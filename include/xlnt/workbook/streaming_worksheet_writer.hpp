@@ -0,0 +1,83 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+// Copyright (c) 2010-2015 openpyxl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+#pragma once
+
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class cell;
+class cell_reference;
+class worksheet;
+
+namespace detail {
+class xlsx_producer;
+}
+
+/// <summary>
+/// Streams the cells of one worksheet of a workbook being written by a streaming_workbook_writer.
+/// Every handle fills its own worksheet and compresses it into a spool of its own, so
+/// the worksheets of a workbook can be filled at the same time from different threads.
+/// Styles and shared strings are merged into the workbook as cells are written and the
+/// spools are copied into the archive when the writer is closed. Handles are cheap to
+/// copy, belong to the writer that created them and must not outlive it.
+/// </summary>
+class XLNT_API streaming_worksheet_writer
+{
+public:
+    /// <summary>
+    /// Returns the title of the worksheet this handle writes.
+    /// </summary>
+    std::string title() const;
+
+    /// <summary>
+    /// Returns the worksheet this handle writes. Its properties, such as column
+    /// widths and page setup, may be changed until its first cell is added.
+    /// </summary>
+    class worksheet worksheet() const;
+
+    /// <summary>
+    /// Writes the previously added cell and returns a cell at ref to be filled. ref must be
+    /// to the right of or below the previously added cell. The returned cell is only valid
+    /// until the next call. Hyperlinks and comments of streamed cells aren't written.
+    /// </summary>
+    cell add_cell(const cell_reference &ref);
+
+private:
+    friend class streaming_workbook_writer;
+
+    /// <summary>
+    /// Constructs a handle writing through producer. Only streaming_workbook_writer
+    /// creates handles.
+    /// </summary>
+    streaming_worksheet_writer(detail::xlsx_producer *producer);
+
+    /// <summary>
+    /// Writes the worksheet. It is owned by the streaming_workbook_writer.
+    /// </summary>
+    detail::xlsx_producer *producer_;
+};
+
+} // namespace xlnt
@@ -35,6 +35,7 @@
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/cell/rich_text.hpp>
+#include <xlnt/workbook/file_format.hpp>
 
 namespace xlnt {
 
@@ -42,6 +43,7 @@ enum class calendar;
 enum class core_property;
 enum class extended_property;
 enum class relationship_type;
+enum class string_storage;
 
 class alignment;
 class border;
@@ -65,10 +67,12 @@ class range;
 class range_reference;
 class relationship;
 class streaming_workbook_reader;
+class streaming_workbook_writer;
 class style;
 class style_serializer;
 class theme;
 class variant;
+class workbook_diff;
 class workbook_view;
 class worksheet;
 class worksheet_iterator;
@@ -78,8 +82,12 @@ struct datetime;
 
 namespace detail {
 
+class snapshot_consumer;
+class snapshot_producer;
 struct stylesheet;
 struct workbook_impl;
+class xlsb_consumer;
+class xlsb_producer;
 class xlsx_consumer;
 class xlsx_producer;
 
@@ -502,7 +510,8 @@ public:
 
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the data into a file
-    /// named filename.
+    /// named filename. This is XLSX whatever the extension, since XLSB leaves out
+    /// content, see save(const xlnt::path &, file_format).
     /// </summary>
     void save(const xlnt::path &filename) const;
 
@@ -523,6 +532,35 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into a file of the given format and saves the bytes
+    /// into byte vector data. XLSB leaves out the content listed for
+    /// save(std::ostream &, file_format).
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, file_format format) const;
+
+    /// <summary>
+    /// Serializes the workbook into a file of the given format and saves the data
+    /// into a file named filename. XLSB leaves out the content listed for
+    /// save(std::ostream &, file_format).
+    /// </summary>
+    void save(const xlnt::path &filename, file_format format) const;
+
+    /// <summary>
+    /// Serializes the workbook into a file of the given format and saves the data
+    /// into stream. XLSB files get cell values, shared strings, styles, sheet
+    /// visibility and views, column widths, row heights, merged cells and page margins,
+    /// along with the document properties, theme and thumbnail. They don't get:
+    /// formulas, of which only the last calculated values are written; the formatting
+    /// of rich text, of which only the plain text is written; comments; hyperlinks;
+    /// images, charts and other drawings; conditional formats; data validations;
+    /// auto-filters; defined names, print areas and print titles; page setup other
+    /// than margins, headers and footers, and page breaks; panes and selections;
+    /// sheet properties such as tab colors; sheet and workbook protection; phonetic
+    /// properties; and extension lists.
+    /// </summary>
+    void save(std::ostream &stream, file_format format) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -575,7 +613,8 @@ public:
 
     /// <summary>
     /// Interprets data in stream as an XLSX file and sets the content of this
-    /// workbook to match that file.
+    /// workbook to match that file. XLSB files are detected from the content type
+    /// of their workbook part and read as well.
     /// </summary>
     void load(std::istream &stream);
 
@@ -585,6 +624,56 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    // Snapshots
+
+    /// <summary>
+    /// Serializes the workbook into a snapshot, a binary format native to this version
+    /// of xlnt which load_snapshot reads back much faster than load reads an XLSX file,
+    /// and saves the bytes into byte vector data. Snapshots are meant to be a cache of
+    /// a workbook and can't be opened by other applications.
+    /// </summary>
+    void save_snapshot(std::vector<std::uint8_t> &data) const;
+
+    /// <summary>
+    /// Serializes the workbook into a snapshot and saves it into a file named filename.
+    /// </summary>
+    void save_snapshot(const std::string &filename) const;
+
+    /// <summary>
+    /// Serializes the workbook into a snapshot and saves it into a file named filename.
+    /// </summary>
+    void save_snapshot(const xlnt::path &filename) const;
+
+    /// <summary>
+    /// Serializes the workbook into a snapshot and writes it into stream.
+    /// </summary>
+    void save_snapshot(std::ostream &stream) const;
+
+    /// <summary>
+    /// Interprets byte vector data as a snapshot and sets the content of this workbook
+    /// to match it. Throws invalid_file if data isn't a snapshot written by this
+    /// version of xlnt or is corrupt.
+    /// </summary>
+    void load_snapshot(const std::vector<std::uint8_t> &data);
+
+    /// <summary>
+    /// Interprets the file named filename as a snapshot and sets the content of this
+    /// workbook to match it.
+    /// </summary>
+    void load_snapshot(const std::string &filename);
+
+    /// <summary>
+    /// Interprets the file named filename as a snapshot and sets the content of this
+    /// workbook to match it.
+    /// </summary>
+    void load_snapshot(const xlnt::path &filename);
+
+    /// <summary>
+    /// Interprets the data in stream as a snapshot and sets the content of this
+    /// workbook to match it.
+    /// </summary>
+    void load_snapshot(std::istream &stream);
+
     // View
 
     /// <summary>
@@ -767,6 +856,29 @@ public:
     /// </summary>
     std::size_t add_shared_string(const rich_text &shared, bool allow_duplicates = false);
 
+    /// <summary>
+    /// Sets how string values are stored in columns of this workbook's worksheets
+    /// which don't have a storage of their own. The default is string_storage::shared.
+    /// </summary>
+    void default_string_storage(string_storage storage);
+
+    /// <summary>
+    /// Returns how string values are stored in columns without a storage of their own.
+    /// </summary>
+    string_storage default_string_storage() const;
+
+    /// <summary>
+    /// Sets the number of cells each worksheet keeps in memory, see worksheet::max_resident_cells.
+    /// This applies to the worksheets of this workbook and those created or loaded later.
+    /// Zero, the default, keeps every cell in memory.
+    /// </summary>
+    void max_resident_cells(std::size_t count);
+
+    /// <summary>
+    /// Returns the number of cells each worksheet keeps in memory, or zero if they keep all of them.
+    /// </summary>
+    std::size_t max_resident_cells() const;
+
     /// <summary>
     /// Returns a reference to the shared string related to the specified index
     /// </summary>
@@ -845,9 +957,24 @@ public:
     /// </summary>
     bool operator!=(const workbook &rhs) const;
 
+    /// <summary>
+    /// Compares this workbook with other and returns every difference found in
+    /// worksheets (matched by title), styles and workbook-level metadata. Worksheets
+    /// are compared by row and block fingerprints first so that identical parts are
+    /// skipped without comparing their cells. If parallel is true, fingerprints and
+    /// changed blocks are processed on multiple threads.
+    /// </summary>
+    workbook_diff diff(const workbook &other, bool parallel = false) const;
+
 private:
+    friend class range;
     friend class streaming_workbook_reader;
+    friend class streaming_workbook_writer;
     friend class worksheet;
+    friend class detail::snapshot_consumer;
+    friend class detail::snapshot_producer;
+    friend class detail::xlsb_consumer;
+    friend class detail::xlsb_producer;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
 
@@ -892,11 +1019,24 @@ private:
     /// </summary>
     void register_worksheet_part(worksheet ws, relationship_type type);
 
+    /// <summary>
+    /// Returns true if any worksheet has a cell with a formula.
+    /// </summary>
+    bool has_formulae() const;
+
     /// <summary>
     /// Removes calcChain part from manifest if no formulae remain in workbook.
     /// </summary>
     void garbage_collect_formulae();
 
+    /// <summary>
+    /// Brings the shared strings, calcChain and comments parts in target, a copy of
+    /// this workbook's manifest, up to date. Cell setters only register these on first
+    /// use and never remove them, so the producers call this on their own copy before
+    /// the package is written, leaving the workbook as it was.
+    /// </summary>
+    void reconcile_manifest(class manifest &target) const;
+
     /// <summary>
     /// Update extended workbook properties titlesOfParts and headingPairs when sheets change.
     /// </summary>
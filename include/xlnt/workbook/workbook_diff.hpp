@@ -0,0 +1,64 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/worksheet/worksheet_diff.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The differences between two workbooks as returned by workbook::diff.
+/// Worksheets are matched by title.
+/// </summary>
+class XLNT_API workbook_diff
+{
+public:
+    /// <summary>
+    /// The differences of every worksheet that was added, removed or changed.
+    /// </summary>
+    std::vector<worksheet_diff> worksheets;
+
+    /// <summary>
+    /// True if the stylesheets differ. Cell formats are then compared by content
+    /// instead of by their position in the stylesheet.
+    /// </summary>
+    bool styles_changed = false;
+
+    /// <summary>
+    /// True if workbook-level metadata differs, e.g. document properties, views,
+    /// calculation properties, the base date or the order and visibility of sheets.
+    /// </summary>
+    bool properties_changed = false;
+
+    /// <summary>
+    /// Returns true if no difference was found.
+    /// </summary>
+    bool empty() const;
+};
+
+} // namespace xlnt
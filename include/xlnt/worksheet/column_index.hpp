@@ -0,0 +1,216 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// A value to look up in a column_index. A key is either empty, a number
+/// (dates and times are numbers too) or a string.
+/// </summary>
+class XLNT_API index_key
+{
+public:
+    /// <summary>
+    /// Constructs an empty key which matches cells without a value. A row is only
+    /// found by its empty key cells when at least one of its other key cells has a value.
+    /// </summary>
+    index_key();
+
+    /// <summary>
+    /// Constructs a numeric key.
+    /// </summary>
+    index_key(double number);
+
+    /// <summary>
+    /// Constructs a numeric key.
+    /// </summary>
+    index_key(int number);
+
+    /// <summary>
+    /// Constructs a string key. Strings are compared case-sensitively.
+    /// </summary>
+    index_key(const std::string &text);
+
+    /// <summary>
+    /// Constructs a string key. Strings are compared case-sensitively.
+    /// </summary>
+    index_key(const char *text);
+
+    /// <summary>
+    /// Returns true if this key is empty.
+    /// </summary>
+    bool is_empty() const;
+
+    /// <summary>
+    /// Returns true if this key is a number.
+    /// </summary>
+    bool is_number() const;
+
+    /// <summary>
+    /// Returns true if this key is a string.
+    /// </summary>
+    bool is_text() const;
+
+    /// <summary>
+    /// Returns the numeric value of this key.
+    /// </summary>
+    double number() const;
+
+    /// <summary>
+    /// Returns the string value of this key.
+    /// </summary>
+    const std::string &text() const;
+
+private:
+    enum class key_type
+    {
+        empty,
+        number,
+        text
+    };
+
+    key_type type_;
+    double number_;
+    std::string text_;
+};
+
+/// <summary>
+/// A hash index over one or more key columns of a worksheet which finds the rows
+/// matching a key in constant expected time instead of scanning the columns.
+/// Numbers, dates and strings (shared or inline) can be looked up. Rows whose key
+/// cells contain booleans or errors aren't indexed, and neither are rows whose key
+/// cells are all empty since every row past the end of the sheet would match them.
+/// The index doesn't observe the worksheet. After changing cells in a key column,
+/// call update with the changed row or rebuild the whole index.
+/// </summary>
+class XLNT_API column_index
+{
+public:
+    /// <summary>
+    /// Builds an index over a single key column of ws.
+    /// </summary>
+    column_index(worksheet ws, column_t key_column, bool parallel = false);
+
+    /// <summary>
+    /// Builds an index over several key columns of ws. A row matches when every
+    /// key cell matches the corresponding key in the same order.
+    /// Throws invalid_parameter if key_columns is empty.
+    /// </summary>
+    column_index(worksheet ws, const std::vector<column_t> &key_columns, bool parallel = false);
+
+    /// <summary>
+    /// Returns the key columns of this index.
+    /// </summary>
+    const std::vector<column_t> &key_columns() const;
+
+    /// <summary>
+    /// Returns the number of indexed rows.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns all rows matching key in ascending order, or no rows if key is
+    /// empty. The index must have a single key column, otherwise invalid_parameter
+    /// is thrown.
+    /// </summary>
+    std::vector<row_t> find(const index_key &key) const;
+
+    /// <summary>
+    /// Returns all rows matching keys in ascending order, or no rows if every key
+    /// is empty. Throws invalid_parameter if the number of keys doesn't equal the
+    /// number of key columns.
+    /// </summary>
+    std::vector<row_t> find(const std::vector<index_key> &keys) const;
+
+    /// <summary>
+    /// Returns true if at least one row matches key.
+    /// </summary>
+    bool contains(const index_key &key) const;
+
+    /// <summary>
+    /// Re-reads the key cells of row and updates the index. Call this after
+    /// changing, adding or clearing a cell in a key column.
+    /// </summary>
+    void update(row_t row);
+
+    /// <summary>
+    /// Discards the index and builds it again from the worksheet in one pass over
+    /// its cell storage. If parallel is true, the work is split across threads.
+    /// </summary>
+    void rebuild(bool parallel = false);
+
+private:
+    /// <summary>
+    /// Returns the shard of hash.
+    /// </summary>
+    const std::unordered_multimap<std::uint64_t, row_t> &shard(std::uint64_t hash) const;
+
+    /// <summary>
+    /// Returns the combined hash of the key cells of row or 0 if it can't be indexed.
+    /// </summary>
+    std::uint64_t row_hash(row_t row) const;
+
+    /// <summary>
+    /// Returns true if the key cells of row equal keys.
+    /// </summary>
+    bool matches(row_t row, const std::vector<index_key> &keys) const;
+
+    /// <summary>
+    /// The indexed worksheet.
+    /// </summary>
+    worksheet ws_;
+
+    /// <summary>
+    /// The indexed columns.
+    /// </summary>
+    std::vector<column_t> key_columns_;
+
+    /// <summary>
+    /// The combined key hash of every row, indexed by row number. 0 means not indexed.
+    /// </summary>
+    std::vector<std::uint64_t> row_hashes_;
+
+    /// <summary>
+    /// Rows by key hash, split into shards by hash so that they can be built in parallel.
+    /// </summary>
+    std::vector<std::unordered_multimap<std::uint64_t, row_t>> shards_;
+
+    /// <summary>
+    /// The number of indexed rows.
+    /// </summary>
+    std::size_t size_;
+};
+
+} // namespace xlnt
@@ -41,6 +41,8 @@
 #include <xlnt/worksheet/major_order.hpp>
 #include <xlnt/worksheet/range_iterator.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
+#include <xlnt/worksheet/range_statistics.hpp>
+#include <xlnt/worksheet/sort_key.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 
 namespace xlnt {
@@ -270,6 +272,33 @@ public:
     /// </summary>
     void apply(std::function<void(class cell)> f);
 
+    /// <summary>
+    /// Computes count, sum, minimum, maximum, mean and distinct count of the numeric
+    /// cells in this range in a single pass over the worksheet's cell storage. Cells
+    /// that aren't numbers are skipped. If parallel is true, the work is split into
+    /// blocks processed on multiple threads which may change the rounding of the sum.
+    /// </summary>
+    range_statistics statistics(bool parallel = false) const;
+
+    /// <summary>
+    /// Reorders the rows of this range by the given keys, the first key being the most
+    /// significant. The sort is stable. Whole cells are moved including their values,
+    /// formats, hyperlinks, comments and formulae (which are moved verbatim). Cells
+    /// outside of the range aren't affected. Throws invalid_parameter if a key column is
+    /// outside of this range or if a merged range intersects it. If parallel is true,
+    /// key extraction and sorting are split across multiple threads.
+    /// </summary>
+    void sort(const std::vector<sort_key> &keys, bool parallel = false);
+
+    /// <summary>
+    /// Sets the width of each column in this range to fit the widest displayed value
+    /// in the range. Values are rendered with their cell's number format and measured
+    /// with approximate glyph widths of their font. Wrapped and merged cells are
+    /// ignored as are columns without any measurable value. If parallel is true,
+    /// the cells are measured on multiple threads.
+    /// </summary>
+    void auto_fit_columns(bool parallel = false);
+
     /// <summary>
     /// Returns the n-th row or column in this range.
     /// </summary>
@@ -115,6 +115,18 @@ public:
     /// </summary>
     std::string to_string() const;
 
+    /// <summary>
+    /// The maximum number of characters to_chars can write.
+    /// </summary>
+    static const std::size_t max_string_length = 2 * cell_reference::max_string_length + 1;
+
+    /// <summary>
+    /// Writes a string like "A1:B2" to the buffer [first, last) without allocating and
+    /// returns a pointer one past the last character written. No terminating null
+    /// character is written. Throws invalid_parameter if the buffer is too small.
+    /// </summary>
+    char *to_chars(char *first, char *last) const;
+
     /// <summary>
     /// Returns true if this range is equivalent to the other range.
     /// </summary>
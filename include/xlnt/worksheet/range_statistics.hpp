@@ -0,0 +1,80 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/utils/optional.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Summary statistics of the numeric cells in a range as computed by range::statistics.
+/// Only cells of type number contribute to count, sum, minimum, maximum and distinct_count.
+/// Strings, booleans, errors and empty cells are skipped the same way aggregate functions
+/// in a spreadsheet application skip them.
+/// </summary>
+class XLNT_API range_statistics
+{
+public:
+    /// <summary>
+    /// The number of numeric cells in the range.
+    /// </summary>
+    std::size_t count = 0;
+
+    /// <summary>
+    /// The number of cells in the range that have a value of any type.
+    /// </summary>
+    std::size_t value_count = 0;
+
+    /// <summary>
+    /// The number of distinct numeric values in the range. All NaN values count as one.
+    /// </summary>
+    std::size_t distinct_count = 0;
+
+    /// <summary>
+    /// The sum of all numeric values in the range.
+    /// </summary>
+    double sum = 0.0;
+
+    /// <summary>
+    /// The smallest numeric value in the range. Not set if the range has no numeric cells.
+    /// </summary>
+    optional<double> minimum;
+
+    /// <summary>
+    /// The largest numeric value in the range. Not set if the range has no numeric cells.
+    /// </summary>
+    optional<double> maximum;
+
+    /// <summary>
+    /// Returns the arithmetic mean of the numeric values in the range.
+    /// Throws invalid_attribute if the range has no numeric cells.
+    /// </summary>
+    double mean() const;
+};
+
+} // namespace xlnt
@@ -0,0 +1,253 @@
+// Copyright (c) 2016-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/utils/calendar.hpp>
+#include <xlnt/utils/string_view.hpp>
+
+namespace xlnt {
+
+struct date;
+struct datetime;
+struct time;
+struct timedelta;
+
+namespace detail {
+class xlsx_consumer;
+}
+
+/// <summary>
+/// A read-only view of one cell of a row_view filled by streaming_workbook_reader::read_row.
+/// Text is not copied out of the reader, so views returned by this cell are only
+/// valid until the row_view it belongs to is read into again.
+/// </summary>
+class XLNT_API cell_view
+{
+public:
+    /// <summary>
+    /// Returns the reference of this cell.
+    /// </summary>
+    cell_reference reference() const;
+
+    /// <summary>
+    /// Returns the column of this cell.
+    /// </summary>
+    column_t column() const;
+
+    /// <summary>
+    /// Returns the row of this cell.
+    /// </summary>
+    row_t row() const;
+
+    /// <summary>
+    /// Returns the type of this cell's value. A cell of type date holds an ISO 8601 string.
+    /// </summary>
+    cell_type data_type() const;
+
+    /// <summary>
+    /// Returns true if this cell has a value.
+    /// </summary>
+    bool has_value() const;
+
+    /// <summary>
+    /// Returns the value of this cell as type T. Numeric types and dates parse the
+    /// stored text on each call. Text types (string_view and std::string) return the
+    /// shared or inline string, the error or the formula result, or else the value
+    /// as it appears in the file. Throws invalid_data_type if the value can't be
+    /// converted, e.g. when asking for a number from a string cell.
+    /// </summary>
+    template <typename T>
+    T value() const;
+
+    /// <summary>
+    /// Returns the value of this cell exactly as it appears in the file, e.g. the
+    /// index of a shared string.
+    /// </summary>
+    string_view raw_value() const;
+
+    /// <summary>
+    /// Returns true if this cell has a formula. Cells that only refer to a shared
+    /// formula aren't reported as having one.
+    /// </summary>
+    bool has_formula() const;
+
+    /// <summary>
+    /// Returns the formula of this cell without a leading "=".
+    /// </summary>
+    string_view formula() const;
+
+    /// <summary>
+    /// Returns true if this cell has a format.
+    /// </summary>
+    bool has_format() const;
+
+    /// <summary>
+    /// Returns the index of this cell's format in the workbook's formats.
+    /// Throws invalid_attribute if the cell has no format.
+    /// </summary>
+    std::size_t format_id() const;
+
+    /// <summary>
+    /// Returns true if phonetics are visible for this cell.
+    /// </summary>
+    bool phonetics_visible() const;
+
+private:
+    friend class detail::xlsx_consumer;
+    friend class row_view;
+
+    double number() const;
+
+    column_t::index_t column_ = 0;
+    row_t row_ = 0;
+    cell_type type_ = cell_type::empty;
+    calendar base_date_ = calendar::windows_1900;
+    bool has_formula_ = false;
+    bool has_format_ = false;
+    bool phonetics_visible_ = false;
+    std::size_t format_id_ = 0;
+
+    // text, formula and raw value point into row_view::text_ or the shared strings
+    // of the reader and are stored as offsets into row_view::text_ while reading
+    string_view text_;
+    string_view formula_;
+    string_view raw_value_;
+    std::size_t raw_value_offset_ = 0;
+    std::size_t formula_offset_ = 0;
+};
+
+/// <summary>
+/// The cells of one row of a worksheet as read by streaming_workbook_reader::read_row.
+/// A row_view owns the text of its cells and reuses its buffers for every row read
+/// into it so that reading a worksheet doesn't allocate per cell. It can't be copied
+/// or moved since its cell_views point into it.
+/// </summary>
+class XLNT_API row_view
+{
+public:
+    /// <summary>
+    /// Constructs an empty row.
+    /// </summary>
+    row_view() = default;
+
+    row_view(const row_view &) = delete;
+    row_view &operator=(const row_view &) = delete;
+
+    /// <summary>
+    /// Returns the index of this row.
+    /// </summary>
+    row_t row() const;
+
+    /// <summary>
+    /// Returns the number of cells in this row. Cells that aren't stored in
+    /// the file aren't included.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns true if this row has no cells.
+    /// </summary>
+    bool empty() const;
+
+    /// <summary>
+    /// Returns the cell at index in the order they appear in the file.
+    /// </summary>
+    const cell_view &operator[](std::size_t index) const;
+
+    /// <summary>
+    /// Returns an iterator to the first cell of this row.
+    /// </summary>
+    std::vector<cell_view>::const_iterator begin() const;
+
+    /// <summary>
+    /// Returns an iterator past the last cell of this row.
+    /// </summary>
+    std::vector<cell_view>::const_iterator end() const;
+
+    /// <summary>
+    /// Returns true if this row has a cell in column.
+    /// </summary>
+    bool has_cell(column_t column) const;
+
+    /// <summary>
+    /// Returns the cell of this row in column. Throws key_not_found if there is none.
+    /// </summary>
+    const cell_view &cell(column_t column) const;
+
+private:
+    friend class detail::xlsx_consumer;
+
+    row_t row_ = 0;
+    std::vector<cell_view> cells_;
+    std::string text_;
+};
+
+template <>
+bool cell_view::value<bool>() const;
+
+template <>
+int cell_view::value<int>() const;
+
+template <>
+unsigned int cell_view::value<unsigned int>() const;
+
+template <>
+long long int cell_view::value<long long int>() const;
+
+template <>
+unsigned long long cell_view::value<unsigned long long int>() const;
+
+template <>
+float cell_view::value<float>() const;
+
+template <>
+double cell_view::value<double>() const;
+
+template <>
+date cell_view::value<date>() const;
+
+template <>
+time cell_view::value<time>() const;
+
+template <>
+datetime cell_view::value<datetime>() const;
+
+template <>
+timedelta cell_view::value<timedelta>() const;
+
+template <>
+string_view cell_view::value<string_view>() const;
+
+template <>
+std::string cell_view::value<std::string>() const;
+
+} // namespace xlnt
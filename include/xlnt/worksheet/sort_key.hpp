@@ -0,0 +1,100 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The direction in which a range is sorted by a key column.
+/// </summary>
+enum class XLNT_API sort_direction
+{
+    ascending,
+    descending
+};
+
+/// <summary>
+/// Defines how the values of a key column are compared when sorting a range.
+/// Regardless of the rule and direction, values are ordered by type first:
+/// numbers, then text, then booleans, then errors. Empty cells are always last and
+/// NaN is always after the other numbers.
+/// </summary>
+enum class XLNT_API sort_rule
+{
+    /// <summary>
+    /// Numbers (including dates and times which are stored as serial numbers) are
+    /// compared numerically and text is compared without regard to case.
+    /// </summary>
+    standard,
+
+    /// <summary>
+    /// Like standard, but text is compared case-sensitively by code point.
+    /// </summary>
+    case_sensitive,
+
+    /// <summary>
+    /// Like standard, but text holding an ISO 8601 date or datetime (e.g. "2020-01-31")
+    /// is converted to a serial number and sorted together with numeric dates.
+    /// </summary>
+    dates
+};
+
+/// <summary>
+/// A column of a range to sort by, the direction to sort in and the rule for comparing values.
+/// </summary>
+class XLNT_API sort_key
+{
+public:
+    /// <summary>
+    /// Constructs a sort key on the given worksheet column.
+    /// </summary>
+    sort_key(column_t key_column, sort_direction key_direction = sort_direction::ascending,
+        sort_rule key_rule = sort_rule::standard)
+        : column(key_column),
+          direction(key_direction),
+          rule(key_rule)
+    {
+    }
+
+    /// <summary>
+    /// The worksheet column to compare. It must be within the range being sorted.
+    /// </summary>
+    column_t column;
+
+    /// <summary>
+    /// The direction of the sort for this key.
+    /// </summary>
+    sort_direction direction;
+
+    /// <summary>
+    /// The rule used to compare values in this key.
+    /// </summary>
+    sort_rule rule;
+};
+
+} // namespace xlnt
@@ -36,9 +36,12 @@
 #include <xlnt/worksheet/page_margins.hpp>
 #include <xlnt/worksheet/page_setup.hpp>
 #include <xlnt/worksheet/sheet_view.hpp>
+#include <xlnt/worksheet/worksheet_diff.hpp>
 
 namespace xlnt {
 
+enum class string_storage;
+
 class cell;
 class cell_reference;
 class cell_vector;
@@ -55,6 +58,7 @@ class range_reference;
 class relationship;
 class row_properties;
 class sheet_format_properties;
+class streaming_worksheet_writer;
 class workbook;
 class phonetic_pr;
 
@@ -62,6 +66,8 @@ struct date;
 
 namespace detail {
 
+class xlsb_consumer;
+class xlsb_producer;
 class xlsx_consumer;
 class xlsx_producer;
 
@@ -318,6 +324,24 @@ public:
     /// </summary>
     double column_width(column_t column) const;
 
+    /// <summary>
+    /// Sets the width of every column containing values to fit its widest displayed value.
+    /// This is equivalent to calling range::auto_fit_columns on calculate_dimension().
+    /// </summary>
+    void auto_fit_columns(bool parallel = false);
+
+    /// <summary>
+    /// Sets how string values assigned to cells of the given column are stored and written.
+    /// Strings already assigned to the column are written according to storage as well.
+    /// </summary>
+    void column_string_storage(column_t column, string_storage storage);
+
+    /// <summary>
+    /// Returns how string values of the given column are stored, the workbook's
+    /// default_string_storage if none was set for the column.
+    /// </summary>
+    string_storage column_string_storage(column_t column) const;
+
     /// <summary>
     /// Returns the row properties for the given row.
     /// </summary>
@@ -507,6 +531,29 @@ public:
     /// </summary>
     bool compare(const worksheet &other, bool reference) const;
 
+    /// <summary>
+    /// Computes the row and block content fingerprints of this worksheet in a
+    /// single pass over its cells. If parallel is true, the pass is split across threads.
+    /// </summary>
+    worksheet_fingerprint fingerprint(bool parallel = false) const;
+
+    /// <summary>
+    /// Compares this worksheet with other and returns the changed cells and rows and
+    /// whether sheet-level metadata differs. Rows and blocks of rows with equal
+    /// fingerprints are skipped. If parallel is true, fingerprints and changed blocks
+    /// are processed on multiple threads.
+    /// </summary>
+    worksheet_diff diff(const worksheet &other, bool parallel = false) const;
+
+    /// <summary>
+    /// Compares this worksheet with other like diff(other, parallel) but reuses fingerprints
+    /// previously returned by fingerprint() for each sheet, e.g. one kept alongside an
+    /// earlier snapshot. The fingerprints must still match the current cells or changes
+    /// in blocks with equal fingerprints will be missed.
+    /// </summary>
+    worksheet_diff diff(const worksheet &other, const worksheet_fingerprint &this_fingerprint,
+        const worksheet_fingerprint &other_fingerprint, bool parallel = false) const;
+
     // page
 
     /// <summary>
@@ -577,6 +624,21 @@ public:
     /// </summary>
     void reserve(std::size_t n);
 
+    /// <summary>
+    /// Keeps at most count cells of this worksheet in memory. Blocks of rows which
+    /// haven't been used recently are written to a temporary file and read back when
+    /// they are used again, so worksheets larger than memory can be loaded, changed
+    /// and saved. The rows of a cell stay in memory while a cell object referring to
+    /// it exists, so holding many cell objects can keep more cells in memory than the
+    /// limit. Zero, the default, keeps every cell in memory.
+    /// </summary>
+    void max_resident_cells(std::size_t count);
+
+    /// <summary>
+    /// Returns the number of cells this worksheet keeps in memory, or zero if it keeps all of them.
+    /// </summary>
+    std::size_t max_resident_cells() const;
+
     /// <summary>
     /// Returns true if this sheet has phonetic properties
     /// </summary>
@@ -778,9 +840,14 @@ public:
 
 private:
     friend class cell;
+    friend class column_index;
     friend class const_range_iterator;
+    friend class range;
     friend class range_iterator;
+    friend class streaming_worksheet_writer;
     friend class workbook;
+    friend class detail::xlsb_consumer;
+    friend class detail::xlsb_producer;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
 
@@ -799,11 +866,6 @@ private:
     /// </summary>
     void register_calc_chain_in_manifest();
 
-    /// <summary>
-    /// Removes calcChain part from manifest if no formulae remain in workbook.
-    /// </summary>
-    void garbage_collect_formulae();
-
     /// <summary>
     /// Sets the parent of this worksheet to wb.
     /// </summary>
@@ -0,0 +1,160 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Content fingerprints of the cells of a worksheet, one per row and one per block
+/// of consecutive rows. Two rows or blocks with different fingerprints are certainly
+/// different, equal fingerprints mean they are identical with very high probability.
+/// A row fingerprint is an order-independent sum of the hashes of its cells so it
+/// can be computed in a single pass over the cell storage and in parallel.
+/// Cell formats are fingerprinted by their position in the stylesheet.
+/// </summary>
+class XLNT_API worksheet_fingerprint
+{
+public:
+    /// <summary>
+    /// The number of consecutive rows summarised by each block fingerprint.
+    /// </summary>
+    static const row_t rows_per_block;
+
+    /// <summary>
+    /// The fingerprint of every row indexed by row number. Rows without cells have a fingerprint of 0.
+    /// </summary>
+    std::vector<std::uint64_t> rows;
+
+    /// <summary>
+    /// The fingerprint of every block of rows_per_block rows. Block n covers
+    /// rows n * rows_per_block + 1 to (n + 1) * rows_per_block.
+    /// </summary>
+    std::vector<std::uint64_t> blocks;
+
+    /// <summary>
+    /// The highest column index of any cell in the worksheet.
+    /// </summary>
+    column_t::index_t highest_column = 0;
+
+    /// <summary>
+    /// Returns the fingerprint of the given row or 0 if it is out of bounds.
+    /// </summary>
+    std::uint64_t row(row_t row) const;
+
+    /// <summary>
+    /// Returns the fingerprint of the given block or 0 if it is out of bounds.
+    /// </summary>
+    std::uint64_t block(std::size_t block) const;
+};
+
+/// <summary>
+/// The difference of a single cell between two worksheets.
+/// </summary>
+class XLNT_API cell_difference
+{
+public:
+    /// <summary>
+    /// The reference of the cell.
+    /// </summary>
+    cell_reference reference;
+
+    /// <summary>
+    /// True if the cell only exists in the other worksheet.
+    /// </summary>
+    bool added = false;
+
+    /// <summary>
+    /// True if the cell only exists in this worksheet.
+    /// </summary>
+    bool removed = false;
+
+    /// <summary>
+    /// True if the type, value or formula of the cell differs.
+    /// </summary>
+    bool value_changed = false;
+
+    /// <summary>
+    /// True if the format of the cell differs.
+    /// </summary>
+    bool format_changed = false;
+
+    /// <summary>
+    /// True if the hyperlink, comment, merge state or phonetics visibility of the cell differs.
+    /// </summary>
+    bool annotation_changed = false;
+};
+
+/// <summary>
+/// The differences between two worksheets as returned by worksheet::diff.
+/// </summary>
+class XLNT_API worksheet_diff
+{
+public:
+    /// <summary>
+    /// The title of the compared worksheet.
+    /// </summary>
+    std::string title;
+
+    /// <summary>
+    /// True if the worksheet only exists in the other workbook.
+    /// </summary>
+    bool added = false;
+
+    /// <summary>
+    /// True if the worksheet only exists in this workbook.
+    /// </summary>
+    bool removed = false;
+
+    /// <summary>
+    /// True if sheet-level metadata differs, e.g. row and column properties, merged
+    /// cells, views, page setup, print settings or the sheet title.
+    /// </summary>
+    bool properties_changed = false;
+
+    /// <summary>
+    /// Every row containing at least one changed cell in ascending order.
+    /// </summary>
+    std::vector<row_t> changed_rows;
+
+    /// <summary>
+    /// Every changed cell in row-major order.
+    /// </summary>
+    std::vector<cell_difference> changed_cells;
+
+    /// <summary>
+    /// Returns true if no difference was found.
+    /// </summary>
+    bool empty() const;
+};
+
+} // namespace xlnt
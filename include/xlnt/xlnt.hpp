@@ -57,6 +57,7 @@
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/utils/string_view.hpp>
 #include <xlnt/utils/time.hpp>
 #include <xlnt/utils/timedelta.hpp>
 #include <xlnt/utils/variant.hpp>
@@ -64,17 +65,23 @@
 // workbook
 #include <xlnt/workbook/document_security.hpp>
 #include <xlnt/workbook/external_book.hpp>
+#include <xlnt/workbook/file_format.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
+#include <xlnt/workbook/streaming_worksheet_cursor.hpp>
+#include <xlnt/workbook/streaming_worksheet_writer.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/workbook/workbook_diff.hpp>
 #include <xlnt/workbook/worksheet_iterator.hpp>
 
 // worksheet
 #include <xlnt/worksheet/cell_iterator.hpp>
 #include <xlnt/worksheet/cell_vector.hpp>
+#include <xlnt/worksheet/column_index.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
 #include <xlnt/worksheet/major_order.hpp>
@@ -84,8 +91,12 @@
 #include <xlnt/worksheet/range.hpp>
 #include <xlnt/worksheet/range_iterator.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
+#include <xlnt/worksheet/range_statistics.hpp>
 #include <xlnt/worksheet/row_properties.hpp>
+#include <xlnt/worksheet/row_view.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/sheet_protection.hpp>
 #include <xlnt/worksheet/sheet_view.hpp>
+#include <xlnt/worksheet/sort_key.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
+#include <xlnt/worksheet/worksheet_diff.hpp>
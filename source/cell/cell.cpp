@@ -47,6 +47,7 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/time.hpp>
 #include <xlnt/utils/timedelta.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/phonetic_pr.hpp>
@@ -194,6 +195,10 @@ std::string cell::check_string(const std::string &to_check)
 cell::cell(detail::cell_impl *d)
     : d_(d)
 {
+    if (d_ != nullptr && d_->parent_ != nullptr && d_->parent_->pager_)
+    {
+        pin_ = d_->parent_->pager_->pin(d_->row_);
+    }
 }
 
 bool cell::garbage_collectible() const
@@ -257,6 +262,14 @@ void cell::value(const rich_text &text)
 {
     check_string(text.plain_text());
 
+    // inline columns keep their strings out of the shared string table entirely
+    if (worksheet().column_string_storage(d_->column_) == string_storage::inline_string)
+    {
+        d_->type_ = type::inline_string;
+        d_->value_text_ = text;
+        return;
+    }
+
     d_->type_ = type::shared_string;
     d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
 }
@@ -272,8 +285,20 @@ void cell::value(const cell c)
     d_->value_numeric_ = c.d_->value_numeric_;
     d_->value_text_ = c.d_->value_text_;
     d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
     d_->format_ = c.d_->format_;
+
+    if (d_->formula_.is_set() == c.d_->formula_.is_set())
+    {
+        d_->formula_ = c.d_->formula_;
+    }
+    else if (c.d_->formula_.is_set())
+    {
+        formula(c.d_->formula_.get());
+    }
+    else
+    {
+        clear_formula();
+    }
 }
 
 void cell::value(const date &d)
@@ -377,26 +402,25 @@ void cell::hyperlink(const std::string &url, const std::string &display)
 
     auto ws = worksheet();
     auto &manifest = ws.workbook().manifest();
+    const auto ws_path = ws.path();
+    const auto target = uri(url);
 
     d_->hyperlink_ = detail::hyperlink_impl();
 
-    // check for existing relationships
-    auto relationships = manifest.relationships(ws.path(), relationship_type::hyperlink);
-    auto relation = std::find_if(relationships.cbegin(), relationships.cend(),
-        [&url](xlnt::relationship rel) { return rel.target().path().string() == url; });
-    if (relation != relationships.end())
+    // reuse an existing relationship to the same target
+    if (manifest.has_relationship(ws_path, relationship_type::hyperlink, target))
     {
-        d_->hyperlink_.get().relationship = *relation;
+        d_->hyperlink_.get().relationship = manifest.relationship(ws_path, relationship_type::hyperlink, target);
     }
     else
     { // register a new relationship
         auto rel_id = manifest.register_relationship(
-            uri(ws.path().string()),
+            uri(ws_path.string()),
             relationship_type::hyperlink,
-            uri(url),
+            target,
             target_mode::external);
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
-        d_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
+        d_->hyperlink_.get().relationship = manifest.relationship(ws_path, rel_id);
     }
     // if a value is already present, the display string is ignored
     if (has_value())
@@ -458,6 +482,12 @@ void cell::formula(const std::string &formula)
         return clear_formula();
     }
 
+    // only the first formula on a sheet needs to check the manifest
+    if (!d_->formula_.is_set() && d_->parent_->formula_count_++ == 0)
+    {
+        worksheet().register_calc_chain_in_manifest();
+    }
+
     if (formula[0] == '=')
     {
         d_->formula_ = formula.substr(1);
@@ -466,8 +496,6 @@ void cell::formula(const std::string &formula)
     {
         d_->formula_ = formula;
     }
-
-    worksheet().register_calc_chain_in_manifest();
 }
 
 bool cell::has_formula() const
@@ -485,7 +513,7 @@ void cell::clear_formula()
     if (has_formula())
     {
         d_->formula_.clear();
-        worksheet().garbage_collect_formulae();
+        --d_->parent_->formula_count_;
     }
 }
 
@@ -990,6 +1018,8 @@ void cell::comment(const std::string &text, const class font &comment_font, cons
 
 void cell::comment(const class comment &new_comment)
 {
+    const auto first_comment = d_->parent_->comments_.empty();
+
     if (has_comment())
     {
         *d_->comment_.get() = new_comment;
@@ -1007,7 +1037,10 @@ void cell::comment(const class comment &new_comment)
 
     d_->comment_.get()->position(cell_position.first, cell_position.second);
 
-    worksheet().register_comments_in_manifest();
+    if (first_comment)
+    {
+        worksheet().register_comments_in_manifest();
+    }
 }
 
 double cell::width() const
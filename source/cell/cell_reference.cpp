@@ -22,6 +22,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cctype>
 
 #include <xlnt/cell/cell_reference.hpp>
@@ -52,10 +53,7 @@ cell_reference::cell_reference()
 
 cell_reference::cell_reference(const std::string &string)
 {
-    auto split = split_reference(string, absolute_column_, absolute_row_);
-
-    column(split.first);
-    row(split.second);
+    *this = from_chars(string.data(), string.data() + string.size());
 }
 
 cell_reference::cell_reference(const char *reference_string)
@@ -82,23 +80,102 @@ range_reference cell_reference::operator,(const xlnt::cell_reference &other) con
 
 std::string cell_reference::to_string() const
 {
-    std::string string_representation;
+    char buffer[max_string_length];
+    return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)));
+}
+
+const std::size_t cell_reference::max_string_length;
+
+char *cell_reference::to_chars(char *first, char *last) const
+{
+    // Written to a local buffer first so the destination is only touched when it fits
+    char buffer[max_string_length];
+    auto end = buffer;
 
     if (absolute_column_)
     {
-        string_representation.append("$");
+        *end++ = '$';
     }
 
-    string_representation.append(column_.column_string());
+    end = column_t::to_chars(column_.index, end, buffer + sizeof(buffer));
 
     if (absolute_row_)
     {
-        string_representation.append("$");
+        *end++ = '$';
+    }
+
+    char digits[10];
+    auto digit = digits + sizeof(digits);
+    auto remaining = row_;
+
+    do
+    {
+        *--digit = static_cast<char>('0' + remaining % 10);
+        remaining /= 10;
+    } while (remaining > 0);
+
+    end = std::copy(digit, digits + sizeof(digits), end);
+
+    const auto length = static_cast<std::size_t>(end - buffer);
+
+    if (static_cast<std::size_t>(last - first) < length)
+    {
+        throw invalid_parameter();
+    }
+
+    return std::copy(buffer, end, first);
+}
+
+cell_reference cell_reference::from_chars(const char *first, const char *last)
+{
+    auto malformed = [first, last]() { return invalid_cell_reference(std::string(first, last)); };
+    auto is_letter = [](char c) { return static_cast<unsigned int>(static_cast<unsigned char>(c) & ~0x20u) - 'A' < 26; };
+    auto is_digit = [](char c) { return static_cast<unsigned int>(static_cast<unsigned char>(c)) - '0' < 10; };
+
+    cell_reference result;
+    auto current = first;
+
+    result.absolute_column_ = current != last && *current == '$';
+    if (result.absolute_column_) ++current;
+
+    const auto column_first = current;
+    while (current != last && is_letter(*current)) ++current;
+
+    if (current == column_first)
+    {
+        throw malformed();
+    }
+
+    result.column_.index = column_t::column_index_from_chars(column_first, current);
+
+    result.absolute_row_ = current != last && *current == '$';
+    if (result.absolute_row_) ++current;
+
+    if (current == last)
+    {
+        throw malformed();
+    }
+
+    std::uint64_t row = 0;
+
+    for (; current != last; ++current)
+    {
+        if (!is_digit(*current))
+        {
+            throw malformed();
+        }
+
+        row = row * 10 + static_cast<std::uint64_t>(*current - '0');
+
+        if (row > constants::max_row())
+        {
+            throw malformed();
+        }
     }
 
-    string_representation.append(std::to_string(row_));
+    result.row_ = static_cast<row_t>(row);
 
-    return string_representation;
+    return result;
 }
 
 range_reference cell_reference::to_range() const
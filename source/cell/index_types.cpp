@@ -21,35 +21,89 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <array>
 #include <cctype>
 
 #include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/exceptions.hpp>
 #include <detail/constants.hpp>
 
+namespace {
+
+// Number of columns with one, two or three letters (A to ZZZ)
+const xlnt::column_t::index_t table_columns = 26 + 26 * 26 + 26 * 26 * 26;
+
+// Letters of every column from A to ZZZ, left-aligned in four bytes with the
+// letter count in the last byte so that encoding is a single table lookup
+struct column_letter_table
+{
+    column_letter_table()
+    {
+        for (xlnt::column_t::index_t index = 1; index <= table_columns; ++index)
+        {
+            auto &entry = letters[index];
+            auto remaining = index;
+            char reversed[3];
+            std::size_t length = 0;
+
+            while (remaining > 0)
+            {
+                const auto remainder = (remaining - 1) % 26;
+                reversed[length++] = static_cast<char>('A' + remainder);
+                remaining = (remaining - 1) / 26;
+            }
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                entry[i] = reversed[length - i - 1];
+            }
+
+            entry[3] = static_cast<char>(length);
+        }
+    }
+
+    std::array<std::array<char, 4>, table_columns + 1> letters;
+};
+
+const column_letter_table &letter_table()
+{
+    static const column_letter_table table;
+    return table;
+}
+
+} // namespace
+
 namespace xlnt {
 
+const std::size_t column_t::max_string_length;
+
 column_t::index_t column_t::column_index_from_string(const std::string &column_string)
 {
-    if (column_string.length() > 3 || column_string.empty())
+    return column_index_from_chars(column_string.data(), column_string.data() + column_string.size());
+}
+
+column_t::index_t column_t::column_index_from_chars(const char *first, const char *last)
+{
+    const auto length = last - first;
+
+    if (length > 3 || length < 1)
     {
         throw invalid_column_index();
     }
 
     column_t::index_t column_index = 0;
-    int place = 1;
 
-    for (int i = static_cast<int>(column_string.length()) - 1; i >= 0; i--)
+    for (; first != last; ++first)
     {
-        if (!std::isalpha(column_string[static_cast<std::size_t>(i)]))
+        // folding to upper case first leaves a single range check
+        const auto letter = static_cast<unsigned int>(static_cast<unsigned char>(*first) & ~0x20u) - 'A';
+
+        if (letter >= 26)
         {
             throw invalid_column_index();
         }
 
-        auto char_index = std::toupper(column_string[static_cast<std::size_t>(i)]) - 'A';
-
-        column_index += static_cast<column_t::index_t>((char_index + 1) * place);
-        place *= 26;
+        column_index = column_index * 26 + letter + 1;
     }
 
     return column_index;
@@ -60,6 +114,12 @@ column_t::index_t column_t::column_index_from_string(const std::string &column_s
 // order.These numbers are 1 - based, and can be converted to ASCII
 // ordinals by adding 64.
 std::string column_t::column_string_from_index(column_t::index_t column_index)
+{
+    char buffer[max_string_length];
+    return std::string(buffer, to_chars(column_index, buffer, buffer + sizeof(buffer)));
+}
+
+char *column_t::to_chars(column_t::index_t column_index, char *first, char *last)
 {
     // these indicies corrospond to A->ZZZ and include all allowed
     // columns
@@ -68,25 +128,37 @@ std::string column_t::column_string_from_index(column_t::index_t column_index)
         throw invalid_column_index();
     }
 
-    int temp = static_cast<int>(column_index);
-    std::string column_letter = "";
-
-    while (temp > 0)
+    if (column_index <= table_columns)
     {
-        int quotient = temp / 26, remainder = temp % 26;
+        const auto &entry = letter_table().letters[column_index];
+        const auto length = static_cast<std::size_t>(entry[3]);
 
-        // check for exact division and borrow if needed
-        if (remainder == 0)
+        if (static_cast<std::size_t>(last - first) < length)
         {
-            quotient -= 1;
-            remainder = 26;
+            throw invalid_parameter();
         }
 
-        column_letter = std::string(1, char(remainder + 64)) + column_letter;
-        temp = quotient;
+        std::copy(entry.begin(), entry.begin() + static_cast<std::ptrdiff_t>(length), first);
+
+        return first + length;
+    }
+
+    // Columns past ZZZ can't be parsed back but are still encoded for completeness
+    char reversed[max_string_length];
+    std::size_t length = 0;
+
+    while (column_index > 0)
+    {
+        reversed[length++] = static_cast<char>('A' + (column_index - 1) % 26);
+        column_index = (column_index - 1) / 26;
+    }
+
+    if (static_cast<std::size_t>(last - first) < length)
+    {
+        throw invalid_parameter();
     }
 
-    return column_letter;
+    return std::reverse_copy(reversed, reversed + length, first);
 }
 
 column_t::column_t()
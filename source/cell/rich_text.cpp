@@ -23,6 +23,8 @@
 // @author: see AUTHORS file
 #include <numeric>
 
+#include <detail/implementations/font_pool.hpp>
+#include <detail/implementations/rich_text_access.hpp>
 #include <xlnt/cell/rich_text.hpp>
 #include <xlnt/cell/rich_text_run.hpp>
 
@@ -31,12 +33,19 @@ bool has_trailing_whitespace(const std::string &s)
 {
     return !s.empty() && (s.front() == ' ' || s.back() == ' ');
 };
+
+bool same_font(const xlnt::font *a, const xlnt::font *b)
+{
+    return a == b || (a != nullptr && b != nullptr && *a == *b);
+}
 } // namespace
 
 namespace xlnt {
 
 rich_text::rich_text(const std::string &plain_text)
-    : rich_text(rich_text_run{plain_text, optional<font>(), has_trailing_whitespace(plain_text)})
+    : plain_text_(plain_text),
+      storage_(storage::plain),
+      plain_preserve_space_(has_trailing_whitespace(plain_text))
 {
 }
 
@@ -52,10 +61,12 @@ rich_text::rich_text(const rich_text &other)
 
 rich_text &rich_text::operator=(const rich_text &rhs)
 {
-    clear();
+    plain_text_ = rhs.plain_text_;
     runs_ = rhs.runs_;
     phonetic_runs_ = rhs.phonetic_runs_;
     phonetic_properties_ = rhs.phonetic_properties_;
+    storage_ = rhs.storage_;
+    plain_preserve_space_ = rhs.plain_preserve_space_;
     return *this;
 }
 
@@ -66,41 +77,95 @@ rich_text::rich_text(const rich_text_run &single_run)
 
 void rich_text::clear()
 {
+    plain_text_.clear();
     runs_.clear();
     phonetic_runs_.clear();
     phonetic_properties_.clear();
+    storage_ = storage::empty;
+    plain_preserve_space_ = false;
 }
 
 void rich_text::plain_text(const std::string &s, bool preserve_space = false)
 {
     clear();
-    add_run(rich_text_run{s, {}, preserve_space});
+    plain_text_ = s;
+    storage_ = storage::plain;
+    plain_preserve_space_ = preserve_space;
 }
 
 std::string rich_text::plain_text() const
 {
+    if (storage_ != storage::runs)
+    {
+        return plain_text_;
+    }
+
     if (runs_.size() == 1)
     {
-        return runs_.begin()->first;
+        return runs_.front().text;
     }
 
     return std::accumulate(runs_.begin(), runs_.end(), std::string(),
-        [](const std::string &a, const rich_text_run &run) { return a + run.first; });
+        [](const std::string &a, const run_impl &run) { return a + run.text; });
 }
 
 std::vector<rich_text_run> rich_text::runs() const
 {
-    return runs_;
+    std::vector<rich_text_run> result;
+
+    for_each_run([&result](const std::string &text, const font *text_font, bool preserve_space) {
+        result.push_back(rich_text_run{text,
+            text_font == nullptr ? optional<font>() : optional<font>(*text_font),
+            preserve_space});
+    });
+
+    return result;
 }
 
 void rich_text::runs(const std::vector<rich_text_run> &new_runs)
 {
-    runs_ = new_runs;
+    plain_text_.clear();
+    runs_.clear();
+    storage_ = storage::empty;
+
+    for (const auto &run : new_runs)
+    {
+        add_run(run);
+    }
 }
 
 void rich_text::add_run(const rich_text_run &t)
 {
-    runs_.push_back(t);
+    add_run(t.first, t.second.is_set() ? std::make_shared<const font>(t.second.get()) : nullptr, t.preserve_space);
+}
+
+void rich_text::add_run(const std::string &text, std::shared_ptr<const font> text_font, bool preserve_space)
+{
+    if (storage_ == storage::empty && text_font == nullptr)
+    {
+        plain_text_ = text;
+        plain_preserve_space_ = preserve_space;
+        storage_ = storage::plain;
+
+        return;
+    }
+
+    if (storage_ == storage::plain)
+    {
+        runs_.push_back(run_impl{std::move(plain_text_), nullptr, plain_preserve_space_});
+        plain_text_.clear();
+    }
+
+    runs_.push_back(run_impl{text, std::move(text_font), preserve_space});
+    storage_ = storage::runs;
+}
+
+void rich_text::intern_fonts(detail::font_pool &pool)
+{
+    for (auto &run : runs_)
+    {
+        run.text_font = pool.intern(run.text_font);
+    }
 }
 
 std::vector<phonetic_run> rich_text::phonetic_runs() const
@@ -135,11 +200,21 @@ void rich_text::phonetic_properties(const phonetic_pr &phonetic_props)
 
 bool rich_text::operator==(const rich_text &rhs) const
 {
-    if (runs_.size() != rhs.runs_.size()) return false;
+    if (storage_ != rhs.storage_) return false;
 
-    for (std::size_t i = 0; i < runs_.size(); i++)
+    if (storage_ == storage::plain)
+    {
+        if (plain_text_ != rhs.plain_text_) return false;
+    }
+    else
     {
-        if (runs_[i] != rhs.runs_[i]) return false;
+        if (runs_.size() != rhs.runs_.size()) return false;
+
+        for (std::size_t i = 0; i < runs_.size(); i++)
+        {
+            if (runs_[i].text != rhs.runs_[i].text) return false;
+            if (!same_font(runs_[i].text_font.get(), rhs.runs_[i].text_font.get())) return false;
+        }
     }
 
     if (phonetic_runs_.size() != rhs.phonetic_runs_.size()) return false;
@@ -156,7 +231,10 @@ bool rich_text::operator==(const rich_text &rhs) const
 
 bool rich_text::operator==(const std::string &rhs) const
 {
-    return *this == rich_text(rhs);
+    return storage_ == storage::plain
+        && plain_text_ == rhs
+        && phonetic_runs_.empty()
+        && !phonetic_properties_.is_set();
 }
 
 bool rich_text::operator!=(const rich_text &rhs) const
@@ -169,4 +247,22 @@ bool rich_text::operator!=(const std::string &rhs) const
     return !(*this == rhs);
 }
 
+std::size_t rich_text_hash::operator()(const rich_text &k) const
+{
+    static const std::hash<std::string> hasher;
+
+    if (detail::rich_text_access::is_empty(k) || detail::rich_text_access::is_plain(k))
+    {
+        return hasher(detail::rich_text_access::plain_text(k));
+    }
+
+    std::size_t res = 0;
+
+    detail::rich_text_access::for_each_run(k, [&res](const std::string &text, const font *, bool) {
+        res ^= hasher(text) + 0x9e3779b9 + (res << 6) + (res >> 2);
+    });
+
+    return res;
+}
+
 } // namespace xlnt
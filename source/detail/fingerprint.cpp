@@ -0,0 +1,491 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <vector>
+
+#include <xlnt/cell/comment.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <detail/fingerprint.hpp>
+#include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+#include <detail/parallel.hpp>
+
+namespace {
+
+using xlnt::detail::hash_bytes;
+using xlnt::detail::hash_double;
+using xlnt::detail::mix_hash;
+
+// Blocks smaller than this aren't worth a thread of their own
+const std::size_t fingerprint_min_block_size = 65536;
+
+const xlnt::rich_text *cell_text(const xlnt::detail::cell_impl &cell, const std::vector<xlnt::rich_text> &shared_strings)
+{
+    switch (cell.type_)
+    {
+    case xlnt::cell_type::shared_string:
+        return &shared_strings.at(static_cast<std::size_t>(cell.value_numeric_));
+    case xlnt::cell_type::inline_string:
+    case xlnt::cell_type::formula_string:
+    case xlnt::cell_type::error:
+        return &cell.value_text_;
+    case xlnt::cell_type::empty:
+    case xlnt::cell_type::boolean:
+    case xlnt::cell_type::date:
+    case xlnt::cell_type::number:
+        break;
+    }
+
+    return nullptr;
+}
+
+std::uint64_t hash_text(const xlnt::rich_text &text)
+{
+    auto hash = hash_bytes(std::string());
+
+    for (const auto &run : text.runs())
+    {
+        hash = hash_bytes(run.first, hash) ^ 0x1fULL;
+    }
+
+    return mix_hash(hash);
+}
+
+// Hashes everything a cell holds except its row which is implied by the row fingerprint.
+// Shared string hashes are memoised by index in string_hashes since most sheets repeat them.
+std::uint64_t fingerprint_cell(const xlnt::detail::cell_impl &cell, const std::vector<xlnt::rich_text> &shared_strings,
+    std::vector<std::uint64_t> &string_hashes)
+{
+    auto hash = mix_hash((static_cast<std::uint64_t>(cell.column_.index) << 8) | static_cast<std::uint64_t>(cell.type_));
+
+    if (cell.type_ == xlnt::cell_type::shared_string)
+    {
+        const auto index = static_cast<std::size_t>(cell.value_numeric_);
+        auto &text_hash = string_hashes.at(index);
+
+        if (text_hash == 0)
+        {
+            text_hash = hash_text(shared_strings[index]) | 1;
+        }
+
+        hash = mix_hash(hash ^ text_hash);
+    }
+    else
+    {
+        auto text = cell_text(cell, shared_strings);
+        hash = mix_hash(hash ^ (text != nullptr ? hash_text(*text) : hash_double(cell.value_numeric_)));
+    }
+
+    hash = mix_hash(hash ^ static_cast<std::uint64_t>((cell.is_merged_ ? 1 : 0) | (cell.phonetics_visible_ ? 2 : 0)));
+
+    if (cell.formula_.is_set())
+    {
+        hash = mix_hash(hash ^ hash_bytes(cell.formula_.get()) ^ 0x2ULL);
+    }
+
+    if (cell.format_.is_set())
+    {
+        hash = mix_hash(hash ^ static_cast<std::uint64_t>(cell.format_.get()->id) ^ 0x3ULL);
+    }
+
+    if (cell.hyperlink_.is_set())
+    {
+        const auto &link = cell.hyperlink_.get();
+        auto link_hash = hash_bytes(link.relationship.target().path().string());
+        link_hash = hash_bytes(link.display.is_set() ? link.display.get() : std::string(), link_hash);
+        link_hash = hash_bytes(link.tooltip.is_set() ? link.tooltip.get() : std::string(), link_hash);
+        hash = mix_hash(hash ^ link_hash ^ 0x4ULL);
+    }
+
+    if (cell.comment_.is_set())
+    {
+        const auto &comment = *cell.comment_.get();
+        hash = mix_hash(hash ^ hash_text(comment.text()) ^ hash_bytes(comment.author()) ^ 0x5ULL);
+    }
+
+    return hash;
+}
+
+bool same_format_fields(const xlnt::detail::format_impl &lhs, const xlnt::detail::format_impl &rhs)
+{
+    return lhs.alignment_id == rhs.alignment_id
+        && lhs.alignment_applied == rhs.alignment_applied
+        && lhs.border_id == rhs.border_id
+        && lhs.border_applied == rhs.border_applied
+        && lhs.fill_id == rhs.fill_id
+        && lhs.fill_applied == rhs.fill_applied
+        && lhs.font_id == rhs.font_id
+        && lhs.font_applied == rhs.font_applied
+        && lhs.number_format_id == rhs.number_format_id
+        && lhs.number_format_applied == rhs.number_format_applied
+        && lhs.protection_id == rhs.protection_id
+        && lhs.protection_applied == rhs.protection_applied
+        && lhs.pivot_button_ == rhs.pivot_button_
+        && lhs.quote_prefix_ == rhs.quote_prefix_
+        && lhs.style == rhs.style;
+}
+
+template <typename T>
+bool same_component(const xlnt::optional<std::size_t> &lhs_id, const std::vector<T> &lhs_values,
+    const xlnt::optional<std::size_t> &rhs_id, const std::vector<T> &rhs_values)
+{
+    if (lhs_id.is_set() != rhs_id.is_set()) return false;
+    if (!lhs_id.is_set()) return true;
+
+    return lhs_values.at(lhs_id.get()) == rhs_values.at(rhs_id.get());
+}
+
+bool same_number_format(const xlnt::detail::format_impl &lhs, const xlnt::detail::format_impl &rhs)
+{
+    if (lhs.number_format_id.is_set() != rhs.number_format_id.is_set()) return false;
+    if (!lhs.number_format_id.is_set()) return true;
+
+    // Built-in formats aren't stored in the stylesheet, so compare their ids directly
+    auto find = [](const xlnt::detail::format_impl &format) -> const xlnt::number_format * {
+        for (const auto &number_format : format.parent->number_formats)
+        {
+            if (number_format.id() == format.number_format_id.get()) return &number_format;
+        }
+        return nullptr;
+    };
+
+    auto lhs_format = find(lhs);
+    auto rhs_format = find(rhs);
+
+    if (lhs_format == nullptr || rhs_format == nullptr)
+    {
+        return lhs_format == rhs_format && lhs.number_format_id == rhs.number_format_id;
+    }
+
+    return lhs_format->format_string() == rhs_format->format_string();
+}
+
+// Compares the formats of two cells by the properties they resolve to
+bool same_format(const xlnt::optional<xlnt::detail::format_impl *> &lhs,
+    const xlnt::optional<xlnt::detail::format_impl *> &rhs, bool same_styles)
+{
+    if (lhs.is_set() != rhs.is_set()) return false;
+    if (!lhs.is_set()) return true;
+
+    const auto &l = *lhs.get();
+    const auto &r = *rhs.get();
+
+    if (same_styles) return l.id == r.id;
+
+    return l.alignment_applied == r.alignment_applied
+        && l.border_applied == r.border_applied
+        && l.fill_applied == r.fill_applied
+        && l.font_applied == r.font_applied
+        && l.number_format_applied == r.number_format_applied
+        && l.protection_applied == r.protection_applied
+        && l.pivot_button_ == r.pivot_button_
+        && l.quote_prefix_ == r.quote_prefix_
+        && l.style == r.style
+        && same_component(l.alignment_id, l.parent->alignments, r.alignment_id, r.parent->alignments)
+        && same_component(l.border_id, l.parent->borders, r.border_id, r.parent->borders)
+        && same_component(l.fill_id, l.parent->fills, r.fill_id, r.parent->fills)
+        && same_component(l.font_id, l.parent->fonts, r.font_id, r.parent->fonts)
+        && same_component(l.protection_id, l.parent->protections, r.protection_id, r.parent->protections)
+        && same_number_format(l, r);
+}
+
+bool same_value(const xlnt::detail::cell_impl &lhs, const std::vector<xlnt::rich_text> &lhs_strings,
+    const xlnt::detail::cell_impl &rhs, const std::vector<xlnt::rich_text> &rhs_strings)
+{
+    if (lhs.type_ != rhs.type_ || lhs.formula_ != rhs.formula_) return false;
+
+    auto lhs_text = cell_text(lhs, lhs_strings);
+    auto rhs_text = cell_text(rhs, rhs_strings);
+
+    if (lhs_text != nullptr)
+    {
+        return *lhs_text == *rhs_text;
+    }
+
+    return xlnt::detail::float_equals(lhs.value_numeric_, rhs.value_numeric_);
+}
+
+bool same_annotations(const xlnt::detail::cell_impl &lhs, const xlnt::detail::cell_impl &rhs)
+{
+    return lhs.is_merged_ == rhs.is_merged_
+        && lhs.phonetics_visible_ == rhs.phonetics_visible_
+        && lhs.hyperlink_ == rhs.hyperlink_
+        && lhs.comment_.is_set() == rhs.comment_.is_set()
+        && (!lhs.comment_.is_set() || *lhs.comment_.get() == *rhs.comment_.get());
+}
+
+bool same_properties(const xlnt::detail::worksheet_impl &lhs, const xlnt::detail::worksheet_impl &rhs)
+{
+    return lhs.title_ == rhs.title_
+        && lhs.format_properties_ == rhs.format_properties_
+        && lhs.column_properties_ == rhs.column_properties_
+        && lhs.row_properties_ == rhs.row_properties_
+        && lhs.page_setup_ == rhs.page_setup_
+        && lhs.auto_filter_ == rhs.auto_filter_
+        && lhs.page_margins_ == rhs.page_margins_
+        && lhs.merged_cells_ == rhs.merged_cells_
+        && lhs.named_ranges_ == rhs.named_ranges_
+        && lhs.phonetic_properties_ == rhs.phonetic_properties_
+        && lhs.header_footer_ == rhs.header_footer_
+        && lhs.print_title_cols_ == rhs.print_title_cols_
+        && lhs.print_title_rows_ == rhs.print_title_rows_
+        && lhs.print_area_ == rhs.print_area_
+        && lhs.views_ == rhs.views_
+        && lhs.column_breaks_ == rhs.column_breaks_
+        && lhs.row_breaks_ == rhs.row_breaks_
+        && lhs.print_options_ == rhs.print_options_
+        && lhs.sheet_properties_ == rhs.sheet_properties_
+        && lhs.extension_list_ == rhs.extension_list_;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+worksheet_fingerprint fingerprint_worksheet(const worksheet_impl &ws, bool parallel)
+{
+    const auto &cells = ws.cell_map_;
+    const auto &shared_strings = ws.parent_->shared_strings();
+    const auto blocks = parallel ? parallel_block_count(cells.size(), fingerprint_min_block_size) : std::size_t(1);
+
+    struct partial
+    {
+        std::vector<std::uint64_t> rows;
+        std::vector<std::uint64_t> string_hashes;
+        column_t::index_t highest_column = 0;
+    };
+
+    std::vector<partial> partials(blocks);
+
+    parallel_for_blocks(cells.bucket_count(), blocks, [&](std::size_t block, std::size_t first, std::size_t last) {
+        auto &result = partials[block];
+        result.string_hashes.assign(shared_strings.size(), 0);
+
+        auto add_cell = [&](const std::pair<const cell_reference, cell_impl> &entry) {
+            const auto row = static_cast<std::size_t>(entry.first.row());
+
+            if (row >= result.rows.size())
+            {
+                result.rows.resize(std::max(row + 1, result.rows.size() * 2), 0);
+            }
+
+            // Summing makes the row fingerprint independent of the order cells are visited in
+            result.rows[row] += mix_hash(fingerprint_cell(entry.second, shared_strings, result.string_hashes));
+            result.highest_column = std::max(result.highest_column, entry.first.column_index());
+        };
+
+        if (blocks == 1)
+        {
+            // Following the node list is cheaper than visiting every bucket in turn
+            std::for_each(cells.begin(), cells.end(), add_cell);
+            return;
+        }
+
+        for (auto bucket = first; bucket < last; ++bucket)
+        {
+            std::for_each(cells.begin(bucket), cells.end(bucket), add_cell);
+        }
+    });
+
+    worksheet_fingerprint result;
+    std::size_t highest_row = 0;
+
+    for (const auto &p : partials)
+    {
+        for (auto row = p.rows.size(); row > highest_row; --row)
+        {
+            if (p.rows[row - 1] != 0)
+            {
+                highest_row = row - 1;
+                break;
+            }
+        }
+
+        result.highest_column = std::max(result.highest_column, p.highest_column);
+    }
+
+    result.rows.assign(highest_row + 1, 0);
+
+    for (const auto &p : partials)
+    {
+        const auto last = std::min(p.rows.size(), result.rows.size());
+
+        for (auto row = std::size_t(0); row < last; ++row)
+        {
+            result.rows[row] += p.rows[row];
+        }
+    }
+
+    const auto block_count = (static_cast<std::size_t>(highest_row) + worksheet_fingerprint::rows_per_block - 1)
+        / worksheet_fingerprint::rows_per_block;
+    result.blocks.assign(block_count, 0);
+
+    for (auto block = std::size_t(0); block < block_count; ++block)
+    {
+        auto hash = std::uint64_t(0);
+        const auto first = block * worksheet_fingerprint::rows_per_block + 1;
+        const auto last = std::min(result.rows.size(), first + worksheet_fingerprint::rows_per_block);
+
+        for (auto row = first; row < last; ++row)
+        {
+            hash = mix_hash(hash ^ result.rows[row]) + row;
+        }
+
+        result.blocks[block] = hash;
+    }
+
+    return result;
+}
+
+bool styles_equivalent(const optional<stylesheet> &lhs_styles, const optional<stylesheet> &rhs_styles)
+{
+    if (lhs_styles.is_set() != rhs_styles.is_set()) return false;
+    if (!lhs_styles.is_set()) return true;
+
+    const auto &lhs = lhs_styles.get();
+    const auto &rhs = rhs_styles.get();
+
+    if (lhs.format_impls.size() != rhs.format_impls.size()) return false;
+
+    auto rhs_format = rhs.format_impls.begin();
+
+    for (const auto &lhs_format : lhs.format_impls)
+    {
+        if (!same_format_fields(lhs_format, *rhs_format++)) return false;
+    }
+
+    return lhs.conditional_format_impls == rhs.conditional_format_impls
+        && lhs.style_impls == rhs.style_impls
+        && lhs.style_names == rhs.style_names
+        && lhs.alignments == rhs.alignments
+        && lhs.borders == rhs.borders
+        && lhs.fills == rhs.fills
+        && lhs.fonts == rhs.fonts
+        && lhs.number_formats == rhs.number_formats
+        && lhs.protections == rhs.protections
+        && lhs.colors == rhs.colors;
+}
+
+worksheet_diff diff_worksheets(const worksheet_impl &lhs, const worksheet_impl &rhs, bool same_styles, bool parallel)
+{
+    return diff_worksheets(lhs, rhs, fingerprint_worksheet(lhs, parallel), fingerprint_worksheet(rhs, parallel),
+        same_styles, parallel);
+}
+
+worksheet_diff diff_worksheets(const worksheet_impl &lhs, const worksheet_impl &rhs,
+    const worksheet_fingerprint &lhs_fingerprint, const worksheet_fingerprint &rhs_fingerprint,
+    bool same_styles, bool parallel)
+{
+    const auto &lhs_strings = lhs.parent_->shared_strings();
+    const auto &rhs_strings = rhs.parent_->shared_strings();
+
+    worksheet_diff result;
+    result.title = lhs.title_;
+    result.properties_changed = !same_properties(lhs, rhs);
+
+    const auto width = std::max(lhs_fingerprint.highest_column, rhs_fingerprint.highest_column);
+    const auto block_count = std::max(lhs_fingerprint.blocks.size(), rhs_fingerprint.blocks.size());
+
+    // Only blocks whose fingerprints differ are visited, and within them only differing rows
+    std::vector<std::size_t> changed_blocks;
+
+    for (auto block = std::size_t(0); block < block_count; ++block)
+    {
+        if (!same_styles || lhs_fingerprint.block(block) != rhs_fingerprint.block(block))
+        {
+            changed_blocks.push_back(block);
+        }
+    }
+
+    const auto threads = parallel ? parallel_block_count(changed_blocks.size(), 16) : std::size_t(1);
+    std::vector<std::vector<cell_difference>> differences(threads);
+
+    parallel_for_blocks(changed_blocks.size(), threads, [&](std::size_t thread, std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; ++i)
+        {
+            const auto first_row = static_cast<row_t>(changed_blocks[i] * worksheet_fingerprint::rows_per_block + 1);
+            const auto last_row = first_row + worksheet_fingerprint::rows_per_block;
+
+            for (auto row = first_row; row < last_row; ++row)
+            {
+                const auto lhs_row = lhs_fingerprint.row(row);
+                const auto rhs_row = rhs_fingerprint.row(row);
+
+                if (lhs_row == 0 && rhs_row == 0) continue;
+                if (same_styles && lhs_row == rhs_row) continue;
+
+                for (column_t::index_t column = 1; column <= width; ++column)
+                {
+                    const auto reference = cell_reference(column, row);
+                    auto lhs_cell = lhs.cell_map_.find(reference);
+                    auto rhs_cell = rhs.cell_map_.find(reference);
+                    const auto in_lhs = lhs_cell != lhs.cell_map_.end();
+                    const auto in_rhs = rhs_cell != rhs.cell_map_.end();
+
+                    if (!in_lhs && !in_rhs) continue;
+
+                    cell_difference difference;
+                    difference.reference = reference;
+                    difference.added = !in_lhs;
+                    difference.removed = !in_rhs;
+
+                    if (in_lhs && in_rhs)
+                    {
+                        difference.value_changed = !same_value(lhs_cell->second, lhs_strings, rhs_cell->second, rhs_strings);
+                        difference.format_changed = !same_format(lhs_cell->second.format_, rhs_cell->second.format_, same_styles);
+                        difference.annotation_changed = !same_annotations(lhs_cell->second, rhs_cell->second);
+                    }
+
+                    if (difference.added || difference.removed || difference.value_changed
+                        || difference.format_changed || difference.annotation_changed)
+                    {
+                        differences[thread].push_back(difference);
+                    }
+                }
+            }
+        }
+    });
+
+    for (auto &thread_differences : differences)
+    {
+        for (auto &difference : thread_differences)
+        {
+            if (result.changed_rows.empty() || result.changed_rows.back() != difference.reference.row())
+            {
+                result.changed_rows.push_back(difference.reference.row());
+            }
+
+            result.changed_cells.push_back(difference);
+        }
+    }
+
+    return result;
+}
+
+} // namespace detail
+} // namespace xlnt
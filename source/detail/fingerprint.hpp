@@ -0,0 +1,106 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <xlnt/utils/optional.hpp>
+#include <xlnt/worksheet/worksheet_diff.hpp>
+
+namespace xlnt {
+namespace detail {
+
+struct stylesheet;
+struct worksheet_impl;
+
+/// <summary>
+/// Scrambles the bits of x (splitmix64 finalizer).
+/// </summary>
+inline std::uint64_t mix_hash(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/// <summary>
+/// Continues an FNV-1a hash of a byte sequence with the bytes of text.
+/// </summary>
+inline std::uint64_t hash_bytes(const std::string &text, std::uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    for (auto c : text)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/// <summary>
+/// Returns a hash of number where 0.0 and -0.0 hash alike.
+/// </summary>
+inline std::uint64_t hash_double(double number)
+{
+    if (number == 0.0) number = 0.0;
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &number, sizeof(bits));
+
+    return mix_hash(bits);
+}
+
+/// <summary>
+/// Computes the row and block fingerprints of every cell in ws.
+/// </summary>
+worksheet_fingerprint fingerprint_worksheet(const worksheet_impl &ws, bool parallel);
+
+/// <summary>
+/// Returns true if both stylesheets hold the same formats in the same order so that
+/// formats can be compared by position rather than by content. Two workbooks
+/// without a stylesheet are also equivalent.
+/// </summary>
+bool styles_equivalent(const optional<stylesheet> &lhs, const optional<stylesheet> &rhs);
+
+/// <summary>
+/// Compares two worksheets, skipping blocks and rows with equal fingerprints.
+/// If same_styles is false, block skipping is disabled and formats are compared by content.
+/// </summary>
+worksheet_diff diff_worksheets(const worksheet_impl &lhs, const worksheet_impl &rhs, bool same_styles, bool parallel);
+
+/// <summary>
+/// Compares two worksheets using previously computed fingerprints of each.
+/// </summary>
+worksheet_diff diff_worksheets(const worksheet_impl &lhs, const worksheet_impl &rhs,
+    const worksheet_fingerprint &lhs_fingerprint, const worksheet_fingerprint &rhs_fingerprint,
+    bool same_styles, bool parallel);
+
+} // namespace detail
+} // namespace xlnt
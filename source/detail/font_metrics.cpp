@@ -0,0 +1,229 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+
+#include <xlnt/styles/font.hpp>
+#include <detail/font_metrics.hpp>
+
+namespace {
+
+using glyph_table = std::array<unsigned short, 128>;
+
+// Widths of the printable ASCII glyphs of a Helvetica-like sans serif, from space to tilde
+const glyph_table &regular_glyphs()
+{
+    static const glyph_table table = []() {
+        const unsigned short printable[95] = {278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333,
+            278, 278, 556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556, 1015, 667, 667,
+            722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778, 667, 778, 722, 667, 611, 722, 667, 944,
+            667, 667, 611, 278, 278, 278, 469, 556, 333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222,
+            833, 556, 556, 556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584};
+        glyph_table result{};
+        std::copy(printable, printable + 95, result.begin() + 32);
+        return result;
+    }();
+
+    return table;
+}
+
+const glyph_table &bold_glyphs()
+{
+    static const glyph_table table = []() {
+        const unsigned short printable[95] = {278, 333, 474, 556, 556, 889, 722, 238, 333, 333, 389, 584, 278, 333,
+            278, 278, 556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611, 975, 722, 722,
+            722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778, 667, 778, 722, 667, 611, 722, 667, 944,
+            667, 667, 611, 333, 278, 333, 584, 556, 333, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278,
+            889, 611, 611, 611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584};
+        glyph_table result{};
+        std::copy(printable, printable + 95, result.begin() + 32);
+        return result;
+    }();
+
+    return table;
+}
+
+const glyph_table &monospace_glyphs()
+{
+    static const glyph_table table = []() {
+        glyph_table result{};
+        std::fill(result.begin() + 32, result.end() - 1, static_cast<unsigned short>(600));
+        return result;
+    }();
+
+    return table;
+}
+
+// Width of the glyphs of a family relative to the Helvetica-like tables above,
+// judged by the width of their digits
+struct family_metrics
+{
+    const glyph_table *glyphs;
+    double relative_width;
+};
+
+family_metrics metrics_for(const xlnt::font &f)
+{
+    auto name = f.has_name() ? f.name() : std::string("Calibri");
+    std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+
+    const auto contains = [&name](const char *part) { return name.find(part) != std::string::npos; };
+
+    if (contains("courier") || contains("consolas") || contains("mono") || contains("console"))
+    {
+        return {&monospace_glyphs(), 1.0};
+    }
+
+    const auto glyphs = f.bold() ? &bold_glyphs() : &regular_glyphs();
+
+    if (contains("calibri") || contains("aptos"))
+    {
+        return {glyphs, 0.912};
+    }
+
+    if (contains("times") || contains("cambria") || contains("georgia") || contains("garamond"))
+    {
+        return {glyphs, 0.9};
+    }
+
+    return {glyphs, 1.0};
+}
+
+double font_size(const xlnt::font &f)
+{
+    return f.has_size() && f.size() > 0 ? f.size() : 11.0;
+}
+
+// Width of the widest digit in thousandths of an em
+double digit_em(const family_metrics &metrics)
+{
+    return (*metrics.glyphs)['0'] * metrics.relative_width;
+}
+
+// East Asian wide and fullwidth characters take about twice the width of a digit
+bool is_wide(std::uint32_t code_point)
+{
+    return (code_point >= 0x1100 && code_point <= 0x115F)
+        || (code_point >= 0x2E80 && code_point <= 0xA4CF)
+        || (code_point >= 0xAC00 && code_point <= 0xD7A3)
+        || (code_point >= 0xF900 && code_point <= 0xFAFF)
+        || (code_point >= 0xFE30 && code_point <= 0xFE4F)
+        || (code_point >= 0xFF00 && code_point <= 0xFF60)
+        || (code_point >= 0xFFE0 && code_point <= 0xFFE6)
+        || code_point >= 0x20000;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+font_metrics::font_metrics(const font &f, const font &default_font)
+{
+    auto resolved = f;
+
+    if (!resolved.has_name() && default_font.has_name())
+    {
+        resolved.name(default_font.name());
+    }
+
+    const auto metrics = metrics_for(resolved);
+    const auto default_metrics = metrics_for(default_font);
+    const auto size = f.has_size() ? font_size(f) : font_size(default_font);
+
+    glyphs_ = metrics.glyphs;
+    scale_ = metrics.relative_width * size / (digit_em(default_metrics) * font_size(default_font));
+}
+
+double font_metrics::text_width(const std::string &text) const
+{
+    const auto &glyphs = *glyphs_;
+    auto widest = std::uint64_t(0);
+    auto line = std::uint64_t(0);
+
+    for (auto i = std::size_t(0); i < text.size(); ++i)
+    {
+        const auto byte = static_cast<unsigned char>(text[i]);
+
+        if (byte < 0x80)
+        {
+            if (byte == '\n')
+            {
+                widest = std::max(widest, line);
+                line = 0;
+            }
+
+            line += glyphs[byte];
+            continue;
+        }
+
+        // continuation bytes were accounted for with their lead byte
+        if ((byte & 0xC0) == 0x80) continue;
+
+        auto code_point = std::uint32_t(0);
+
+        if ((byte & 0xE0) == 0xC0 && i + 1 < text.size())
+        {
+            code_point = (std::uint32_t(byte & 0x1F) << 6) | (static_cast<unsigned char>(text[i + 1]) & 0x3F);
+        }
+        else if ((byte & 0xF0) == 0xE0 && i + 2 < text.size())
+        {
+            code_point = (std::uint32_t(byte & 0x0F) << 12)
+                | (std::uint32_t(static_cast<unsigned char>(text[i + 1]) & 0x3F) << 6)
+                | (static_cast<unsigned char>(text[i + 2]) & 0x3F);
+        }
+        else if ((byte & 0xF8) == 0xF0)
+        {
+            code_point = 0x10000;
+        }
+
+        if (code_point >= 0x300 && code_point <= 0x36F) continue; // combining marks
+
+        line += is_wide(code_point) ? 1000u : glyphs['0'];
+    }
+
+    return static_cast<double>(std::max(widest, line)) * scale_;
+}
+
+double font_metrics::digit_width() const
+{
+    return (*glyphs_)['0'] * scale_;
+}
+
+double font_metrics::column_padding(const font &default_font)
+{
+    // Excel pads content by five pixels, measured against the default font's digit at 96 dpi
+    const auto digit_pixels = std::max(1.0,
+        std::round(font_size(default_font) * 96.0 / 72.0 * digit_em(metrics_for(default_font)) / 1000.0));
+
+    return 5.0 / digit_pixels;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,79 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <array>
+#include <string>
+
+namespace xlnt {
+
+class font;
+
+namespace detail {
+
+/// <summary>
+/// Approximate advance widths of the glyphs of a font, used to size columns to their
+/// content without a font rasteriser. Widths are expressed in the unit of column widths,
+/// the width of the widest digit of the workbook's default font.
+/// </summary>
+class font_metrics
+{
+public:
+    /// <summary>
+    /// Returns the metrics of f in units of the widest digit of default_font.
+    /// Fonts without a name or size take them from default_font.
+    /// </summary>
+    font_metrics(const font &f, const font &default_font);
+
+    /// <summary>
+    /// Returns the width of UTF-8 encoded text, the width of its widest line if
+    /// it has line breaks.
+    /// </summary>
+    double text_width(const std::string &text) const;
+
+    /// <summary>
+    /// Returns the width of a single digit.
+    /// </summary>
+    double digit_width() const;
+
+    /// <summary>
+    /// Returns the padding, in the same unit, that Excel adds to the content of a column.
+    /// </summary>
+    static double column_padding(const font &default_font);
+
+private:
+    /// <summary>
+    /// Widths of ASCII glyphs in thousandths of an em.
+    /// </summary>
+    const std::array<unsigned short, 128> *glyphs_;
+
+    /// <summary>
+    /// Converts thousandths of an em of this font to digit widths of the default font.
+    /// </summary>
+    double scale_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,523 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/constants.hpp>
+#include <detail/implementations/cell_pager.hpp>
+#include <detail/implementations/rich_text_access.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+enum cell_flags : std::uint16_t
+{
+    merged_flag = 1,
+    phonetics_visible_flag = 2,
+    plain_text_flag = 4,
+    preserve_space_flag = 8,
+    kept_text_flag = 16,
+    formula_flag = 32,
+    format_flag = 64,
+    comment_flag = 128,
+    kept_hyperlink_flag = 256
+};
+
+template <typename T>
+void put(std::vector<std::uint8_t> &buffer, const T &value)
+{
+    const auto size = buffer.size();
+    buffer.resize(size + sizeof(T));
+    std::memcpy(buffer.data() + size, &value, sizeof(T));
+}
+
+void put_string(std::vector<std::uint8_t> &buffer, const std::string &value)
+{
+    put(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+template <typename T>
+T get(const std::uint8_t *&position)
+{
+    T value;
+    std::memcpy(&value, position, sizeof(T));
+    position += sizeof(T);
+
+    return value;
+}
+
+std::string get_string(const std::uint8_t *&position)
+{
+    const auto size = get<std::uint32_t>(position);
+    std::string value(reinterpret_cast<const char *>(position), size);
+    position += size;
+
+    return value;
+}
+
+bool seek(std::FILE *file, std::uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+std::size_t block_index(xlnt::row_t row)
+{
+    return static_cast<std::size_t>((row - 1) / xlnt::detail::cell_pager::rows_per_block);
+}
+
+const auto no_block = std::numeric_limits<std::size_t>::max();
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+cell_pager::cell_pager(std::size_t max_resident_cells)
+    : max_resident_cells_(max_resident_cells)
+{
+}
+
+cell_pager::~cell_pager()
+{
+    if (file_ != nullptr)
+    {
+        std::fclose(file_);
+    }
+}
+
+std::size_t cell_pager::max_resident_cells() const
+{
+    return max_resident_cells_;
+}
+
+void cell_pager::max_resident_cells(worksheet_impl &ws, std::size_t count)
+{
+    max_resident_cells_ = count;
+    enforce_limit(ws, no_block, no_block);
+}
+
+void cell_pager::page_in(worksheet_impl &ws, row_t first_row, row_t last_row, bool modify)
+{
+    if (blocks_.empty()) return;
+
+    const auto first = block_index(first_row);
+    const auto last = std::min(block_index(last_row), blocks_.size() - 1);
+    ++clock_;
+
+    for (auto index = first; index <= last; ++index)
+    {
+        blocks_[index].last_used = clock_;
+
+        if (!blocks_[index].resident)
+        {
+            load(ws, index);
+        }
+
+        blocks_[index].dirty = blocks_[index].dirty || modify;
+    }
+
+    enforce_limit(ws, first, last);
+}
+
+void cell_pager::page_in_all(worksheet_impl &ws)
+{
+    for (auto index = std::size_t(0); index < blocks_.size(); ++index)
+    {
+        if (!blocks_[index].resident)
+        {
+            load(ws, index);
+        }
+
+        blocks_[index].dirty = true;
+    }
+}
+
+void cell_pager::added(worksheet_impl &ws, const cell_reference &reference)
+{
+    const auto index = block_index(reference.row());
+    auto &added_to = block_of(reference.row());
+
+    if (!added_to.resident)
+    {
+        load(ws, index);
+    }
+
+    added_to.cells.push_back(reference);
+    added_to.dirty = true;
+    added_to.last_used = ++clock_;
+
+    if (ws.cell_map_.size() > max_resident_cells_)
+    {
+        enforce_limit(ws, index, index);
+    }
+}
+
+void cell_pager::record(const cell_reference &reference)
+{
+    auto &recorded = block_of(reference.row());
+    recorded.cells.push_back(reference);
+    recorded.dirty = true;
+}
+
+void cell_pager::reindex(worksheet_impl &ws)
+{
+    page_in_all(ws);
+
+    for (auto &resident : blocks_)
+    {
+        resident.cells.clear();
+    }
+
+    for (const auto &entry : ws.cell_map_)
+    {
+        block_of(entry.first.row()).cells.push_back(entry.first);
+    }
+
+    enforce_limit(ws, no_block, no_block);
+}
+
+std::shared_ptr<const void> cell_pager::pin(row_t row)
+{
+    auto &pinned = block_of(row);
+
+    if (!pinned.pin)
+    {
+        pinned.pin = std::make_shared<char>();
+    }
+
+    return pinned.pin;
+}
+
+std::size_t cell_pager::paged_cell_count() const
+{
+    return paged_cells_;
+}
+
+cell_pager::bounds cell_pager::paged_bounds() const
+{
+    auto result = bounds{constants::max_column(), constants::min_column(), constants::max_row(), constants::min_row()};
+
+    for (const auto &paged : blocks_)
+    {
+        if (paged.resident || paged.paged_count == 0) continue;
+
+        result.min_column = std::min(result.min_column, column_t(paged.min_column));
+        result.max_column = std::max(result.max_column, column_t(paged.max_column));
+        result.min_row = std::min(result.min_row, paged.min_row);
+        result.max_row = std::max(result.max_row, paged.max_row);
+    }
+
+    return result;
+}
+
+cell_pager::block &cell_pager::block_of(row_t row)
+{
+    const auto index = block_index(row);
+
+    if (index >= blocks_.size())
+    {
+        blocks_.resize(index + 1);
+    }
+
+    return blocks_[index];
+}
+
+void cell_pager::read_block(const worksheet_impl &ws, std::size_t index, std::vector<cell_impl> &cells, bool take) const
+{
+    const auto &paged = blocks_[index];
+    if (paged.size == 0) return;
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(paged.size));
+
+    if (!seek(file_, paged.offset) || std::fread(data.data(), 1, data.size(), file_) != data.size())
+    {
+        throw xlnt::exception("failed to read worksheet cells from temporary file");
+    }
+
+    cells.reserve(cells.size() + paged.paged_count);
+    const auto *position = data.data();
+    const auto *end = position + data.size();
+
+    while (position < end)
+    {
+        cell_impl cell;
+        cell.parent_ = const_cast<worksheet_impl *>(&ws);
+        cell.column_ = column_t(get<column_t::index_t>(position));
+        cell.row_ = get<row_t>(position);
+        cell.type_ = static_cast<cell_type>(get<std::uint8_t>(position));
+        const auto flags = get<std::uint16_t>(position);
+        cell.value_numeric_ = get<double>(position);
+        cell.is_merged_ = (flags & merged_flag) != 0;
+        cell.phonetics_visible_ = (flags & phonetics_visible_flag) != 0;
+
+        const auto reference = cell_reference(cell.column_, cell.row_);
+
+        if ((flags & plain_text_flag) != 0)
+        {
+            rich_text_access::plain_text(cell.value_text_) = get_string(position);
+            rich_text_access::plain_preserve_space(cell.value_text_) = (flags & preserve_space_flag) != 0;
+            rich_text_access::make_plain(cell.value_text_);
+        }
+        else if ((flags & kept_text_flag) != 0)
+        {
+            auto match = kept_text_.find(reference);
+
+            if (take)
+            {
+                cell.value_text_ = std::move(match->second);
+                kept_text_.erase(match);
+            }
+            else
+            {
+                cell.value_text_ = match->second;
+            }
+        }
+
+        if ((flags & formula_flag) != 0)
+        {
+            cell.formula_.set(get_string(position));
+        }
+
+        if ((flags & format_flag) != 0)
+        {
+            cell.format_.set(formats_.at(get<std::uint32_t>(position)));
+        }
+
+        if ((flags & comment_flag) != 0)
+        {
+            cell.comment_.set(&const_cast<worksheet_impl &>(ws).comments_.at(get_string(position)));
+        }
+
+        if ((flags & kept_hyperlink_flag) != 0)
+        {
+            auto match = kept_hyperlinks_.find(reference);
+
+            if (take)
+            {
+                cell.hyperlink_.set(std::move(match->second));
+                kept_hyperlinks_.erase(match);
+            }
+            else
+            {
+                cell.hyperlink_.set(match->second);
+            }
+        }
+
+        cells.push_back(std::move(cell));
+    }
+}
+
+void cell_pager::load(worksheet_impl &ws, std::size_t index)
+{
+    std::vector<cell_impl> cells;
+    read_block(ws, index, cells, true);
+
+    auto &loaded = blocks_[index];
+    loaded.cells.reserve(cells.size());
+
+    for (auto &cell : cells)
+    {
+        const auto reference = cell_reference(cell.column_, cell.row_);
+        loaded.cells.push_back(reference);
+        ws.cell_map_.emplace(reference, std::move(cell));
+    }
+
+    paged_cells_ -= loaded.paged_count;
+    loaded.paged_count = 0;
+    loaded.resident = true;
+    loaded.dirty = false;
+}
+
+void cell_pager::unload(worksheet_impl &ws, std::size_t index)
+{
+    auto &unloaded = blocks_[index];
+
+    buffer_.clear();
+    unloaded.paged_count = 0;
+    unloaded.min_column = constants::max_column().index;
+    unloaded.max_column = constants::min_column().index;
+    unloaded.min_row = constants::max_row();
+    unloaded.max_row = constants::min_row();
+
+    for (const auto &reference : unloaded.cells)
+    {
+        // cells erased since they were recorded are skipped, as are repeated references
+        auto match = ws.cell_map_.find(reference);
+        if (match == ws.cell_map_.end()) continue;
+
+        auto &cell = match->second;
+        auto flags = std::uint16_t(0);
+
+        if (cell.is_merged_) flags |= merged_flag;
+        if (cell.phonetics_visible_) flags |= phonetics_visible_flag;
+        if (cell.formula_.is_set()) flags |= formula_flag;
+        if (cell.format_.is_set()) flags |= format_flag;
+        if (cell.comment_.is_set()) flags |= comment_flag;
+
+        const auto &text = cell.value_text_;
+
+        if (rich_text_access::is_plain(text) && !rich_text_access::has_phonetics(text))
+        {
+            flags |= plain_text_flag;
+            if (rich_text_access::plain_preserve_space(text)) flags |= preserve_space_flag;
+        }
+        else if (!rich_text_access::is_empty(text) || rich_text_access::has_phonetics(text))
+        {
+            flags |= kept_text_flag;
+            kept_text_[reference] = std::move(cell.value_text_);
+        }
+
+        if (cell.hyperlink_.is_set())
+        {
+            flags |= kept_hyperlink_flag;
+            kept_hyperlinks_[reference] = std::move(cell.hyperlink_.get());
+        }
+
+        ++unloaded.paged_count;
+        unloaded.min_column = std::min(unloaded.min_column, cell.column_.index);
+        unloaded.max_column = std::max(unloaded.max_column, cell.column_.index);
+        unloaded.min_row = std::min(unloaded.min_row, cell.row_);
+        unloaded.max_row = std::max(unloaded.max_row, cell.row_);
+
+        // a block read back and left as it was is already in the file
+        if (!unloaded.dirty)
+        {
+            ws.cell_map_.erase(match);
+            continue;
+        }
+
+        put(buffer_, cell.column_.index);
+        put(buffer_, cell.row_);
+        put(buffer_, static_cast<std::uint8_t>(cell.type_));
+        put(buffer_, flags);
+        put(buffer_, cell.value_numeric_);
+
+        if ((flags & plain_text_flag) != 0)
+        {
+            put_string(buffer_, rich_text_access::plain_text(text));
+        }
+
+        if ((flags & formula_flag) != 0)
+        {
+            put_string(buffer_, cell.formula_.get());
+        }
+
+        // formats are written as an index into formats_ since their ids in the stylesheet
+        // change when it is garbage collected
+        if ((flags & format_flag) != 0)
+        {
+            put(buffer_, format_index(cell.format_.get()));
+        }
+
+        if ((flags & comment_flag) != 0)
+        {
+            put_string(buffer_, ws.comment_key(reference, cell.comment_.get()));
+        }
+
+        ws.cell_map_.erase(match);
+    }
+
+    if (unloaded.dirty)
+    {
+        if (file_ == nullptr && !buffer_.empty())
+        {
+            file_ = std::tmpfile();
+
+            if (file_ == nullptr)
+            {
+                throw xlnt::exception("failed to create temporary file for worksheet cells");
+            }
+        }
+
+        if (buffer_.size() > unloaded.capacity)
+        {
+            unloaded.offset = file_size_;
+            unloaded.capacity = buffer_.size();
+            file_size_ += buffer_.size();
+        }
+
+        if (!buffer_.empty()
+            && (!seek(file_, unloaded.offset) || std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()))
+        {
+            throw xlnt::exception("failed to write worksheet cells to temporary file");
+        }
+
+        unloaded.size = buffer_.size();
+        unloaded.dirty = false;
+    }
+
+    unloaded.cells.clear();
+    unloaded.cells.shrink_to_fit();
+    unloaded.resident = false;
+    paged_cells_ += unloaded.paged_count;
+}
+
+std::uint32_t cell_pager::format_index(format_impl *format)
+{
+    auto match = format_indices_.find(format);
+
+    if (match == format_indices_.end())
+    {
+        match = format_indices_.emplace(format, static_cast<std::uint32_t>(formats_.size())).first;
+        formats_.push_back(format);
+    }
+
+    return match->second;
+}
+
+void cell_pager::enforce_limit(worksheet_impl &ws, std::size_t first_block, std::size_t last_block)
+{
+    while (ws.cell_map_.size() > max_resident_cells_)
+    {
+        auto victim = no_block;
+
+        for (auto index = std::size_t(0); index < blocks_.size(); ++index)
+        {
+            const auto &candidate = blocks_[index];
+            if (!candidate.resident || candidate.cells.empty()) continue;
+            if (candidate.pin && candidate.pin.use_count() > 1) continue;
+            if (first_block != no_block && index >= first_block && index <= last_block) continue;
+
+            if (victim == no_block || candidate.last_used < blocks_[victim].last_used)
+            {
+                victim = index;
+            }
+        }
+
+        if (victim == no_block) break;
+
+        unload(ws, victim);
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
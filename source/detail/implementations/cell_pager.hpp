@@ -0,0 +1,292 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/hyperlink_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+struct worksheet_impl;
+
+/// <summary>
+/// Keeps the cells of a worksheet within a number of resident cells by writing blocks
+/// of rows that haven't been used recently to a temporary file and reading them back
+/// into the worksheet's cell map when they are needed again.
+/// </summary>
+class cell_pager
+{
+public:
+    /// <summary>
+    /// The number of rows in a block, the unit that is written out and read back.
+    /// </summary>
+    static const row_t rows_per_block = 256;
+
+    /// <summary>
+    /// Creates a pager which keeps at most max_resident_cells cells in memory.
+    /// </summary>
+    explicit cell_pager(std::size_t max_resident_cells);
+
+    /// <summary>
+    /// Closes and so deletes the temporary file.
+    /// </summary>
+    ~cell_pager();
+
+    cell_pager(const cell_pager &) = delete;
+    cell_pager &operator=(const cell_pager &) = delete;
+
+    /// <summary>
+    /// The number of cells that may stay in memory.
+    /// </summary>
+    std::size_t max_resident_cells() const;
+
+    /// <summary>
+    /// Changes the number of cells that may stay in memory, writing blocks out if
+    /// there are more than that.
+    /// </summary>
+    void max_resident_cells(worksheet_impl &ws, std::size_t count);
+
+    /// <summary>
+    /// Makes the blocks holding rows first_row to last_row resident and the most
+    /// recently used, then writes out other blocks while over the limit. Unless
+    /// modify is false, the blocks are written again when they are next written out.
+    /// </summary>
+    void page_in(worksheet_impl &ws, row_t first_row, row_t last_row, bool modify = true);
+
+    /// <summary>
+    /// Makes every block resident regardless of the limit.
+    /// </summary>
+    void page_in_all(worksheet_impl &ws);
+
+    /// <summary>
+    /// Records a cell just added to the cell map, then writes out blocks other than
+    /// its own while over the limit.
+    /// </summary>
+    void added(worksheet_impl &ws, const cell_reference &reference);
+
+    /// <summary>
+    /// Records a cell just added to the cell map in a block that is resident, without
+    /// writing other blocks out. The limit is enforced when rows are next paged in.
+    /// </summary>
+    void record(const cell_reference &reference);
+
+    /// <summary>
+    /// Assigns the resident cells to blocks again after they moved between rows.
+    /// </summary>
+    void reindex(worksheet_impl &ws);
+
+    /// <summary>
+    /// Returns a token which keeps the block holding row resident for as long as any
+    /// copy of it exists. Cell objects hold one so that the cell_impl they point to
+    /// isn't destroyed by writing its block out.
+    /// </summary>
+    std::shared_ptr<const void> pin(row_t row);
+
+    /// <summary>
+    /// Makes each block with cells in rows first_row to last_row resident in turn,
+    /// calling f with the references of its cells. Blocks are written out behind it as
+    /// needed, so any number of rows can be visited within the limit. If modify is
+    /// false, f must not change the cells.
+    /// </summary>
+    template <typename F>
+    void for_each_block(worksheet_impl &ws, F f, row_t first_row = 1,
+        row_t last_row = std::numeric_limits<row_t>::max(), bool modify = true)
+    {
+        const auto first_block = static_cast<std::size_t>((first_row - 1) / rows_per_block);
+        const auto last_block = static_cast<std::size_t>((last_row - 1) / rows_per_block);
+
+        for (auto index = first_block; index < blocks_.size() && index <= last_block; ++index)
+        {
+            if (!blocks_[index].resident && blocks_[index].paged_count == 0) continue;
+
+            const auto first_row = static_cast<row_t>(index * rows_per_block + 1);
+            page_in(ws, first_row, first_row + rows_per_block - 1, modify);
+            f(blocks_[index].cells);
+        }
+    }
+
+    /// <summary>
+    /// The number of cells that are written out.
+    /// </summary>
+    std::size_t paged_cell_count() const;
+
+    /// <summary>
+    /// The lowest and highest columns and rows of the cells that are written out.
+    /// </summary>
+    struct bounds
+    {
+        column_t min_column;
+        column_t max_column;
+        row_t min_row;
+        row_t max_row;
+    };
+
+    /// <summary>
+    /// Returns the bounds of the cells that are written out. If there are none, the
+    /// minimums are the highest possible values and the maximums the lowest.
+    /// </summary>
+    bounds paged_bounds() const;
+
+    /// <summary>
+    /// Calls f with a copy of each cell in rows first_row to last_row that is written
+    /// out, leaving it on disk. Other cells of the blocks holding those rows may be
+    /// passed to f too.
+    /// </summary>
+    template <typename F>
+    void for_each_paged_cell(const worksheet_impl &ws, F f, row_t first_row = 1,
+        row_t last_row = std::numeric_limits<row_t>::max()) const
+    {
+        std::vector<cell_impl> cells;
+        const auto first_block = static_cast<std::size_t>((first_row - 1) / rows_per_block);
+        const auto last_block = static_cast<std::size_t>((last_row - 1) / rows_per_block);
+
+        for (auto index = first_block; index < blocks_.size() && index <= last_block; ++index)
+        {
+            if (blocks_[index].resident || blocks_[index].paged_count == 0) continue;
+
+            cells.clear();
+            read_block(ws, index, cells, false);
+
+            for (const auto &cell : cells)
+            {
+                f(cell);
+            }
+        }
+    }
+
+private:
+    struct block
+    {
+        /// <summary>
+        /// True if the block's cells are in the cell map rather than the file.
+        /// </summary>
+        bool resident = true;
+
+        /// <summary>
+        /// The cells of a resident block. Cells erased since are skipped.
+        /// </summary>
+        std::vector<cell_reference> cells;
+
+        /// <summary>
+        /// Shared with cell objects of the block's cells, which keep it resident while
+        /// there is more than one owner.
+        /// </summary>
+        std::shared_ptr<const void> pin;
+
+        /// <summary>
+        /// The value of the pager's clock when the block was last used.
+        /// </summary>
+        std::uint64_t last_used = 0;
+
+        /// <summary>
+        /// Where the block was last written to and how many bytes it has there.
+        /// </summary>
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        std::uint64_t capacity = 0;
+
+        /// <summary>
+        /// True if the resident cells may differ from those in the file, so that blocks
+        /// which were only read aren't written again.
+        /// </summary>
+        bool dirty = true;
+
+        /// <summary>
+        /// The number and bounds of the cells in the file.
+        /// </summary>
+        std::size_t paged_count = 0;
+        column_t::index_t min_column = 0;
+        column_t::index_t max_column = 0;
+        row_t min_row = 0;
+        row_t max_row = 0;
+    };
+
+    /// <summary>
+    /// Returns the block holding row, adding blocks as needed.
+    /// </summary>
+    block &block_of(row_t row);
+
+    /// <summary>
+    /// Reads the cells of a written out block. If take is true, text and hyperlinks
+    /// kept aside in memory are moved into the cells rather than copied.
+    /// </summary>
+    void read_block(const worksheet_impl &ws, std::size_t index, std::vector<cell_impl> &cells, bool take) const;
+
+    /// <summary>
+    /// Moves the cells of a written out block into the cell map.
+    /// </summary>
+    void load(worksheet_impl &ws, std::size_t index);
+
+    /// <summary>
+    /// Writes the cells of a resident block to the file and erases them from the cell map.
+    /// </summary>
+    void unload(worksheet_impl &ws, std::size_t index);
+
+    /// <summary>
+    /// Returns the index of format in formats_, adding it if needed.
+    /// </summary>
+    std::uint32_t format_index(format_impl *format);
+
+    /// <summary>
+    /// Writes out the least recently used blocks outside first_block to last_block
+    /// which aren't pinned until no more than the limit of cells are resident.
+    /// </summary>
+    void enforce_limit(worksheet_impl &ws, std::size_t first_block, std::size_t last_block);
+
+    std::size_t max_resident_cells_;
+    std::vector<block> blocks_;
+    std::FILE *file_ = nullptr;
+    std::uint64_t file_size_ = 0;
+    std::uint64_t clock_ = 0;
+    std::size_t paged_cells_ = 0;
+
+    /// <summary>
+    /// Formatted text and hyperlinks of written out cells, which are rare enough to
+    /// be kept in memory rather than encoded in the file.
+    /// </summary>
+    mutable std::unordered_map<cell_reference, rich_text> kept_text_;
+    mutable std::unordered_map<cell_reference, hyperlink_impl> kept_hyperlinks_;
+
+    /// <summary>
+    /// The formats of written out cells, which the file refers to by index. Cells hold
+    /// a reference to their format, so these aren't garbage collected meanwhile.
+    /// </summary>
+    std::vector<format_impl *> formats_;
+    std::unordered_map<const format_impl *, std::uint32_t> format_indices_;
+
+    std::vector<std::uint8_t> buffer_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 
 #include <xlnt/styles/conditional_format.hpp>
 #include <xlnt/utils/optional.hpp>
@@ -25,7 +26,7 @@ struct conditional_format_impl
     bool operator==(const conditional_format_impl& rhs) const
     {
         // not comparing parent or target sheet
-        return target_range == rhs.target_range
+        return target_ranges == rhs.target_ranges
             && priority == rhs.priority
             && differential_format_id == rhs.differential_format_id
             && when == rhs.when
@@ -34,7 +35,11 @@ struct conditional_format_impl
             && font_id == rhs.font_id;
     }
 
-	range_reference target_range;
+	/// <summary>
+	/// Every range this rule was added to. Rules with the same sheet, condition
+	/// and format share one impl.
+	/// </summary>
+	std::vector<range_reference> target_ranges;
 
 	std::size_t priority;
 	std::size_t differential_format_id;
@@ -0,0 +1,125 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/styles/font.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Workbook-wide store of immutable fonts referenced by rich text runs.
+/// Equal fonts are shared so formatted strings only hold a pointer per run.
+/// </summary>
+class font_pool
+{
+public:
+    /// <summary>
+    /// Returns the pooled font equal to f, adding a copy of f if there is none yet.
+    /// </summary>
+    std::shared_ptr<const font> intern(const font &f)
+    {
+        auto &bucket = buckets_[hash(f)];
+
+        for (const auto &pooled : bucket)
+        {
+            if (*pooled == f)
+            {
+                return pooled;
+            }
+        }
+
+        bucket.push_back(std::make_shared<const font>(f));
+        ++size_;
+
+        return bucket.back();
+    }
+
+    /// <summary>
+    /// Returns the pooled equivalent of f, which may be f itself.
+    /// </summary>
+    std::shared_ptr<const font> intern(const std::shared_ptr<const font> &f)
+    {
+        if (f == nullptr)
+        {
+            return f;
+        }
+
+        auto &bucket = buckets_[hash(*f)];
+
+        for (const auto &pooled : bucket)
+        {
+            if (pooled == f || *pooled == *f)
+            {
+                return pooled;
+            }
+        }
+
+        bucket.push_back(f);
+        ++size_;
+
+        return f;
+    }
+
+    /// <summary>
+    /// Returns the number of distinct fonts in the pool.
+    /// </summary>
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// <summary>
+    /// Removes every font from the pool. Fonts still referenced by text stay alive.
+    /// </summary>
+    void clear()
+    {
+        buckets_.clear();
+        size_ = 0;
+    }
+
+private:
+    static std::size_t hash(const font &f)
+    {
+        auto result = std::hash<std::string>()(f.has_name() ? f.name() : std::string());
+        result ^= std::hash<double>()(f.has_size() ? f.size() : 0.0) + 0x9e3779b9 + (result << 6) + (result >> 2);
+        result ^= static_cast<std::size_t>(f.bold()) | static_cast<std::size_t>(f.italic()) << 1
+            | static_cast<std::size_t>(f.underline()) << 2;
+
+        return result;
+    }
+
+    std::unordered_map<std::size_t, std::vector<std::shared_ptr<const font>>> buckets_;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
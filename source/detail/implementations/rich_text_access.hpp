@@ -0,0 +1,136 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <xlnt/cell/rich_text.hpp>
+
+namespace xlnt {
+namespace detail {
+
+class font_pool;
+
+/// <summary>
+/// Gives the serializers and the cell pager access to how rich text is stored,
+/// so that the common case of a single unformatted run is read and written
+/// without building runs.
+/// </summary>
+struct rich_text_access
+{
+    /// <summary>
+    /// Returns true if text has no content.
+    /// </summary>
+    static bool is_empty(const rich_text &text)
+    {
+        return text.storage_ == rich_text::storage::empty;
+    }
+
+    /// <summary>
+    /// Returns true if text is a single unformatted run held in plain_text.
+    /// </summary>
+    static bool is_plain(const rich_text &text)
+    {
+        return text.storage_ == rich_text::storage::plain;
+    }
+
+    /// <summary>
+    /// Returns true if text has phonetic runs or properties.
+    /// </summary>
+    static bool has_phonetics(const rich_text &text)
+    {
+        return !text.phonetic_runs_.empty() || text.phonetic_properties_.is_set();
+    }
+
+    /// <summary>
+    /// The text of a plain run, which may be filled in directly before calling make_plain.
+    /// </summary>
+    static std::string &plain_text(rich_text &text)
+    {
+        return text.plain_text_;
+    }
+
+    static const std::string &plain_text(const rich_text &text)
+    {
+        return text.plain_text_;
+    }
+
+    /// <summary>
+    /// Whether whitespace of a plain run is preserved.
+    /// </summary>
+    static bool &plain_preserve_space(rich_text &text)
+    {
+        return text.plain_preserve_space_;
+    }
+
+    static bool plain_preserve_space(const rich_text &text)
+    {
+        return text.plain_preserve_space_;
+    }
+
+    /// <summary>
+    /// Marks text as the plain run already filled in through plain_text.
+    /// </summary>
+    static void make_plain(rich_text &text)
+    {
+        text.storage_ = rich_text::storage::plain;
+    }
+
+    static const std::vector<phonetic_run> &phonetic_runs(const rich_text &text)
+    {
+        return text.phonetic_runs_;
+    }
+
+    /// <summary>
+    /// Appends a run whose font has already been interned.
+    /// </summary>
+    static void add_run(rich_text &text, const std::string &run_text, std::shared_ptr<const font> run_font,
+        bool preserve_space)
+    {
+        text.add_run(run_text, std::move(run_font), preserve_space);
+    }
+
+    /// <summary>
+    /// Replaces the font of each run of text with its equivalent from pool.
+    /// </summary>
+    static void intern_fonts(rich_text &text, font_pool &pool)
+    {
+        text.intern_fonts(pool);
+    }
+
+    /// <summary>
+    /// Calls f(text, font, preserve_space) for each run in order without copying.
+    /// A null font pointer means the run has no formatting.
+    /// </summary>
+    template <typename F>
+    static void for_each_run(const rich_text &text, F f)
+    {
+        text.for_each_run(f);
+    }
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -24,7 +24,9 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <detail/implementations/conditional_format_impl.hpp>
@@ -503,6 +505,7 @@ struct stylesheet
     void clear()
     {
 		conditional_format_impls.clear();
+        conditional_format_index.clear();
         format_impls.clear();
         
         style_impls.clear();
@@ -520,18 +523,56 @@ struct stylesheet
 
 	conditional_format add_conditional_format_rule(worksheet_impl *ws, const range_reference &ref, const condition &when)
 	{
-		conditional_format_impls.push_back(conditional_format_impl());
+		auto &impl = find_or_add_conditional_format(ws, when, optional<std::size_t>(),
+			optional<std::size_t>(), optional<std::size_t>());
+		impl.target_ranges.push_back(ref);
 
-		auto &impl = conditional_format_impls.back();
-		impl.when = when;
-		impl.parent = this;
-		impl.target_sheet = ws;
-		impl.target_range = ref;
-		impl.differential_format_id = conditional_format_impls.size() - 1;
-
-		return xlnt::conditional_format(&impl);
+		return xlnt::conditional_format(&impl, ref);
 	}
 
+    /// <summary>
+    /// Moves ref out of rule into the rule with the same sheet and condition and the given
+    /// border, fill and font, creating it if needed, and returns the rule that now holds ref.
+    /// Rules left without ranges are kept so that later calls can reuse them.
+    /// </summary>
+    conditional_format_impl *restyle_conditional_format(conditional_format_impl *rule, const range_reference &ref,
+        const optional<std::size_t> &border_id, const optional<std::size_t> &fill_id, const optional<std::size_t> &font_id)
+    {
+        auto holds_ref = [&ref](const conditional_format_impl &candidate) {
+            return std::find(candidate.target_ranges.begin(), candidate.target_ranges.end(), ref)
+                != candidate.target_ranges.end();
+        };
+
+        // an older copy of a handle may point at a rule ref has since moved out of
+        if (!holds_ref(*rule))
+        {
+            for (auto &candidate : conditional_format_impls)
+            {
+                if (candidate.target_sheet == rule->target_sheet
+                    && conditional_format_key(candidate) == conditional_format_key(*rule)
+                    && holds_ref(candidate))
+                {
+                    rule = &candidate;
+                    break;
+                }
+            }
+        }
+
+        auto &target = find_or_add_conditional_format(rule->target_sheet, rule->when, border_id, fill_id, font_id);
+        if (&target == rule) return rule;
+
+        auto &ranges = rule->target_ranges;
+        auto match = std::find(ranges.begin(), ranges.end(), ref);
+        if (match != ranges.end())
+        {
+            ranges.erase(match);
+        }
+
+        target.target_ranges.push_back(ref);
+
+        return &target;
+    }
+
     workbook *parent;
 
     bool operator==(const stylesheet& rhs) const
@@ -570,6 +611,68 @@ struct stylesheet
 	std::vector<protection> protections;
     
     std::vector<color> colors;
+
+    using conditional_format_key_type = std::tuple<const worksheet_impl *, int, int, std::string,
+        std::size_t, std::size_t, std::size_t>;
+
+    static conditional_format_key_type conditional_format_key(const worksheet_impl *ws, const condition &when,
+        const optional<std::size_t> &border_id, const optional<std::size_t> &fill_id, const optional<std::size_t> &font_id)
+    {
+        const auto unset = std::size_t(-1);
+
+        return std::make_tuple(ws, static_cast<int>(when.type_), static_cast<int>(when.operator_), when.text_comparand_,
+            border_id.is_set() ? border_id.get() : unset,
+            fill_id.is_set() ? fill_id.get() : unset,
+            font_id.is_set() ? font_id.get() : unset);
+    }
+
+    static conditional_format_key_type conditional_format_key(const conditional_format_impl &rule)
+    {
+        return conditional_format_key(rule.target_sheet, rule.when, rule.border_id, rule.fill_id, rule.font_id);
+    }
+
+    conditional_format_impl &find_or_add_conditional_format(worksheet_impl *ws, const condition &when,
+        const optional<std::size_t> &border_id, const optional<std::size_t> &fill_id, const optional<std::size_t> &font_id)
+    {
+        // a copied stylesheet still indexes the rules of the one it was copied from
+        if (conditional_format_index_owner != &conditional_format_impls)
+        {
+            conditional_format_index.clear();
+
+            for (auto &rule : conditional_format_impls)
+            {
+                conditional_format_index.emplace(conditional_format_key(rule), &rule);
+            }
+
+            conditional_format_index_owner = &conditional_format_impls;
+        }
+
+        const auto key = conditional_format_key(ws, when, border_id, fill_id, font_id);
+        auto match = conditional_format_index.find(key);
+        if (match != conditional_format_index.end()) return *match->second;
+
+        conditional_format_impls.push_back(conditional_format_impl());
+
+        auto &impl = conditional_format_impls.back();
+        impl.when = when;
+        impl.parent = this;
+        impl.target_sheet = ws;
+        impl.differential_format_id = conditional_format_impls.size() - 1;
+        impl.border_id = border_id;
+        impl.fill_id = fill_id;
+        impl.font_id = font_id;
+
+        conditional_format_index.emplace(key, &impl);
+
+        return impl;
+    }
+
+    /// <summary>
+    /// The conditional format rule for each sheet, condition and format, built from
+    /// conditional_format_impls when conditional_format_index_owner isn't this stylesheet's list.
+    /// </summary>
+    std::map<conditional_format_key_type, conditional_format_impl *> conditional_format_index;
+    const std::list<conditional_format_impl> *conditional_format_index_owner = nullptr;
 };
 
 } // namespace detail
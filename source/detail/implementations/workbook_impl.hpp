@@ -27,6 +27,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include <detail/implementations/font_pool.hpp>
 #include <detail/implementations/stylesheet.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <xlnt/packaging/ext_list.hpp>
@@ -34,6 +35,7 @@
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/calculation_properties.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/worksheet/range.hpp>
@@ -56,6 +58,10 @@ struct workbook_impl
           worksheets_(other.worksheets_),
           shared_strings_ids_(other.shared_strings_ids_),
           shared_strings_values_(other.shared_strings_values_),
+          shared_strings_indexed_(other.shared_strings_indexed_),
+          default_string_storage_(other.default_string_storage_),
+          max_resident_cells_(other.max_resident_cells_),
+          font_pool_(other.font_pool_),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -75,6 +81,10 @@ struct workbook_impl
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
         shared_strings_ids_ = other.shared_strings_ids_;
         shared_strings_values_ = other.shared_strings_values_;
+        shared_strings_indexed_ = other.shared_strings_indexed_;
+        default_string_storage_ = other.default_string_storage_;
+        max_resident_cells_ = other.max_resident_cells_;
+        font_pool_ = other.font_pool_;
         theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -95,7 +105,7 @@ struct workbook_impl
     {
         return active_sheet_index_ == other.active_sheet_index_
             && worksheets_ == other.worksheets_
-            && shared_strings_ids_ == other.shared_strings_ids_
+            && shared_strings_values_ == other.shared_strings_values_
             && stylesheet_ == other.stylesheet_
             && base_date_ == other.base_date_
             && title_ == other.title_
@@ -122,6 +132,27 @@ struct workbook_impl
     std::unordered_map<rich_text, std::size_t, rich_text_hash> shared_strings_ids_;
     std::vector<rich_text> shared_strings_values_;
 
+    /// <summary>
+    /// The number of leading shared_strings_values_ that are in shared_strings_ids_.
+    /// Strings appended directly when loading are indexed on the next add_shared_string.
+    /// </summary>
+    std::size_t shared_strings_indexed_ = 0;
+
+    /// <summary>
+    /// How strings are stored in columns without a string_storage of their own.
+    /// </summary>
+    string_storage default_string_storage_ = string_storage::shared;
+
+    /// <summary>
+    /// The number of cells new worksheets keep in memory, zero to keep all of them.
+    /// </summary>
+    std::size_t max_resident_cells_ = 0;
+
+    /// <summary>
+    /// Fonts referenced by the runs of formatted shared strings and comments.
+    /// </summary>
+    font_pool font_pool_;
+
     optional<stylesheet> stylesheet_;
 
     calendar base_date_;
@@ -23,12 +23,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <xlnt/drawing/spreadsheet_drawing.hpp>
 #include <xlnt/packaging/ext_list.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
@@ -41,6 +45,7 @@
 #include <xlnt/worksheet/print_options.hpp>
 #include <xlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_pager.hpp>
 
 namespace xlnt {
 
@@ -63,6 +68,45 @@ struct worksheet_impl
     }
 
     void operator=(const worksheet_impl &other)
+    {
+        copy_properties(other);
+
+        column_string_storage_ = other.column_string_storage_;
+        row_properties_ = other.row_properties_;
+        comments_ = other.comments_;
+        cell_map_ = other.cell_map_;
+        pager_.reset(other.pager_ ? new cell_pager(other.pager_->max_resident_cells()) : nullptr);
+        formula_count_ = other.formula_count_;
+
+        if (other.pager_)
+        {
+            other.pager_->for_each_paged_cell(other, [this](const cell_impl &cell) {
+                cell_map_.emplace(cell_reference(cell.column_, cell.row_), cell);
+            });
+        }
+
+        for (auto &cell : cell_map_)
+        {
+            cell.second.parent_ = this;
+
+            // cells refer to the copies of their comments rather than those of other
+            if (cell.second.comment_.is_set())
+            {
+                cell.second.comment_.set(&comments_.at(other.comment_key(cell.first, cell.second.comment_.get())));
+            }
+        }
+
+        // the copy pages out to a file of its own
+        if (pager_)
+        {
+            pager_->reindex(*this);
+        }
+    }
+
+    /// <summary>
+    /// Copies everything operator= does except the cells, row properties, comments and string storage.
+    /// </summary>
+    void copy_properties(const worksheet_impl &other)
     {
         parent_ = other.parent_;
 
@@ -70,8 +114,6 @@ struct worksheet_impl
         title_ = other.title_;
         format_properties_ = other.format_properties_;
         column_properties_ = other.column_properties_;
-        row_properties_ = other.row_properties_;
-        cell_map_ = other.cell_map_;
         page_setup_ = other.page_setup_;
         auto_filter_ = other.auto_filter_;
         page_margins_ = other.page_margins_;
@@ -88,11 +130,6 @@ struct worksheet_impl
         extension_list_ = other.extension_list_;
         sheet_properties_ = other.sheet_properties_;
         print_options_ = other.print_options_;
-
-        for (auto &cell : cell_map_)
-        {
-            cell.second.parent_ = this;
-        }
     }
 
     workbook *parent_;
@@ -103,8 +140,9 @@ struct worksheet_impl
             && title_ == rhs.title_
             && format_properties_ == rhs.format_properties_
             && column_properties_ == rhs.column_properties_
+            && column_string_storage_ == rhs.column_string_storage_
             && row_properties_ == rhs.row_properties_
-            && cell_map_ == rhs.cell_map_
+            && same_cells(rhs)
             && page_setup_ == rhs.page_setup_
             && auto_filter_ == rhs.auto_filter_
             && page_margins_ == rhs.page_margins_
@@ -124,16 +162,160 @@ struct worksheet_impl
             && extension_list_ == rhs.extension_list_;
     }
 
+    /// <summary>
+    /// Returns true if this worksheet has the same cells as rhs, including cells
+    /// either of them has paged out.
+    /// </summary>
+    bool same_cells(const worksheet_impl &rhs) const
+    {
+        if (!pager_ && !rhs.pager_) return cell_map_ == rhs.cell_map_;
+        if (cell_count() != rhs.cell_count()) return false;
+
+        std::unordered_map<cell_reference, cell_impl> rhs_cells;
+        rhs.for_each_cell([&rhs_cells](const cell_impl &cell) {
+            rhs_cells.emplace(cell_reference(cell.column_, cell.row_), cell);
+        });
+
+        auto same = true;
+        for_each_cell([&](const cell_impl &cell) {
+            auto match = rhs_cells.find(cell_reference(cell.column_, cell.row_));
+            same = same && match != rhs_cells.end() && match->second == cell;
+        });
+
+        return same;
+    }
+
+    /// <summary>
+    /// Returns the key in comments_ of note, the comment of the cell at reference.
+    /// Comments stay under the reference they were added at when rows or columns move.
+    /// </summary>
+    const std::string &comment_key(const cell_reference &reference, const comment *note) const
+    {
+        auto match = comments_.find(reference.to_string());
+
+        if (match == comments_.end() || &match->second != note)
+        {
+            match = std::find_if(comments_.begin(), comments_.end(),
+                [note](const std::pair<const std::string, comment> &entry) { return &entry.second == note; });
+        }
+
+        if (match == comments_.end())
+        {
+            throw xlnt::key_not_found();
+        }
+
+        return match->first;
+    }
+
+    /// <summary>
+    /// The number of cells in the worksheet, in memory or paged out.
+    /// </summary>
+    std::size_t cell_count() const
+    {
+        return cell_map_.size() + (pager_ ? pager_->paged_cell_count() : 0);
+    }
+
+    /// <summary>
+    /// Returns the cell at reference, or nullptr if there is none, first paging in
+    /// the rows around it if they were paged out.
+    /// </summary>
+    cell_impl *find_cell(const cell_reference &reference)
+    {
+        if (pager_)
+        {
+            pager_->page_in(*this, reference.row(), reference.row());
+        }
+
+        auto match = cell_map_.find(reference);
+        return match == cell_map_.end() ? nullptr : &match->second;
+    }
+
+    /// <summary>
+    /// Makes the cells in rows first_row to last_row resident in cell_map_. modify
+    /// must be false only if the caller won't change them.
+    /// </summary>
+    void page_in(row_t first_row, row_t last_row, bool modify = true)
+    {
+        if (pager_)
+        {
+            pager_->page_in(*this, first_row, last_row, modify);
+        }
+    }
+
+    /// <summary>
+    /// Makes every cell resident in cell_map_, regardless of the worksheet's limit.
+    /// </summary>
+    void page_in_all()
+    {
+        if (pager_)
+        {
+            pager_->page_in_all(*this);
+        }
+    }
+
+    /// <summary>
+    /// Calls f with each cell, reading cells that are paged out without making them resident.
+    /// </summary>
+    template <typename F>
+    void for_each_cell(F f) const
+    {
+        for (const auto &entry : cell_map_)
+        {
+            f(entry.second);
+        }
+
+        if (pager_)
+        {
+            pager_->for_each_paged_cell(*this, f);
+        }
+    }
+
+    /// <summary>
+    /// Calls f with each cell in rows first_row to last_row, reading cells that are
+    /// paged out without making them resident.
+    /// </summary>
+    template <typename F>
+    void for_each_cell(row_t first_row, row_t last_row, F f) const
+    {
+        auto f_if_contained = [&](const cell_impl &cell) {
+            if (cell.row_ >= first_row && cell.row_ <= last_row)
+            {
+                f(cell);
+            }
+        };
+
+        for (const auto &entry : cell_map_)
+        {
+            f_if_contained(entry.second);
+        }
+
+        if (pager_)
+        {
+            pager_->for_each_paged_cell(*this, f_if_contained, first_row, last_row);
+        }
+    }
+
     std::size_t id_;
     std::string title_;
 
     sheet_format_properties format_properties_;
 
     std::unordered_map<column_t, column_properties> column_properties_;
+
+    /// <summary>
+    /// The string_storage of columns which don't use the workbook's default.
+    /// </summary>
+    std::unordered_map<column_t, string_storage> column_string_storage_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
     std::unordered_map<cell_reference, cell_impl> cell_map_;
 
+    /// <summary>
+    /// Pages blocks of rows out of cell_map_ to keep it within a number of cells,
+    /// or null if every cell stays in memory.
+    /// </summary>
+    std::unique_ptr<cell_pager> pager_;
+
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
     optional<page_margins> page_margins_;
@@ -161,6 +343,13 @@ struct worksheet_impl
 
     std::string drawing_rel_id_;
     optional<drawing::spreadsheet_drawing> drawing_;
+
+    /// <summary>
+    /// The number of cells in cell_map_ with a formula. This is kept up to date by
+    /// every path that sets, clears, loads or erases a formula so that the calc chain
+    /// can be dropped without rescanning the workbook.
+    /// </summary>
+    std::size_t formula_count_ = 0;
 };
 
 } // namespace detail
@@ -0,0 +1,146 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The number of blocks parallel_block_count returns on the calling thread
+/// regardless of the minimum block size and hardware threads, or 0 if it is
+/// not overridden. Set through scoped_parallel_block_count.
+/// </summary>
+XLNT_API std::size_t &parallel_block_override();
+
+/// <summary>
+/// Forces parallel_block_count to split work into block_count blocks on the
+/// calling thread while this object is alive so that the block merging code
+/// can be exercised with small inputs on any machine.
+/// </summary>
+class scoped_parallel_block_count
+{
+public:
+    explicit scoped_parallel_block_count(std::size_t block_count)
+        : previous_(parallel_block_override())
+    {
+        parallel_block_override() = block_count;
+    }
+
+    ~scoped_parallel_block_count()
+    {
+        parallel_block_override() = previous_;
+    }
+
+    scoped_parallel_block_count(const scoped_parallel_block_count &) = delete;
+    scoped_parallel_block_count &operator=(const scoped_parallel_block_count &) = delete;
+
+private:
+    std::size_t previous_;
+};
+
+/// <summary>
+/// Returns the number of blocks that count items should be split into so that
+/// each block has at least min_block_size items and there are no more blocks
+/// than hardware threads. Always returns at least 1.
+/// </summary>
+inline std::size_t parallel_block_count(std::size_t count, std::size_t min_block_size)
+{
+    if (parallel_block_override() != 0)
+    {
+        return std::max(std::size_t(1), std::min(parallel_block_override(), count));
+    }
+
+    const auto hardware = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+    const auto by_size = count / std::max(min_block_size, std::size_t(1));
+
+    return std::max(std::size_t(1), std::min(hardware, by_size));
+}
+
+/// <summary>
+/// Splits [0, count) into block_count contiguous blocks and calls
+/// fn(block_index, first, last) for each one. Blocks after the first run on
+/// their own thread while the calling thread processes the first one. The
+/// first exception thrown by any block is rethrown after all threads joined.
+/// </summary>
+template <typename Function>
+void parallel_for_blocks(std::size_t count, std::size_t block_count, Function fn)
+{
+    block_count = std::max(std::size_t(1), std::min(block_count, count));
+
+    if (block_count == 1)
+    {
+        fn(std::size_t(0), std::size_t(0), count);
+        return;
+    }
+
+    const auto block_size = (count + block_count - 1) / block_count;
+    std::vector<std::exception_ptr> errors(block_count);
+    std::vector<std::thread> workers;
+    workers.reserve(block_count - 1);
+
+    auto run_block = [&](std::size_t block) {
+        try
+        {
+            const auto first = std::min(count, block * block_size);
+            const auto last = std::min(count, first + block_size);
+            fn(block, first, last);
+        }
+        catch (...)
+        {
+            errors[block] = std::current_exception();
+        }
+    };
+
+    for (auto block = std::size_t(1); block < block_count; ++block)
+    {
+        workers.emplace_back(run_block, block);
+    }
+
+    run_block(0);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
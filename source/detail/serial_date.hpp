@@ -0,0 +1,230 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <xlnt/utils/calendar.hpp>
+
+// Packed 32-bit multiplies and double rounding need more than the SSE2 baseline of
+// x86-64, so where the toolchain can select a clone when the library is loaded, the
+// functions running these kernels are also compiled for AVX2. FMA isn't enabled, so
+// both clones round identically.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define XLNT_SERIAL_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define XLNT_SERIAL_KERNEL
+#endif
+
+namespace xlnt {
+namespace detail {
+
+// The kernels below convert between serial numbers and date/time fields for a
+// block of values at a time. Each pass is a branch-free loop over plain arrays
+// so that the compiler can vectorise it, and each uses exactly the arithmetic of
+// date::from_number, date::to_number, time::from_number and time::to_number so
+// that the results are identical to converting the values one at a time.
+
+/// <summary>
+/// The number of values converted per block.
+/// </summary>
+constexpr std::size_t serial_block_size = 256;
+
+/// <summary>
+/// The fields of a block of dates and times, one array per field.
+/// </summary>
+struct serial_block
+{
+    int year[serial_block_size];
+    int month[serial_block_size];
+    int day[serial_block_size];
+    int hour[serial_block_size];
+    int minute[serial_block_size];
+    int second[serial_block_size];
+    int microsecond[serial_block_size];
+};
+
+/// <summary>
+/// Sets the date fields of the first count entries of block from days, a number
+/// of days since the start of base_date, exactly like date::from_number.
+/// </summary>
+inline void dates_from_serials(const int *days, std::size_t count, calendar base_date, serial_block &block)
+{
+    const int offset = base_date == calendar::mac_1904 ? 1462 : 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int serial = days[i] + offset;
+
+        // serial 60 is 1900-02-29, which doesn't exist but was kept for compatibility
+        // with Lotus 1-2-3, so serials before it are one day off
+        const bool phantom_leap_day = serial == 60;
+        serial += serial < 60 ? 1 : 0;
+
+        int l = serial + 68569 + 2415019;
+        int n = (4 * l) / 146097;
+        l = l - (146097 * n + 3) / 4;
+        int y = (4000 * (l + 1)) / 1461001;
+        l = l - (1461 * y) / 4 + 31;
+        int j = (80 * l) / 2447;
+        const int d = l - (2447 * j) / 80;
+        l = j / 11;
+        const int m = j + 2 - (12 * l);
+        y = 100 * (n - 49) + y + l;
+
+        block.year[i] = phantom_leap_day ? 1900 : y;
+        block.month[i] = phantom_leap_day ? 2 : m;
+        block.day[i] = phantom_leap_day ? 29 : d;
+    }
+}
+
+/// <summary>
+/// Sets the first count entries of days from the date fields of block, exactly
+/// like date::to_number.
+/// </summary>
+inline void serials_from_dates(const serial_block &block, std::size_t count, calendar base_date, int *days)
+{
+    const int offset = base_date == calendar::mac_1904 ? 1462 : 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const int year = block.year[i];
+        const int month = block.month[i];
+        const int day = block.day[i];
+        const bool phantom_leap_day = day == 29 && month == 2 && year == 1900;
+
+        int serial = ((1461 * (year + 4800 + (month - 14) / 12)) / 4)
+            + ((367 * (month - 2 - 12 * ((month - 14) / 12))) / 12)
+            - ((3 * ((year + 4900 + (month - 14) / 12) / 100)) / 4) + day - 2415019 - 32075;
+        serial -= serial <= 60 ? 1 : 0;
+
+        days[i] = phantom_leap_day ? 60 : serial - offset;
+    }
+}
+
+/// <summary>
+/// Sets the time fields of the first count entries of block from the fractional
+/// part of numbers, exactly like time::from_number. numbers must be finite.
+/// </summary>
+inline void times_from_serials(const double *numbers, std::size_t count, serial_block &block)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // x - trunc(x) is exact, so this is the fractional part std::modf returns
+        double fractional_part = numbers[i] - std::trunc(numbers[i]);
+
+        fractional_part *= 24;
+        int hour = static_cast<int>(fractional_part);
+        fractional_part = 60 * (fractional_part - hour);
+        int minute = static_cast<int>(fractional_part);
+        fractional_part = 60 * (fractional_part - minute);
+        int second = static_cast<int>(fractional_part);
+        fractional_part = 1000000 * (fractional_part - second);
+        int microsecond = static_cast<int>(fractional_part);
+
+        const bool carry = microsecond == 999999 && fractional_part - microsecond > 0.5;
+        microsecond = carry ? 0 : microsecond;
+        second += carry ? 1 : 0;
+        const bool second_carry = carry && second == 60;
+        second = second_carry ? 0 : second;
+        minute += second_carry ? 1 : 0;
+        const bool minute_carry = second_carry && minute == 60;
+        minute = minute_carry ? 0 : minute;
+        hour += minute_carry ? 1 : 0;
+
+        block.hour[i] = hour;
+        block.minute[i] = minute;
+        block.second[i] = second;
+        block.microsecond[i] = microsecond;
+    }
+}
+
+/// <summary>
+/// Sets the first count entries of fractions from the time fields of block,
+/// exactly like time::to_number for fields which aren't negative.
+/// </summary>
+inline void fractions_from_times(const serial_block &block, std::size_t count, double *fractions)
+{
+    const auto microseconds_per_hour = static_cast<std::uint64_t>(1e6) * 60 * 60;
+    const auto microseconds_per_day = 24.0 * static_cast<double>(microseconds_per_hour);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // time::to_number sums the microseconds as integers and converts the total to
+        // double. Each term and the sum are integers well below 2^53, so summing them
+        // as doubles is exact and gives the same value without 64-bit conversions.
+        const auto microseconds = static_cast<double>(block.microsecond[i])
+            + block.second[i] * 1e6
+            + block.minute[i] * 1e6 * 60
+            + static_cast<double>(block.hour[i]) * static_cast<double>(microseconds_per_hour);
+        auto number = microseconds / microseconds_per_day;
+        fractions[i] = std::floor(number * 100e9 + 0.5) / 100e9;
+    }
+}
+
+/// <summary>
+/// Sets the first count entries of days from the date fields of block as a number
+/// of days since 1970-01-01 in the proleptic Gregorian calendar.
+/// </summary>
+inline void unix_days_from_dates(const serial_block &block, std::size_t count, std::int64_t *days)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const int year = block.year[i];
+        const int month = block.month[i];
+
+        // the Julian day number, as in date::to_number
+        const int julian_day = ((1461 * (year + 4800 + (month - 14) / 12)) / 4)
+            + ((367 * (month - 2 - 12 * ((month - 14) / 12))) / 12)
+            - ((3 * ((year + 4900 + (month - 14) / 12) / 100)) / 4) + block.day[i] - 32075;
+
+        days[i] = julian_day - 2440588;
+    }
+}
+
+/// <summary>
+/// Sets the date fields of the first count entries of block from days since
+/// 1970-01-01 in the proleptic Gregorian calendar.
+/// </summary>
+inline void dates_from_unix_days(const std::int64_t *days, std::size_t count, serial_block &block)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // the inverse of the Julian day number, as in date::from_number
+        int l = static_cast<int>(days[i]) + 2440588 + 68569;
+        int n = (4 * l) / 146097;
+        l = l - (146097 * n + 3) / 4;
+        int y = (4000 * (l + 1)) / 1461001;
+        l = l - (1461 * y) / 4 + 31;
+        int j = (80 * l) / 2447;
+        block.day[i] = l - (2447 * j) / 80;
+        l = j / 11;
+        block.month[i] = j + 2 - (12 * l);
+        block.year[i] = 100 * (n - 49) + y + l;
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -28,28 +28,17 @@ struct Cell_Reference
     }
 
     // the common case. row # is already known during parsing (from parent <row> element)
-    // just need to evaluate the column
-    explicit Cell_Reference(xlnt::row_t row_arg, const std::string &reference) noexcept
+    // just need to evaluate the column from the leading letters
+    explicit Cell_Reference(xlnt::row_t row_arg, const std::string &reference)
         : row(row_arg)
     {
-        // only three characters allowed for the column
-        // assumption:
-        // - regex pattern match: [A-Z]{1,3}\d{1,7}
-        const char *iter = reference.c_str();
-        int temp = *iter - 'A' + 1; // 'A' == 1
-        ++iter;
-        if (*iter >= 'A') // second char
+        const char *first = reference.data();
+        const char *last = first;
+        while (*last >= 'A') // letters come before digits and the terminating null
         {
-            temp *= 26; // LHS values are more significant
-            temp += *iter - 'A' + 1; // 'A' == 1
-            ++iter;
-            if (*iter >= 'A') // third char
-            {
-                temp *= 26; // LHS values are more significant
-                temp += *iter - 'A' + 1; // 'A' == 1
-            }
+            ++last;
         }
-        column = static_cast<xlnt::column_t::index_t>(temp);
+        column = xlnt::column_t::column_index_from_chars(first, last);
     }
 
     // for sorting purposes
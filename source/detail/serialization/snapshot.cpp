@@ -0,0 +1,790 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <detail/implementations/rich_text_access.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/snapshot.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/xlsx_producer.hpp>
+
+namespace {
+
+// A snapshot is a header, sections and a trailer. Each section is a kind and a size
+// followed by its content, padded so that the next section starts on eight bytes.
+// Numbers are in the byte order of the machine which wrote them, which is checked.
+
+const char snapshot_magic[8] = {'X', 'L', 'N', 'T', 'S', 'N', 'A', 'P'};
+const std::uint32_t snapshot_version = 1;
+const std::uint32_t byte_order_mark = 0x01020304;
+
+struct snapshot_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+};
+
+struct snapshot_trailer
+{
+    std::uint64_t payload_size;
+    std::uint64_t checksum;
+    std::uint32_t section_count;
+    std::uint32_t reserved;
+};
+
+struct section_header
+{
+    std::uint32_t kind;
+    std::uint32_t reserved;
+    std::uint64_t size;
+};
+
+enum section_kind : std::uint32_t
+{
+    skeleton_section = 1,
+    shared_strings_section = 2,
+    cells_section = 3
+};
+
+// How the text of a string or cell is stored. Kept text has runs or phonetics, so it
+// is left in the skeleton, which already knows how to write and read those.
+enum text_kind : std::uint8_t
+{
+    no_text,
+    plain_text,
+    preserved_text,
+    kept_text
+};
+
+struct string_record
+{
+    std::uint64_t text_offset;
+    std::uint32_t text_size;
+    std::uint8_t kind;
+    std::uint8_t reserved[3];
+};
+
+enum cell_flags : std::uint8_t
+{
+    merged_flag = 1,
+    phonetics_visible_flag = 2,
+    formula_flag = 4,
+    skeleton_flag = 8
+};
+
+struct cell_record
+{
+    std::uint32_t column;
+    std::uint32_t row;
+    std::uint32_t format;
+    std::uint8_t type;
+    std::uint8_t flags;
+    std::uint8_t text;
+    std::uint8_t reserved;
+    double numeric;
+    std::uint64_t text_offset;
+    std::uint32_t text_size;
+    std::uint32_t formula_size;
+};
+
+enum row_flags : std::uint16_t
+{
+    height_flag = 1,
+    dy_descent_flag = 2,
+    custom_height_flag = 4,
+    hidden_flag = 8,
+    custom_format_set_flag = 16,
+    custom_format_flag = 32,
+    style_flag = 64,
+    spans_flag = 128
+};
+
+struct row_record
+{
+    std::uint32_t row;
+    std::uint16_t flags;
+    std::uint16_t reserved;
+    std::uint32_t style;
+    std::uint32_t spans_size;
+    double height;
+    double dy_descent;
+    std::uint64_t spans_offset;
+};
+
+static_assert(sizeof(snapshot_header) == 16, "snapshot_header must have no padding");
+static_assert(sizeof(snapshot_trailer) == 24, "snapshot_trailer must have no padding");
+static_assert(sizeof(section_header) == 16, "section_header must have no padding");
+static_assert(sizeof(string_record) == 16, "string_record must have no padding");
+static_assert(sizeof(cell_record) == 40, "cell_record must have no padding");
+static_assert(sizeof(row_record) == 40, "row_record must have no padding");
+
+const std::uint32_t no_format = std::numeric_limits<std::uint32_t>::max();
+
+std::size_t padded(std::size_t size)
+{
+    return (size + 7) & ~std::size_t(7);
+}
+
+template <typename T>
+void put(std::vector<std::uint8_t> &buffer, const T &value)
+{
+    const auto size = buffer.size();
+    buffer.resize(size + sizeof(T));
+    std::memcpy(buffer.data() + size, &value, sizeof(T));
+}
+
+void put_bytes(std::vector<std::uint8_t> &buffer, const std::string &bytes)
+{
+    buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+}
+
+void pad(std::vector<std::uint8_t> &buffer)
+{
+    buffer.resize(padded(buffer.size()), 0);
+}
+
+const std::uint64_t checksum_basis = 14695981039346656037ULL;
+
+// FNV-1a taken a word rather than a byte at a time, which keeps checking a large
+// snapshot well under the time it takes to read it. size is a multiple of eight.
+std::uint64_t checksum(std::uint64_t hash, const std::uint8_t *data, std::size_t size)
+{
+    for (auto offset = std::size_t(0); offset < size; offset += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+void invalid_snapshot()
+{
+    throw xlnt::invalid_file("snapshot is corrupt or was written by another version");
+}
+
+// Reads the size bytes at data as a sequence of values, checking that each fits.
+class snapshot_reader
+{
+public:
+    snapshot_reader(const std::uint8_t *data, std::size_t size)
+        : data_(data), size_(size)
+    {
+    }
+
+    template <typename T>
+    T get()
+    {
+        T value;
+        std::memcpy(&value, bytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    const std::uint8_t *bytes(std::size_t count)
+    {
+        if (count > size_ - position_) invalid_snapshot();
+
+        const auto result = data_ + position_;
+        position_ += count;
+
+        return result;
+    }
+
+    void align()
+    {
+        position_ = std::min(padded(position_), size_);
+    }
+
+private:
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::size_t position_ = 0;
+};
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+// Classifies text by how it is stored rather than how it looks so that it reads back identically
+std::uint8_t snapshot_producer::text_kind_of(const rich_text &text)
+{
+    if (rich_text_access::has_phonetics(text)) return kept_text;
+    if (rich_text_access::is_empty(text)) return no_text;
+    if (!rich_text_access::is_plain(text)) return kept_text;
+
+    return rich_text_access::plain_preserve_space(text) ? preserved_text : plain_text;
+}
+
+bool snapshot_producer::kept_in_skeleton(const cell_impl &cell)
+{
+    return cell.comment_.is_set() || cell.hyperlink_.is_set() || text_kind_of(cell.value_text_) == kept_text;
+}
+
+void snapshot_consumer::set_text(rich_text &text, std::uint8_t kind, const std::uint8_t *data, std::size_t size)
+{
+    rich_text_access::plain_text(text).assign(reinterpret_cast<const char *>(data), size);
+    rich_text_access::plain_preserve_space(text) = kind == preserved_text;
+    rich_text_access::make_plain(text);
+}
+
+snapshot_producer::snapshot_producer(const workbook &source)
+    : source_(source)
+{
+}
+
+void snapshot_producer::write(std::ostream &destination)
+{
+    destination_ = &destination;
+    checksum_ = checksum_basis;
+
+    snapshot_header header;
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.byte_order = byte_order_mark;
+    destination.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    const auto &wb = *source_.d_;
+    auto section_count = std::uint32_t(0);
+    std::vector<std::uint8_t> section;
+
+    write_skeleton(section);
+    write_section(skeleton_section, section);
+    ++section_count;
+
+    section.clear();
+    std::string text;
+    put(section, static_cast<std::uint64_t>(wb.shared_strings_values_.size()));
+
+    for (const auto &value : wb.shared_strings_values_)
+    {
+        string_record record{};
+        record.kind = text_kind_of(value);
+
+        if (record.kind == plain_text || record.kind == preserved_text)
+        {
+            record.text_offset = text.size();
+            record.text_size = static_cast<std::uint32_t>(rich_text_access::plain_text(value).size());
+            text.append(rich_text_access::plain_text(value));
+        }
+
+        put(section, record);
+    }
+
+    put_bytes(section, text);
+    write_section(shared_strings_section, section);
+    ++section_count;
+
+    // formats are written by their position in the stylesheet, which is kept by the skeleton
+    std::unordered_map<const format_impl *, std::uint32_t> format_ids;
+
+    if (wb.stylesheet_.is_set())
+    {
+        for (const auto &format : wb.stylesheet_.get().format_impls)
+        {
+            format_ids.emplace(&format, static_cast<std::uint32_t>(format_ids.size()));
+        }
+    }
+
+    for (const auto &ws : wb.worksheets_)
+    {
+        section.clear();
+        text.clear();
+
+        put(section, static_cast<std::uint64_t>(ws.title_.size()));
+        put(section, static_cast<std::uint64_t>(ws.cell_count()));
+        put(section, static_cast<std::uint64_t>(ws.row_properties_.size()));
+        put_bytes(section, ws.title_);
+        pad(section);
+
+        ws.for_each_cell([&](const cell_impl &cell) {
+            cell_record record{};
+            record.column = cell.column_.index;
+            record.row = cell.row_;
+            record.format = cell.format_.is_set() ? format_ids.at(cell.format_.get()) : no_format;
+            record.type = static_cast<std::uint8_t>(cell.type_);
+            record.text = text_kind_of(cell.value_text_);
+            record.numeric = cell.value_numeric_;
+            record.text_offset = text.size();
+
+            if (cell.is_merged_) record.flags |= merged_flag;
+            if (cell.phonetics_visible_) record.flags |= phonetics_visible_flag;
+            if (kept_in_skeleton(cell)) record.flags |= skeleton_flag;
+
+            if (record.text == plain_text || record.text == preserved_text)
+            {
+                record.text_size = static_cast<std::uint32_t>(rich_text_access::plain_text(cell.value_text_).size());
+                text.append(rich_text_access::plain_text(cell.value_text_));
+            }
+
+            if (cell.formula_.is_set())
+            {
+                record.flags |= formula_flag;
+                record.formula_size = static_cast<std::uint32_t>(cell.formula_.get().size());
+                text.append(cell.formula_.get());
+            }
+
+            put(section, record);
+        });
+
+        // row properties are written here too, as the skeleton would write a row for each
+        for (const auto &properties : ws.row_properties_)
+        {
+            const auto &row = properties.second;
+
+            row_record record{};
+            record.row = properties.first;
+            record.height = row.height.is_set() ? row.height.get() : 0;
+            record.dy_descent = row.dy_descent.is_set() ? row.dy_descent.get() : 0;
+            record.style = row.style.is_set() ? static_cast<std::uint32_t>(row.style.get()) : 0;
+            record.spans_offset = text.size();
+
+            if (row.height.is_set()) record.flags |= height_flag;
+            if (row.dy_descent.is_set()) record.flags |= dy_descent_flag;
+            if (row.custom_height) record.flags |= custom_height_flag;
+            if (row.hidden) record.flags |= hidden_flag;
+            if (row.custom_format.is_set()) record.flags |= custom_format_set_flag;
+            if (row.custom_format.is_set() && row.custom_format.get()) record.flags |= custom_format_flag;
+            if (row.style.is_set()) record.flags |= style_flag;
+
+            if (row.spans.is_set())
+            {
+                record.flags |= spans_flag;
+                record.spans_size = static_cast<std::uint32_t>(row.spans.get().size());
+                text.append(row.spans.get());
+            }
+
+            put(section, record);
+        }
+
+        put_bytes(section, text);
+        write_section(cells_section, section);
+        ++section_count;
+    }
+
+    snapshot_trailer trailer{};
+    trailer.payload_size = payload_size_;
+    trailer.checksum = checksum_;
+    trailer.section_count = section_count;
+    destination.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+}
+
+void snapshot_producer::write_section(std::uint32_t kind, std::vector<std::uint8_t> &content)
+{
+    section_header header{};
+    header.kind = kind;
+    header.size = content.size();
+
+    pad(content);
+
+    auto append = [this](const std::uint8_t *data, std::size_t size) {
+        destination_->write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+        checksum_ = checksum(checksum_, data, size);
+        payload_size_ += size;
+    };
+
+    append(reinterpret_cast<const std::uint8_t *>(&header), sizeof(header));
+    append(content.data(), content.size());
+}
+
+void snapshot_producer::write_skeleton(std::vector<std::uint8_t> &package)
+{
+    // the package is written from a copy of the workbook which has everything but the
+    // cells, rows and strings stored in the snapshot, so that source_ is only ever read
+    const auto &wb = *source_.d_;
+
+    workbook skeleton(new workbook_impl());
+    auto &copy = *skeleton.d_;
+
+    copy.active_sheet_index_ = wb.active_sheet_index_;
+    copy.font_pool_ = wb.font_pool_;
+    copy.stylesheet_ = wb.stylesheet_;
+    copy.base_date_ = wb.base_date_;
+    copy.title_ = wb.title_;
+    copy.manifest_ = wb.manifest_;
+    copy.theme_ = wb.theme_;
+    copy.images_ = wb.images_;
+    copy.core_properties_ = wb.core_properties_;
+    copy.extended_properties_ = wb.extended_properties_;
+    copy.custom_properties_ = wb.custom_properties_;
+    copy.sheet_title_rel_id_map_ = wb.sheet_title_rel_id_map_;
+    copy.sheet_hidden_ = wb.sheet_hidden_;
+    copy.view_ = wb.view_;
+    copy.code_name_ = wb.code_name_;
+    copy.file_version_ = wb.file_version_;
+    copy.calculation_properties_ = wb.calculation_properties_;
+    copy.abs_path_ = wb.abs_path_;
+    copy.arch_id_flags_ = wb.arch_id_flags_;
+    copy.extensions_ = wb.extensions_;
+
+    std::unordered_map<const worksheet_impl *, worksheet_impl *> copied_sheets;
+
+    for (const auto &ws : wb.worksheets_)
+    {
+        copy.worksheets_.emplace_back(&skeleton, ws.id_, ws.title_);
+        auto &sheet = copy.worksheets_.back();
+        sheet.copy_properties(ws);
+        sheet.parent_ = &skeleton;
+        sheet.comments_ = ws.comments_;
+        sheet.drawing_rel_id_ = ws.drawing_rel_id_;
+        sheet.drawing_ = ws.drawing_;
+        copied_sheets[&ws] = &sheet;
+
+        ws.for_each_cell([&wb, &sheet](const cell_impl &cell) {
+            if (!kept_in_skeleton(cell)) return;
+
+            // values are kept as they are read back into the display text of hyperlinks, but
+            // shared strings become inline as they aren't in the skeleton's shared string table
+            auto kept = cell;
+            kept.parent_ = &sheet;
+            kept.is_merged_ = false;
+            kept.phonetics_visible_ = false;
+            kept.formula_.clear();
+            kept.format_.clear();
+
+            if (cell.type_ == cell_type::shared_string)
+            {
+                kept.type_ = cell_type::inline_string;
+                kept.value_text_ = wb.shared_strings_values_.at(static_cast<std::size_t>(cell.value_numeric_));
+            }
+            else if (cell.type_ == cell_type::empty)
+            {
+                // a placeholder value makes sure that a cell with only a comment is written
+                kept.type_ = cell_type::number;
+                kept.value_numeric_ = 0;
+                kept.value_text_.clear();
+
+                if (cell.hyperlink_.is_set() && cell.hyperlink_.get().display.is_set())
+                {
+                    kept.type_ = cell_type::inline_string;
+                    kept.value_text_.plain_text(cell.hyperlink_.get().display.get(), false);
+                }
+            }
+
+            sheet.cell_map_.emplace(cell_reference(cell.column_, cell.row_), kept);
+        });
+    }
+
+    if (copy.stylesheet_.is_set())
+    {
+        auto &styles = copy.stylesheet_.get();
+        styles.parent = &skeleton;
+
+        for (auto &format : styles.format_impls)
+        {
+            format.parent = &styles;
+        }
+
+        for (auto &style : styles.style_impls)
+        {
+            style.second.parent = &styles;
+        }
+
+        for (auto &rule : styles.conditional_format_impls)
+        {
+            rule.parent = &styles;
+            auto match = copied_sheets.find(rule.target_sheet);
+            rule.target_sheet = match == copied_sheets.end() ? nullptr : match->second;
+        }
+    }
+
+    // every kept string is written to the shared string table, in order
+    for (const auto &value : wb.shared_strings_values_)
+    {
+        if (text_kind_of(value) == kept_text)
+        {
+            copy.shared_strings_values_.push_back(value);
+        }
+    }
+
+    copy.default_string_storage_ = string_storage::shared;
+
+    vector_ostreambuf package_buffer(package);
+    std::ostream package_stream(&package_buffer);
+    xlsx_producer producer(skeleton);
+    producer.write(package_stream);
+}
+
+snapshot_consumer::snapshot_consumer(workbook &target)
+    : target_(target)
+{
+}
+
+void snapshot_consumer::read(const std::uint8_t *data, std::size_t size)
+{
+    if (size < sizeof(snapshot_header) + sizeof(snapshot_trailer)) invalid_snapshot();
+
+    snapshot_header header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0
+        || header.version != snapshot_version || header.byte_order != byte_order_mark)
+    {
+        invalid_snapshot();
+    }
+
+    snapshot_trailer trailer;
+    std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+
+    const auto payload = data + sizeof(header);
+    const auto payload_size = size - sizeof(header) - sizeof(trailer);
+
+    if (trailer.payload_size != payload_size
+        || payload_size % sizeof(std::uint64_t) != 0
+        || checksum(checksum_basis, payload, payload_size) != trailer.checksum)
+    {
+        invalid_snapshot();
+    }
+
+    snapshot_reader sections(payload, payload_size);
+
+    for (auto index = std::uint32_t(0); index < trailer.section_count; ++index)
+    {
+        const auto section = sections.get<section_header>();
+        const auto content = sections.bytes(static_cast<std::size_t>(section.size));
+        sections.align();
+
+        if (index == 0)
+        {
+            if (section.kind != skeleton_section) invalid_snapshot();
+            target_.load(std::vector<std::uint8_t>(content, content + section.size));
+        }
+        else if (section.kind == shared_strings_section)
+        {
+            read_shared_strings(content, static_cast<std::size_t>(section.size));
+        }
+        else if (section.kind == cells_section)
+        {
+            read_cells(content, static_cast<std::size_t>(section.size));
+        }
+    }
+}
+
+void snapshot_consumer::read_shared_strings(const std::uint8_t *data, std::size_t size)
+{
+    auto &wb = *target_.d_;
+    snapshot_reader reader(data, size);
+
+    const auto count = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    if (count > size / sizeof(string_record)) invalid_snapshot();
+
+    const auto records = reader.bytes(count * sizeof(string_record));
+    const auto text = records + count * sizeof(string_record);
+    const auto text_size = static_cast<std::size_t>(data + size - text);
+
+    // strings with runs were read with the skeleton and are merged back in order
+    std::vector<rich_text> kept;
+    std::swap(kept, wb.shared_strings_values_);
+    auto next_kept = kept.begin();
+
+    std::vector<rich_text> values(count);
+
+    for (auto index = std::size_t(0); index < count; ++index)
+    {
+        string_record record;
+        std::memcpy(&record, records + index * sizeof(string_record), sizeof(record));
+
+        if (record.kind == kept_text)
+        {
+            if (next_kept == kept.end()) invalid_snapshot();
+            values[index] = *next_kept++;
+        }
+        else if (record.kind != no_text)
+        {
+            if (record.text_offset > text_size || record.text_size > text_size - record.text_offset) invalid_snapshot();
+            set_text(values[index], record.kind, text + record.text_offset, record.text_size);
+        }
+    }
+
+    wb.shared_strings_values_ = std::move(values);
+    wb.shared_strings_ids_.clear();
+    wb.shared_strings_indexed_ = 0;
+}
+
+void snapshot_consumer::read_cells(const std::uint8_t *data, std::size_t size)
+{
+    auto &wb = *target_.d_;
+    snapshot_reader reader(data, size);
+
+    const auto title_size = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    const auto count = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    const auto row_count = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    const auto title_data = reader.bytes(title_size);
+    const auto title = std::string(reinterpret_cast<const char *>(title_data), title_size);
+    reader.align();
+
+    if (count > size / sizeof(cell_record) || row_count > size / sizeof(row_record)) invalid_snapshot();
+
+    const auto records = reader.bytes(count * sizeof(cell_record));
+    const auto rows = reader.bytes(row_count * sizeof(row_record));
+    const auto text = rows + row_count * sizeof(row_record);
+    const auto text_size = static_cast<std::size_t>(data + size - text);
+
+    auto match = std::find_if(wb.worksheets_.begin(), wb.worksheets_.end(),
+        [&title](const worksheet_impl &ws) { return ws.title_ == title; });
+    if (match == wb.worksheets_.end()) invalid_snapshot();
+    auto &ws = *match;
+
+    std::vector<format_impl *> formats;
+
+    if (wb.stylesheet_.is_set())
+    {
+        for (auto &format : wb.stylesheet_.get().format_impls)
+        {
+            formats.push_back(&format);
+        }
+    }
+
+    // the cells read with the skeleton hold the comments, hyperlinks and formatted text
+    // of their records and are merged into them
+    ws.page_in_all();
+    auto skeleton_cells = std::move(ws.cell_map_);
+    ws.cell_map_.clear();
+
+    if (ws.pager_)
+    {
+        ws.pager_->reindex(ws);
+    }
+    else
+    {
+        ws.cell_map_.reserve(count + skeleton_cells.size());
+    }
+
+    ws.formula_count_ = 0;
+
+    for (auto index = std::size_t(0); index < count; ++index)
+    {
+        cell_record record;
+        std::memcpy(&record, records + index * sizeof(cell_record), sizeof(record));
+
+        const auto text_end = record.text_offset + record.text_size + record.formula_size;
+        if (record.text_offset > text_size || text_end > text_size || text_end < record.text_offset) invalid_snapshot();
+        if (record.format != no_format && record.format >= formats.size()) invalid_snapshot();
+
+        // cells are built where they are stored, as moving one copies its text
+        const auto reference = cell_reference(column_t(record.column), record.row);
+        auto &cell = ws.cell_map_.emplace(std::piecewise_construct,
+            std::forward_as_tuple(reference), std::forward_as_tuple()).first->second;
+
+        cell.parent_ = &ws;
+        cell.column_ = column_t(record.column);
+        cell.row_ = record.row;
+        cell.type_ = static_cast<cell_type>(record.type);
+        cell.value_numeric_ = record.numeric;
+        cell.is_merged_ = (record.flags & merged_flag) != 0;
+        cell.phonetics_visible_ = (record.flags & phonetics_visible_flag) != 0;
+
+        if (record.text == plain_text || record.text == preserved_text)
+        {
+            set_text(cell.value_text_, record.text, text + record.text_offset, record.text_size);
+        }
+
+        if ((record.flags & formula_flag) != 0)
+        {
+            const auto formula = text + record.text_offset + record.text_size;
+            cell.formula_ = std::string(reinterpret_cast<const char *>(formula), record.formula_size);
+            ++ws.formula_count_;
+        }
+
+        if (record.format != no_format)
+        {
+            cell.format_ = formats[record.format];
+        }
+
+        auto kept = skeleton_cells.empty() ? skeleton_cells.end() : skeleton_cells.find(reference);
+
+        if ((record.flags & skeleton_flag) != 0 && kept == skeleton_cells.end())
+        {
+            invalid_snapshot();
+        }
+
+        if (kept != skeleton_cells.end())
+        {
+            cell.hyperlink_ = kept->second.hyperlink_;
+            cell.comment_ = kept->second.comment_;
+
+            if (record.text == kept_text)
+            {
+                cell.value_text_ = kept->second.value_text_;
+            }
+
+            skeleton_cells.erase(kept);
+        }
+
+        if (ws.pager_)
+        {
+            ws.pager_->added(ws, reference);
+        }
+    }
+
+    // cells the skeleton added by itself, such as those of merged ranges, stay as they were read
+    for (auto &cell : skeleton_cells)
+    {
+        ws.cell_map_.emplace(cell.first, std::move(cell.second));
+
+        if (ws.pager_)
+        {
+            ws.pager_->added(ws, cell.first);
+        }
+    }
+
+    ws.row_properties_.clear();
+    ws.row_properties_.reserve(row_count);
+
+    for (auto index = std::size_t(0); index < row_count; ++index)
+    {
+        row_record record;
+        std::memcpy(&record, rows + index * sizeof(row_record), sizeof(record));
+
+        if (record.spans_offset > text_size || record.spans_size > text_size - record.spans_offset) invalid_snapshot();
+
+        row_properties row;
+        row.custom_height = (record.flags & custom_height_flag) != 0;
+        row.hidden = (record.flags & hidden_flag) != 0;
+
+        if ((record.flags & height_flag) != 0) row.height = record.height;
+        if ((record.flags & dy_descent_flag) != 0) row.dy_descent = record.dy_descent;
+        if ((record.flags & custom_format_set_flag) != 0) row.custom_format = (record.flags & custom_format_flag) != 0;
+        if ((record.flags & style_flag) != 0) row.style = static_cast<std::size_t>(record.style);
+
+        if ((record.flags & spans_flag) != 0)
+        {
+            row.spans = std::string(reinterpret_cast<const char *>(text + record.spans_offset), record.spans_size);
+        }
+
+        ws.row_properties_.emplace(record.row, std::move(row));
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,108 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace xlnt {
+
+class rich_text;
+class workbook;
+
+namespace detail {
+
+struct cell_impl;
+
+/// <summary>
+/// Writes a workbook as a snapshot, the native binary format read by snapshot_consumer.
+/// A snapshot holds everything but the cells and plain shared strings as an XLSX package
+/// without cells, then the strings and the cells of each worksheet as fixed-size records
+/// followed by the text they refer to, so that they can be read back without parsing.
+/// </summary>
+class snapshot_producer
+{
+public:
+    snapshot_producer(const workbook &source);
+
+    void write(std::ostream &destination);
+
+private:
+    /// <summary>
+    /// Writes a copy of source_ without cells or plain shared strings into package. Cells
+    /// which have a comment, a hyperlink or formatted text are kept so that those are too.
+    /// </summary>
+    void write_skeleton(std::vector<std::uint8_t> &package);
+
+    /// <summary>
+    /// Pads content and writes it as one section, updating the running checksum.
+    /// </summary>
+    void write_section(std::uint32_t kind, std::vector<std::uint8_t> &content);
+
+    /// <summary>
+    /// Returns whether text is stored plainly, and so in the snapshot, or is kept in the skeleton.
+    /// </summary>
+    static std::uint8_t text_kind_of(const rich_text &text);
+
+    /// <summary>
+    /// Returns true if cell has anything which only the skeleton can hold.
+    /// </summary>
+    static bool kept_in_skeleton(const cell_impl &cell);
+
+    const workbook &source_;
+    std::ostream *destination_ = nullptr;
+    std::uint64_t payload_size_ = 0;
+    std::uint64_t checksum_ = 0;
+};
+
+/// <summary>
+/// Reads a snapshot written by snapshot_producer into a workbook.
+/// </summary>
+class snapshot_consumer
+{
+public:
+    snapshot_consumer(workbook &target);
+
+    /// <summary>
+    /// Replaces the content of the target with the snapshot in the size bytes at data,
+    /// throwing invalid_file if they aren't a snapshot of this version or are corrupt.
+    /// </summary>
+    void read(const std::uint8_t *data, std::size_t size);
+
+private:
+    void read_shared_strings(const std::uint8_t *data, std::size_t size);
+
+    void read_cells(const std::uint8_t *data, std::size_t size);
+
+    /// <summary>
+    /// Sets text to the plain string in the size bytes at data.
+    /// </summary>
+    static void set_text(rich_text &text, std::uint8_t kind, const std::uint8_t *data, std::size_t size);
+
+    workbook &target_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,946 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <unordered_set>
+
+#include <xlnt/packaging/manifest.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/calculation_properties.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/workbook/workbook_view.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+#include <detail/implementations/cell_pager.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/xlsb_consumer.hpp>
+#include <detail/serialization/xlsb_records.hpp>
+#include <detail/serialization/zstream.hpp>
+
+namespace {
+
+xlnt::border_style border_style_from_code(std::uint16_t code)
+{
+    using xlnt::border_style;
+
+    static const border_style styles[] = {border_style::none, border_style::thin, border_style::medium,
+        border_style::dashed, border_style::dotted, border_style::thick, border_style::double_,
+        border_style::hair, border_style::mediumdashed, border_style::dashdot, border_style::mediumdashdot,
+        border_style::dashdotdot, border_style::mediumdashdotdot, border_style::slantdashdot};
+
+    return code < sizeof(styles) / sizeof(styles[0]) ? styles[code] : border_style::none;
+}
+
+xlnt::font::underline_style underline_from_code(std::uint8_t code)
+{
+    using underline = xlnt::font::underline_style;
+
+    switch (code)
+    {
+    case 0x01: return underline::single;
+    case 0x02: return underline::double_;
+    case 0x21: return underline::single_accounting;
+    case 0x22: return underline::double_accounting;
+    default: return underline::none;
+    }
+}
+
+/// <summary>
+/// Decodes an RkNumber, an integer or the upper 30 bits of a double, optionally
+/// divided by 100.
+/// </summary>
+double rk_value(std::uint32_t rk)
+{
+    auto value = 0.0;
+
+    if ((rk & 0x02) != 0)
+    {
+        value = static_cast<double>(static_cast<std::int32_t>(rk & 0xFFFFFFFC) / 4);
+    }
+    else
+    {
+        const auto bits = static_cast<std::uint64_t>(rk & 0xFFFFFFFC) << 32;
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+
+    return (rk & 0x01) != 0 ? value / 100 : value;
+}
+
+/// <summary>
+/// Returns the XLSX content type of the part of an XLSB package with the given
+/// content type, or an empty string for parts which are the same in both.
+/// </summary>
+std::string xlsx_content_type(const std::string &xlsb_type)
+{
+    using namespace xlnt::detail;
+
+    if (xlsb_type == xlsb_workbook_content_type)
+    {
+        return "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml";
+    }
+    else if (xlsb_type == xlsb_worksheet_content_type)
+    {
+        return "application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml";
+    }
+    else if (xlsb_type == xlsb_styles_content_type)
+    {
+        return "application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml";
+    }
+    else if (xlsb_type == xlsb_shared_strings_content_type)
+    {
+        return "application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml";
+    }
+
+    return std::string();
+}
+
+/// <summary>
+/// Returns the path of the XML part read from the binary part at part.
+/// </summary>
+xlnt::path xml_part(const xlnt::path &part)
+{
+    const auto name = part.string();
+
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0)
+    {
+        return xlnt::path(name.substr(0, name.size() - 4) + ".xml");
+    }
+
+    return part;
+}
+
+/// <summary>
+/// The fields of a BrtXF which are kept in a format_impl, with the index of its parent.
+/// </summary>
+struct xf_record
+{
+    xlnt::detail::format_impl format;
+    std::size_t parent;
+};
+
+xf_record read_xf(xlnt::detail::xlsb_record_reader &reader, xlnt::detail::stylesheet &stylesheet)
+{
+    xf_record record;
+
+    record.parent = reader.read_u16();
+    record.format.number_format_id = static_cast<std::size_t>(reader.read_u16());
+    record.format.font_id = static_cast<std::size_t>(reader.read_u16());
+    record.format.fill_id = static_cast<std::size_t>(reader.read_u16());
+    record.format.border_id = static_cast<std::size_t>(reader.read_u16());
+
+    const auto rotation = reader.read_u8();
+    const auto indent = reader.read_u8();
+    const auto flags = reader.read_u16();
+    const auto applied = reader.read_u16();
+
+    record.format.number_format_applied = (applied & 0x01) != 0;
+    record.format.font_applied = (applied & 0x02) != 0;
+    record.format.alignment_applied = (applied & 0x04) != 0;
+    record.format.border_applied = (applied & 0x08) != 0;
+    record.format.fill_applied = (applied & 0x10) != 0;
+    record.format.protection_applied = (applied & 0x20) != 0;
+    record.format.pivot_button_ = (flags & 0x4000) != 0;
+    record.format.quote_prefix_ = (flags & 0x8000) != 0;
+
+    const auto horizontal = flags & 0x07;
+    const auto vertical = (flags >> 3) & 0x07;
+    const auto wrap = (flags & 0x40) != 0;
+    const auto shrink = (flags & 0x100) != 0;
+
+    // an alignment is only kept when it's applied or differs from the default, as in XLSX
+    if (record.format.alignment_applied.get() || rotation != 0 || indent != 0 || horizontal != 0
+        || vertical != 2 || wrap || shrink)
+    {
+        xlnt::alignment new_alignment;
+
+        if (rotation != 0) new_alignment.rotation(rotation);
+        if (indent != 0) new_alignment.indent(indent);
+        if (horizontal != 0) new_alignment.horizontal(static_cast<xlnt::horizontal_alignment>(horizontal));
+        if (vertical != 2) new_alignment.vertical(static_cast<xlnt::vertical_alignment>(vertical));
+        new_alignment.wrap(wrap);
+        new_alignment.shrink(shrink);
+
+        record.format.alignment_id = stylesheet.alignments.size();
+        stylesheet.alignments.push_back(new_alignment);
+    }
+
+    const auto locked = (flags & 0x1000) != 0;
+    const auto hidden = (flags & 0x2000) != 0;
+
+    if (record.format.protection_applied.get() || !locked || hidden)
+    {
+        xlnt::protection new_protection;
+        new_protection.locked(locked);
+        new_protection.hidden(hidden);
+
+        record.format.protection_id = stylesheet.protections.size();
+        stylesheet.protections.push_back(new_protection);
+    }
+
+    return record;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+xlsb_consumer::xlsb_consumer(workbook &target, izstream &archive)
+    : target_(target),
+      archive_(archive)
+{
+}
+
+bool xlsb_consumer::is_xlsb(const class manifest &manifest)
+{
+    if (!manifest.has_relationship(path("/"), relationship_type::office_document))
+    {
+        return false;
+    }
+
+    const auto workbook_part = manifest.relationship(path("/"), relationship_type::office_document)
+                                   .target()
+                                   .path()
+                                   .resolve(path("/"));
+
+    // Excel types the workbook part by the default for the .bin extension rather
+    // than with an override
+    if (!manifest.has_override_type(workbook_part) && !manifest.has_default_type(workbook_part.extension()))
+    {
+        return false;
+    }
+
+    return manifest.content_type(workbook_part) == xlsb_workbook_content_type;
+}
+
+void xlsb_consumer::read()
+{
+    const auto &manifest = target_.manifest();
+    const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
+    const auto workbook_part = workbook_rel.target().path();
+
+    std::vector<sheet_record> sheets;
+    read_workbook(workbook_part, sheets);
+
+    if (manifest.has_relationship(workbook_part, relationship_type::shared_string_table))
+    {
+        read_shared_strings(manifest.canonicalize({workbook_rel,
+            manifest.relationship(workbook_part, relationship_type::shared_string_table)}));
+    }
+
+    if (manifest.has_relationship(workbook_part, relationship_type::stylesheet))
+    {
+        read_styles(manifest.canonicalize({workbook_rel,
+            manifest.relationship(workbook_part, relationship_type::stylesheet)}));
+    }
+
+    for (const auto &sheet : sheets)
+    {
+        target_.d_->worksheets_.emplace_back(&target_, sheet.id, sheet.title);
+        auto &ws = target_.d_->worksheets_.back();
+
+        if (target_.d_->max_resident_cells_ != 0)
+        {
+            ws.pager_.reset(new cell_pager(target_.d_->max_resident_cells_));
+        }
+
+        if (sheet.state != 0)
+        {
+            page_setup setup;
+            setup.sheet_state(static_cast<sheet_state>(sheet.state));
+            ws.page_setup_ = setup;
+        }
+
+        if (manifest.has_relationship(workbook_part, sheet.rel_id))
+        {
+            read_worksheet(manifest.canonicalize({workbook_rel, manifest.relationship(workbook_part, sheet.rel_id)}), ws);
+        }
+    }
+
+    convert_manifest();
+}
+
+void xlsb_consumer::convert_manifest()
+{
+    const auto &source = target_.manifest();
+    class manifest converted;
+    std::unordered_set<path> renamed;
+
+    // the absolute path of the part a relationship targets
+    auto target_part = [](const relationship &rel) {
+        return rel.source().path().parent().append(rel.target().path()).resolve(path("/"));
+    };
+
+    for (const auto &extension : source.extensions_with_default_types())
+    {
+        // parts typed by an XLSB default, as the workbook is by Excel, get an override below
+        if (!xlsx_content_type(source.default_type(extension)).empty()) continue;
+
+        converted.register_default_type(extension, source.default_type(extension));
+    }
+
+    for (const auto &part : source.parts_with_overriden_types())
+    {
+        const auto type = source.override_type(part);
+        const auto xml_type = xlsx_content_type(type);
+
+        if (xml_type.empty())
+        {
+            converted.register_override_type(part, type);
+        }
+        else
+        {
+            renamed.insert(part);
+            converted.register_override_type(xml_part(part), xml_type);
+        }
+    }
+
+    for (const auto &part : source.parts())
+    {
+        for (const auto &rel : source.relationships(part))
+        {
+            if (rel.target_mode() != target_mode::internal) continue;
+
+            const auto target = target_part(rel);
+            if (source.has_override_type(target) || !source.has_default_type(target.extension())) continue;
+
+            const auto xml_type = xlsx_content_type(source.default_type(target.extension()));
+
+            if (!xml_type.empty())
+            {
+                renamed.insert(target);
+                converted.register_override_type(xml_part(target), xml_type);
+            }
+        }
+    }
+
+    for (const auto &part : source.parts())
+    {
+        const auto source_part = part.resolve(path("/"));
+        const auto new_source = renamed.count(source_part) > 0 ? uri(xml_part(part).string()) : uri(part.string());
+
+        for (const auto &rel : source.relationships(part))
+        {
+            auto new_target = rel.target();
+
+            // targets are relative to the folder of their source
+            if (rel.target_mode() == target_mode::internal && renamed.count(target_part(rel)) > 0)
+            {
+                new_target = uri(xml_part(rel.target().path()).string());
+            }
+
+            converted.register_relationship(relationship(rel.id(), rel.type(), new_source, new_target, rel.target_mode()));
+        }
+    }
+
+    target_.manifest() = converted;
+}
+
+void xlsb_consumer::read_workbook(const path &part, std::vector<sheet_record> &sheets)
+{
+    auto part_buffer = archive_.open(part);
+    xlsb_record_reader reader(*part_buffer);
+
+    while (reader.next())
+    {
+        switch (reader.type())
+        {
+        case brt_file_version:
+        {
+            workbook_impl::file_version_t version;
+
+            reader.skip(16); // guidCodeName
+            version.app_name = reader.read_string();
+            version.last_edited = static_cast<std::size_t>(std::stoull("0" + reader.read_string()));
+            version.lowest_edited = static_cast<std::size_t>(std::stoull("0" + reader.read_string()));
+            version.rup_build = static_cast<std::size_t>(std::stoull("0" + reader.read_string()));
+
+            target_.d_->file_version_ = version;
+            break;
+        }
+
+        case brt_wb_prop:
+            if ((reader.read_u32() & 0x01) != 0)
+            {
+                target_.base_date(calendar::mac_1904);
+            }
+            break;
+
+        case brt_book_view:
+        {
+            // only the first view is kept, as in XLSX
+            if (target_.has_view()) break;
+
+            workbook_view view;
+
+            view.x_window = static_cast<std::size_t>(static_cast<std::int32_t>(reader.read_u32()));
+            view.y_window = static_cast<std::size_t>(static_cast<std::int32_t>(reader.read_u32()));
+            view.window_width = static_cast<std::size_t>(reader.read_u32());
+            view.window_height = static_cast<std::size_t>(reader.read_u32());
+            view.tab_ratio = static_cast<std::size_t>(reader.read_u32());
+            view.first_sheet = static_cast<std::size_t>(reader.read_u32());
+            view.active_tab = static_cast<std::size_t>(reader.read_u32());
+
+            const auto flags = reader.read_u8();
+            view.visible = (flags & 0x01) == 0;
+            view.minimized = (flags & 0x04) != 0;
+            view.show_horizontal_scroll = (flags & 0x08) != 0;
+            view.show_vertical_scroll = (flags & 0x10) != 0;
+            view.show_sheet_tabs = (flags & 0x20) != 0;
+            view.auto_filter_date_grouping = (flags & 0x40) != 0;
+
+            target_.view(view);
+            break;
+        }
+
+        case brt_bundle_sh:
+        {
+            sheet_record sheet;
+
+            sheet.state = reader.read_u32();
+            sheet.id = static_cast<std::size_t>(reader.read_u32());
+            sheet.rel_id = reader.read_string();
+            sheet.title = reader.read_string();
+
+            target_.d_->sheet_title_rel_id_map_[sheet.title] = sheet.rel_id;
+            target_.d_->sheet_hidden_.push_back(sheet.state != 0);
+            sheets.push_back(sheet);
+            break;
+        }
+
+        case brt_calc_prop:
+        {
+            calculation_properties props;
+
+            props.calc_id = static_cast<std::size_t>(reader.read_u32());
+            reader.skip(4 + 4 + 8 + 4); // fAutoRecalc, cCalcCount, xnumDelta and cUserThreads
+            props.concurrent_calc = (reader.read_u16() & 0x40) != 0;
+
+            target_.calculation_properties(props);
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+}
+
+void xlsb_consumer::read_shared_strings(const path &part)
+{
+    auto part_buffer = archive_.open(part);
+    xlsb_record_reader reader(*part_buffer);
+    auto &strings = target_.d_->shared_strings_values_;
+
+    while (reader.next())
+    {
+        if (reader.type() == brt_begin_sst)
+        {
+            reader.read_u32(); // cstTotal
+
+            // the count comes from the file, so no more is reserved than the part can hold,
+            // each item taking at least a record header, flags and a length
+            const auto most_strings = archive_.file_size(part) / 7;
+            strings.reserve(strings.size() + std::min(static_cast<std::size_t>(reader.read_u32()), most_strings));
+        }
+        else if (reader.type() == brt_sst_item)
+        {
+            // runs and phonetics follow the text and aren't kept
+            reader.read_u8();
+            strings.emplace_back(reader.read_string());
+        }
+    }
+}
+
+void xlsb_consumer::read_styles(const path &part)
+{
+    target_.impl().stylesheet_ = detail::stylesheet();
+    auto &stylesheet = target_.impl().stylesheet_.get();
+    stylesheet.parent = &target_;
+
+    auto part_buffer = archive_.open(part);
+    xlsb_record_reader reader(*part_buffer);
+
+    std::vector<std::pair<style_impl, std::size_t>> styles;
+    std::vector<xf_record> format_records;
+    std::vector<xf_record> style_records;
+    auto in_style_records = false;
+
+    while (reader.next())
+    {
+        switch (reader.type())
+        {
+        case brt_fmt:
+        {
+            number_format nf;
+
+            const auto id = reader.read_u16();
+            nf.format_string(reader.read_string());
+            nf.id(id);
+            stylesheet.number_formats.push_back(nf);
+            break;
+        }
+
+        case brt_font:
+        {
+            font new_font;
+
+            new_font.size(reader.read_u16() / 20.0);
+
+            const auto flags = reader.read_u16();
+            new_font.italic((flags & 0x02) != 0);
+            new_font.strikethrough((flags & 0x08) != 0);
+            new_font.outline((flags & 0x10) != 0);
+            new_font.shadow((flags & 0x20) != 0);
+            new_font.bold(reader.read_u16() >= 700);
+
+            const auto script = reader.read_u16();
+            new_font.superscript(script == 1);
+            new_font.subscript(script == 2);
+            new_font.underline(underline_from_code(reader.read_u8()));
+
+            const auto family = reader.read_u8();
+            if (family != 0) new_font.family(family);
+
+            const auto charset = reader.read_u8();
+            if (charset != 1) new_font.charset(charset);
+
+            reader.read_u8();
+
+            const auto font_color = reader.read_color();
+            if (font_color.is_set()) new_font.color(font_color.get());
+
+            const auto scheme = reader.read_u8();
+            if (scheme == 1) new_font.scheme("major");
+            if (scheme == 2) new_font.scheme("minor");
+
+            const auto name = reader.read_string();
+            if (!name.empty()) new_font.name(name);
+
+            stylesheet.fonts.push_back(new_font);
+            break;
+        }
+
+        case brt_fill:
+        {
+            const auto pattern_type = reader.read_u32();
+            const auto foreground = reader.read_color();
+            const auto background = reader.read_color();
+
+            if (pattern_type == 0x28)
+            {
+                gradient_fill gradient;
+
+                gradient.type(reader.read_u32() == 1 ? gradient_fill_type::path : gradient_fill_type::linear);
+                gradient.degree(reader.read_double());
+                gradient.left(reader.read_double());
+                gradient.right(reader.read_double());
+                gradient.top(reader.read_double());
+                gradient.bottom(reader.read_double());
+
+                for (auto stop_count = reader.read_u32(); stop_count > 0; --stop_count)
+                {
+                    const auto stop_color = reader.read_color();
+                    const auto position = reader.read_double();
+                    gradient.add_stop(position, stop_color.is_set() ? stop_color.get() : color());
+                }
+
+                stylesheet.fills.push_back(fill(gradient));
+            }
+            else
+            {
+                pattern_fill pattern;
+
+                pattern.type(pattern_type <= static_cast<std::uint32_t>(pattern_fill_type::gray0625)
+                        ? static_cast<pattern_fill_type>(pattern_type)
+                        : pattern_fill_type::none);
+                if (foreground.is_set()) pattern.foreground(foreground.get());
+                if (background.is_set()) pattern.background(background.get());
+
+                stylesheet.fills.push_back(fill(pattern));
+            }
+
+            break;
+        }
+
+        case brt_border:
+        {
+            border new_border;
+
+            const auto diagonal = reader.read_u8() & 0x03;
+            if (diagonal == 0x01) new_border.diagonal(diagonal_direction::down);
+            if (diagonal == 0x02) new_border.diagonal(diagonal_direction::up);
+            if (diagonal == 0x03) new_border.diagonal(diagonal_direction::both);
+
+            for (auto side : {border_side::top, border_side::bottom, border_side::start, border_side::end, border_side::diagonal})
+            {
+                border::border_property property;
+
+                const auto style = reader.read_u16();
+                if (style != 0) property.style(border_style_from_code(style));
+
+                const auto side_color = reader.read_color();
+                if (side_color.is_set()) property.color(side_color.get());
+
+                new_border.side(side, property);
+            }
+
+            stylesheet.borders.push_back(new_border);
+            break;
+        }
+
+        case brt_begin_cell_style_xfs:
+            in_style_records = true;
+            break;
+
+        case brt_end_cell_style_xfs:
+            in_style_records = false;
+            break;
+
+        case brt_xf:
+            (in_style_records ? style_records : format_records).push_back(read_xf(reader, stylesheet));
+            break;
+
+        case brt_style:
+        {
+            style_impl style;
+
+            const auto xf_id = static_cast<std::size_t>(reader.read_u32());
+            const auto flags = reader.read_u16();
+            const auto builtin_id = reader.read_u8();
+            const auto level = reader.read_u8();
+
+            if ((flags & 0x01) != 0) style.builtin_id = builtin_id;
+            if (level != 0xFF) style.outline_style = level;
+            style.hidden_style = (flags & 0x02) != 0;
+            style.custom_builtin = (flags & 0x04) != 0;
+            style.name = reader.read_string();
+
+            styles.emplace_back(style, xf_id);
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    // styles and formats are assembled from their records as read_stylesheet does for XLSX
+
+    for (std::size_t xf_id = 0; xf_id < style_records.size(); ++xf_id)
+    {
+        const auto &record = style_records[xf_id].format;
+        auto style_iter = std::find_if(styles.begin(), styles.end(),
+            [xf_id](const std::pair<style_impl, std::size_t> &s) { return s.second == xf_id; });
+
+        if (style_iter == styles.end()) continue;
+
+        stylesheet.create_style(style_iter->first.name);
+        auto &new_style = stylesheet.style_impls.at(style_iter->first.name);
+
+        new_style.pivot_button_ = record.pivot_button_;
+        new_style.quote_prefix_ = record.quote_prefix_;
+        new_style.formatting_record_id = xf_id;
+        new_style.hidden_style = style_iter->first.hidden_style;
+        new_style.custom_builtin = style_iter->first.custom_builtin;
+        new_style.builtin_id = style_iter->first.builtin_id;
+        new_style.outline_style = style_iter->first.outline_style;
+
+        new_style.alignment_applied = record.alignment_applied;
+        new_style.alignment_id = record.alignment_id;
+        new_style.border_applied = record.border_applied;
+        new_style.border_id = record.border_id;
+        new_style.fill_applied = record.fill_applied;
+        new_style.fill_id = record.fill_id;
+        new_style.font_applied = record.font_applied;
+        new_style.font_id = record.font_id;
+        new_style.number_format_applied = record.number_format_applied;
+        new_style.number_format_id = record.number_format_id;
+        new_style.protection_applied = record.protection_applied;
+        new_style.protection_id = record.protection_id;
+    }
+
+    std::size_t record_index = 0;
+
+    for (const auto &record : format_records)
+    {
+        stylesheet.format_impls.push_back(record.format);
+        auto &new_format = stylesheet.format_impls.back();
+
+        new_format.id = record_index++;
+        new_format.parent = &stylesheet;
+        ++new_format.references;
+
+        for (const auto &style : styles)
+        {
+            if (style.second == record.parent)
+            {
+                new_format.style = style.first.name;
+            }
+        }
+
+        formats_.push_back(&new_format);
+    }
+}
+
+void xlsb_consumer::read_worksheet(const path &part, worksheet_impl &ws)
+{
+    auto part_buffer = archive_.open(part);
+    xlsb_record_reader reader(*part_buffer);
+
+    auto &format_properties = ws.format_properties_;
+    auto row = row_t(1);
+    std::vector<range_reference> merged_cells;
+
+    auto read_cell = [&](cell_type type) -> cell_impl & {
+        const auto column = column_t(static_cast<column_t::index_t>(reader.read_u32() + 1));
+        const auto style = reader.read_u32();
+        const auto reference = cell_reference(column, row);
+
+        auto &impl = ws.cell_map_.emplace(std::piecewise_construct,
+                                     std::forward_as_tuple(reference), std::forward_as_tuple())
+                         .first->second;
+
+        if (ws.pager_)
+        {
+            ws.pager_->added(ws, reference);
+        }
+
+        impl.parent_ = &ws;
+        impl.column_ = column;
+        impl.row_ = row;
+        impl.type_ = type;
+        impl.phonetics_visible_ = (style & 0x1000000) != 0;
+
+        const auto format_index = static_cast<std::size_t>(style & 0xFFFFFF);
+
+        if (format_index < formats_.size())
+        {
+            impl.format_ = formats_[format_index];
+        }
+
+        return impl;
+    };
+
+    while (reader.next())
+    {
+        switch (reader.type())
+        {
+        case brt_begin_ws_view:
+        {
+            sheet_view view;
+
+            const auto flags = reader.read_u16();
+            view.show_grid_lines((flags & 0x04) != 0);
+            view.default_grid_color((flags & 0x200) != 0);
+
+            const auto view_type = reader.read_u32();
+            view.type(view_type <= 2 ? static_cast<sheet_view_type>(view_type) : sheet_view_type::normal);
+
+            const auto top = reader.read_u32();
+            const auto left = reader.read_u32();
+
+            if (top != 0 || left != 0)
+            {
+                view.top_left_cell(cell_reference(static_cast<column_t::index_t>(left + 1), top + 1));
+            }
+
+            reader.skip(1 + 1 + 2 * 4); // icvHdr and the zoom scales
+            view.id(reader.read_u32());
+
+            ws.views_.push_back(view);
+            break;
+        }
+
+        case brt_ws_fmt_info:
+        {
+            const auto default_width = reader.read_u32();
+            if (default_width != 0xFFFFFFFF) format_properties.default_column_width = default_width / 256.0;
+
+            format_properties.base_col_width = static_cast<double>(reader.read_u16());
+            format_properties.default_row_height = reader.read_u16() / 20.0;
+            break;
+        }
+
+        case brt_col_info:
+        {
+            const auto first = reader.read_u32() + 1;
+            const auto last = reader.read_u32() + 1;
+            const auto width = reader.read_u32() / 256.0;
+            const auto style = reader.read_u32();
+            const auto flags = reader.read_u16();
+
+            column_properties props;
+
+            // widths are kept without the padding of the column, as in XLSX
+            props.width = (width * 7 - 5) / 7;
+            if (style != 0) props.style = static_cast<std::size_t>(style);
+            props.hidden = (flags & 0x01) != 0;
+            props.custom_width = (flags & 0x02) != 0;
+            props.best_fit = (flags & 0x04) != 0;
+
+            for (auto column = first; column <= last; ++column)
+            {
+                ws.column_properties_[column_t(static_cast<column_t::index_t>(column))] = props;
+            }
+
+            break;
+        }
+
+        case brt_row_hdr:
+        {
+            row = static_cast<row_t>(reader.read_u32() + 1);
+
+            const auto style = reader.read_u32();
+            const auto height = reader.read_u16() / 20.0;
+            reader.read_u8();
+            const auto flags = reader.read_u16();
+
+            const auto hidden = (flags & 0x10) != 0;
+            const auto custom_height = (flags & 0x20) != 0;
+            const auto custom_format = (flags & 0x40) != 0;
+
+            // rows only get properties which differ from the sheet's, since every row
+            // with cells has a header
+            if (hidden || custom_height || custom_format || height != format_properties.default_row_height)
+            {
+                auto &props = ws.row_properties_[row];
+
+                props.height = height;
+                props.hidden = hidden;
+                props.custom_height = custom_height;
+
+                if (custom_format)
+                {
+                    props.custom_format = true;
+                    props.style = static_cast<std::size_t>(style);
+                }
+            }
+
+            break;
+        }
+
+        case brt_cell_blank:
+            read_cell(cell_type::empty);
+            break;
+
+        case brt_cell_rk:
+        {
+            // the cell is read before its value, which follows it in the record
+            auto &impl = read_cell(cell_type::number);
+            impl.value_numeric_ = rk_value(reader.read_u32());
+            break;
+        }
+
+        case brt_cell_real:
+        case brt_fmla_num:
+        {
+            auto &impl = read_cell(cell_type::number);
+            impl.value_numeric_ = reader.read_double();
+            break;
+        }
+
+        case brt_cell_bool:
+        case brt_fmla_bool:
+        {
+            auto &impl = read_cell(cell_type::boolean);
+            impl.value_numeric_ = reader.read_u8() != 0 ? 1.0 : 0.0;
+            break;
+        }
+
+        case brt_cell_error:
+        case brt_fmla_error:
+        {
+            auto &impl = read_cell(cell_type::error);
+            impl.value_text_.plain_text(xlsb_error_text(reader.read_u8()), false);
+            break;
+        }
+
+        case brt_cell_isst:
+        {
+            auto &impl = read_cell(cell_type::shared_string);
+            impl.value_numeric_ = static_cast<double>(reader.read_u32());
+            break;
+        }
+
+        case brt_cell_st:
+        case brt_fmla_string:
+        {
+            // formulas are compiled in XLSB, so only their values are kept
+            auto &impl = read_cell(cell_type::inline_string);
+            impl.value_text_.plain_text(reader.read_string(), false);
+            break;
+        }
+
+        case brt_cell_rstring:
+        {
+            // the runs and phonetics follow the text and aren't kept, as for shared strings
+            auto &impl = read_cell(cell_type::inline_string);
+            reader.read_u8();
+            impl.value_text_.plain_text(reader.read_string(), false);
+            break;
+        }
+
+        case brt_merge_cell:
+        {
+            const auto first_row = reader.read_u32() + 1;
+            const auto last_row = reader.read_u32() + 1;
+            const auto first_column = static_cast<column_t::index_t>(reader.read_u32() + 1);
+            const auto last_column = static_cast<column_t::index_t>(reader.read_u32() + 1);
+
+            merged_cells.emplace_back(cell_reference(first_column, first_row), cell_reference(last_column, last_row));
+            break;
+        }
+
+        case brt_margins:
+        {
+            page_margins margins;
+
+            margins.left(reader.read_double());
+            margins.right(reader.read_double());
+            margins.top(reader.read_double());
+            margins.bottom(reader.read_double());
+            margins.header(reader.read_double());
+            margins.footer(reader.read_double());
+
+            ws.page_margins_ = margins;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    // merging marks the cells, so it's done once they all exist
+    auto sheet = worksheet(&ws);
+
+    for (const auto &range : merged_cells)
+    {
+        sheet.merge_cells(range);
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
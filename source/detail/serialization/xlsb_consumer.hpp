@@ -0,0 +1,99 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <xlnt/utils/path.hpp>
+
+namespace xlnt {
+
+class manifest;
+class workbook;
+
+namespace detail {
+
+class izstream;
+class xlsb_record_reader;
+struct format_impl;
+struct worksheet_impl;
+
+/// <summary>
+/// Handles reading the binary parts of an XLSB file into a workbook. The package,
+/// document properties and theme are read by the xlsx_consumer which detected the
+/// file, since they are the same as in XLSX.
+/// </summary>
+class xlsb_consumer
+{
+public:
+    xlsb_consumer(workbook &target, izstream &archive);
+
+    /// <summary>
+    /// Returns true if the office document of the package described by manifest is
+    /// an XLSB workbook.
+    /// </summary>
+    static bool is_xlsb(const class manifest &manifest);
+
+    /// <summary>
+    /// Reads the workbook part and the shared strings, styles and worksheets it relates to.
+    /// </summary>
+    void read();
+
+private:
+    struct sheet_record
+    {
+        std::string title;
+        std::string rel_id;
+        std::size_t id;
+        std::uint32_t state;
+    };
+
+    void read_workbook(const path &part, std::vector<sheet_record> &sheets);
+
+    void read_shared_strings(const path &part);
+
+    void read_styles(const path &part);
+
+    void read_worksheet(const path &part, worksheet_impl &ws);
+
+    /// <summary>
+    /// Renames the binary parts of the package in the manifest to the XML parts of an
+    /// XLSX package, so that the workbook is saved as XLSX unless XLSB is asked for.
+    /// </summary>
+    void convert_manifest();
+
+    workbook &target_;
+
+    izstream &archive_;
+
+    /// <summary>
+    /// The formats of the stylesheet by index, which cells refer to.
+    /// </summary>
+    std::vector<format_impl *> formats_;
+};
+
+} // namespace detail
+} // namespace xlnt
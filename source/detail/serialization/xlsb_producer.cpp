@@ -0,0 +1,1100 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <xlnt/packaging/manifest.hpp>
+#include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/workbook/workbook_view.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+#include <detail/implementations/cell_pager.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/xlsb_producer.hpp>
+#include <detail/serialization/xlsb_records.hpp>
+#include <detail/serialization/zstream.hpp>
+
+namespace {
+
+// Excel's default column width for an 11pt Calibri font, used for columns which
+// have properties but no width since records can't leave the width out
+const double default_column_width = 9.140625;
+
+std::uint16_t border_style_code(xlnt::border_style style)
+{
+    using xlnt::border_style;
+
+    switch (style)
+    {
+    case border_style::none: return 0;
+    case border_style::thin: return 1;
+    case border_style::medium: return 2;
+    case border_style::dashed: return 3;
+    case border_style::dotted: return 4;
+    case border_style::thick: return 5;
+    case border_style::double_: return 6;
+    case border_style::hair: return 7;
+    case border_style::mediumdashed: return 8;
+    case border_style::dashdot: return 9;
+    case border_style::mediumdashdot: return 10;
+    case border_style::dashdotdot: return 11;
+    case border_style::mediumdashdotdot: return 12;
+    case border_style::slantdashdot: return 13;
+    }
+
+    return 0;
+}
+
+std::uint8_t underline_code(xlnt::font::underline_style style)
+{
+    using underline = xlnt::font::underline_style;
+
+    switch (style)
+    {
+    case underline::none: return 0x00;
+    case underline::single: return 0x01;
+    case underline::double_: return 0x02;
+    case underline::single_accounting: return 0x21;
+    case underline::double_accounting: return 0x22;
+    }
+
+    return 0x00;
+}
+
+/// <summary>
+/// Encodes value as an RkNumber, the four byte form of most integers and of numbers
+/// with two decimals, returning false if it can't be held exactly.
+/// </summary>
+bool rk_number(double value, std::uint32_t &rk)
+{
+    const auto rk_min = -536870912.0;
+    const auto rk_max = 536870911.0;
+
+    // negative zero would come back as zero
+    if (value >= rk_min && value <= rk_max && std::floor(value) == value && !(value == 0.0 && std::signbit(value)))
+    {
+        rk = (static_cast<std::uint32_t>(static_cast<std::int32_t>(value)) << 2) | 2;
+        return true;
+    }
+
+    const auto hundredths = value * 100;
+
+    if (hundredths >= rk_min && hundredths <= rk_max && std::floor(hundredths) == hundredths
+        && static_cast<double>(static_cast<std::int32_t>(hundredths)) / 100 == value)
+    {
+        rk = (static_cast<std::uint32_t>(static_cast<std::int32_t>(hundredths)) << 2) | 3;
+        return true;
+    }
+
+    // doubles whose low 34 bits are zero keep their upper 30 bits
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    if ((bits & 0x3FFFFFFFFULL) == 0)
+    {
+        rk = static_cast<std::uint32_t>(bits >> 32);
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+xlsb_producer::xlsb_producer(const workbook &source)
+    : source_(source),
+      xml_(source)
+{
+}
+
+path xlsb_producer::binary_part(const path &part)
+{
+    const auto name = part.string();
+
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+    {
+        return path(name.substr(0, name.size() - 4) + ".bin");
+    }
+
+    return part;
+}
+
+void xlsb_producer::write(std::ostream &destination)
+{
+    xml_.reconcile_manifest();
+
+    xml_.archive_.reset(new ozstream(destination));
+    xml_.index_string_storage();
+
+    const auto &manifest = xml_.manifest_;
+    const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
+    const auto workbook_part = workbook_rel.target().path();
+    const auto binary_workbook_part = binary_part(workbook_part);
+
+    // Relationships are renumbered since parts that aren't written, such as the
+    // calculation chain, are dropped, and relationship parts are written in id order.
+
+    std::vector<relationship> root_rels;
+    std::vector<std::pair<relationship, relationship>> written_root_rels;
+
+    for (const auto &rel : manifest.relationships(path("/")))
+    {
+        auto target = rel.target().path();
+
+        if (rel.type() == relationship_type::office_document)
+        {
+            target = binary_workbook_part;
+        }
+        else if (rel.type() != relationship_type::core_properties
+            && rel.type() != relationship_type::extended_properties
+            && rel.type() != relationship_type::custom_properties
+            && rel.type() != relationship_type::thumbnail)
+        {
+            continue;
+        }
+
+        root_rels.emplace_back("rId" + std::to_string(root_rels.size() + 1), rel.type(),
+            rel.source(), uri(target.string()), target_mode::internal);
+        written_root_rels.emplace_back(rel, root_rels.back());
+    }
+
+    std::vector<relationship> workbook_rels;
+    std::vector<std::pair<relationship, relationship>> written_workbook_rels;
+
+    for (const auto &rel : manifest.relationships(workbook_part))
+    {
+        auto target = rel.target().path();
+
+        if (rel.type() == relationship_type::worksheet
+            || rel.type() == relationship_type::stylesheet
+            || rel.type() == relationship_type::shared_string_table)
+        {
+            target = binary_part(target);
+        }
+        else if (rel.type() != relationship_type::theme)
+        {
+            continue;
+        }
+
+        workbook_rels.emplace_back("rId" + std::to_string(workbook_rels.size() + 1), rel.type(),
+            uri(binary_workbook_part.string()), uri(target.string()), target_mode::internal);
+        written_workbook_rels.emplace_back(rel, workbook_rels.back());
+
+        if (rel.type() == relationship_type::worksheet)
+        {
+            sheet_rel_ids_[rel.id()] = workbook_rels.back().id();
+        }
+    }
+
+    write_content_types(workbook_rels);
+    xml_.write_relationships(root_rels, path("/"));
+
+    for (const auto &rels : written_root_rels)
+    {
+        const auto &rel = rels.first;
+
+        if (rel.type() == relationship_type::thumbnail)
+        {
+            xml_.write_image(rel.target().path());
+        }
+        else if (rel.type() != relationship_type::office_document)
+        {
+            xml_.begin_part(rel.target().path());
+
+            if (rel.type() == relationship_type::core_properties)
+            {
+                xml_.write_core_properties(rel);
+            }
+            else if (rel.type() == relationship_type::extended_properties)
+            {
+                xml_.write_extended_properties(rel);
+            }
+            else
+            {
+                xml_.write_custom_properties(rel);
+            }
+        }
+    }
+
+    xml_.write_relationships(workbook_rels, binary_workbook_part);
+    write_part(binary_workbook_part, [this](xlsb_record_writer &writer) { write_workbook(writer); });
+
+    for (const auto &rels : written_workbook_rels)
+    {
+        const auto &rel = rels.first;
+        const auto part = workbook_part.parent().append(rels.second.target().path());
+
+        switch (rel.type())
+        {
+        case relationship_type::theme:
+            xml_.write_theme(rel);
+            break;
+
+        case relationship_type::stylesheet:
+            write_part(part, [this](xlsb_record_writer &writer) { write_styles(writer); });
+            break;
+
+        case relationship_type::shared_string_table:
+            write_part(part, [this](xlsb_record_writer &writer) { write_shared_strings(writer); });
+            break;
+
+        default:
+        {
+            const auto &titles = source_.d_->sheet_title_rel_id_map_;
+            const auto title = std::find_if(titles.begin(), titles.end(),
+                [&rel](const std::pair<std::string, std::string> &p) { return p.second == rel.id(); })->first;
+            auto &ws = *source_.sheet_by_title(title).d_;
+
+            write_part(part, [this, &ws](xlsb_record_writer &writer) { write_worksheet(writer, ws); });
+            break;
+        }
+        }
+    }
+
+    // the archive's central directory is written when it is closed
+    xml_.end_part();
+    xml_.archive_.reset();
+}
+
+void xlsb_producer::write_part(const path &part, const std::function<void(xlsb_record_writer &)> &write_records)
+{
+    xml_.end_part();
+
+    auto part_buffer = xml_.archive_->open(part);
+    xlsb_record_writer writer(*part_buffer);
+
+    write_records(writer);
+    writer.flush();
+}
+
+void xlsb_producer::write_content_types(const std::vector<relationship> &workbook_rels)
+{
+    const auto &manifest = xml_.manifest_;
+    const auto xmlns = "http://schemas.openxmlformats.org/package/2006/content-types";
+    const auto workbook_part = manifest.relationship(path("/"), relationship_type::office_document).target().path();
+
+    std::vector<std::pair<std::string, std::string>> overrides;
+
+    for (const auto &rel : manifest.relationships(path("/")))
+    {
+        if (rel.type() == relationship_type::core_properties
+            || rel.type() == relationship_type::extended_properties
+            || rel.type() == relationship_type::custom_properties)
+        {
+            overrides.emplace_back(rel.target().path().resolve(path("/")).string(),
+                manifest.content_type(rel.target().path()));
+        }
+    }
+
+    overrides.emplace_back(binary_part(workbook_part).resolve(path("/")).string(), xlsb_workbook_content_type);
+
+    for (const auto &rel : workbook_rels)
+    {
+        const auto part = workbook_part.parent().append(rel.target().path());
+
+        switch (rel.type())
+        {
+        case relationship_type::worksheet:
+            overrides.emplace_back(part.resolve(path("/")).string(), xlsb_worksheet_content_type);
+            break;
+        case relationship_type::stylesheet:
+            overrides.emplace_back(part.resolve(path("/")).string(), xlsb_styles_content_type);
+            break;
+        case relationship_type::shared_string_table:
+            overrides.emplace_back(part.resolve(path("/")).string(), xlsb_shared_strings_content_type);
+            break;
+        default:
+            overrides.emplace_back(part.resolve(path("/")).string(), manifest.content_type(part));
+            break;
+        }
+    }
+
+    xml_.begin_part(path("[Content_Types].xml"));
+
+    xml_.write_start_element(xmlns, "Types");
+    xml_.write_namespace(xmlns, "");
+
+    for (const auto &extension : manifest.extensions_with_default_types())
+    {
+        xml_.write_start_element(xmlns, "Default");
+        xml_.write_attribute("Extension", extension);
+        xml_.write_attribute("ContentType", manifest.default_type(extension));
+        xml_.write_end_element(xmlns, "Default");
+    }
+
+    for (const auto &part : overrides)
+    {
+        xml_.write_start_element(xmlns, "Override");
+        xml_.write_attribute("PartName", part.first);
+        xml_.write_attribute("ContentType", part.second);
+        xml_.write_end_element(xmlns, "Override");
+    }
+
+    xml_.write_end_element(xmlns, "Types");
+}
+
+void xlsb_producer::write_workbook(xlsb_record_writer &writer)
+{
+    const auto &workbook = *source_.d_;
+
+    writer.empty_record(brt_begin_book);
+
+    auto version = workbook_impl::file_version_t();
+    version.app_name = "xl";
+
+    if (workbook.file_version_.is_set())
+    {
+        version = workbook.file_version_.get();
+    }
+
+    writer.begin(brt_file_version);
+    writer.write_u32(0); // guidCodeName
+    writer.write_u32(0);
+    writer.write_u32(0);
+    writer.write_u32(0);
+    writer.write_string(version.app_name);
+    writer.write_string(std::to_string(version.last_edited));
+    writer.write_string(std::to_string(version.lowest_edited));
+    writer.write_string(std::to_string(version.rup_build));
+    writer.end();
+
+    writer.begin(brt_wb_prop);
+    writer.write_u32(source_.base_date() == calendar::mac_1904 ? 1 : 0);
+    writer.write_u32(0); // dwThemeVersion
+    writer.write_string(std::string()); // strName
+    writer.end();
+
+    if (source_.has_view())
+    {
+        const auto view = source_.view();
+
+        writer.empty_record(brt_begin_book_views);
+        writer.begin(brt_book_view);
+        writer.write_u32(static_cast<std::uint32_t>(view.x_window.is_set() ? view.x_window.get() : 0));
+        writer.write_u32(static_cast<std::uint32_t>(view.y_window.is_set() ? view.y_window.get() : 0));
+        writer.write_u32(static_cast<std::uint32_t>(view.window_width.is_set() ? view.window_width.get() : 0));
+        writer.write_u32(static_cast<std::uint32_t>(view.window_height.is_set() ? view.window_height.get() : 0));
+        writer.write_u32(static_cast<std::uint32_t>(view.tab_ratio.is_set() ? view.tab_ratio.get() : 600));
+        writer.write_u32(static_cast<std::uint32_t>(view.first_sheet.is_set() ? view.first_sheet.get() : 0));
+        writer.write_u32(static_cast<std::uint32_t>(view.active_tab.is_set() ? view.active_tab.get() : 0));
+        writer.write_u8(static_cast<std::uint8_t>((view.visible ? 0 : 0x01)
+            | (view.minimized ? 0x04 : 0)
+            | (view.show_horizontal_scroll ? 0x08 : 0)
+            | (view.show_vertical_scroll ? 0x10 : 0)
+            | (view.show_sheet_tabs ? 0x20 : 0)
+            | (view.auto_filter_date_grouping ? 0x40 : 0)));
+        writer.end();
+        writer.empty_record(brt_end_book_views);
+    }
+
+    writer.empty_record(brt_begin_bundle_shs);
+
+    for (const auto &ws_impl : workbook.worksheets_)
+    {
+        const auto rel_id = workbook.sheet_title_rel_id_map_.find(ws_impl.title_);
+        if (rel_id == workbook.sheet_title_rel_id_map_.end()) continue;
+
+        const auto written_id = sheet_rel_ids_.find(rel_id->second);
+        if (written_id == sheet_rel_ids_.end()) continue;
+
+        auto state = std::uint32_t(0);
+
+        if (ws_impl.page_setup_.is_set())
+        {
+            state = static_cast<std::uint32_t>(ws_impl.page_setup_.get().sheet_state());
+        }
+
+        writer.begin(brt_bundle_sh);
+        writer.write_u32(state);
+        writer.write_u32(static_cast<std::uint32_t>(ws_impl.id_));
+        writer.write_string(written_id->second);
+        writer.write_string(ws_impl.title_);
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_bundle_shs);
+
+    if (source_.has_calculation_properties())
+    {
+        const auto props = source_.calculation_properties();
+
+        writer.begin(brt_calc_prop);
+        writer.write_u32(static_cast<std::uint32_t>(props.calc_id));
+        writer.write_u32(1); // fAutoRecalc
+        writer.write_u32(100); // cCalcCount
+        writer.write_double(0.001); // xnumDelta
+        writer.write_u32(1); // cUserThreads
+        // fRefA1, fFullPrec and fSaveRecalc, with fMTREnabled for concurrent calculation
+        writer.write_u16(static_cast<std::uint16_t>(0x02 | 0x08 | 0x20 | (props.concurrent_calc ? 0x40 : 0)));
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_book);
+}
+
+void xlsb_producer::write_shared_strings(xlsb_record_writer &writer)
+{
+    const auto &strings = source_.shared_strings();
+    const auto &ids = xml_.shared_string_ids_;
+    const auto unique_count = ids.empty()
+        ? strings.size()
+        : static_cast<std::size_t>(std::count_if(ids.begin(), ids.end(),
+              [](std::size_t id) { return id != std::size_t(-1); }));
+
+    writer.begin(brt_begin_sst);
+    writer.write_u32(static_cast<std::uint32_t>(xml_.shared_string_count_));
+    writer.write_u32(static_cast<std::uint32_t>(unique_count));
+    writer.end();
+
+    for (auto index = std::size_t(0); index < strings.size(); ++index)
+    {
+        if (!ids.empty() && ids[index] == std::size_t(-1)) continue;
+
+        writer.begin(brt_sst_item);
+        writer.write_u8(0); // neither runs nor phonetics
+        writer.write_string(strings[index].plain_text());
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_sst);
+}
+
+template <typename T>
+void xlsb_producer::write_xf(xlsb_record_writer &writer, const T &xf, std::uint16_t parent)
+{
+    const auto &stylesheet = source_.d_->stylesheet_.get();
+    auto id = [](const optional<std::size_t> &value) {
+        return static_cast<std::uint16_t>(value.is_set() ? value.get() : 0);
+    };
+    auto applied = [](const optional<bool> &value, std::uint16_t bit) {
+        return static_cast<std::uint16_t>(value.is_set() && value.get() ? bit : 0);
+    };
+
+    auto rotation = std::uint8_t(0);
+    auto indent = std::uint8_t(0);
+    auto horizontal = std::uint16_t(0);
+    auto vertical = std::uint16_t(2); // bottom
+    auto wrap = false;
+    auto shrink = false;
+
+    if (xf.alignment_id.is_set())
+    {
+        const auto &current = stylesheet.alignments.at(xf.alignment_id.get());
+
+        rotation = static_cast<std::uint8_t>(current.rotation().is_set() ? current.rotation().get() : 0);
+        indent = static_cast<std::uint8_t>(current.indent().is_set() ? current.indent().get() : 0);
+        horizontal = static_cast<std::uint16_t>(current.horizontal().is_set() ? current.horizontal().get() : horizontal_alignment::general);
+        vertical = static_cast<std::uint16_t>(current.vertical().is_set() ? current.vertical().get() : vertical_alignment::bottom);
+        wrap = current.wrap();
+        shrink = current.shrink();
+    }
+
+    auto locked = true;
+    auto hidden = false;
+
+    if (xf.protection_id.is_set())
+    {
+        const auto &current = stylesheet.protections.at(xf.protection_id.get());
+
+        locked = current.locked();
+        hidden = current.hidden();
+    }
+
+    writer.begin(brt_xf);
+    writer.write_u16(parent);
+    writer.write_u16(id(xf.number_format_id));
+    writer.write_u16(id(xf.font_id));
+    writer.write_u16(id(xf.fill_id));
+    writer.write_u16(id(xf.border_id));
+    writer.write_u8(rotation);
+    writer.write_u8(indent);
+    writer.write_u16(static_cast<std::uint16_t>(horizontal
+        | (vertical << 3)
+        | (wrap ? 0x40 : 0)
+        | (shrink ? 0x100 : 0)
+        | (locked ? 0x1000 : 0)
+        | (hidden ? 0x2000 : 0)
+        | (xf.pivot_button_ ? 0x4000 : 0)
+        | (xf.quote_prefix_ ? 0x8000 : 0)));
+    writer.write_u16(static_cast<std::uint16_t>(applied(xf.number_format_applied, 0x01)
+        | applied(xf.font_applied, 0x02)
+        | applied(xf.alignment_applied, 0x04)
+        | applied(xf.border_applied, 0x08)
+        | applied(xf.fill_applied, 0x10)
+        | applied(xf.protection_applied, 0x20)));
+    writer.end();
+}
+
+void xlsb_producer::write_styles(xlsb_record_writer &writer)
+{
+    const auto &stylesheet = source_.d_->stylesheet_.get();
+
+    writer.empty_record(brt_begin_style_sheet);
+
+    // Number Formats
+
+    if (!stylesheet.number_formats.empty())
+    {
+        writer.count_record(brt_begin_fmts, stylesheet.number_formats.size());
+
+        for (const auto &current : stylesheet.number_formats)
+        {
+            writer.begin(brt_fmt);
+            writer.write_u16(static_cast<std::uint16_t>(current.id()));
+            writer.write_string(current.format_string());
+            writer.end();
+        }
+
+        writer.empty_record(brt_end_fmts);
+    }
+
+    // Fonts
+
+    writer.count_record(brt_begin_fonts, stylesheet.fonts.size());
+
+    for (const auto &current : stylesheet.fonts)
+    {
+        auto scheme = std::uint8_t(0);
+
+        if (current.has_scheme())
+        {
+            scheme = current.scheme() == "major" ? 1 : current.scheme() == "minor" ? 2 : 0;
+        }
+
+        writer.begin(brt_font);
+        writer.write_u16(static_cast<std::uint16_t>(std::lround((current.has_size() ? current.size() : 11.0) * 20)));
+        writer.write_u16(static_cast<std::uint16_t>((current.italic() ? 0x02 : 0)
+            | (current.strikethrough() ? 0x08 : 0)
+            | (current.outline() ? 0x10 : 0)
+            | (current.shadow() ? 0x20 : 0)));
+        writer.write_u16(current.bold() ? 700 : 400);
+        writer.write_u16(current.superscript() ? 1 : current.subscript() ? 2 : 0);
+        writer.write_u8(underline_code(current.underline()));
+        writer.write_u8(static_cast<std::uint8_t>(current.has_family() ? current.family() : 0));
+        writer.write_u8(static_cast<std::uint8_t>(current.has_charset() ? current.charset() : 1));
+        writer.write_u8(0);
+        writer.write_color(current.has_color() ? optional<color>(current.color()) : optional<color>());
+        writer.write_u8(scheme);
+        writer.write_string(current.has_name() ? current.name() : std::string());
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_fonts);
+
+    // Fills
+
+    writer.count_record(brt_begin_fills, stylesheet.fills.size());
+
+    for (const auto &current : stylesheet.fills)
+    {
+        writer.begin(brt_fill);
+
+        if (current.type() == fill_type::gradient)
+        {
+            const auto &gradient = current.gradient_fill();
+            auto stops = std::vector<std::pair<double, color>>(gradient.stops().begin(), gradient.stops().end());
+            std::sort(stops.begin(), stops.end(),
+                [](const std::pair<double, color> &a, const std::pair<double, color> &b) { return a.first < b.first; });
+
+            writer.write_u32(0x28);
+            writer.write_color(optional<color>());
+            writer.write_color(optional<color>());
+            writer.write_u32(gradient.type() == gradient_fill_type::path ? 1 : 0);
+            writer.write_double(gradient.degree());
+            writer.write_double(gradient.left());
+            writer.write_double(gradient.right());
+            writer.write_double(gradient.top());
+            writer.write_double(gradient.bottom());
+            writer.write_u32(static_cast<std::uint32_t>(stops.size()));
+
+            for (const auto &stop : stops)
+            {
+                writer.write_color(stop.second);
+                writer.write_double(stop.first);
+            }
+        }
+        else
+        {
+            const auto &pattern = current.pattern_fill();
+
+            // pattern_fill_type is in the order of the fls values
+            writer.write_u32(static_cast<std::uint32_t>(pattern.type()));
+            writer.write_color(pattern.foreground());
+            writer.write_color(pattern.background());
+            writer.write_u32(0);
+
+            for (auto field = 0; field < 5; ++field)
+            {
+                writer.write_double(0);
+            }
+
+            writer.write_u32(0);
+        }
+
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_fills);
+
+    // Borders
+
+    writer.count_record(brt_begin_borders, stylesheet.borders.size());
+
+    for (const auto &current : stylesheet.borders)
+    {
+        auto diagonal = std::uint8_t(0);
+
+        if (current.diagonal().is_set())
+        {
+            const auto direction = current.diagonal().get();
+            diagonal = static_cast<std::uint8_t>(
+                (direction == diagonal_direction::down || direction == diagonal_direction::both ? 0x01 : 0)
+                | (direction == diagonal_direction::up || direction == diagonal_direction::both ? 0x02 : 0));
+        }
+
+        writer.begin(brt_border);
+        writer.write_u8(diagonal);
+
+        for (auto side : {border_side::top, border_side::bottom, border_side::start, border_side::end, border_side::diagonal})
+        {
+            const auto property = current.side(side);
+            const auto has_style = property.is_set() && property.get().style().is_set();
+
+            writer.write_u16(has_style ? border_style_code(property.get().style().get()) : 0);
+            writer.write_color(property.is_set() ? property.get().color() : optional<color>());
+        }
+
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_borders);
+
+    // Style XFs
+
+    writer.count_record(brt_begin_cell_style_xfs, stylesheet.style_names.size());
+
+    for (const auto &name : stylesheet.style_names)
+    {
+        write_xf(writer, stylesheet.style_impls.at(name), 0xFFFF);
+    }
+
+    writer.empty_record(brt_end_cell_style_xfs);
+
+    // Format XFs
+
+    writer.count_record(brt_begin_cell_xfs, stylesheet.format_impls.size());
+
+    for (const auto &current : stylesheet.format_impls)
+    {
+        // every format has a parent style in XLSB, the first one unless another is set
+        auto parent = static_cast<std::uint16_t>(stylesheet.style_names.empty() ? 0xFFFF : 0);
+
+        if (current.style.is_set())
+        {
+            parent = static_cast<std::uint16_t>(stylesheet.style_index(current.style.get()));
+        }
+
+        write_xf(writer, current, parent);
+    }
+
+    writer.empty_record(brt_end_cell_xfs);
+
+    // Styles
+
+    writer.count_record(brt_begin_styles, stylesheet.style_names.size());
+    auto style_index = std::uint32_t(0);
+
+    for (const auto &name : stylesheet.style_names)
+    {
+        const auto &current = stylesheet.style_impls.at(name);
+
+        writer.begin(brt_style);
+        writer.write_u32(style_index++);
+        writer.write_u16(static_cast<std::uint16_t>((current.builtin_id.is_set() ? 0x01 : 0)
+            | (current.hidden_style ? 0x02 : 0)
+            | (current.builtin_id.is_set() && current.custom_builtin ? 0x04 : 0)));
+        writer.write_u8(static_cast<std::uint8_t>(current.builtin_id.is_set() ? current.builtin_id.get() : 0));
+        writer.write_u8(static_cast<std::uint8_t>(current.outline_style.is_set() ? current.outline_style.get() : 0xFF));
+        writer.write_string(current.name);
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_styles);
+    writer.empty_record(brt_end_style_sheet);
+}
+
+void xlsb_producer::write_worksheet(xlsb_record_writer &writer, worksheet_impl &ws)
+{
+    const auto inline_match = xml_.inline_string_columns_.find(&ws);
+    const auto inline_columns = inline_match == xml_.inline_string_columns_.end() ? nullptr : &inline_match->second;
+    const auto &format_properties = ws.format_properties_;
+
+    writer.empty_record(brt_begin_sheet);
+
+    // rows and columns are zero based in XLSB
+    const auto dimension = worksheet(&ws).calculate_dimension();
+    writer.begin(brt_ws_dim);
+    writer.write_u32(dimension.top_left().row() - 1);
+    writer.write_u32(dimension.bottom_right().row() - 1);
+    writer.write_u32(dimension.top_left().column_index() - 1);
+    writer.write_u32(dimension.bottom_right().column_index() - 1);
+    writer.end();
+
+    if (!ws.views_.empty())
+    {
+        const auto &sheets = source_.d_->worksheets_;
+        const auto index = static_cast<std::size_t>(std::distance(sheets.begin(),
+            std::find_if(sheets.begin(), sheets.end(), [&ws](const worksheet_impl &other) { return &other == &ws; })));
+        const auto active_tab = source_.has_view() && source_.view().active_tab.is_set()
+            ? source_.view().active_tab.get()
+            : std::size_t(0);
+
+        writer.empty_record(brt_begin_ws_views);
+
+        for (const auto &view : ws.views_)
+        {
+            const auto top_left = view.has_top_left_cell() ? view.top_left_cell() : cell_reference("A1");
+
+            writer.begin(brt_begin_ws_view);
+            // fDspRwCol, fDspZeros and fDspGuts are always shown
+            writer.write_u16(static_cast<std::uint16_t>((view.show_grid_lines() ? 0x04 : 0)
+                | 0x08 | 0x10
+                | (index == active_tab ? 0x40 : 0)
+                | 0x100
+                | (view.default_grid_color() ? 0x200 : 0)));
+            writer.write_u32(static_cast<std::uint32_t>(view.type()));
+            writer.write_u32(top_left.row() - 1);
+            writer.write_u32(top_left.column_index() - 1);
+            writer.write_u8(64); // icvHdr, the default grid color
+            writer.write_u8(0);
+            writer.write_u16(100); // wScale
+            writer.write_u16(0);
+            writer.write_u16(0);
+            writer.write_u16(0);
+            writer.write_u32(static_cast<std::uint32_t>(view.id()));
+            writer.end();
+            writer.empty_record(brt_end_ws_view);
+        }
+
+        writer.empty_record(brt_end_ws_views);
+    }
+
+    writer.begin(brt_ws_fmt_info);
+    writer.write_u32(format_properties.default_column_width.is_set()
+            ? static_cast<std::uint32_t>(std::lround(format_properties.default_column_width.get() * 256))
+            : 0xFFFFFFFF);
+    writer.write_u16(static_cast<std::uint16_t>(std::lround(format_properties.base_col_width.is_set()
+            ? format_properties.base_col_width.get()
+            : 8.0)));
+    writer.write_u16(static_cast<std::uint16_t>(std::lround(format_properties.default_row_height * 20)));
+    writer.write_u16(0);
+    writer.write_u8(0);
+    writer.write_u8(0);
+    writer.end();
+
+    // Columns
+
+    if (!ws.column_properties_.empty())
+    {
+        std::vector<column_t> columns;
+
+        for (const auto &column : ws.column_properties_)
+        {
+            columns.push_back(column.first);
+        }
+
+        std::sort(columns.begin(), columns.end());
+        writer.empty_record(brt_begin_col_infos);
+
+        for (auto column : columns)
+        {
+            const auto &props = ws.column_properties_.at(column);
+            // widths are stored without the padding of the column, as in XLSX
+            const auto width = props.width.is_set() ? (props.width.get() * 7 + 5) / 7
+                : format_properties.default_column_width.is_set() ? format_properties.default_column_width.get()
+                                                                   : default_column_width;
+
+            writer.begin(brt_col_info);
+            writer.write_u32(column.index - 1);
+            writer.write_u32(column.index - 1);
+            writer.write_u32(static_cast<std::uint32_t>(std::lround(width * 256)));
+            writer.write_u32(static_cast<std::uint32_t>(props.style.is_set() ? props.style.get() : 0));
+            writer.write_u16(static_cast<std::uint16_t>((props.hidden ? 0x01 : 0)
+                | (props.custom_width ? 0x02 : 0)
+                | (props.best_fit ? 0x04 : 0)));
+            writer.end();
+        }
+
+        writer.empty_record(brt_end_col_infos);
+    }
+
+    // Rows and Cells
+
+    std::vector<row_t> property_rows;
+
+    for (const auto &row : ws.row_properties_)
+    {
+        property_rows.push_back(row.first);
+    }
+
+    std::sort(property_rows.begin(), property_rows.end());
+    auto next_property_row = property_rows.begin();
+
+    auto write_row_header = [&](row_t row, const cell_impl *const *first, const cell_impl *const *last) {
+        const auto props = ws.row_properties_.find(row);
+        const auto has_props = props != ws.row_properties_.end();
+        const auto has_style = has_props && props->second.style.is_set();
+        const auto height = has_props && props->second.height.is_set()
+            ? props->second.height.get()
+            : format_properties.default_row_height;
+
+        writer.begin(brt_row_hdr);
+        writer.write_u32(row - 1);
+        writer.write_u32(static_cast<std::uint32_t>(has_style ? props->second.style.get() : 0));
+        writer.write_u16(static_cast<std::uint16_t>(std::lround(height * 20)));
+        writer.write_u8(0);
+        writer.write_u16(static_cast<std::uint16_t>((has_props && props->second.hidden ? 0x10 : 0)
+            | (has_props && props->second.custom_height ? 0x20 : 0)
+            | (has_style || (has_props && props->second.custom_format.is_set() && props->second.custom_format.get()) ? 0x40 : 0)));
+
+        if (first == last)
+        {
+            writer.write_u32(0);
+        }
+        else
+        {
+            writer.write_u32(1);
+            writer.write_u32((*first)->column_.index - 1);
+            writer.write_u32((*(last - 1))->column_.index - 1);
+        }
+
+        writer.end();
+    };
+
+    // writes the given cells, and the rows up to last_row which only have properties
+    auto write_rows = [&](std::vector<const cell_impl *> &cells, row_t last_row) {
+        std::sort(cells.begin(), cells.end(), [](const cell_impl *a, const cell_impl *b) {
+            return a->row_ < b->row_ || (a->row_ == b->row_ && a->column_ < b->column_);
+        });
+
+        const auto *cells_end = cells.data() + cells.size();
+
+        for (const auto *first = cells.data(); first != cells_end;)
+        {
+            const auto row = (*first)->row_;
+            const auto *last = first;
+
+            while (last != cells_end && (*last)->row_ == row)
+            {
+                ++last;
+            }
+
+            while (next_property_row != property_rows.end() && *next_property_row < row)
+            {
+                write_row_header(*next_property_row++, nullptr, nullptr);
+            }
+
+            if (next_property_row != property_rows.end() && *next_property_row == row)
+            {
+                ++next_property_row;
+            }
+
+            write_row_header(row, first, last);
+
+            for (; first != last; ++first)
+            {
+                write_cell(writer, **first, inline_columns);
+            }
+        }
+
+        while (next_property_row != property_rows.end() && *next_property_row <= last_row)
+        {
+            write_row_header(*next_property_row++, nullptr, nullptr);
+        }
+
+        cells.clear();
+    };
+
+    writer.empty_record(brt_begin_sheet_data);
+
+    std::vector<const cell_impl *> cells;
+
+    if (ws.pager_)
+    {
+        // a block of rows at a time so that the worksheet stays within its resident cells,
+        // blocks are only read so they aren't written out again
+        ws.pager_->for_each_block(ws, [&](const std::vector<cell_reference> &references) {
+            if (references.empty()) return;
+
+            for (const auto &reference : references)
+            {
+                const auto match = ws.cell_map_.find(reference);
+
+                if (match != ws.cell_map_.end() && !match->second.is_garbage_collectible())
+                {
+                    cells.push_back(&match->second);
+                }
+            }
+
+            const auto block = (references.front().row() - 1) / cell_pager::rows_per_block;
+            write_rows(cells, static_cast<row_t>((block + 1) * cell_pager::rows_per_block));
+        }, 1, std::numeric_limits<row_t>::max(), false);
+    }
+    else
+    {
+        cells.reserve(ws.cell_map_.size());
+
+        for (const auto &entry : ws.cell_map_)
+        {
+            if (!entry.second.is_garbage_collectible())
+            {
+                cells.push_back(&entry.second);
+            }
+        }
+    }
+
+    write_rows(cells, constants::max_row());
+
+    writer.empty_record(brt_end_sheet_data);
+
+    // Merged Cells
+
+    if (!ws.merged_cells_.empty())
+    {
+        writer.count_record(brt_begin_merge_cells, ws.merged_cells_.size());
+
+        for (const auto &range : ws.merged_cells_)
+        {
+            writer.begin(brt_merge_cell);
+            writer.write_u32(range.top_left().row() - 1);
+            writer.write_u32(range.bottom_right().row() - 1);
+            writer.write_u32(range.top_left().column_index() - 1);
+            writer.write_u32(range.bottom_right().column_index() - 1);
+            writer.end();
+        }
+
+        writer.empty_record(brt_end_merge_cells);
+    }
+
+    if (ws.page_margins_.is_set())
+    {
+        const auto &margins = ws.page_margins_.get();
+
+        writer.begin(brt_margins);
+        writer.write_double(margins.left());
+        writer.write_double(margins.right());
+        writer.write_double(margins.top());
+        writer.write_double(margins.bottom());
+        writer.write_double(margins.header());
+        writer.write_double(margins.footer());
+        writer.end();
+    }
+
+    writer.empty_record(brt_end_sheet);
+}
+
+void xlsb_producer::write_cell(xlsb_record_writer &writer, const cell_impl &cell, const std::vector<bool> *inline_columns)
+{
+    const auto style = cell.format_.is_set() ? static_cast<std::uint32_t>(cell.format_.get()->id) : 0;
+
+    auto begin = [&](std::uint32_t type) {
+        writer.begin(type);
+        writer.write_u32(cell.column_.index - 1);
+        writer.write_u32((style & 0xFFFFFF) | (cell.phonetics_visible_ ? 0x1000000 : 0));
+    };
+
+    // formulas are stored compiled in XLSB, so only their cached values are written
+    switch (cell.type_)
+    {
+    case cell_type::empty:
+        begin(brt_cell_blank);
+        break;
+
+    case cell_type::boolean:
+        begin(brt_cell_bool);
+        writer.write_u8(cell.value_numeric_ != 0.0 ? 1 : 0);
+        break;
+
+    case cell_type::error:
+        begin(brt_cell_error);
+        writer.write_u8(xlsb_error_code(cell.value_text_.plain_text()));
+        break;
+
+    case cell_type::number:
+    case cell_type::date:
+    {
+        auto rk = std::uint32_t(0);
+
+        if (rk_number(cell.value_numeric_, rk))
+        {
+            begin(brt_cell_rk);
+            writer.write_u32(rk);
+        }
+        else
+        {
+            begin(brt_cell_real);
+            writer.write_double(cell.value_numeric_);
+        }
+
+        break;
+    }
+
+    case cell_type::shared_string:
+    {
+        const auto id = static_cast<std::size_t>(cell.value_numeric_);
+
+        // shared strings of columns written inline are copied into their cells
+        if (inline_columns != nullptr && cell.column_.index < inline_columns->size() && (*inline_columns)[cell.column_.index])
+        {
+            begin(brt_cell_st);
+            writer.write_string(source_.shared_strings().at(id).plain_text());
+        }
+        else
+        {
+            const auto &ids = xml_.shared_string_ids_;
+
+            begin(brt_cell_isst);
+            writer.write_u32(static_cast<std::uint32_t>(ids.empty() ? id : ids[id]));
+        }
+
+        break;
+    }
+
+    case cell_type::inline_string:
+    case cell_type::formula_string:
+        begin(brt_cell_st);
+        writer.write_string(cell.value_text_.plain_text());
+        break;
+    }
+
+    writer.end();
+}
+
+} // namespace detail
+} // namespace xlnt
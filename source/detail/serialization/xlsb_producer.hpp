@@ -0,0 +1,103 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/packaging/relationship.hpp>
+#include <detail/serialization/xlsx_producer.hpp>
+
+namespace xlnt {
+
+class path;
+class workbook;
+
+namespace detail {
+
+struct cell_impl;
+struct format_impl;
+struct style_impl;
+struct worksheet_impl;
+class xlsb_record_writer;
+
+/// <summary>
+/// Handles writing a workbook into an XLSB file. The package, document properties and
+/// theme are written by an xlsx_producer since they are the same as in XLSX. The
+/// workbook, styles, shared strings and worksheets are written as records.
+/// </summary>
+class xlsb_producer
+{
+public:
+    xlsb_producer(const workbook &source);
+
+    void write(std::ostream &destination);
+
+private:
+    /// <summary>
+    /// Returns the path of the binary part written instead of the XML part at part.
+    /// </summary>
+    static path binary_part(const path &part);
+
+    /// <summary>
+    /// Opens part in the archive and writes the records written by write_records into it.
+    /// </summary>
+    void write_part(const path &part, const std::function<void(xlsb_record_writer &)> &write_records);
+
+    void write_content_types(const std::vector<relationship> &workbook_rels);
+
+    void write_workbook(xlsb_record_writer &writer);
+
+    void write_shared_strings(xlsb_record_writer &writer);
+
+    void write_styles(xlsb_record_writer &writer);
+
+    /// <summary>
+    /// Writes a BrtXF for a format_impl or a style_impl, which share these fields.
+    /// </summary>
+    template <typename T>
+    void write_xf(xlsb_record_writer &writer, const T &xf, std::uint16_t parent);
+
+    void write_worksheet(xlsb_record_writer &writer, worksheet_impl &ws);
+
+    void write_cell(xlsb_record_writer &writer, const cell_impl &cell, const std::vector<bool> *inline_columns);
+
+    const workbook &source_;
+
+    /// <summary>
+    /// Writes the XML parts and holds the archive all parts are written into.
+    /// </summary>
+    xlsx_producer xml_;
+
+    /// <summary>
+    /// The id each written worksheet relationship has in the workbook's relationships.
+    /// </summary>
+    std::unordered_map<std::string, std::string> sheet_rel_ids_;
+};
+
+} // namespace detail
+} // namespace xlnt
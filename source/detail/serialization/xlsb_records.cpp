@@ -0,0 +1,410 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <xlnt/styles/color.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/serialization/xlsb_records.hpp>
+#include <detail/unicode.hpp>
+
+namespace {
+
+// Records are buffered until there are this many bytes, then handed to the archive at once
+const std::size_t flush_size = 64 * 1024;
+
+// The xColorType of a BrtColor
+enum color_kind : std::uint8_t
+{
+    automatic_color = 0,
+    indexed_kind = 1,
+    rgb_kind = 2,
+    theme_kind = 3
+};
+
+const std::pair<std::uint8_t, const char *> error_codes[] = {
+    {0x00, "#NULL!"},
+    {0x07, "#DIV/0!"},
+    {0x0F, "#VALUE!"},
+    {0x17, "#REF!"},
+    {0x1D, "#NAME?"},
+    {0x24, "#NUM!"},
+    {0x2A, "#N/A"},
+    {0x2B, "#GETTING_DATA"}};
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::uint8_t xlsb_error_code(const std::string &text)
+{
+    for (const auto &code : error_codes)
+    {
+        if (text == code.second) return code.first;
+    }
+
+    return 0x2A;
+}
+
+std::string xlsb_error_text(std::uint8_t code)
+{
+    for (const auto &error : error_codes)
+    {
+        if (code == error.first) return error.second;
+    }
+
+    return "#N/A";
+}
+
+xlsb_record_reader::xlsb_record_reader(std::streambuf &source)
+    : source_(source)
+{
+}
+
+bool xlsb_record_reader::next()
+{
+    const auto eof = std::char_traits<char>::eof();
+
+    auto byte = source_.sbumpc();
+    if (byte == eof) return false;
+
+    // the type takes one or two bytes and the size one to four, seven bits in each
+    type_ = static_cast<std::uint32_t>(byte & 0x7F);
+
+    if ((byte & 0x80) != 0)
+    {
+        byte = source_.sbumpc();
+        if (byte == eof) throw invalid_file("truncated XLSB record");
+        type_ |= static_cast<std::uint32_t>(byte & 0x7F) << 7;
+    }
+
+    auto size = std::size_t(0);
+
+    for (auto shift = 0; shift < 28; shift += 7)
+    {
+        byte = source_.sbumpc();
+        if (byte == eof) throw invalid_file("truncated XLSB record");
+        size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) break;
+    }
+
+    payload_.resize(size);
+    position_ = 0;
+
+    if (size > 0
+        && source_.sgetn(reinterpret_cast<char *>(payload_.data()), static_cast<std::streamsize>(size))
+            != static_cast<std::streamsize>(size))
+    {
+        throw invalid_file("truncated XLSB record");
+    }
+
+    return true;
+}
+
+std::uint32_t xlsb_record_reader::type() const
+{
+    return type_;
+}
+
+std::size_t xlsb_record_reader::remaining() const
+{
+    return payload_.size() - position_;
+}
+
+void xlsb_record_reader::require(std::size_t count) const
+{
+    if (count > remaining())
+    {
+        throw invalid_file("XLSB record " + std::to_string(type_) + " is too short");
+    }
+}
+
+std::uint8_t xlsb_record_reader::read_u8()
+{
+    require(1);
+    return payload_[position_++];
+}
+
+std::uint16_t xlsb_record_reader::read_u16()
+{
+    require(2);
+    const auto *bytes = payload_.data() + position_;
+    position_ += 2;
+
+    return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+std::uint32_t xlsb_record_reader::read_u32()
+{
+    require(4);
+    const auto *bytes = payload_.data() + position_;
+    position_ += 4;
+
+    return static_cast<std::uint32_t>(bytes[0])
+        | (static_cast<std::uint32_t>(bytes[1]) << 8)
+        | (static_cast<std::uint32_t>(bytes[2]) << 16)
+        | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+double xlsb_record_reader::read_double()
+{
+    const auto low = static_cast<std::uint64_t>(read_u32());
+    const auto bits = low | (static_cast<std::uint64_t>(read_u32()) << 32);
+
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+std::string xlsb_record_reader::read_string()
+{
+    const auto length = static_cast<std::size_t>(read_u32());
+    require(length * 2);
+
+    const auto *units = payload_.data() + position_;
+    position_ += length * 2;
+
+    std::string text(length, '\0');
+
+    // almost all text is ASCII, which is copied directly
+    for (auto index = std::size_t(0); index < length; ++index)
+    {
+        if (units[index * 2] >= 0x80 || units[index * 2 + 1] != 0)
+        {
+            std::u16string wide(length, u'\0');
+
+            for (auto unit = std::size_t(0); unit < length; ++unit)
+            {
+                wide[unit] = static_cast<char16_t>(units[unit * 2] | (units[unit * 2 + 1] << 8));
+            }
+
+            return utf16_to_utf8(wide);
+        }
+
+        text[index] = static_cast<char>(units[index * 2]);
+    }
+
+    return text;
+}
+
+optional<color> xlsb_record_reader::read_color()
+{
+    const auto flags = read_u8();
+    const auto index = read_u8();
+    const auto tint = static_cast<std::int16_t>(read_u16());
+    const auto red = read_u8();
+    const auto green = read_u8();
+    const auto blue = read_u8();
+    const auto alpha = read_u8();
+
+    auto result = color();
+
+    switch (flags >> 1)
+    {
+    case automatic_color:
+        return optional<color>();
+    case indexed_kind:
+        result = indexed_color(index);
+        break;
+    case theme_kind:
+        result = theme_color(index);
+        break;
+    default:
+        result = rgb_color(red, green, blue, alpha);
+        break;
+    }
+
+    if (tint != 0)
+    {
+        result.tint(tint / 32767.0);
+    }
+
+    return result;
+}
+
+void xlsb_record_reader::skip(std::size_t count)
+{
+    require(count);
+    position_ += count;
+}
+
+xlsb_record_writer::xlsb_record_writer(std::streambuf &destination)
+    : destination_(destination)
+{
+    buffer_.reserve(flush_size + 1024);
+}
+
+void xlsb_record_writer::begin(std::uint32_t type)
+{
+    type_ = type;
+    payload_.clear();
+}
+
+void xlsb_record_writer::end()
+{
+    buffer_.push_back(static_cast<std::uint8_t>((type_ & 0x7F) | (type_ >= 0x80 ? 0x80 : 0)));
+
+    if (type_ >= 0x80)
+    {
+        buffer_.push_back(static_cast<std::uint8_t>(type_ >> 7));
+    }
+
+    auto size = payload_.size();
+
+    do
+    {
+        const auto byte = static_cast<std::uint8_t>(size & 0x7F);
+        size >>= 7;
+        buffer_.push_back(static_cast<std::uint8_t>(byte | (size > 0 ? 0x80 : 0)));
+    } while (size > 0);
+
+    buffer_.insert(buffer_.end(), payload_.begin(), payload_.end());
+
+    if (buffer_.size() >= flush_size)
+    {
+        flush();
+    }
+}
+
+void xlsb_record_writer::empty_record(std::uint32_t type)
+{
+    begin(type);
+    end();
+}
+
+void xlsb_record_writer::count_record(std::uint32_t type, std::size_t count)
+{
+    begin(type);
+    write_u32(static_cast<std::uint32_t>(count));
+    end();
+}
+
+void xlsb_record_writer::write_u8(std::uint8_t value)
+{
+    payload_.push_back(value);
+}
+
+void xlsb_record_writer::write_u16(std::uint16_t value)
+{
+    payload_.push_back(static_cast<std::uint8_t>(value));
+    payload_.push_back(static_cast<std::uint8_t>(value >> 8));
+}
+
+void xlsb_record_writer::write_u32(std::uint32_t value)
+{
+    payload_.push_back(static_cast<std::uint8_t>(value));
+    payload_.push_back(static_cast<std::uint8_t>(value >> 8));
+    payload_.push_back(static_cast<std::uint8_t>(value >> 16));
+    payload_.push_back(static_cast<std::uint8_t>(value >> 24));
+}
+
+void xlsb_record_writer::write_double(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    write_u32(static_cast<std::uint32_t>(bits));
+    write_u32(static_cast<std::uint32_t>(bits >> 32));
+}
+
+void xlsb_record_writer::write_string(const std::string &text)
+{
+    const auto ascii = std::all_of(text.begin(), text.end(), [](char c) { return (c & 0x80) == 0; });
+
+    if (ascii)
+    {
+        write_u32(static_cast<std::uint32_t>(text.size()));
+
+        for (auto c : text)
+        {
+            payload_.push_back(static_cast<std::uint8_t>(c));
+            payload_.push_back(0);
+        }
+
+        return;
+    }
+
+    const auto wide = utf8_to_utf16(text);
+    write_u32(static_cast<std::uint32_t>(wide.size()));
+
+    for (auto unit : wide)
+    {
+        write_u16(static_cast<std::uint16_t>(unit));
+    }
+}
+
+void xlsb_record_writer::write_color(const optional<color> &value)
+{
+    if (!value.is_set() || value.get().auto_())
+    {
+        write_u32(static_cast<std::uint32_t>(automatic_color << 1));
+        write_u32(0);
+
+        return;
+    }
+
+    const auto &c = value.get();
+    const auto tint = static_cast<std::int16_t>(std::lround(c.tint() * 32767));
+
+    switch (c.type())
+    {
+    case color_type::indexed:
+        write_u8(indexed_kind << 1);
+        write_u8(static_cast<std::uint8_t>(c.indexed().index()));
+        write_u16(static_cast<std::uint16_t>(tint));
+        write_u32(0);
+        break;
+
+    case color_type::theme:
+        write_u8(theme_kind << 1);
+        write_u8(static_cast<std::uint8_t>(c.theme().index()));
+        write_u16(static_cast<std::uint16_t>(tint));
+        write_u32(0);
+        break;
+
+    case color_type::rgb:
+        write_u8((rgb_kind << 1) | 1);
+        write_u8(0);
+        write_u16(static_cast<std::uint16_t>(tint));
+        write_u8(c.rgb().red());
+        write_u8(c.rgb().green());
+        write_u8(c.rgb().blue());
+        write_u8(c.rgb().alpha());
+        break;
+    }
+}
+
+void xlsb_record_writer::flush()
+{
+    if (buffer_.empty()) return;
+
+    destination_.sputn(reinterpret_cast<const char *>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,241 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/utils/optional.hpp>
+
+namespace xlnt {
+
+class color;
+
+namespace detail {
+
+/// <summary>
+/// The content types of the parts of an XLSB package which differ from XLSX.
+/// Document properties and the theme are XML in both.
+/// </summary>
+const char xlsb_workbook_content_type[] = "application/vnd.ms-excel.sheet.binary.macroEnabled.main";
+const char xlsb_worksheet_content_type[] = "application/vnd.ms-excel.worksheet";
+const char xlsb_styles_content_type[] = "application/vnd.ms-excel.styles";
+const char xlsb_shared_strings_content_type[] = "application/vnd.ms-excel.sharedStrings";
+
+/// <summary>
+/// The types of the records read and written, named as in [MS-XLSB] 2.3.
+/// Other records are skipped when reading.
+/// </summary>
+enum xlsb_record_type : std::uint32_t
+{
+    brt_row_hdr = 0,
+    brt_cell_blank = 1,
+    brt_cell_rk = 2,
+    brt_cell_error = 3,
+    brt_cell_bool = 4,
+    brt_cell_real = 5,
+    brt_cell_st = 6,
+    brt_cell_isst = 7,
+    brt_fmla_string = 8,
+    brt_fmla_num = 9,
+    brt_fmla_bool = 10,
+    brt_fmla_error = 11,
+    brt_sst_item = 19,
+    brt_font = 43,
+    brt_fmt = 44,
+    brt_fill = 45,
+    brt_border = 46,
+    brt_xf = 47,
+    brt_style = 48,
+    brt_col_info = 60,
+    brt_cell_rstring = 62,
+    brt_file_version = 128,
+    brt_begin_sheet = 129,
+    brt_end_sheet = 130,
+    brt_begin_book = 131,
+    brt_end_book = 132,
+    brt_begin_ws_views = 133,
+    brt_end_ws_views = 134,
+    brt_begin_book_views = 135,
+    brt_end_book_views = 136,
+    brt_begin_ws_view = 137,
+    brt_end_ws_view = 138,
+    brt_begin_bundle_shs = 143,
+    brt_end_bundle_shs = 144,
+    brt_begin_sheet_data = 145,
+    brt_end_sheet_data = 146,
+    brt_ws_dim = 148,
+    brt_wb_prop = 153,
+    brt_bundle_sh = 156,
+    brt_calc_prop = 157,
+    brt_book_view = 158,
+    brt_begin_sst = 159,
+    brt_end_sst = 160,
+    brt_merge_cell = 176,
+    brt_begin_merge_cells = 177,
+    brt_end_merge_cells = 178,
+    brt_begin_style_sheet = 278,
+    brt_end_style_sheet = 279,
+    brt_begin_col_infos = 390,
+    brt_end_col_infos = 391,
+    brt_margins = 476,
+    brt_ws_fmt_info = 485,
+    brt_begin_fills = 603,
+    brt_end_fills = 604,
+    brt_begin_fonts = 611,
+    brt_end_fonts = 612,
+    brt_begin_borders = 613,
+    brt_end_borders = 614,
+    brt_begin_fmts = 615,
+    brt_end_fmts = 616,
+    brt_begin_cell_xfs = 617,
+    brt_end_cell_xfs = 618,
+    brt_begin_styles = 619,
+    brt_end_styles = 620,
+    brt_begin_cell_style_xfs = 626,
+    brt_end_cell_style_xfs = 627
+};
+
+/// <summary>
+/// Returns the byte of a BrtCellError record for the error string text, such as "#N/A".
+/// </summary>
+std::uint8_t xlsb_error_code(const std::string &text);
+
+/// <summary>
+/// Returns the error string of the byte of a BrtCellError record.
+/// </summary>
+std::string xlsb_error_text(std::uint8_t code);
+
+/// <summary>
+/// Reads the records of one binary part. Each record is a type and a size, both
+/// variable length integers, followed by that many bytes, which are read whole and
+/// then consumed in order by the read methods. Reading past the end of a record
+/// throws invalid_file.
+/// </summary>
+class xlsb_record_reader
+{
+public:
+    explicit xlsb_record_reader(std::streambuf &source);
+
+    /// <summary>
+    /// Reads the next record, returning false at the end of the part.
+    /// </summary>
+    bool next();
+
+    /// <summary>
+    /// The type of the current record.
+    /// </summary>
+    std::uint32_t type() const;
+
+    /// <summary>
+    /// The number of bytes of the current record which haven't been read.
+    /// </summary>
+    std::size_t remaining() const;
+
+    std::uint8_t read_u8();
+    std::uint16_t read_u16();
+    std::uint32_t read_u32();
+    double read_double();
+
+    /// <summary>
+    /// Reads an XLWideString, a count of UTF-16 code units followed by the units.
+    /// </summary>
+    std::string read_string();
+
+    /// <summary>
+    /// Reads a BrtColor. Automatic colors are returned as no color.
+    /// </summary>
+    optional<color> read_color();
+
+    void skip(std::size_t count);
+
+private:
+    void require(std::size_t count) const;
+
+    std::streambuf &source_;
+    std::uint32_t type_ = 0;
+    std::vector<std::uint8_t> payload_;
+    std::size_t position_ = 0;
+};
+
+/// <summary>
+/// Writes the records of one binary part. A record is started with begin, filled with
+/// the write methods and finished with end, which buffers it for the destination.
+/// </summary>
+class xlsb_record_writer
+{
+public:
+    explicit xlsb_record_writer(std::streambuf &destination);
+
+    /// <summary>
+    /// Starts a record of the given type.
+    /// </summary>
+    void begin(std::uint32_t type);
+
+    /// <summary>
+    /// Finishes the current record.
+    /// </summary>
+    void end();
+
+    /// <summary>
+    /// Writes a record without content, such as the start or end of a collection.
+    /// </summary>
+    void empty_record(std::uint32_t type);
+
+    /// <summary>
+    /// Writes a record holding only count, as the start of most collections do.
+    /// </summary>
+    void count_record(std::uint32_t type, std::size_t count);
+
+    void write_u8(std::uint8_t value);
+    void write_u16(std::uint16_t value);
+    void write_u32(std::uint32_t value);
+    void write_double(double value);
+
+    /// <summary>
+    /// Writes text as an XLWideString.
+    /// </summary>
+    void write_string(const std::string &text);
+
+    /// <summary>
+    /// Writes value as a BrtColor. No color is written as an automatic one.
+    /// </summary>
+    void write_color(const optional<color> &value);
+
+    /// <summary>
+    /// Writes the buffered records to the destination.
+    /// </summary>
+    void flush();
+
+private:
+    std::streambuf &destination_;
+    std::uint32_t type_ = 0;
+    std::vector<std::uint8_t> payload_;
+    std::vector<std::uint8_t> buffer_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -23,6 +23,8 @@
 
 #include <cassert>
 #include <cctype>
+#include <cstring>
+#include <limits>
 #include <numeric> // for std::accumulate
 #include <sstream>
 #include <unordered_map>
@@ -35,14 +37,17 @@
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/row_view.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
+#include <detail/implementations/rich_text_access.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/xlsb_consumer.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
 
@@ -77,7 +82,8 @@ inline bool string_equal(const std::string &lhs, const char (&rhs)[N])
 xml::qname &qn(const std::string &namespace_, const std::string &name)
 {
     using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto memo = std::unordered_map<std::string, qname_map>();
+    // per thread so that worksheets can be streamed from several threads
+    static thread_local auto memo = std::unordered_map<std::string, qname_map>();
 
     auto &ns_memo = memo[namespace_];
 
@@ -326,7 +332,10 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
 }
 
 // <sheetData> inside <worksheet> element
-Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter)
+// Passes the rows of a sheetData element to construct in batches of up to batch_size
+// rows, so that all of them needn't be held at once
+template <typename F>
+void parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::size_t batch_size, F construct)
 {
     Sheet_Data sheet_data;
     int level = 1; // nesting level
@@ -340,6 +349,14 @@ Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser
         {
         case xml::parser::start_element: {
             sheet_data.parsed_rows.push_back(parse_row(parser, converter, sheet_data.parsed_cells));
+
+            if (sheet_data.parsed_rows.size() >= batch_size)
+            {
+                construct(sheet_data);
+                sheet_data.parsed_rows.clear();
+                sheet_data.parsed_cells.clear();
+            }
+
             break;
         }
         case xml::parser::end_element: {
@@ -360,9 +377,385 @@ Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser
         }
         }
     }
-    return sheet_data;
+    construct(sheet_data);
 }
 
+/// <summary>
+/// Reads the entries of a sharedStrings part directly from its bytes. An entry that is a
+/// single <t> element is decoded straight into the caller's string. Anything else is
+/// reported as complex, with its markup left for the XML parser.
+/// </summary>
+class shared_string_scanner
+{
+public:
+    enum class entry
+    {
+        plain,
+        complex,
+        end,
+        unsupported
+    };
+
+    explicit shared_string_scanner(const std::string &xml)
+        : xml_(xml)
+    {
+    }
+
+    /// <summary>
+    /// Reads up to the end of the sst start tag. Returns false if the part isn't laid out
+    /// as expected, in which case all of it should go through the XML parser instead.
+    /// </summary>
+    bool read_start()
+    {
+        if (xml_.compare(0, 3, "\xEF\xBB\xBF") == 0)
+        {
+            position_ = 3;
+        }
+
+        skip_whitespace();
+
+        if (at("<?xml"))
+        {
+            position_ = xml_.find("?>", position_);
+            if (position_ == std::string::npos) return false;
+            position_ += 2;
+            skip_whitespace();
+        }
+
+        const auto tag_begin = position_;
+        if (!at_tag("<sst")) return false;
+        position_ += 4;
+
+        auto has_namespace = false;
+        auto unsupported = false;
+
+        const auto read = read_attributes([&](const std::string &name, std::size_t begin, std::size_t end) {
+            const auto length = end - begin;
+
+            if (name == "xmlns")
+            {
+                has_namespace = xml_.compare(begin, length, xlnt::constants::ns("spreadsheetml")) == 0;
+            }
+            else if (name == "uniqueCount")
+            {
+                unsupported = unsupported || length == 0 || length > 18
+                    || xml_.find_first_not_of("0123456789", begin) < end;
+                unique_count_ = unsupported ? 0 : std::stoull(xml_.substr(begin, length));
+                has_unique_count_ = true;
+            }
+        });
+
+        start_tag_ = xml_.substr(tag_begin, position_ - tag_begin);
+
+        return read && has_namespace && !unsupported;
+    }
+
+    /// <summary>
+    /// Reads the next entry, decoding it into text and preserve_space if it is plain.
+    /// The markup of a complex entry is given by entry_begin() and entry_end().
+    /// </summary>
+    entry next(std::string &text, bool &preserve_space)
+    {
+        if (self_closing_) return entry::end;
+
+        skip_whitespace();
+
+        if (at("</sst>"))
+        {
+            position_ += 6;
+            return entry::end;
+        }
+
+        if (!at("<si>")) return entry::unsupported;
+
+        entry_begin_ = position_;
+        position_ += 4;
+        skip_whitespace();
+
+        if (at_tag("<t"))
+        {
+            position_ += 2;
+            preserve_space = false;
+
+            const auto read = read_attributes([&](const std::string &name, std::size_t begin, std::size_t end) {
+                if (name == "xml:space")
+                {
+                    preserve_space = xml_.compare(begin, end - begin, "preserve") == 0;
+                }
+            });
+
+            if (!read) return entry::unsupported;
+
+            auto decoded = true;
+
+            if (!self_closing_)
+            {
+                decoded = decode_text(text) && at("</t>");
+                position_ += 4;
+            }
+
+            self_closing_ = false;
+            skip_whitespace();
+
+            if (decoded && at("</si>"))
+            {
+                position_ += 5;
+                return entry::plain;
+            }
+
+            if (!decoded && failed_)
+            {
+                return entry::unsupported;
+            }
+        }
+
+        entry_end_ = xml_.find("</si>", entry_begin_);
+        if (entry_end_ == std::string::npos) return entry::unsupported;
+        entry_end_ += 5;
+        position_ = entry_end_;
+
+        return entry::complex;
+    }
+
+    /// <summary>
+    /// The sst start tag as written in the part, used to wrap complex entries.
+    /// </summary>
+    const std::string &start_tag() const
+    {
+        return start_tag_;
+    }
+
+    bool has_unique_count() const
+    {
+        return has_unique_count_;
+    }
+
+    std::size_t unique_count() const
+    {
+        return static_cast<std::size_t>(unique_count_);
+    }
+
+    std::size_t entry_begin() const
+    {
+        return entry_begin_;
+    }
+
+    std::size_t entry_end() const
+    {
+        return entry_end_;
+    }
+
+private:
+    bool at(const char *literal) const
+    {
+        return xml_.compare(position_, std::strlen(literal), literal) == 0;
+    }
+
+    /// <summary>
+    /// Returns true if the start of an element named by the literal is at the current position.
+    /// </summary>
+    bool at_tag(const char *literal) const
+    {
+        const auto length = std::strlen(literal);
+
+        return at(literal) && position_ + length < xml_.size()
+            && (xml_[position_ + length] == '>' || xml_[position_ + length] == '/'
+                || is_whitespace(xml_[position_ + length]));
+    }
+
+    static bool is_whitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void skip_whitespace()
+    {
+        while (position_ < xml_.size() && is_whitespace(xml_[position_]))
+        {
+            ++position_;
+        }
+    }
+
+    /// <summary>
+    /// Calls handle with the name and value bounds of each attribute up to the end of the
+    /// current start tag. Values are passed undecoded since none of those read need it.
+    /// </summary>
+    template <typename Handler>
+    bool read_attributes(Handler handle)
+    {
+        while (true)
+        {
+            skip_whitespace();
+
+            if (at(">"))
+            {
+                ++position_;
+                return true;
+            }
+
+            if (at("/>"))
+            {
+                position_ += 2;
+                self_closing_ = true;
+                return true;
+            }
+
+            const auto name_begin = position_;
+
+            while (position_ < xml_.size() && xml_[position_] != '=' && !is_whitespace(xml_[position_]))
+            {
+                ++position_;
+            }
+
+            const auto name = xml_.substr(name_begin, position_ - name_begin);
+            skip_whitespace();
+            if (!at("=") || name.empty()) return false;
+            ++position_;
+            skip_whitespace();
+
+            if (position_ >= xml_.size() || (xml_[position_] != '"' && xml_[position_] != '\'')) return false;
+
+            const auto quote = xml_[position_++];
+            const auto value_end = xml_.find(quote, position_);
+            if (value_end == std::string::npos) return false;
+
+            handle(name, position_, value_end);
+            position_ = value_end + 1;
+        }
+    }
+
+    /// <summary>
+    /// Decodes character data up to the next tag into text, normalising line breaks and
+    /// replacing entity and character references as an XML parser would. Returns false
+    /// if something other than plain character data is found; failed_ is set if the
+    /// part is better handed to the XML parser as a whole.
+    /// </summary>
+    bool decode_text(std::string &text)
+    {
+        text.clear();
+
+        while (position_ < xml_.size())
+        {
+            const auto chunk_begin = position_;
+
+            while (position_ < xml_.size() && xml_[position_] != '<' && xml_[position_] != '&'
+                && xml_[position_] != '\r')
+            {
+                ++position_;
+            }
+
+            text.append(xml_, chunk_begin, position_ - chunk_begin);
+
+            if (position_ >= xml_.size()) break;
+
+            if (xml_[position_] == '<')
+            {
+                // CDATA sections and comments are rare enough to leave to the parser
+                return !at("<!") && !at("<?");
+            }
+
+            if (xml_[position_] == '\r')
+            {
+                text.push_back('\n');
+                ++position_;
+
+                if (at("\n"))
+                {
+                    ++position_;
+                }
+
+                continue;
+            }
+
+            if (!decode_reference(text))
+            {
+                failed_ = true;
+                return false;
+            }
+        }
+
+        failed_ = true;
+        return false;
+    }
+
+    bool decode_reference(std::string &text)
+    {
+        const auto end = xml_.find(';', position_);
+        if (end == std::string::npos || end - position_ > 10) return false;
+
+        const auto name = xml_.substr(position_ + 1, end - position_ - 1);
+        position_ = end + 1;
+
+        if (name == "lt") text.push_back('<');
+        else if (name == "gt") text.push_back('>');
+        else if (name == "amp") text.push_back('&');
+        else if (name == "quot") text.push_back('"');
+        else if (name == "apos") text.push_back('\'');
+        else if (name.size() > 1 && name[0] == '#')
+        {
+            const auto hex = name[1] == 'x';
+            const auto digits = name.substr(hex ? 2 : 1);
+
+            if (digits.empty()
+                || digits.find_first_not_of(hex ? "0123456789abcdefABCDEF" : "0123456789") != std::string::npos)
+            {
+                return false;
+            }
+
+            const auto code_point = std::stoul(digits, nullptr, hex ? 16 : 10);
+
+            if (code_point == 0 || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+            {
+                return false;
+            }
+
+            append_utf8(static_cast<std::uint32_t>(code_point), text);
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    static void append_utf8(std::uint32_t code_point, std::string &text)
+    {
+        if (code_point < 0x80)
+        {
+            text.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    const std::string &xml_;
+    std::size_t position_ = 0;
+    std::string start_tag_;
+    bool has_unique_count_ = false;
+    unsigned long long unique_count_ = 0;
+    bool self_closing_ = false;
+    bool failed_ = false;
+    std::size_t entry_begin_ = 0;
+    std::size_t entry_end_ = 0;
+};
+
 } // namespace
 
 /*
@@ -430,6 +823,8 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
         streaming_cell_.reset(new detail::cell_impl());
     }
 
+    streaming_row_ = 0;
+
     auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
         target_.d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
@@ -742,66 +1137,82 @@ void xlsx_consumer::read_worksheet_sheetdata()
     {
         return;
     }
-    Sheet_Data ws_data = parse_sheet_data(parser_, converter_);
     // NOTE: parse->construct are seperated here and could easily be threaded
-    // with a SPSC queue for what is likely to be an easy performance win
-    for (auto &row : ws_data.parsed_rows)
-    {
-        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
-    }
-    auto impl = detail::cell_impl();
-    for (Cell &cell : ws_data.parsed_cells)
-    {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
-        if (cell.style_index != -1)
-        {
-            ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
-        }
-        if (cell.cell_metatdata_idx != -1)
-        {
-        }
-        ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
-        if (!cell.formula_string.empty())
-        {
-            ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
-        }
-        if (!cell.value.empty())
-        {
-            ws_cell_impl->type_ = cell.type;
-            switch (cell.type)
+    // with a SPSC queue for what is likely to be an easy performance win.
+    // Worksheets limited to a number of resident cells are built a block of rows at a
+    // time, so that the parsed rows don't have to fit in memory either
+    const auto batch_size = current_worksheet_->pager_
+        ? static_cast<std::size_t>(cell_pager::rows_per_block)
+        : std::numeric_limits<std::size_t>::max();
+
+    parse_sheet_data(parser_, converter_, batch_size, [this](Sheet_Data &ws_data) {
+        for (auto &row : ws_data.parsed_rows)
+        {
+            current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+        }
+        auto impl = detail::cell_impl();
+        for (Cell &cell : ws_data.parsed_cells)
+        {
+            impl.parent_ = current_worksheet_;
+            impl.column_ = cell.ref.column;
+            impl.row_ = cell.ref.row;
+            auto reference = cell_reference(impl.column_, impl.row_);
+            detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(reference, std::move(impl)).first->second;
+            if (current_worksheet_->pager_)
             {
-            case cell::type::boolean: {
-                ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
-                break;
-            }
-            case cell::type::empty:
-            case cell::type::number:
-            case cell::type::date: {
-                ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
-                break;
+                current_worksheet_->pager_->added(*current_worksheet_, reference);
             }
-            case cell::type::shared_string: {
-                ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
-                break;
-            }
-            case cell::type::inline_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            if (cell.style_index != -1)
+            {
+                ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
             }
-            case cell::type::formula_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            if (cell.cell_metatdata_idx != -1)
+            {
             }
-            case cell::type::error: {
-                ws_cell_impl->value_text_.plain_text(cell.value, false);
-                break;
+            ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
+            if (!cell.formula_string.empty())
+            {
+                if (!ws_cell_impl->formula_.is_set())
+                {
+                    ++current_worksheet_->formula_count_;
+                }
+                ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
             }
+            if (!cell.value.empty())
+            {
+                ws_cell_impl->type_ = cell.type;
+                switch (cell.type)
+                {
+                case cell::type::boolean: {
+                    ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
+                    break;
+                }
+                case cell::type::empty:
+                case cell::type::number:
+                case cell::type::date: {
+                    ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
+                    break;
+                }
+                case cell::type::shared_string: {
+                    ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
+                    break;
+                }
+                case cell::type::inline_string: {
+                    ws_cell_impl->value_text_ = std::move(cell.value);
+                    break;
+                }
+                case cell::type::formula_string: {
+                    ws_cell_impl->value_text_ = std::move(cell.value);
+                    break;
+                }
+                case cell::type::error: {
+                    ws_cell_impl->value_text_.plain_text(cell.value, false);
+                    break;
+                }
+                }
             }
         }
-    }
+    });
     stack_.pop_back();
 }
 
@@ -1231,12 +1642,6 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         auto drawings_part = manifest.canonicalize({workbook_rel, sheet_rel,
             manifest.relationship(sheet_path, xlnt::relationship_type::drawings)});
 
-        auto receive = xml::parser::receive_default;
-        auto drawings_part_streambuf = archive_->open(drawings_part);
-        std::istream drawings_part_stream(drawings_part_streambuf.get());
-        xml::parser parser(drawings_part_stream, drawings_part.string(), receive);
-        parser_ = &parser;
-
         read_drawings(ws, drawings_part);
     }
 
@@ -1248,33 +1653,37 @@ xml::parser &xlsx_consumer::parser()
     return *parser_;
 }
 
-bool xlsx_consumer::has_cell()
+bool xlsx_consumer::read_row_start()
 {
-    auto ws = worksheet(current_worksheet_);
+    const auto &row_element = qn("spreadsheetml", "row");
+    const auto &sheet_data_element = qn("spreadsheetml", "sheetData");
 
     while (streaming_cell_ // we're not at the end of the file
-           && !in_element(qn("spreadsheetml", "row"))) // we're at the end of a row, or between rows
+           && !in_element(row_element)) // we're at the end of a row, or between rows
     {
         if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "row"))
+            && stack_.back() == row_element)
         {
             // We're at the end of a row.
-            expect_end_element(qn("spreadsheetml", "row"));
+            expect_end_element(row_element);
             // ... and keep parsing.
         }
 
         if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "sheetData"))
+            && stack_.back() == sheet_data_element)
         {
             // End of sheet. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
-            expect_end_element(qn("spreadsheetml", "sheetData"));
+            expect_end_element(sheet_data_element);
             streaming_cell_.reset(nullptr);
             break;
         }
 
-        expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
-        auto &row_properties = ws.row_properties(row_index);
+        expect_start_element(row_element, xml::content::complex); // CT_Row
+        // r is optional, in which case the row follows the previous one
+        streaming_row_ = parser().attribute_present("r")
+            ? static_cast<row_t>(std::stoul(parser().attribute("r")))
+            : streaming_row_ + 1;
+        auto &row_properties = worksheet(current_worksheet_).row_properties(streaming_row_);
 
         if (parser().attribute_present("ht"))
         {
@@ -1306,6 +1715,13 @@ bool xlsx_consumer::has_cell()
             "ph"});
     }
 
+    return streaming_cell_ != nullptr;
+}
+
+bool xlsx_consumer::has_cell()
+{
+    read_row_start();
+
     if (!streaming_cell_)
     {
         // We're at the end of the worksheet
@@ -1420,6 +1836,284 @@ bool xlsx_consumer::has_cell()
     return true;
 }
 
+bool xlsx_consumer::read_row(row_view &row)
+{
+    assert(streaming_);
+
+    row.row_ = 0;
+    row.cells_.clear();
+    row.text_.clear();
+
+    if (!read_row_start())
+    {
+        // We're at the end of the worksheet
+        return false;
+    }
+
+    // shared strings are flattened once so that cells can point into them
+    const auto &shared_strings = *flat_shared_strings();
+    const auto base_date = target_.base_date();
+
+    // qn() looks names up in a map so they're resolved once per row
+    const auto &row_element = qn("spreadsheetml", "row");
+    const auto &cell_element = qn("spreadsheetml", "c");
+    const auto &value_element = qn("spreadsheetml", "v");
+    const auto &formula_element = qn("spreadsheetml", "f");
+    const auto &inline_string_element = qn("spreadsheetml", "is");
+    const auto &text_element_name = qn("spreadsheetml", "t");
+    const auto &run_element_name = qn("spreadsheetml", "r");
+
+    // appends character content to the row's text and returns its length
+    auto read_text_into_row = [&]() {
+        const auto start = row.text_.size();
+
+        while (parser().peek() == xml::parser::event_type::characters)
+        {
+            parser().next_expect(xml::parser::event_type::characters);
+            row.text_.append(parser().value());
+        }
+
+        return row.text_.size() - start;
+    };
+
+    row.row_ = streaming_row_;
+
+    while (in_element(row_element))
+    {
+        expect_start_element(cell_element, xml::content::complex);
+
+        row.cells_.emplace_back();
+        auto &cell = row.cells_.back();
+        cell.row_ = streaming_row_;
+        cell.base_date_ = base_date;
+        cell.column_ = row.cells_.size() > 1 ? row.cells_[row.cells_.size() - 2].column_ + 1 : 1;
+
+        auto type = std::string("n");
+
+        for (const auto &attribute : parser().attribute_map())
+        {
+            const auto &name = attribute.first.name();
+            const auto &value = attribute.second.value;
+
+            if (name == "r")
+            {
+                cell.column_ = cell_reference::from_chars(value.data(), value.data() + value.size()).column_index();
+            }
+            else if (name == "t")
+            {
+                type = value;
+            }
+            else if (name == "s")
+            {
+                cell.has_format_ = true;
+                cell.format_id_ = static_cast<std::size_t>(std::stoull(value));
+            }
+            else if (name == "ph")
+            {
+                cell.phonetics_visible_ = is_true(value);
+            }
+        }
+
+        auto has_value = false;
+        auto value_length = std::size_t(0);
+        auto formula_length = std::size_t(0);
+
+        while (in_element(cell_element))
+        {
+            auto current_element = expect_start_element(xml::content::mixed);
+
+            if (current_element == value_element) // s:ST_Xstring
+            {
+                has_value = true;
+                cell.raw_value_offset_ = row.text_.size();
+                value_length = read_text_into_row();
+            }
+            else if (current_element == formula_element) // CT_CellFormula
+            {
+                auto shared_formula = false;
+
+                for (const auto &attribute : parser().attribute_map())
+                {
+                    if (attribute.first.name() == "t")
+                    {
+                        shared_formula = attribute.second.value == "shared";
+                    }
+                }
+
+                cell.formula_offset_ = row.text_.size();
+                formula_length = read_text_into_row();
+                cell.has_formula_ = !shared_formula;
+            }
+            else if (current_element == inline_string_element) // CT_Rst
+            {
+                // runs are flattened to their text, as rich_text::plain_text does
+                has_value = true;
+                cell.raw_value_offset_ = row.text_.size();
+
+                while (in_element(inline_string_element))
+                {
+                    auto text_element = expect_start_element(xml::content::mixed);
+
+                    if (text_element == text_element_name)
+                    {
+                        read_text_into_row();
+                    }
+                    else if (text_element == run_element_name)
+                    {
+                        while (in_element(run_element_name))
+                        {
+                            auto run_element = expect_start_element(xml::content::mixed);
+
+                            if (run_element == text_element_name)
+                            {
+                                read_text_into_row();
+                            }
+                            else
+                            {
+                                skip_remaining_content(run_element);
+                            }
+
+                            expect_end_element(run_element);
+                        }
+                    }
+                    else
+                    {
+                        skip_remaining_content(text_element);
+                    }
+
+                    expect_end_element(text_element);
+                }
+
+                value_length = row.text_.size() - cell.raw_value_offset_;
+            }
+            else
+            {
+                unexpected_element(current_element);
+            }
+
+            expect_end_element(current_element);
+        }
+
+        expect_end_element(cell_element);
+
+        // views are filled in once the row is complete since text_ may reallocate until then
+        cell.raw_value_ = string_view(nullptr, value_length);
+        cell.formula_ = string_view(nullptr, formula_length);
+
+        if (!has_value)
+        {
+            cell.type_ = cell_type::empty;
+        }
+        else if (type == "s")
+        {
+            cell.type_ = cell_type::shared_string;
+        }
+        else if (type == "str")
+        {
+            cell.type_ = cell_type::formula_string;
+        }
+        else if (type == "inlineStr")
+        {
+            cell.type_ = cell_type::inline_string;
+        }
+        else if (type == "b")
+        {
+            cell.type_ = cell_type::boolean;
+        }
+        else if (type == "e")
+        {
+            cell.type_ = cell_type::error;
+        }
+        else if (type == "d")
+        {
+            cell.type_ = cell_type::date;
+        }
+        else
+        {
+            cell.type_ = cell_type::number;
+        }
+    }
+
+    expect_end_element(row_element);
+
+    for (auto &cell : row.cells_)
+    {
+        cell.raw_value_ = string_view(row.text_.data() + cell.raw_value_offset_, cell.raw_value_.size());
+        cell.formula_ = string_view(row.text_.data() + cell.formula_offset_, cell.formula_.size());
+        cell.text_ = cell.raw_value_;
+
+        if (cell.type_ == cell_type::shared_string)
+        {
+            const auto index = static_cast<std::size_t>(converter_.deserialise(cell.raw_value_.data(), cell.raw_value_.size()));
+
+            if (index + 1 >= shared_strings.offsets.size())
+            {
+                throw xlnt::exception("shared string index out of range");
+            }
+
+            cell.text_ = string_view(shared_strings.text.data() + shared_strings.offsets[index],
+                shared_strings.offsets[index + 1] - shared_strings.offsets[index]);
+        }
+    }
+
+    return true;
+}
+
+void xlsx_consumer::begin_streaming_worksheet(const std::string &title)
+{
+    const auto &rel_id = target_.d_->sheet_title_rel_id_map_.at(title);
+    const auto workbook_rel = target_.manifest().relationship(path("/"), relationship_type::office_document);
+    const auto worksheet_rel = target_.manifest().relationship(workbook_rel.target().path(), rel_id);
+    const auto part_path = target_.manifest().canonicalize({workbook_rel, worksheet_rel});
+
+    // the previous part is released before opening the next to keep one decompressor per consumer
+    streaming_parser_.reset();
+    streaming_part_stream_.reset();
+    streaming_part_buffer_ = archive_->open(part_path);
+    streaming_part_stream_.reset(new std::istream(streaming_part_buffer_.get()));
+    streaming_parser_.reset(new xml::parser(*streaming_part_stream_, part_path.string()));
+    parser_ = streaming_parser_.get();
+    stack_.clear();
+
+    current_worksheet_ = nullptr;
+
+    for (auto &impl : target_.d_->worksheets_)
+    {
+        if (impl.title_ == title)
+        {
+            current_worksheet_ = &impl;
+        }
+    }
+
+    if (current_worksheet_ == nullptr)
+    {
+        throw xlnt::exception("sheet not found");
+    }
+
+    read_worksheet_begin(rel_id);
+}
+
+std::shared_ptr<const xlsx_consumer::shared_string_table> xlsx_consumer::flat_shared_strings()
+{
+    const auto &shared_strings = target_.shared_strings();
+
+    if (!shared_string_table_ || shared_string_table_->offsets.size() != shared_strings.size() + 1)
+    {
+        auto table = std::make_shared<shared_string_table>();
+        table->offsets.push_back(0);
+
+        for (const auto &shared_string : shared_strings)
+        {
+            table->text.append(shared_string.plain_text());
+            table->offsets.push_back(table->text.size());
+        }
+
+        shared_string_table_ = table;
+    }
+
+    return shared_string_table_;
+}
+
 std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
 {
     const auto part_rels_path = part.parent().append("_rels").append(part.filename() + ".rels").relative_to(path("/"));
@@ -1465,6 +2159,13 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 {
     const auto &manifest = target_.manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
+
+    if (rel_chain.back().type() == relationship_type::shared_string_table)
+    {
+        read_shared_string_table(archive_->read(part_path), part_path);
+        return;
+    }
+
     auto part_streambuf = archive_->open(part_path);
     std::istream part_stream(part_streambuf.get());
     xml::parser parser(part_stream, part_path.string());
@@ -1513,7 +2214,6 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
         break;
 
     case relationship_type::shared_string_table:
-        read_shared_string_table();
         break;
 
     case relationship_type::stylesheet:
@@ -1630,6 +2330,27 @@ void xlsx_consumer::populate_workbook(bool streaming)
         }
     }
 
+    if (xlsb_consumer::is_xlsb(manifest()))
+    {
+        if (streaming_)
+        {
+            throw xlnt::invalid_file("XLSB workbooks can't be streamed");
+        }
+
+        xlsb_consumer(target_, *archive_).read();
+
+        // the theme is XML in XLSB too
+        const auto workbook_rel = manifest().relationship(root_path, relationship_type::office_document);
+        const auto workbook_path = workbook_rel.target().path();
+
+        if (manifest().has_relationship(workbook_path, relationship_type::theme))
+        {
+            read_part({workbook_rel, manifest().relationship(workbook_path, relationship_type::theme)});
+        }
+
+        return;
+    }
+
     read_part({manifest().relationship(root_path,
         relationship_type::office_document)});
 }
@@ -2036,6 +2757,11 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
         current_worksheet_ = &*target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
 
+        if (target_.d_->max_resident_cells_ != 0 && !streaming_)
+        {
+            current_worksheet_->pager_.reset(new cell_pager(target_.d_->max_resident_cells_));
+        }
+
         if (!streaming_)
         {
             read_part({workbook_rel, worksheet_rel});
@@ -2107,6 +2833,92 @@ void xlsx_consumer::read_shared_string_table()
     }
 }
 
+void xlsx_consumer::read_shared_string_table(const std::string &xml, const path &part)
+{
+    auto &strings = target_.d_->shared_strings_values_;
+    const auto first = strings.size();
+
+    shared_string_scanner scanner(xml);
+
+    if (scanner.read_start())
+    {
+        if (scanner.has_unique_count())
+        {
+            // the count comes from the file, so no more is reserved than the part can hold,
+            // leaving a wrong count to be reported once the strings are read
+            const auto most_strings = xml.size() / (sizeof("<si><t/></si>") - 1);
+            strings.reserve(first + std::min(scanner.unique_count(), most_strings));
+        }
+
+        // complex entries are collected into one document so that only one parser is needed
+        auto complex_entries = scanner.start_tag();
+        std::vector<std::size_t> complex_indices;
+        auto result = shared_string_scanner::entry::plain;
+
+        while (true)
+        {
+            strings.emplace_back();
+            auto &text = strings.back();
+            result = scanner.next(rich_text_access::plain_text(text), rich_text_access::plain_preserve_space(text));
+
+            if (result == shared_string_scanner::entry::plain)
+            {
+                rich_text_access::make_plain(text);
+            }
+            else if (result == shared_string_scanner::entry::complex)
+            {
+                complex_indices.push_back(strings.size() - 1);
+                complex_entries.append(xml, scanner.entry_begin(), scanner.entry_end() - scanner.entry_begin());
+            }
+            else
+            {
+                strings.pop_back();
+                break;
+            }
+        }
+
+        if (result == shared_string_scanner::entry::end)
+        {
+            if (!complex_indices.empty())
+            {
+                complex_entries.append("</sst>");
+                std::istringstream complex_stream(complex_entries);
+                xml::parser complex_parser(complex_stream, part.string());
+                parser_ = &complex_parser;
+
+                expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+                skip_attributes();
+
+                for (auto index : complex_indices)
+                {
+                    expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
+                    strings[index] = read_rich_text(qn("spreadsheetml", "si"));
+                    expect_end_element(qn("spreadsheetml", "si"));
+                }
+
+                expect_end_element(qn("spreadsheetml", "sst"));
+                parser_ = nullptr;
+            }
+
+            if (scanner.has_unique_count() && scanner.unique_count() != strings.size())
+            {
+                throw invalid_file("sizes don't match");
+            }
+
+            return;
+        }
+
+        strings.resize(first);
+    }
+
+    // anything the scanner doesn't recognise is read by the parser from the start
+    std::istringstream stream(xml);
+    xml::parser parser(stream, part.string());
+    parser_ = &parser;
+    read_shared_string_table();
+    parser_ = nullptr;
+}
+
 void xlsx_consumer::read_shared_workbook_revision_headers()
 {
 }
@@ -2871,7 +3683,12 @@ void xlsx_consumer::read_drawings(worksheet ws, const path &part)
 {
     auto images = manifest().relationships(part, relationship_type::image);
 
-    auto sd = drawing::spreadsheet_drawing(parser());
+    // drawings are kept as markup and written back out verbatim so they aren't parsed here
+    auto drawing_streambuf = archive_->open(part);
+    std::ostringstream drawing_markup;
+    drawing_markup << drawing_streambuf.get();
+
+    auto sd = drawing::spreadsheet_drawing(drawing_markup.str());
 
     for (const auto &image_rel_id : sd.get_embed_ids())
     {
@@ -3099,8 +3916,8 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
         }
         else if (text_element == xml::qname(xmlns, "r"))
         {
-            rich_text_run run;
-            run.preserve_space = preserve_space;
+            std::string run_text_value;
+            optional<font> run_font;
 
             while (in_element(xml::qname(xmlns, "r")))
             {
@@ -3109,7 +3926,7 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
                 if (run_element == xml::qname(xmlns, "rPr"))
                 {
-                    run.second = xlnt::font();
+                    run_font = xlnt::font();
 
                     while (in_element(xml::qname(xmlns, "rPr")))
                     {
@@ -3117,37 +3934,37 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
                         if (current_run_property_element == xml::qname(xmlns, "sz"))
                         {
-                            run.second.get().size(converter_.deserialise(parser().attribute("val")));
+                            run_font.get().size(converter_.deserialise(parser().attribute("val")));
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "rFont"))
                         {
-                            run.second.get().name(parser().attribute("val"));
+                            run_font.get().name(parser().attribute("val"));
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "color"))
                         {
-                            run.second.get().color(read_color());
+                            run_font.get().color(read_color());
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "family"))
                         {
-                            run.second.get().family(parser().attribute<std::size_t>("val"));
+                            run_font.get().family(parser().attribute<std::size_t>("val"));
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "charset"))
                         {
-                            run.second.get().charset(parser().attribute<std::size_t>("val"));
+                            run_font.get().charset(parser().attribute<std::size_t>("val"));
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "scheme"))
                         {
-                            run.second.get().scheme(parser().attribute("val"));
+                            run_font.get().scheme(parser().attribute("val"));
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "b"))
                         {
-                            run.second.get().bold(parser().attribute_present("val")
+                            run_font.get().bold(parser().attribute_present("val")
                                     ? is_true(parser().attribute("val"))
                                     : true);
                         }
                         else if (current_run_property_element == xml::qname(xmlns, "i"))
                         {
-                            run.second.get().italic(parser().attribute_present("val")
+                            run_font.get().italic(parser().attribute_present("val")
                                     ? is_true(parser().attribute("val"))
                                     : true);
                         }
@@ -3155,11 +3972,11 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
                         {
                             if (parser().attribute_present("val"))
                             {
-                                run.second.get().underline(parser().attribute<font::underline_style>("val"));
+                                run_font.get().underline(parser().attribute<font::underline_style>("val"));
                             }
                             else
                             {
-                                run.second.get().underline(font::underline_style::single);
+                                run_font.get().underline(font::underline_style::single);
                             }
                         }
                         else
@@ -3173,7 +3990,7 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
                 }
                 else if (run_element == xml::qname(xmlns, "t"))
                 {
-                    run.first = run_text;
+                    run_text_value = run_text;
                 }
                 else
                 {
@@ -3185,11 +4002,15 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
                 read_text();
             }
 
-            t.add_run(run);
+            // equal run fonts are shared across the workbook rather than stored per run
+            rich_text_access::add_run(t, run_text_value,
+                run_font.is_set() ? target_.d_->font_pool_.intern(run_font.get()) : nullptr,
+                preserve_space);
         }
         else if (text_element == xml::qname(xmlns, "rPh"))
         {
             phonetic_run pr;
+            pr.preserve_space = false;
             pr.start = parser().attribute<std::uint32_t>("sb");
             pr.end = parser().attribute<std::uint32_t>("eb");
 
@@ -34,6 +34,7 @@
 
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
+#include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/numeric.hpp>
 
 namespace xlnt {
@@ -46,7 +47,9 @@ template<typename T>
 class optional;
 class path;
 class relationship;
+class row_view;
 class streaming_workbook_reader;
+class streaming_worksheet_cursor;
 class variant;
 class workbook;
 class worksheet;
@@ -73,6 +76,17 @@ public:
 
 private:
     friend class xlnt::streaming_workbook_reader;
+    friend class xlnt::streaming_worksheet_cursor;
+
+    /// <summary>
+    /// The plain text of every shared string, concatenated, and the offset of
+    /// each string into it, so that streamed cells can point into it.
+    /// </summary>
+    struct shared_string_table
+    {
+        std::string text;
+        std::vector<std::size_t> offsets;
+    };
 
     void open(std::istream &source);
 
@@ -85,6 +99,31 @@ private:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the remaining cells of the current row, or all cells of the next row,
+    /// into row without creating cells in the worksheet. Returns false if the last
+    /// row in the sheet has already been read.
+    /// </summary>
+    bool read_row(row_view &row);
+
+    /// <summary>
+    /// Reads the start of the next row and its properties. Returns false and ends
+    /// streaming of the worksheet at the end of sheetData.
+    /// </summary>
+    bool read_row_start();
+
+    /// <summary>
+    /// Opens the part of the worksheet with the given title from archive_ and reads
+    /// it up to its first row. The part's stream and parser are owned by this consumer,
+    /// so consumers sharing an archive can stream different worksheets at once.
+    /// </summary>
+    void begin_streaming_worksheet(const std::string &title);
+
+    /// <summary>
+    /// Returns the flattened shared strings of the workbook, building them on first use.
+    /// </summary>
+    std::shared_ptr<const shared_string_table> flat_shared_strings();
+
 	/// <summary>
 	/// Read all the files needed from the XLSX archive and initialize all of
 	/// the data in the workbook to match.
@@ -158,6 +197,13 @@ private:
 	/// </summary>
 	void read_shared_string_table();
 
+	/// <summary>
+	/// xl/sharedStrings.xml given as the bytes of the part. Entries holding a single
+	/// unformatted run are decoded directly into the table and the others are read
+	/// with read_rich_text.
+	/// </summary>
+	void read_shared_string_table(const std::string &xml, const path &part);
+
 	/// <summary>
 	///
 	/// </summary>
@@ -379,8 +425,9 @@ private:
 
 	/// <summary>
 	/// The ZIP file containing the files that make up the OOXML package.
+	/// Shared by the consumers of streaming_worksheet_cursors opened from one reader.
 	/// </summary>
-	std::unique_ptr<izstream> archive_;
+	std::shared_ptr<izstream> archive_;
 
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
@@ -413,6 +460,24 @@ private:
 
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
+    /// <summary>
+    /// The index of the row most recently started while streaming.
+    /// </summary>
+    row_t streaming_row_ = 0;
+
+    /// <summary>
+    /// The shared strings as read_row uses them. Built once when read_row first
+    /// needs it and shared with cursors opened from the same reader.
+    /// </summary>
+    std::shared_ptr<const shared_string_table> shared_string_table_;
+
+    /// <summary>
+    /// The decompressed stream and parser of the worksheet part being streamed.
+    /// </summary>
+    std::unique_ptr<std::streambuf> streaming_part_buffer_;
+    std::unique_ptr<std::istream> streaming_part_stream_;
+    std::unique_ptr<xml::parser> streaming_parser_;
+
     detail::worksheet_impl *current_worksheet_;
     number_serialiser converter_;
 };
@@ -21,9 +21,14 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
 #include <numeric> // for std::accumulate
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_set>
 
@@ -33,12 +38,14 @@
 #include <xlnt/utils/numeric.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/scoped_enum_hash.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
+#include <detail/implementations/rich_text_access.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
@@ -74,6 +81,111 @@ std::vector<std::pair<std::string, std::string>> core_property_namespace(xlnt::c
     return {{constants::ns("core-properties"), "cp"}};
 }
 
+// Adaptive columns are written inline when at least nine in ten of their strings are
+// distinct, since sharing them would save next to nothing
+bool mostly_unique(std::size_t distinct, std::size_t count)
+{
+    return distinct * 10 >= count * 9;
+}
+
+// The number of strings of an adaptive column the streaming writer looks at before
+// deciding how the column is written
+const std::size_t streaming_string_sample_size = 1024;
+
+// Merges ranges that share their rows and touch horizontally, then ranges that
+// share their columns and touch vertically, so that rules applied cell by cell
+// are written as a few rectangles.
+std::vector<xlnt::range_reference> coalesce_ranges(std::vector<xlnt::range_reference> ranges)
+{
+    using xlnt::range_reference;
+
+    auto merge = [&ranges](bool by_rows) {
+        std::sort(ranges.begin(), ranges.end(), [by_rows](const range_reference &a, const range_reference &b) {
+            const auto a_key = by_rows
+                ? std::make_tuple(a.top_left().row(), a.bottom_right().row(), a.top_left().column_index(), a.bottom_right().column_index())
+                : std::make_tuple(a.top_left().column_index(), a.bottom_right().column_index(), a.top_left().row(), a.bottom_right().row());
+            const auto b_key = by_rows
+                ? std::make_tuple(b.top_left().row(), b.bottom_right().row(), b.top_left().column_index(), b.bottom_right().column_index())
+                : std::make_tuple(b.top_left().column_index(), b.bottom_right().column_index(), b.top_left().row(), b.bottom_right().row());
+            return a_key < b_key;
+        });
+
+        auto merged = std::vector<range_reference>();
+
+        for (const auto &current : ranges)
+        {
+            if (!merged.empty())
+            {
+                auto &last = merged.back();
+
+                if (by_rows && last.top_left().row() == current.top_left().row()
+                    && last.bottom_right().row() == current.bottom_right().row()
+                    && current.top_left().column_index() <= last.bottom_right().column_index() + 1)
+                {
+                    const auto right = std::max(last.bottom_right().column_index(), current.bottom_right().column_index());
+                    last = range_reference(last.top_left().column_index(), last.top_left().row(), right, last.bottom_right().row());
+                    continue;
+                }
+
+                if (!by_rows && last.top_left().column_index() == current.top_left().column_index()
+                    && last.bottom_right().column_index() == current.bottom_right().column_index()
+                    && current.top_left().row() <= last.bottom_right().row() + 1)
+                {
+                    const auto bottom = std::max(last.bottom_right().row(), current.bottom_right().row());
+                    last = range_reference(last.top_left().column_index(), last.top_left().row(), last.bottom_right().column_index(), bottom);
+                    continue;
+                }
+            }
+
+            merged.push_back(current);
+        }
+
+        ranges.swap(merged);
+    };
+
+    merge(true);
+    merge(false);
+
+    return ranges;
+}
+
+/// <summary>
+/// Compressed parts shared by every save in the process. Only the built-in default
+/// theme is kept, since it is written unchanged by every save, so the XML it was
+/// compressed from never needs to be compared.
+/// </summary>
+class part_cache
+{
+public:
+    static part_cache &instance()
+    {
+        static part_cache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const xlnt::detail::zspool> find(const xlnt::path &part)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto match = parts_.find(part.string());
+
+        return match == parts_.end() ? nullptr : match->second;
+    }
+
+    void insert(const xlnt::path &part, std::shared_ptr<const xlnt::detail::zspool> spool)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        parts_.emplace(part.string(), std::move(spool));
+    }
+
+private:
+    std::mutex mutex_;
+
+    /// <summary>
+    /// Spools by archive path, which only varies with where loaded workbooks kept their theme.
+    /// </summary>
+    std::unordered_map<std::string, std::shared_ptr<const xlnt::detail::zspool>> parts_;
+};
+
 } // namespace
 
 namespace xlnt {
@@ -82,7 +194,6 @@ namespace detail {
 xlsx_producer::xlsx_producer(const workbook &target)
     : source_(target),
       current_part_stream_(nullptr),
-      current_cell_(nullptr),
       current_worksheet_(nullptr)
 {
 }
@@ -95,39 +206,329 @@ xlsx_producer::~xlsx_producer()
 
 void xlsx_producer::write(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
-    populate_archive(false);
+    write(std::unique_ptr<ozstream>(new ozstream(destination)));
+}
+
+void xlsx_producer::write(std::unique_ptr<ozstream> archive)
+{
+    archive_ = std::move(archive);
+    populate_archive();
+}
+
+// Streaming
+
+void xlsx_producer::begin_streaming_worksheet(worksheet ws, std::mutex &mutex, ozstream *archive)
+{
+    streaming_ = true;
+    streaming_mutex_ = &mutex;
+    streaming_archive_ = archive;
+    current_worksheet_ = ws.d_;
+
+    // the manifest is only reconciled when the worksheet ends since the other producers change it meanwhile
+    const auto &manifest = source_.manifest();
+    const auto workbook_part = manifest.relationship(path("/"), relationship_type::office_document).target().path();
+    const auto worksheet_rel = manifest.relationship(workbook_part,
+        source_.d_->sheet_title_rel_id_map_.at(ws.title()));
+    streaming_part_path_ = worksheet_rel.source().path().parent().append(worksheet_rel.target().path());
+
+    streaming_workbook_.reset(new workbook());
+    streaming_workbook_->base_date(source_.base_date());
+    streaming_workbook_->d_->stylesheet_.get().garbage_collection_enabled = false;
+
+    streaming_cell_.reset(new cell_impl());
+    streaming_cell_->parent_ = streaming_workbook_->active_sheet().d_;
+}
+
+cell xlsx_producer::add_streaming_cell(const cell_reference &ref)
+{
+    if (!current_part_serializer_)
+    {
+        begin_streaming_part();
+    }
+    else if (streaming_cell_pending_)
+    {
+        if (ref.row() < streaming_cell_->row_
+            || (ref.row() == streaming_cell_->row_ && ref.column() <= streaming_cell_->column_))
+        {
+            throw xlnt::invalid_parameter();
+        }
+
+        write_streaming_cell();
+    }
+
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    if (ref.row() != streaming_row_)
+    {
+        if (streaming_row_ != 0)
+        {
+            write_end_element(xmlns, "row");
+        }
+
+        streaming_row_ = ref.row();
+        write_start_element(xmlns, "row");
+        write_attribute("r", streaming_row_);
+
+        auto ws = worksheet(current_worksheet_);
+
+        if (ws.has_row_properties(streaming_row_))
+        {
+            write_row_properties(ws.row_properties(streaming_row_));
+        }
+    }
+
+    auto parent = streaming_cell_->parent_;
+    *streaming_cell_ = cell_impl();
+    streaming_cell_->parent_ = parent;
+    streaming_cell_->column_ = ref.column();
+    streaming_cell_->row_ = ref.row();
+    streaming_cell_pending_ = true;
+
+    return cell(streaming_cell_.get());
 }
 
-void xlsx_producer::open(std::ostream &destination)
+void xlsx_producer::end_streaming_worksheet()
 {
-    archive_.reset(new ozstream(destination));
-    populate_archive(true);
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    if (!current_part_serializer_)
+    {
+        begin_streaming_part();
+    }
+
+    if (streaming_cell_pending_)
+    {
+        write_streaming_cell();
+    }
+
+    if (streaming_row_ != 0)
+    {
+        write_end_element(xmlns, "row");
+        streaming_row_ = 0;
+    }
+
+    write_end_element(xmlns, "sheetData");
+
+    {
+        std::lock_guard<std::mutex> lock(*streaming_mutex_);
+        reconcile_manifest();
+    }
+
+    write_worksheet_end(worksheet(current_worksheet_), streaming_part_path_, {});
+    end_part();
+
+    streaming_cell_.reset();
+    streaming_workbook_.reset();
 }
 
-cell xlsx_producer::add_cell(const cell_reference &ref)
+void xlsx_producer::begin_streaming_part()
 {
-    current_cell_->column_ = ref.column();
-    current_cell_->row_ = ref.row();
+    if (streaming_archive_ != nullptr)
+    {
+        current_part_streambuf_ = streaming_archive_->open(streaming_part_path_);
+    }
+    else
+    {
+        streaming_part_.reset(new zspool(streaming_part_path_, true));
+        current_part_streambuf_ = streaming_part_->open();
+    }
 
-    return cell(current_cell_);
+    current_part_stream_.rdbuf(current_part_streambuf_.get());
+    current_part_serializer_.reset(new xml::serializer(current_part_stream_, streaming_part_path_.string()));
+
+    // the worksheet's string storage is final once its first cell is added, so the
+    // scratch worksheet takes it over and stores strings of inline columns directly
+    streaming_workbook_->d_->default_string_storage_ = current_worksheet_->parent_->d_->default_string_storage_;
+    streaming_workbook_->active_sheet().d_->column_string_storage_ = current_worksheet_->column_string_storage_;
+
+    write_worksheet_begin(worksheet(current_worksheet_));
+    write_start_element(constants::ns("spreadsheetml"), "sheetData");
 }
 
-worksheet xlsx_producer::add_worksheet(const std::string &title)
+void xlsx_producer::write_streaming_cell()
 {
-    current_worksheet_->title_ = title;
-    return worksheet(current_worksheet_);
+    streaming_cell_pending_ = false;
+
+    auto c = cell(streaming_cell_.get());
+    if (c.garbage_collectible()) return;
+
+    auto format_id = std::size_t(0);
+
+    if (c.has_format())
+    {
+        format_id = streaming_format_id(*streaming_cell_->format_.get());
+    }
+
+    apply_streaming_string_storage();
+
+    if (streaming_cell_->type_ == cell_type::shared_string)
+    {
+        const auto id = streaming_shared_string_id(static_cast<std::size_t>(streaming_cell_->value_numeric_));
+        streaming_cell_->value_numeric_ = static_cast<double>(id);
+        ++streaming_shared_string_count_;
+    }
+
+    write_cell(c, format_id);
+
+    // Setting a format on a cell without one creates a format which is usually
+    // merged into an existing one right away. Drop such leftovers so that the
+    // scratch stylesheet doesn't grow with the number of cells written.
+    auto &formats = streaming_workbook_->d_->stylesheet_.get().format_impls;
+
+    while (!formats.empty() && formats.back().references == 0)
+    {
+        formats.pop_back();
+    }
+
+    if (streaming_format_ids_.size() > formats.size())
+    {
+        streaming_format_ids_.resize(formats.size());
+    }
 }
 
-// Part Writing Methods
+std::size_t xlsx_producer::streaming_format_id(const format_impl &scratch_format)
+{
+    if (scratch_format.id < streaming_format_ids_.size()
+        && streaming_format_ids_[scratch_format.id].first == scratch_format)
+    {
+        return streaming_format_ids_[scratch_format.id].second;
+    }
+
+    const auto &scratch = *scratch_format.parent;
+    auto merged = scratch_format;
+    std::size_t merged_id = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(*streaming_mutex_);
+        auto &target = current_worksheet_->parent_->d_->stylesheet_.get();
+
+        merged.parent = &target;
+        merged.references = 1;
+
+        if (merged.alignment_id.is_set())
+        {
+            merged.alignment_id = target.find_or_add(target.alignments, scratch.alignments.at(merged.alignment_id.get()));
+        }
+        if (merged.border_id.is_set())
+        {
+            merged.border_id = target.find_or_add(target.borders, scratch.borders.at(merged.border_id.get()));
+        }
+        if (merged.fill_id.is_set())
+        {
+            merged.fill_id = target.find_or_add(target.fills, scratch.fills.at(merged.fill_id.get()));
+        }
+        if (merged.font_id.is_set())
+        {
+            merged.font_id = target.find_or_add(target.fonts, scratch.fonts.at(merged.font_id.get()));
+        }
+        if (merged.protection_id.is_set())
+        {
+            merged.protection_id = target.find_or_add(target.protections, scratch.protections.at(merged.protection_id.get()));
+        }
+        if (merged.number_format_id.is_set() && !number_format::is_builtin_format(merged.number_format_id.get()))
+        {
+            const auto id = merged.number_format_id.get();
+            const auto &format_string = std::find_if(scratch.number_formats.begin(), scratch.number_formats.end(),
+                [id](const number_format &nf) { return nf.id() == id; })->format_string();
+            auto match = std::find_if(target.number_formats.begin(), target.number_formats.end(),
+                [&format_string](const number_format &nf) { return nf.format_string() == format_string; });
+
+            if (match == target.number_formats.end())
+            {
+                target.number_formats.push_back(number_format(format_string, target.next_custom_number_format_id()));
+                match = target.number_formats.end() - 1;
+            }
+
+            merged.number_format_id = match->id();
+        }
+        if (merged.style.is_set() && target.style_impls.find(merged.style.get()) == target.style_impls.end())
+        {
+            merged.style.clear();
+        }
+
+        auto match = std::find(target.format_impls.begin(), target.format_impls.end(), merged);
+        merged_id = static_cast<std::size_t>(std::distance(target.format_impls.begin(), match));
+
+        if (match == target.format_impls.end())
+        {
+            merged.id = merged_id;
+            target.format_impls.push_back(merged);
+        }
+    }
+
+    if (streaming_format_ids_.size() <= scratch_format.id)
+    {
+        streaming_format_ids_.resize(scratch_format.id + 1, std::make_pair(format_impl(), std::size_t(0)));
+    }
+
+    streaming_format_ids_[scratch_format.id] = std::make_pair(scratch_format, merged_id);
+
+    return merged_id;
+}
+
+std::size_t xlsx_producer::streaming_shared_string_id(std::size_t scratch_id)
+{
+    if (scratch_id < streaming_shared_string_ids_.size() && streaming_shared_string_ids_[scratch_id] != std::size_t(-1))
+    {
+        return streaming_shared_string_ids_[scratch_id];
+    }
+
+    if (streaming_shared_string_ids_.size() <= scratch_id)
+    {
+        streaming_shared_string_ids_.resize(scratch_id + 1, std::size_t(-1));
+    }
+
+    const auto &text = streaming_workbook_->d_->shared_strings_values_.at(scratch_id);
+
+    std::lock_guard<std::mutex> lock(*streaming_mutex_);
+    auto id = current_worksheet_->parent_->add_shared_string(text);
+    streaming_shared_string_ids_[scratch_id] = id;
+
+    return id;
+}
 
-void xlsx_producer::populate_archive(bool streaming)
+void xlsx_producer::apply_streaming_string_storage()
 {
-    streaming_ = streaming;
+    auto &streamed = *streaming_cell_;
+    if (streamed.type_ != cell_type::shared_string) return;
+
+    auto &scratch_storage = streaming_workbook_->active_sheet().d_->column_string_storage_;
+    auto storage = scratch_storage.find(streamed.column_);
+    if (storage == scratch_storage.end())
+    {
+        if (streaming_workbook_->d_->default_string_storage_ != string_storage::adaptive) return;
+    }
+    else if (storage->second != string_storage::adaptive)
+    {
+        return;
+    }
+
+    const auto scratch_id = static_cast<std::size_t>(streamed.value_numeric_);
+    auto &sample = streaming_string_samples_[streamed.column_.index];
+    sample.ids.insert(scratch_id);
+
+    if (++sample.count < streaming_string_sample_size) return;
+
+    // the rest of the column is stored by the scratch worksheet's setters as decided here
+    const auto inline_strings = mostly_unique(sample.ids.size(), sample.count);
+    scratch_storage[streamed.column_] = inline_strings ? string_storage::inline_string : string_storage::shared;
+    streaming_string_samples_.erase(streamed.column_.index);
+
+    if (inline_strings)
+    {
+        streamed.value_text_ = streaming_workbook_->d_->shared_strings_values_.at(scratch_id);
+        streamed.type_ = cell_type::inline_string;
+    }
+}
+
+// Part Writing Methods
 
+void xlsx_producer::populate_archive()
+{
+    reconcile_manifest();
     write_content_types();
 
-    const auto root_rels = source_.manifest().relationships(path("/"));
+    const auto root_rels = manifest_.relationships(path("/"));
     write_relationships(root_rels, path("/"));
 
     for (auto &rel : root_rels)
@@ -167,6 +568,13 @@ void xlsx_producer::populate_archive(bool streaming)
     end_part();
 }
 
+void xlsx_producer::reconcile_manifest()
+{
+    // cell setters leave part registration to be done here, once, rather than on every call
+    manifest_ = source_.manifest();
+    source_.reconcile_manifest(manifest_);
+}
+
 void xlsx_producer::end_part()
 {
     if (current_part_serializer_)
@@ -185,6 +593,44 @@ void xlsx_producer::begin_part(const path &part)
     current_part_serializer_.reset(new xml::serializer(current_part_stream_, part.string()));
 }
 
+std::string xlsx_producer::render_part(const path &part, const std::function<void()> &write)
+{
+    end_part();
+
+    std::ostringstream rendered;
+    current_part_stream_.rdbuf(rendered.rdbuf());
+    current_part_serializer_.reset(new xml::serializer(current_part_stream_, part.string()));
+    write();
+    current_part_serializer_.reset();
+    current_part_stream_.rdbuf(nullptr);
+
+    return rendered.str();
+}
+
+void xlsx_producer::write_cached_part(const path &part, const std::function<std::string()> &content)
+{
+    end_part();
+
+    auto &cache = part_cache::instance();
+    auto cached = cache.find(part);
+
+    if (cached == nullptr)
+    {
+        const auto xml = content();
+        auto spool = std::make_shared<zspool>(part);
+
+        {
+            auto spool_buffer = spool->open();
+            spool_buffer->sputn(xml.data(), static_cast<std::streamsize>(xml.size()));
+        }
+
+        cache.insert(part, spool);
+        cached = spool;
+    }
+
+    archive_->append(*cached);
+}
+
 // Package Parts
 
 void xlsx_producer::write_content_types()
@@ -197,19 +643,19 @@ void xlsx_producer::write_content_types()
     write_start_element(xmlns, "Types");
     write_namespace(xmlns, "");
 
-    for (const auto &extension : source_.manifest().extensions_with_default_types())
+    for (const auto &extension : manifest_.extensions_with_default_types())
     {
         write_start_element(xmlns, "Default");
         write_attribute("Extension", extension);
-        write_attribute("ContentType", source_.manifest().default_type(extension));
+        write_attribute("ContentType", manifest_.default_type(extension));
         write_end_element(xmlns, "Default");
     }
 
-    for (const auto &part : source_.manifest().parts_with_overriden_types())
+    for (const auto &part : manifest_.parts_with_overriden_types())
     {
         write_start_element(xmlns, "Override");
         write_attribute("PartName", part.resolve(path("/")).string());
-        write_attribute("ContentType", source_.manifest().override_type(part));
+        write_attribute("ContentType", manifest_.override_type(part));
         write_end_element(xmlns, "Override");
     }
 
@@ -664,7 +1110,7 @@ void xlsx_producer::write_workbook(const relationship &rel)
 
     write_end_element(xmlns, "workbook");
 
-    auto workbook_rels = source_.manifest().relationships(rel.target().path());
+    auto workbook_rels = manifest_.relationships(rel.target().path());
     write_relationships(workbook_rels, rel.target().path());
 
     for (const auto &child_rel : workbook_rels)
@@ -672,6 +1118,30 @@ void xlsx_producer::write_workbook(const relationship &rel)
         if (child_rel.type() == relationship_type::calculation_chain) continue;
 
         path archive_path(child_rel.source().path().parent().append(child_rel.target().path()));
+
+        auto streamed = streamed_worksheets_.find(archive_path.string());
+
+        if (streamed != streamed_worksheets_.end())
+        {
+            end_part();
+
+            // a worksheet without a spool was written straight into the archive
+            if (streamed->second->streaming_part_)
+            {
+                archive_->append(*streamed->second->streaming_part_);
+            }
+
+            write_worksheet_parts(worksheet(streamed->second->current_worksheet_), archive_path, {});
+
+            continue;
+        }
+
+        if (child_rel.type() == relationship_type::theme)
+        {
+            write_theme(child_rel);
+            continue;
+        }
+
         begin_part(archive_path);
 
         switch (child_rel.type())
@@ -712,10 +1182,6 @@ void xlsx_producer::write_workbook(const relationship &rel)
             write_styles(child_rel);
             break;
 
-        case relationship_type::theme:
-            write_theme(child_rel);
-            break;
-
         case relationship_type::volatile_dependencies:
             write_volatile_dependencies(child_rel);
             break;
@@ -726,6 +1192,8 @@ void xlsx_producer::write_workbook(const relationship &rel)
 
         case relationship_type::calculation_chain:
             break;
+        case relationship_type::theme:
+            break;
         case relationship_type::office_document:
             break;
         case relationship_type::thumbnail:
@@ -812,72 +1280,72 @@ void xlsx_producer::write_pivot_table(const relationship & /*rel*/)
 
 void xlsx_producer::write_rich_text(const std::string &ns, const xlnt::rich_text &text)
 {
-    if (text.runs().size() == 1 && !text.runs().at(0).second.is_set())
+    if (rich_text_access::is_plain(text))
     {
         write_start_element(ns, "t");
-        write_characters(text.plain_text(), text.runs().front().preserve_space);
+        write_characters(rich_text_access::plain_text(text), rich_text_access::plain_preserve_space(text));
         write_end_element(ns, "t");
     }
     else
     {
-        for (const auto &run : text.runs())
-        {
+        rich_text_access::for_each_run(text, [&](const std::string &run_text, const font *text_font, bool preserve_space) {
             write_start_element(ns, "r");
 
-            if (run.second.is_set())
+            if (text_font != nullptr)
             {
+                const auto &run_font = *text_font;
                 write_start_element(ns, "rPr");
 
-                if (run.second.get().bold())
+                if (run_font.bold())
                 {
                     write_start_element(ns, "b");
                     write_end_element(ns, "b");
                 }
 
-                if (run.second.get().has_size())
+                if (run_font.has_size())
                 {
                     write_start_element(ns, "sz");
-                    write_attribute<double>("val", run.second.get().size());
+                    write_attribute<double>("val", run_font.size());
                     write_end_element(ns, "sz");
                 }
 
-                if (run.second.get().has_color())
+                if (run_font.has_color())
                 {
                     write_start_element(ns, "color");
-                    write_color(run.second.get().color());
+                    write_color(run_font.color());
                     write_end_element(ns, "color");
                 }
 
-                if (run.second.get().has_name())
+                if (run_font.has_name())
                 {
                     write_start_element(ns, "rFont");
-                    write_attribute("val", run.second.get().name());
+                    write_attribute("val", run_font.name());
                     write_end_element(ns, "rFont");
                 }
 
-                if (run.second.get().has_family())
+                if (run_font.has_family())
                 {
                     write_start_element(ns, "family");
-                    write_attribute("val", run.second.get().family());
+                    write_attribute("val", run_font.family());
                     write_end_element(ns, "family");
                 }
 
-                if (run.second.get().has_scheme())
+                if (run_font.has_scheme())
                 {
                     write_start_element(ns, "scheme");
-                    write_attribute("val", run.second.get().scheme());
+                    write_attribute("val", run_font.scheme());
                     write_end_element(ns, "scheme");
                 }
 
                 write_end_element(ns, "rPr");
             }
 
-            write_element(ns, "t", run.first, run.preserve_space);
+            write_element(ns, "t", run_text, preserve_space);
             write_end_element(ns, "r");
-        }
+        });
     }
 
-    for (const auto &run : text.phonetic_runs())
+    for (const auto &run : rich_text_access::phonetic_runs(text))
     {
         write_start_element(ns, "rPh");
         write_attribute("sb", run.start);
@@ -918,64 +1386,160 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
-    std::size_t string_count = 0;
-
-    for (const auto ws : source_)
-    {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
-        {
-            while (current_cell.column() <= dimension.bottom_right().column())
-            {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
+    index_string_storage();
 
-                current_cell.column_index(current_cell.column_index() + 1);
-            }
+    auto string_count = shared_string_count_;
 
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
-        }
+    for (const auto &streamed : streamed_worksheets_)
+    {
+        string_count += streamed.second->streaming_shared_string_count_;
     }
 
+    const auto &strings = source_.shared_strings();
+    const auto unique_count = shared_string_ids_.empty()
+        ? strings.size()
+        : static_cast<std::size_t>(std::count_if(shared_string_ids_.begin(), shared_string_ids_.end(),
+              [](std::size_t id) { return id != std::size_t(-1); }));
+
     write_attribute("count", string_count);
-    write_attribute("uniqueCount", source_.shared_strings().size());
+    write_attribute("uniqueCount", unique_count);
 
-    for (const auto &text : source_.shared_strings())
+    for (auto index = std::size_t(0); index < strings.size(); ++index)
     {
+        if (!shared_string_ids_.empty() && shared_string_ids_[index] == std::size_t(-1)) continue;
+
         write_start_element(xmlns, "si");
-        write_rich_text(xmlns, text);
+        write_rich_text(xmlns, strings[index]);
         write_end_element(xmlns, "si");
     }
 
     write_end_element(xmlns, "sst");
 }
 
-void xlsx_producer::write_shared_workbook_revision_headers(const relationship & /*rel*/)
+void xlsx_producer::index_string_storage()
 {
-    write_start_element(constants::ns("spreadsheetml"), "headers");
-    write_end_element(constants::ns("spreadsheetml"), "headers");
-}
+    if (string_storage_indexed_) return;
+    string_storage_indexed_ = true;
 
-void xlsx_producer::write_shared_workbook(const relationship & /*rel*/)
-{
-    write_start_element(constants::ns("spreadsheetml"), "revisions");
-    write_end_element(constants::ns("spreadsheetml"), "revisions");
-}
+    const auto &workbook = source_.impl();
+    auto any_inline = false;
 
-void xlsx_producer::write_shared_workbook_user_data(const relationship & /*rel*/)
-{
-    write_start_element(constants::ns("spreadsheetml"), "users");
-    write_end_element(constants::ns("spreadsheetml"), "users");
-}
+    // strings of streamed worksheets are only known by their ids, so none can be dropped
+    std::vector<bool> referenced(workbook.shared_strings_values_.size(), !streamed_worksheets_.empty());
 
-void xlsx_producer::write_font(const font &f)
+    for (const auto &sheet : workbook.worksheets_)
+    {
+        std::vector<bool> inline_columns;
+
+        if (!sheet.column_string_storage_.empty() || workbook.default_string_storage_ != string_storage::shared)
+        {
+            auto storage_of = [&](column_t column) {
+                auto match = sheet.column_string_storage_.find(column);
+                return match == sheet.column_string_storage_.end() ? workbook.default_string_storage_ : match->second;
+            };
+
+            auto mark_inline = [&inline_columns](column_t::index_t column) {
+                if (inline_columns.size() <= column)
+                {
+                    inline_columns.resize(column + 1, false);
+                }
+
+                inline_columns[column] = true;
+            };
+
+            // cardinality is measured on shared string ids, which are already deduplicated
+            std::vector<std::pair<column_t::index_t, std::size_t>> adaptive;
+
+            sheet.for_each_cell([&](const cell_impl &c) {
+                if (c.type_ != cell_type::shared_string) return;
+
+                const auto storage = storage_of(c.column_);
+
+                if (storage == string_storage::inline_string)
+                {
+                    mark_inline(c.column_.index);
+                }
+                else if (storage == string_storage::adaptive)
+                {
+                    adaptive.emplace_back(c.column_.index, static_cast<std::size_t>(c.value_numeric_));
+                }
+            });
+
+            std::sort(adaptive.begin(), adaptive.end());
+
+            for (auto first = adaptive.begin(); first != adaptive.end();)
+            {
+                auto last = first;
+                auto distinct = std::size_t(0);
+
+                for (; last != adaptive.end() && last->first == first->first; ++last)
+                {
+                    if (last == first || *last != *(last - 1))
+                    {
+                        ++distinct;
+                    }
+                }
+
+                if (mostly_unique(distinct, static_cast<std::size_t>(last - first)))
+                {
+                    mark_inline(first->first);
+                }
+
+                first = last;
+            }
+        }
+
+        sheet.for_each_cell([&](const cell_impl &c) {
+            if (c.type_ != cell_type::shared_string) return;
+
+            if (c.column_.index < inline_columns.size() && inline_columns[c.column_.index])
+            {
+                any_inline = true;
+                return;
+            }
+
+            referenced[static_cast<std::size_t>(c.value_numeric_)] = true;
+            ++shared_string_count_;
+        });
+
+        if (!inline_columns.empty())
+        {
+            inline_string_columns_[&sheet] = std::move(inline_columns);
+        }
+    }
+
+    // the table is only compacted once strings moved out of it, so unused strings
+    // otherwise round-trip as they always did
+    if (!any_inline || std::find(referenced.begin(), referenced.end(), false) == referenced.end()) return;
+
+    auto next_id = std::size_t(0);
+    shared_string_ids_.resize(referenced.size());
+
+    for (auto index = std::size_t(0); index < referenced.size(); ++index)
+    {
+        shared_string_ids_[index] = referenced[index] ? next_id++ : std::size_t(-1);
+    }
+}
+
+void xlsx_producer::write_shared_workbook_revision_headers(const relationship & /*rel*/)
+{
+    write_start_element(constants::ns("spreadsheetml"), "headers");
+    write_end_element(constants::ns("spreadsheetml"), "headers");
+}
+
+void xlsx_producer::write_shared_workbook(const relationship & /*rel*/)
+{
+    write_start_element(constants::ns("spreadsheetml"), "revisions");
+    write_end_element(constants::ns("spreadsheetml"), "revisions");
+}
+
+void xlsx_producer::write_shared_workbook_user_data(const relationship & /*rel*/)
+{
+    write_start_element(constants::ns("spreadsheetml"), "users");
+    write_end_element(constants::ns("spreadsheetml"), "users");
+}
+
+void xlsx_producer::write_font(const font &f)
 {
     static const auto &xmlns = constants::ns("spreadsheetml");
 
@@ -1626,28 +2190,30 @@ void xlsx_producer::write_styles(const relationship & /*rel*/)
     }
 
     // Conditional Formats
+    index_conditional_formats();
+
     write_start_element(xmlns, "dxfs");
-    write_attribute("count", stylesheet.conditional_format_impls.size());
+    write_attribute("count", differential_formats_.size());
 
-    for (auto &rule : stylesheet.conditional_format_impls)
+    for (auto rule : differential_formats_)
     {
         write_start_element(xmlns, "dxf");
 
-        if (rule.border_id.is_set())
+        if (rule->border_id.is_set())
         {
-            const auto &current_border = stylesheet.borders.at(rule.border_id.get());
+            const auto &current_border = stylesheet.borders.at(rule->border_id.get());
             write_border(current_border);
         }
 
-        if (rule.fill_id.is_set())
+        if (rule->fill_id.is_set())
         {
-            const auto &current_fill = stylesheet.fills.at(rule.fill_id.get());
+            const auto &current_fill = stylesheet.fills.at(rule->fill_id.get());
             write_fill(current_fill);
         }
 
-        if (rule.font_id.is_set())
+        if (rule->font_id.is_set())
         {
-            const auto &current_font = stylesheet.fonts.at(rule.font_id.get());
+            const auto &current_font = stylesheet.fonts.at(rule->font_id.get());
             write_font(current_font);
         }
 
@@ -1702,6 +2268,33 @@ void xlsx_producer::write_styles(const relationship & /*rel*/)
 }
 
 void xlsx_producer::write_theme(const relationship &theme_rel)
+{
+    const auto workbook_rel = manifest_.relationship(path("/"), relationship_type::office_document);
+    const auto theme_part = manifest_.canonicalize({workbook_rel, theme_rel});
+
+    // the default theme is all that is ever written so it never needs rendering twice
+    write_cached_part(theme_part, [this, &theme_part]() {
+        return render_part(theme_part, [this]() { write_default_theme(); });
+    });
+
+    const auto theme_rels = manifest_.relationships(theme_part);
+
+    if (!theme_rels.empty())
+    {
+        write_relationships(theme_rels, theme_part);
+
+        for (auto rel : theme_rels)
+        {
+            if (rel.type() == relationship_type::image)
+            {
+                const auto image_path = manifest_.canonicalize({workbook_rel, theme_rel, rel});
+                write_image(image_path);
+            }
+        }
+    }
+}
+
+void xlsx_producer::write_default_theme()
 {
     static const auto &xmlns_a = constants::ns("drawingml");
     static const auto &xmlns_thm15 = constants::ns("thm15");
@@ -2152,24 +2745,6 @@ void xlsx_producer::write_theme(const relationship &theme_rel)
     write_end_element(xmlns_a, "extLst");
 
     write_end_element(xmlns_a, "theme");
-
-    const auto workbook_rel = source_.manifest().relationship(path("/"), relationship_type::office_document);
-    const auto theme_part = source_.manifest().canonicalize({workbook_rel, theme_rel});
-    const auto theme_rels = source_.manifest().relationships(theme_part);
-
-    if (!theme_rels.empty())
-    {
-        write_relationships(theme_rels, theme_part);
-
-        for (auto rel : theme_rels)
-        {
-            if (rel.type() == relationship_type::image)
-            {
-                const auto image_path = source_.manifest().canonicalize({workbook_rel, theme_rel, rel});
-                write_image(image_path);
-            }
-        }
-    }
 }
 
 void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
@@ -2178,23 +2753,13 @@ void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
     write_end_element(constants::ns("spreadsheetml"), "volTypes");
 }
 
-void xlsx_producer::write_worksheet(const relationship &rel)
+void xlsx_producer::write_worksheet_begin(const worksheet &ws)
 {
     static const auto &xmlns = constants::ns("spreadsheetml");
     static const auto &xmlns_r = constants::ns("r");
     static const auto &xmlns_mc = constants::ns("mc");
     static const auto &xmlns_x14ac = constants::ns("x14ac");
 
-    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
-    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
-
-    auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
-        [&](const std::pair<std::string, std::string> &p) {
-            return p.second == rel.id();
-        })->first;
-
-    auto ws = source_.sheet_by_title(title);
-
     write_start_element(xmlns, "worksheet");
     write_namespace(xmlns, "");
     write_namespace(xmlns_r, "r");
@@ -2282,10 +2847,21 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "sheetPr");
     }
 
-    write_start_element(xmlns, "dimension");
-    const auto dimension = ws.calculate_dimension();
-    write_attribute("ref", dimension.is_single_cell() ? dimension.top_left().to_string() : dimension.to_string());
-    write_end_element(xmlns, "dimension");
+    // the dimension of a streamed worksheet isn't known until its last cell is written
+    if (!streaming_)
+    {
+        write_start_element(xmlns, "dimension");
+        const auto dimension = ws.calculate_dimension();
+        if (dimension.is_single_cell())
+        {
+            write_reference_attribute("ref", dimension.top_left());
+        }
+        else
+        {
+            write_reference_attribute("ref", dimension);
+        }
+        write_end_element(xmlns, "dimension");
+    }
 
     if (ws.has_view())
     {
@@ -2450,10 +3026,32 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     {
         write_end_element(xmlns, "cols");
     }
+}
+
+void xlsx_producer::write_worksheet(const relationship &rel)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
+
+    auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
+        [&](const std::pair<std::string, std::string> &p) {
+            return p.second == rel.id();
+        })->first;
+
+    auto ws = source_.sheet_by_title(title);
+
+    write_worksheet_begin(ws);
 
-    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
+    index_string_storage();
+    auto inline_columns = inline_string_columns_.find(ws.d_);
+    current_inline_string_columns_ = inline_columns == inline_string_columns_.end() ? nullptr : &inline_columns->second;
+
+    std::vector<cell_reference> cells_with_hyperlinks;
     std::vector<cell_reference> cells_with_comments;
 
+    const auto dimension = ws.calculate_dimension();
+
     write_start_element(xmlns, "sheetData");
     auto first_row = ws.lowest_row_or_props();
     auto last_row = ws.highest_row_or_props();
@@ -2484,18 +3082,18 @@ void xlsx_producer::write_worksheet(const relationship &rel)
             for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
             {
                 auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
+                auto cell = ws.d_->find_cell(ref);
+                if (cell == nullptr)
                 {
                     continue;
                 }
-                if (cell->second.is_garbage_collectible())
+                if (cell->is_garbage_collectible())
                 {
                     continue;
                 }
 
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
+                first_block_column = std::min(first_block_column, cell->column_);
+                last_block_column = std::max(last_block_column, cell->column_);
 
                 if (row == check_row)
                 {
@@ -2515,37 +3113,7 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
         if (ws.has_row_properties(row))
         {
-            const auto &props = ws.row_properties(row);
-
-            if (props.style.is_set())
-            {
-                write_attribute("s", props.style.get());
-            }
-            if (props.custom_format.is_set())
-            {
-                write_attribute("customFormat", write_bool(props.custom_format.get()));
-            }
-
-            if (props.height.is_set())
-            {
-                auto height = props.height.get();
-                write_attribute("ht", converter_.serialise(height));
-            }
-
-            if (props.hidden)
-            {
-                write_attribute("hidden", write_bool(true));
-            }
-
-            if (props.custom_height)
-            {
-                write_attribute("customHeight", write_bool(true));
-            }
-
-            if (props.dy_descent.is_set())
-            {
-                write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.get());
-            }
+            write_row_properties(ws.row_properties(row));
         }
 
         if (any_non_null)
@@ -2567,109 +3135,10 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
                 if (cell.has_hyperlink())
                 {
-                    hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
+                    cells_with_hyperlinks.push_back(cell.reference());
                 }
 
-                write_start_element(xmlns, "c");
-
-                // begin cell attributes
-
-                write_attribute("r", cell.reference().to_string());
-
-                if (cell.phonetics_visible())
-                {
-                    write_attribute("ph", write_bool(true));
-                }
-
-                if (cell.has_format())
-                {
-                    write_attribute("s", cell.format().d_->id);
-                }
-
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_attribute("t", "b");
-                    break;
-
-                case cell::type::date:
-                    write_attribute("t", "d");
-                    break;
-
-                case cell::type::error:
-                    write_attribute("t", "e");
-                    break;
-
-                case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
-                    break;
-
-                case cell::type::number: // default, don't write it
-                    //write_attribute("t", "n");
-                    break;
-
-                case cell::type::shared_string:
-                    write_attribute("t", "s");
-                    break;
-
-                case cell::type::formula_string:
-                    write_attribute("t", "str");
-                    break;
-                }
-
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
-
-                // begin child elements
-
-                if (cell.has_formula())
-                {
-                    write_element(xmlns, "f", cell.formula());
-                }
-
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
-                    break;
-
-                case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::inline_string:
-                    write_start_element(xmlns, "is");
-                    write_rich_text(xmlns, cell.value<xlnt::rich_text>());
-                    write_end_element(xmlns, "is");
-                    break;
-
-                case cell::type::number:
-                    write_start_element(xmlns, "v");
-                    write_characters(converter_.serialise(cell.value<double>()));
-                    write_end_element(xmlns, "v");
-                    break;
-
-                case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-                }
-
-                write_end_element(xmlns, "c");
+                write_cell(cell, cell.has_format() ? cell.format().d_->id : 0);
             }
         }
 
@@ -2678,6 +3147,18 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     write_end_element(xmlns, "sheetData");
 
+    write_worksheet_end(ws, worksheet_part, cells_with_hyperlinks);
+    write_worksheet_parts(ws, worksheet_part, cells_with_comments);
+}
+
+void xlsx_producer::write_worksheet_end(const worksheet &ws, const path &worksheet_part,
+    const std::vector<cell_reference> &cells_with_hyperlinks)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
+    auto worksheet_rels = manifest_.relationships(worksheet_part);
+
     if (ws.has_auto_filter())
     {
         write_start_element(xmlns, "autoFilter");
@@ -2693,73 +3174,35 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         for (auto merged_range : ws.merged_ranges())
         {
             write_start_element(xmlns, "mergeCell");
-            write_attribute("ref", merged_range.to_string());
+            write_reference_attribute("ref", merged_range);
             write_end_element(xmlns, "mergeCell");
         }
 
         write_end_element(xmlns, "mergeCells");
     }
 
-    if (source_.impl().stylesheet_.is_set())
-    {
-        const auto &stylesheet = source_.impl().stylesheet_.get();
-        const auto &cf_impls = stylesheet.conditional_format_impls;
-
-        std::unordered_map<std::string, std::vector<const conditional_format_impl *>> range_map;
+    write_conditional_formats(ws);
 
-        for (auto &cf : cf_impls)
-        {
-            if (cf.target_sheet != ws.d_) continue;
-
-            if (range_map.find(cf.target_range.to_string()) == range_map.end())
-            {
-                range_map[cf.target_range.to_string()] = {};
-            }
-
-            range_map[cf.target_range.to_string()].push_back(&cf);
-        }
-
-        for (const auto &range_rules_pair : range_map)
-        {
-            write_start_element(xmlns, "conditionalFormatting");
-            write_attribute("sqref", range_rules_pair.first);
-
-            std::size_t i = 1;
-
-            for (auto rule : range_rules_pair.second)
-            {
-                write_start_element(xmlns, "cfRule");
-                write_attribute("type", "containsText");
-                write_attribute("operator", "containsText");
-                write_attribute("dxfId", rule->differential_format_id);
-                write_attribute("priority", i++);
-                write_attribute("text", rule->when.text_comparand_);
-                //TODO: what does this formula mean and why is it necessary?
-                write_element(xmlns, "formula", "NOT(ISERROR(SEARCH(\"" + rule->when.text_comparand_ + "\",A1)))");
-                write_end_element(xmlns, "cfRule");
-            }
-
-            write_end_element(xmlns, "conditionalFormatting");
-        }
-    }
-
-    if (!hyperlinks.empty())
+    if (!cells_with_hyperlinks.empty())
     {
         write_start_element(xmlns, "hyperlinks");
 
-        for (const auto &hyperlink : hyperlinks)
+        // looked up again since the rows of a paged worksheet may have been written out since
+        for (const auto &reference : cells_with_hyperlinks)
         {
+            const auto hyperlink = ws.cell(reference).hyperlink();
+
             write_start_element(xmlns, "hyperlink");
-            write_attribute("ref", hyperlink.first);
-            if (hyperlink.second.external())
+            write_reference_attribute("ref", reference);
+            if (hyperlink.external())
             {
                 write_attribute(xml::qname(xmlns_r, "id"),
-                    hyperlink.second.relationship().id());
+                    hyperlink.relationship().id());
             }
             else
             {
-                write_attribute("location", hyperlink.second.target_range());
-                write_attribute("display", hyperlink.second.display());
+                write_attribute("location", hyperlink.target_range());
+                write_attribute("display", hyperlink.display());
             }
             write_end_element(xmlns, "hyperlink");
         }
@@ -3001,10 +3444,19 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     if (ws.d_->extension_list_.is_set())
     {
-        ws.d_->extension_list_.get().serialize(*current_part_serializer_, xmlns);
+        // the previous element has been closed so the markup can go straight into the stream
+        // once the serializer has handed over what it has buffered
+        current_part_serializer_->flush();
+        ws.d_->extension_list_.get().serialize(current_part_stream_);
     }
 
     write_end_element(xmlns, "worksheet");
+}
+
+void xlsx_producer::write_worksheet_parts(const worksheet &ws, const path &worksheet_part,
+    const std::vector<cell_reference> &cells_with_comments)
+{
+    auto worksheet_rels = manifest_.relationships(worksheet_part);
 
     if (!worksheet_rels.empty())
     {
@@ -3051,6 +3503,283 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     }
 }
 
+void xlsx_producer::write_row_properties(const row_properties &props)
+{
+    static const auto &xmlns_x14ac = constants::ns("x14ac");
+
+    if (props.style.is_set())
+    {
+        write_attribute("s", props.style.get());
+    }
+    if (props.custom_format.is_set())
+    {
+        write_attribute("customFormat", write_bool(props.custom_format.get()));
+    }
+
+    if (props.height.is_set())
+    {
+        auto height = props.height.get();
+        write_attribute("ht", converter_.serialise(height));
+    }
+
+    if (props.hidden)
+    {
+        write_attribute("hidden", write_bool(true));
+    }
+
+    if (props.custom_height)
+    {
+        write_attribute("customHeight", write_bool(true));
+    }
+
+    if (props.dy_descent.is_set())
+    {
+        write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.get());
+    }
+}
+
+void xlsx_producer::write_cell(const cell &cell, std::size_t format_id)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    write_start_element(xmlns, "c");
+
+    // begin cell attributes
+
+    write_reference_attribute("r", cell.reference());
+
+    if (cell.phonetics_visible())
+    {
+        write_attribute("ph", write_bool(true));
+    }
+
+    if (cell.has_format())
+    {
+        write_attribute("s", format_id);
+    }
+
+    auto type = cell.data_type();
+
+    // shared strings of columns written inline are copied into their cells
+    if (type == cell::type::shared_string && current_inline_string_columns_ != nullptr
+        && cell.d_->column_.index < current_inline_string_columns_->size()
+        && (*current_inline_string_columns_)[cell.d_->column_.index])
+    {
+        type = cell::type::inline_string;
+    }
+
+    switch (type)
+    {
+    case cell::type::empty:
+        break;
+
+    case cell::type::boolean:
+        write_attribute("t", "b");
+        break;
+
+    case cell::type::date:
+        write_attribute("t", "d");
+        break;
+
+    case cell::type::error:
+        write_attribute("t", "e");
+        break;
+
+    case cell::type::inline_string:
+        write_attribute("t", "inlineStr");
+        break;
+
+    case cell::type::number: // default, don't write it
+        //write_attribute("t", "n");
+        break;
+
+    case cell::type::shared_string:
+        write_attribute("t", "s");
+        break;
+
+    case cell::type::formula_string:
+        write_attribute("t", "str");
+        break;
+    }
+
+    //write_attribute("cm", "");
+    //write_attribute("vm", "");
+    //write_attribute("ph", "");
+
+    // begin child elements
+
+    if (cell.has_formula())
+    {
+        write_element(xmlns, "f", cell.formula());
+    }
+
+    switch (type)
+    {
+    case cell::type::empty:
+        break;
+
+    case cell::type::boolean:
+        write_element(xmlns, "v", write_bool(cell.value<bool>()));
+        break;
+
+    case cell::type::date:
+        write_element(xmlns, "v", cell.value<std::string>());
+        break;
+
+    case cell::type::error:
+        write_element(xmlns, "v", cell.value<std::string>());
+        break;
+
+    case cell::type::inline_string:
+        write_start_element(xmlns, "is");
+        write_rich_text(xmlns, cell.value<xlnt::rich_text>());
+        write_end_element(xmlns, "is");
+        break;
+
+    case cell::type::number:
+        write_start_element(xmlns, "v");
+        write_characters(converter_.serialise(cell.value<double>()));
+        write_end_element(xmlns, "v");
+        break;
+
+    case cell::type::shared_string:
+    {
+        const auto id = static_cast<std::size_t>(cell.d_->value_numeric_);
+        write_element(xmlns, "v", shared_string_ids_.empty() ? id : shared_string_ids_[id]);
+        break;
+    }
+
+    case cell::type::formula_string:
+        write_element(xmlns, "v", cell.value<std::string>());
+        break;
+    }
+
+    write_end_element(xmlns, "c");
+}
+
+void xlsx_producer::index_conditional_formats()
+{
+    if (conditional_formats_indexed_) return;
+    conditional_formats_indexed_ = true;
+
+    if (!source_.impl().stylesheet_.is_set()) return;
+
+    // border, fill and font ids are already shared so equal ids mean an equal dxf
+    const auto unset = std::size_t(-1);
+    std::map<std::tuple<std::size_t, std::size_t, std::size_t>, std::size_t> ids;
+
+    for (const auto &rule : source_.impl().stylesheet_.get().conditional_format_impls)
+    {
+        // rules whose ranges have all moved to another format aren't written
+        if (rule.target_ranges.empty()) continue;
+
+        const auto key = std::make_tuple(rule.border_id.is_set() ? rule.border_id.get() : unset,
+            rule.fill_id.is_set() ? rule.fill_id.get() : unset,
+            rule.font_id.is_set() ? rule.font_id.get() : unset);
+        const auto match = ids.emplace(key, differential_formats_.size());
+
+        if (match.second)
+        {
+            differential_formats_.push_back(&rule);
+        }
+
+        differential_format_ids_[&rule] = match.first->second;
+        sheet_conditional_formats_[rule.target_sheet].push_back(&rule);
+    }
+}
+
+void xlsx_producer::write_conditional_formats(const worksheet &ws)
+{
+    const auto xmlns = constants::ns("spreadsheetml");
+
+    index_conditional_formats();
+
+    const auto sheet_rules = sheet_conditional_formats_.find(ws.d_);
+    if (sheet_rules == sheet_conditional_formats_.end()) return;
+
+    // rules with the same condition and dxf are written once with all of their ranges
+    struct rule_group
+    {
+        const conditional_format_impl *rule;
+        std::vector<range_reference> ranges;
+    };
+
+    std::vector<rule_group> groups;
+    std::map<std::tuple<int, int, std::string, std::size_t>, std::size_t> group_ids;
+
+    for (auto rule : sheet_rules->second)
+    {
+        const auto key = std::make_tuple(static_cast<int>(rule->when.type_), static_cast<int>(rule->when.operator_),
+            rule->when.text_comparand_, differential_format_ids_.at(rule));
+        const auto match = group_ids.emplace(key, groups.size());
+
+        if (match.second)
+        {
+            groups.push_back({rule, {}});
+        }
+
+        auto &ranges = groups[match.first->second].ranges;
+        ranges.insert(ranges.end(), rule->target_ranges.begin(), rule->target_ranges.end());
+    }
+
+    // then groups covering the same cells share a conditionalFormatting element
+    std::vector<std::pair<std::string, std::vector<std::size_t>>> blocks;
+    std::unordered_map<std::string, std::size_t> block_ids;
+
+    for (auto i = std::size_t(0); i < groups.size(); ++i)
+    {
+        groups[i].ranges = coalesce_ranges(std::move(groups[i].ranges));
+
+        auto sqref = std::string();
+
+        for (const auto &range : groups[i].ranges)
+        {
+            if (!sqref.empty())
+            {
+                sqref.push_back(' ');
+            }
+
+            sqref.append(range.to_string());
+        }
+
+        const auto match = block_ids.emplace(sqref, blocks.size());
+
+        if (match.second)
+        {
+            blocks.push_back({sqref, {}});
+        }
+
+        blocks[match.first->second].second.push_back(i);
+    }
+
+    std::size_t priority = 1;
+
+    for (const auto &block : blocks)
+    {
+        write_start_element(xmlns, "conditionalFormatting");
+        write_attribute("sqref", block.first);
+
+        for (auto i : block.second)
+        {
+            const auto &group = groups[i];
+            const auto &text = group.rule->when.text_comparand_;
+
+            write_start_element(xmlns, "cfRule");
+            write_attribute("type", "containsText");
+            write_attribute("operator", "containsText");
+            write_attribute("dxfId", differential_format_ids_.at(group.rule));
+            write_attribute("priority", priority++);
+            write_attribute("text", text);
+            // relative references in the formula are taken from the top left cell of the first range
+            write_element(xmlns, "formula", "NOT(ISERROR(SEARCH(\"" + text + "\","
+                + group.ranges.front().top_left().to_string() + ")))");
+            write_end_element(xmlns, "cfRule");
+        }
+
+        write_end_element(xmlns, "conditionalFormatting");
+    }
+}
+
 // Sheet Relationship Target Parts
 
 void xlsx_producer::write_comments(const relationship & /*rel*/, worksheet ws, const std::vector<cell_reference> &cells)
@@ -3095,7 +3824,7 @@ void xlsx_producer::write_comments(const relationship & /*rel*/, worksheet ws, c
             auto cell = ws.cell(cell_ref);
             auto cell_comment = cell.comment();
 
-            write_attribute("ref", cell_ref.to_string());
+            write_reference_attribute("ref", cell_ref);
             auto author_id = authors.at(cell_comment.author());
             write_attribute("authorId", author_id);
 
@@ -3250,14 +3979,14 @@ void xlsx_producer::write_vml_drawings(const relationship &rel, worksheet ws, co
 
 void xlsx_producer::write_drawings(const relationship &drawing_rel, worksheet ws)
 {
-    const auto workbook_rel = source_.manifest().relationship(path("/"), relationship_type::office_document);
+    const auto workbook_rel = manifest_.relationship(path("/"), relationship_type::office_document);
     const auto worksheet_rel = ws.referring_relationship();
-    const auto drawing_part = source_.manifest().canonicalize({workbook_rel, worksheet_rel, drawing_rel});
-    const auto drawing_rels = source_.manifest().relationships(drawing_part);
+    const auto drawing_part = manifest_.canonicalize({workbook_rel, worksheet_rel, drawing_rel});
+    const auto drawing_rels = manifest_.relationships(drawing_part);
 
     if (ws.d_->drawing_.is_set())
     {
-        ws.d_->drawing_.get().serialize(*current_part_serializer_);
+        ws.d_->drawing_.get().serialize(current_part_stream_);
     }
 
     if (!drawing_rels.empty())
@@ -3268,7 +3997,7 @@ void xlsx_producer::write_drawings(const relationship &drawing_rel, worksheet ws
         {
             if (rel.type() == relationship_type::image)
             {
-                const auto image_path = source_.manifest().canonicalize({workbook_rel, worksheet_rel, rel});
+                const auto image_path = manifest_.canonicalize({workbook_rel, worksheet_rel, rel});
                 if (image_path.string().find("cid:") != std::string::npos)
                 {
                     // skip cid attachments
@@ -24,14 +24,22 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/utils/path.hpp>
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
+#include <detail/implementations/format_impl.hpp>
 
 namespace xml {
 class serializer;
@@ -45,10 +53,12 @@ class cell_reference;
 class color;
 class fill;
 class font;
-class path;
+class hyperlink;
 class relationship;
 class rich_text;
+class row_properties;
 class streaming_workbook_writer;
+class streaming_worksheet_writer;
 class variant;
 class workbook;
 class worksheet;
@@ -56,7 +66,9 @@ class worksheet;
 namespace detail {
 
 class ozstream;
+class zspool;
 struct cell_impl;
+struct conditional_format_impl;
 struct worksheet_impl;
 
 /// <summary>
@@ -73,24 +85,91 @@ public:
 
     void write(std::ostream &destination, const std::string &password);
 
+    /// <summary>
+    /// Writes the workbook into archive, which may already hold streamed worksheets,
+    /// and finishes it when this producer is destroyed.
+    /// </summary>
+    void write(std::unique_ptr<ozstream> archive);
+
 private:
     friend class xlnt::streaming_workbook_writer;
-
-    void open(std::ostream &destination);
-
-    cell add_cell(const cell_reference &ref);
-
-    worksheet add_worksheet(const std::string &title);
+    friend class xlnt::streaming_worksheet_writer;
+    friend class xlsb_producer;
+
+    // Streaming
+
+    /// <summary>
+    /// Prepares this producer to stream the cells of ws, a worksheet of source_, straight
+    /// into archive or, if archive is null, into a spool of its own in a temporary file.
+    /// Styles and shared strings of streamed cells are merged into source_ while holding
+    /// mutex, so that several producers sharing source_ can be filled concurrently. The
+    /// caller must hold mutex.
+    /// </summary>
+    void begin_streaming_worksheet(worksheet ws, std::mutex &mutex, ozstream *archive);
+
+    /// <summary>
+    /// Writes the previously added cell and returns a cell at ref for the caller to fill.
+    /// </summary>
+    cell add_streaming_cell(const cell_reference &ref);
+
+    /// <summary>
+    /// Writes the remaining cells and the end of the streamed worksheet and completes its spool.
+    /// </summary>
+    void end_streaming_worksheet();
+
+    /// <summary>
+    /// Opens the spool and writes the worksheet up to and including the start of sheetData.
+    /// </summary>
+    void begin_streaming_part();
+
+    /// <summary>
+    /// Writes the cell most recently returned by add_streaming_cell.
+    /// </summary>
+    void write_streaming_cell();
+
+    /// <summary>
+    /// Returns the index in source_ of the format of the streamed cell, adding it if needed.
+    /// </summary>
+    std::size_t streaming_format_id(const format_impl &scratch_format);
+
+    /// <summary>
+    /// Returns the index in source_ of the streamed cell's shared string, adding it if needed.
+    /// </summary>
+    std::size_t streaming_shared_string_id(std::size_t scratch_id);
+
+    /// <summary>
+    /// Converts the streamed cell's shared string to an inline string once the strings
+    /// sampled from its adaptive column turned out to be nearly unique.
+    /// </summary>
+    void apply_streaming_string_storage();
 
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
 	/// data contained in workbook.
 	/// </summary>
-	void populate_archive(bool streaming);
+	void populate_archive();
+
+    /// <summary>
+    /// Copies the manifest of source_ into manifest_ and registers the parts which
+    /// cell setters leave to be registered when the workbook is written.
+    /// </summary>
+    void reconcile_manifest();
 
     void begin_part(const path &part);
     void end_part();
 
+    /// <summary>
+    /// Runs write with the part serializer pointed at a string and returns the XML it produced.
+    /// </summary>
+    std::string render_part(const path &part, const std::function<void()> &write);
+
+    /// <summary>
+    /// Appends part, whose content is the same on every save, to the archive from the
+    /// process-wide cache of compressed parts. On a miss, content is called for the XML,
+    /// which is compressed and kept so that later saves skip both steps.
+    /// </summary>
+    void write_cached_part(const path &part, const std::function<std::string()> &content);
+
 	// Package Parts
 
 	void write_content_types();
@@ -116,17 +195,26 @@ private:
 	void write_shared_workbook_user_data(const relationship &rel);
 	void write_styles(const relationship &rel);
 	void write_theme(const relationship &rel);
+	void write_default_theme();
 	void write_volatile_dependencies(const relationship &rel);
 
 	void write_chartsheet(const relationship &rel);
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
+    void write_worksheet_begin(const worksheet &ws);
+    void write_worksheet_end(const worksheet &ws, const path &worksheet_part,
+        const std::vector<cell_reference> &cells_with_hyperlinks);
+    void write_worksheet_parts(const worksheet &ws, const path &worksheet_part,
+        const std::vector<cell_reference> &cells_with_comments);
+    void write_row_properties(const row_properties &props);
+    void write_cell(const cell &c, std::size_t format_id);
 
 	// Sheet Relationship Target Parts
 
 	void write_comments(const relationship &rel, worksheet ws, const std::vector<cell_reference> &cells);
     void write_vml_drawings(const relationship &rel, worksheet ws, const std::vector<cell_reference> &cells);
     void write_drawings(const relationship &rel, worksheet ws);
+    void write_conditional_formats(const worksheet &ws);
 
 	// Other Parts
 
@@ -149,6 +237,18 @@ private:
 	void write_fill(const xlnt::fill &f);
 	void write_font(const xlnt::font &f);
     void write_table_styles();
+
+    /// <summary>
+    /// Fills differential_formats_, differential_format_ids_ and sheet_conditional_formats_
+    /// from the conditional formats of source_ the first time it is called.
+    /// </summary>
+    void index_conditional_formats();
+
+    /// <summary>
+    /// Fills inline_string_columns_, shared_string_ids_ and shared_string_count_ from
+    /// the string storage of source_'s columns the first time it is called.
+    /// </summary>
+    void index_string_storage();
     void write_colors(const std::vector<xlnt::color> &colors);
     void write_rich_text(const std::string &ns, const xlnt::rich_text &text);
 
@@ -211,6 +311,18 @@ private:
     }
 
 
+    /// <summary>
+    /// Writes a cell_reference or range_reference attribute without allocating
+    /// once reference_buffer_ has grown to fit.
+    /// </summary>
+    template <typename Reference>
+    void write_reference_attribute(const std::string &name, const Reference &reference)
+    {
+        char buffer[Reference::max_string_length];
+        reference_buffer_.assign(buffer, reference.to_chars(buffer, buffer + sizeof(buffer)));
+        current_part_serializer_->attribute(name, reference_buffer_);
+    }
+
     template <typename T>
     void write_characters(T characters, bool preserve_whitespace = false)
     {
@@ -227,19 +339,157 @@ private:
 	/// </summary>
 	const workbook &source_;
 
+    /// <summary>
+    /// The manifest of source_ as it is written, filled by reconcile_manifest.
+    /// </summary>
+    manifest manifest_;
+
 	std::unique_ptr<ozstream> archive_;
     std::unique_ptr<xml::serializer> current_part_serializer_;
     std::unique_ptr<std::streambuf> current_part_streambuf_;
     std::ostream current_part_stream_;
 
+    /// <summary>
+    /// True if this producer streams a single worksheet rather than writing source_.
+    /// </summary>
     bool streaming_ = false;
 
+    /// <summary>
+    /// The worksheet of source_ being streamed.
+    /// </summary>
+    detail::worksheet_impl *current_worksheet_;
+
+    /// <summary>
+    /// The archive path of the streamed worksheet.
+    /// </summary>
+    path streaming_part_path_;
+
+    /// <summary>
+    /// The archive the streamed worksheet is written into directly, or null if it is spooled.
+    /// </summary>
+    ozstream *streaming_archive_ = nullptr;
+
+    /// <summary>
+    /// The compressed worksheet, appended to the archive when the workbook is written.
+    /// Null if the worksheet was written into streaming_archive_.
+    /// </summary>
+    std::unique_ptr<zspool> streaming_part_;
+
+    /// <summary>
+    /// Guards the styles and shared strings of source_ while streaming.
+    /// </summary>
+    std::mutex *streaming_mutex_ = nullptr;
+
+    /// <summary>
+    /// A workbook owned by this producer in which streamed cells are filled, so that
+    /// setting their values and formats never touches source_.
+    /// </summary>
+    std::unique_ptr<workbook> streaming_workbook_;
+
+    /// <summary>
+    /// The detached cell reused for each streamed cell.
+    /// </summary>
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
-    detail::cell_impl *current_cell_;
+    /// <summary>
+    /// True if streaming_cell_ has been handed out and not yet written.
+    /// </summary>
+    bool streaming_cell_pending_ = false;
+
+    /// <summary>
+    /// The row element currently open in the streamed worksheet, or 0 if none is.
+    /// </summary>
+    row_t streaming_row_ = 0;
+
+    /// <summary>
+    /// For each format of streaming_workbook_, the format as it was when it was
+    /// merged into source_ and its index there.
+    /// </summary>
+    std::vector<std::pair<format_impl, std::size_t>> streaming_format_ids_;
+
+    /// <summary>
+    /// For each shared string of streaming_workbook_, its index in source_ or -1.
+    /// </summary>
+    std::vector<std::size_t> streaming_shared_string_ids_;
+
+    /// <summary>
+    /// The number of streamed cells holding shared strings.
+    /// </summary>
+    std::size_t streaming_shared_string_count_ = 0;
+
+    /// <summary>
+    /// The strings seen so far in an adaptive column of the streamed worksheet.
+    /// </summary>
+    struct streaming_string_sample
+    {
+        std::size_t count = 0;
+        std::unordered_set<std::size_t> ids;
+    };
+
+    /// <summary>
+    /// The samples of the streamed worksheet's adaptive columns by column index.
+    /// </summary>
+    std::unordered_map<column_t::index_t, streaming_string_sample> streaming_string_samples_;
+
+    /// <summary>
+    /// Worksheets already streamed by other producers, by archive path, which are
+    /// copied into the archive instead of being written from source_.
+    /// </summary>
+    std::unordered_map<std::string, const xlsx_producer *> streamed_worksheets_;
 
-    detail::worksheet_impl *current_worksheet_;
     detail::number_serialiser converter_;
+
+    /// <summary>
+    /// Reused by write_reference_attribute so that references don't allocate.
+    /// </summary>
+    std::string reference_buffer_;
+
+    /// <summary>
+    /// True once index_conditional_formats has run.
+    /// </summary>
+    bool conditional_formats_indexed_ = false;
+
+    /// <summary>
+    /// One conditional format for each distinct dxf, in dxfId order.
+    /// </summary>
+    std::vector<const conditional_format_impl *> differential_formats_;
+
+    /// <summary>
+    /// The dxfId of every conditional format, shared by all formats with the same
+    /// border, fill and font.
+    /// </summary>
+    std::unordered_map<const conditional_format_impl *, std::size_t> differential_format_ids_;
+
+    /// <summary>
+    /// The conditional formats of each worksheet in the order they were added.
+    /// </summary>
+    std::unordered_map<const worksheet_impl *, std::vector<const conditional_format_impl *>> sheet_conditional_formats_;
+
+    /// <summary>
+    /// True once index_string_storage has run.
+    /// </summary>
+    bool string_storage_indexed_ = false;
+
+    /// <summary>
+    /// For each worksheet with shared strings to be written inline, a flag per column index.
+    /// </summary>
+    std::unordered_map<const worksheet_impl *, std::vector<bool>> inline_string_columns_;
+
+    /// <summary>
+    /// The inline_string_columns_ of the worksheet being written or null if it has none.
+    /// </summary>
+    const std::vector<bool> *current_inline_string_columns_ = nullptr;
+
+    /// <summary>
+    /// For each shared string of source_, its index in the written table or -1 if every
+    /// cell holding it is written inline. Empty if all strings are written unchanged.
+    /// </summary>
+    std::vector<std::size_t> shared_string_ids_;
+
+    /// <summary>
+    /// The number of cells of source_ written with a shared string.
+    /// </summary>
+    std::size_t shared_string_count_ = 0;
 };
 
 } // namespace detail
@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
@@ -171,12 +172,120 @@ namespace detail {
 
 static const std::size_t buffer_size = 512;
 
+// compressed data is read in larger chunks so that files open at the same time
+// don't take the archive's lock and seek its stream as often
+static const std::size_t input_buffer_size = 16384;
+
+// deflate output is collected in larger chunks so that each call to deflate
+// can do more work and the destination stream sees fewer, larger writes
+static const std::size_t output_buffer_size = 16384;
+
+// general purpose flag set on files whose CRC and sizes follow their data
+static const std::uint16_t data_descriptor_flag = 0x08;
+
+// Writes to a temporary file which it doesn't own, seeking within it as the
+// compressing streambuf rewrites local headers
+class file_streambuf : public std::streambuf
+{
+    std::FILE *file;
+
+public:
+    file_streambuf(std::FILE *destination)
+        : file(destination)
+    {
+        setp(nullptr, nullptr);
+    }
+
+protected:
+    virtual int overflow(int c)
+    {
+        if (c == EOF) return traits_type::not_eof(c);
+        return std::fputc(c, file) == EOF ? EOF : c;
+    }
+
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        return static_cast<std::streamsize>(std::fwrite(s, 1, static_cast<std::size_t>(n), file));
+    }
+
+    virtual int sync()
+    {
+        return std::fflush(file) == 0 ? 0 : -1;
+    }
+
+    virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+    {
+        if ((which & std::ios_base::out) == 0) return std::streampos(-1);
+
+        const auto origin = way == std::ios_base::beg ? SEEK_SET : way == std::ios_base::cur ? SEEK_CUR : SEEK_END;
+        if (std::fseek(file, static_cast<long>(off), origin) != 0) return std::streampos(-1);
+
+        return std::streampos(std::ftell(file));
+    }
+
+    virtual std::streampos seekpos(std::streampos pos, std::ios_base::openmode which)
+    {
+        return seekoff(std::streamoff(pos), std::ios_base::beg, which);
+    }
+};
+
+// Passes everything written to it on to destination and reports the number of bytes
+// written as its position, so that offsets in an archive written to a stream which
+// can't seek are still known
+class counting_streambuf : public std::streambuf
+{
+    std::streambuf &destination;
+    std::streamoff count;
+
+public:
+    counting_streambuf(std::streambuf &destination_buffer)
+        : destination(destination_buffer), count(0)
+    {
+        setp(nullptr, nullptr);
+    }
+
+protected:
+    virtual int overflow(int c)
+    {
+        if (c == EOF) return traits_type::not_eof(c);
+        if (destination.sputc(static_cast<char>(c)) == EOF) return EOF;
+        ++count;
+
+        return c;
+    }
+
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        const auto written = destination.sputn(s, n);
+        count += written;
+
+        return written;
+    }
+
+    virtual int sync()
+    {
+        return destination.pubsync();
+    }
+
+    virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+    {
+        if (off == 0 && way == std::ios_base::cur && (which & std::ios_base::out) != 0)
+        {
+            return std::streampos(count);
+        }
+
+        return std::streampos(-1);
+    }
+};
+
 class zip_streambuf_decompress : public std::streambuf
 {
-    std::istream &istream;
+    const izstream &archive;
+    std::streamoff start;
+    std::streamoff position;
 
     z_stream strm;
-    std::array<char, buffer_size> in;
+    std::array<char, input_buffer_size> in;
     std::array<char, buffer_size> out;
     zheader header;
     std::size_t total_read;
@@ -188,8 +297,9 @@ class zip_streambuf_decompress : public std::streambuf
     static const unsigned short UNCOMPRESSED = 0;
 
 public:
-    zip_streambuf_decompress(std::istream &stream, zheader central_header)
-        : istream(stream), header(central_header), total_read(0), total_uncompressed(0), valid(true)
+    // expects data_offset to be the position of the file's data in the archive
+    zip_streambuf_decompress(const izstream &source, zheader central_header, std::streamoff data_offset)
+        : archive(source), start(data_offset), position(data_offset), header(central_header), total_read(0), total_uncompressed(0), valid(true)
     {
         in.fill(0);
         out.fill(0);
@@ -203,9 +313,6 @@ public:
         setg(in.data(), in.data(), in.data());
         setp(nullptr, nullptr);
 
-        // skip the header
-        read_header(istream, false);
-
         if (header.compression_type == DEFLATE)
         {
             compressed_data = true;
@@ -233,8 +340,6 @@ public:
                 throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
             }
         }
-
-        header = central_header;
     }
 
     virtual ~zip_streambuf_decompress()
@@ -243,6 +348,8 @@ public:
         {
             inflateEnd(&strm);
         }
+
+        archive.release_source(start, header.compressed_size);
     }
 
     int process()
@@ -259,9 +366,8 @@ public:
                 if (strm.avail_in == 0)
                 {
                     // buffer empty, read some more from file
-                    istream.read(in.data(),
-                        static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
-                    strm.avail_in = static_cast<unsigned int>(istream.gcount());
+                    strm.avail_in = static_cast<unsigned int>(read_source(in.data(),
+                        std::min(input_buffer_size, header.compressed_size - total_read)));
                     total_read += strm.avail_in;
                     strm.next_in = reinterpret_cast<Bytef *>(in.data());
                 }
@@ -282,13 +388,18 @@ public:
         }
 
         // uncompressed, so just read
-        istream.read(out.data() + 4,
-            static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
-        auto count = istream.gcount();
-        total_read += static_cast<std::size_t>(count);
+        auto count = read_source(out.data() + 4, std::min(buffer_size - 4, header.uncompressed_size - total_read));
+        total_read += count;
         return static_cast<int>(count);
     }
 
+    std::size_t read_source(char *data, std::size_t size)
+    {
+        auto count = archive.read_source(position, data, size);
+        position += static_cast<std::streamoff>(count);
+        return count;
+    }
+
     virtual int underflow()
     {
         if (gptr() && (gptr() < egptr()))
@@ -317,7 +428,7 @@ class zip_streambuf_compress : public std::streambuf
 
     z_stream strm;
     std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::array<char, output_buffer_size> out;
 
     zheader *header;
     std::uint32_t uncompressed_size;
@@ -366,12 +477,25 @@ public:
             deflateEnd(&strm);
             if (header)
             {
-                auto final_position = ostream.tellp();
                 header->uncompressed_size = uncompressed_size;
                 header->crc = crc;
-                ostream.seekp(header->header_offset);
-                write_header(*header, ostream, false);
-                ostream.seekp(final_position);
+
+                if ((header->flags & data_descriptor_flag) != 0)
+                {
+                    // the local header can't be rewritten, so its CRC and sizes follow the data
+                    write_int(ostream, static_cast<std::uint32_t>(0x08074b50));
+                    write_int(ostream, header->crc);
+                    write_int(ostream, header->compressed_size);
+                    write_int(ostream, header->uncompressed_size);
+                    ostream.flush();
+                }
+                else
+                {
+                    auto final_position = ostream.tellp();
+                    ostream.seekp(header->header_offset);
+                    write_header(*header, ostream, false);
+                    ostream.seekp(final_position);
+                }
             }
             else
             {
@@ -384,15 +508,23 @@ public:
 
 protected:
     int process(bool flush)
+    {
+        auto result = compress(pbase(), static_cast<std::size_t>(pptr() - pbase()), flush);
+        setp(pbase(), pbase() + buffer_size - 4);
+
+        return result;
+    }
+
+    int compress(const char *data, std::size_t size, bool flush)
     {
         if (!valid) return -1;
 
-        strm.next_in = reinterpret_cast<Bytef *>(pbase());
-        strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        strm.avail_in = static_cast<unsigned int>(size);
 
         while (strm.avail_in != 0 || flush)
         {
-            strm.avail_out = buffer_size;
+            strm.avail_out = output_buffer_size;
             strm.next_out = reinterpret_cast<Bytef *>(out.data());
 
             int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
@@ -410,15 +542,29 @@ protected:
             if (ret == Z_STREAM_END) break;
         }
 
-        // update counts, crc's and buffers
-        auto consumed_input = static_cast<std::uint32_t>(pptr() - pbase());
+        // update counts and crc's
+        auto consumed_input = static_cast<std::uint32_t>(size);
         uncompressed_size += consumed_input;
-        crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<Bytef *>(in.data()), consumed_input));
-        setp(pbase(), pbase() + buffer_size - 4);
+        crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(data), consumed_input));
 
         return 1;
     }
 
+    // Blocks larger than the put area, such as those from a staging buffer upstream,
+    // are compressed in place instead of being copied through it a piece at a time.
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        if (n < static_cast<std::streamsize>(buffer_size))
+        {
+            return std::streambuf::xsputn(s, n);
+        }
+
+        if (pptr() > pbase() && process(false) == -1) return 0;
+        if (compress(s, static_cast<std::size_t>(n), false) == -1) return 0;
+
+        return n;
+    }
+
     virtual int sync()
     {
         if (pptr() && pptr() > pbase()) return process(false);
@@ -444,48 +590,145 @@ int zip_streambuf_compress::overflow(int c)
     return c;
 }
 
+zspool::zspool(const path &file, bool temporary_file)
+    : data_stream_(nullptr)
+{
+    header_.filename = file.string();
+
+    if (temporary_file)
+    {
+        file_ = std::tmpfile();
+
+        if (file_ == nullptr)
+        {
+            throw xlnt::exception("failed to create temporary file for archive entry");
+        }
+
+        data_buffer_.reset(new file_streambuf(file_));
+    }
+    else
+    {
+        data_buffer_.reset(new vector_ostreambuf(data_));
+    }
+
+    data_stream_.rdbuf(data_buffer_.get());
+}
+
+zspool::~zspool()
+{
+    if (file_ != nullptr)
+    {
+        std::fclose(file_);
+    }
+}
+
+std::unique_ptr<std::streambuf> zspool::open()
+{
+    data_.clear();
+    data_stream_.clear();
+    data_stream_.seekp(0);
+    header_.compressed_size = 0;
+
+    return std::unique_ptr<zip_streambuf_compress>(new zip_streambuf_compress(&header_, data_stream_));
+}
+
 ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+    : destination_stream_(stream),
+      archive_stream_(&stream)
 {
     if (!destination_stream_)
     {
         throw xlnt::exception("bad zip stream");
     }
+
+    // streams which can't seek report an invalid position, their files are followed
+    // by data descriptors and offsets are counted instead
+    if (destination_stream_.tellp() == std::streampos(-1))
+    {
+        destination_stream_.clear(destination_stream_.rdstate() & ~std::ios_base::failbit);
+        counting_buffer_.reset(new counting_streambuf(*destination_stream_.rdbuf()));
+        counting_stream_.reset(new std::ostream(counting_buffer_.get()));
+        archive_stream_ = counting_stream_.get();
+    }
 }
 
 ozstream::~ozstream()
 {
     // Write all file headers
-    auto final_position = destination_stream_.tellp();
+    auto final_position = archive_stream_->tellp();
 
     for (const auto &header : file_headers_)
     {
-        write_header(header, destination_stream_, true);
+        write_header(header, *archive_stream_, true);
     }
 
-    auto central_end = destination_stream_.tellp();
+    auto central_end = archive_stream_->tellp();
 
     // Write end of central
-    write_int(destination_stream_, static_cast<std::uint32_t>(0x06054b50)); // end of central
-    write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
-    write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center in this disk
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center
-    write_int(destination_stream_, static_cast<std::uint32_t>(central_end - final_position)); // size of header
-    write_int(destination_stream_, static_cast<std::uint32_t>(final_position)); // offset to header
-    write_int(destination_stream_, static_cast<std::uint16_t>(0)); // zip comment
+    write_int(*archive_stream_, static_cast<std::uint32_t>(0x06054b50)); // end of central
+    write_int(*archive_stream_, static_cast<std::uint16_t>(0)); // this disk number
+    write_int(*archive_stream_, static_cast<std::uint16_t>(0)); // this disk number
+    write_int(*archive_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center in this disk
+    write_int(*archive_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center
+    write_int(*archive_stream_, static_cast<std::uint32_t>(central_end - final_position)); // size of header
+    write_int(*archive_stream_, static_cast<std::uint32_t>(final_position)); // offset to header
+    write_int(*archive_stream_, static_cast<std::uint16_t>(0)); // zip comment
+    archive_stream_->flush();
 }
 
 std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
 {
     zheader header;
     header.filename = filename.string();
+
+    if (counting_stream_)
+    {
+        header.flags |= data_descriptor_flag;
+    }
+
     file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), *archive_stream_);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
+void ozstream::append(const zspool &spool)
+{
+    auto header = spool.header_;
+    header.header_offset = static_cast<std::uint32_t>(archive_stream_->tellp());
+
+    if (spool.file_ != nullptr)
+    {
+        // the compressing streambuf leaves the file positioned at the end of the entry
+        const auto size = std::ftell(spool.file_);
+        std::fflush(spool.file_);
+        std::rewind(spool.file_);
+        std::array<char, output_buffer_size> chunk;
+
+        for (auto remaining = static_cast<std::size_t>(size); remaining > 0;)
+        {
+            const auto count = std::fread(chunk.data(), 1, std::min(chunk.size(), remaining), spool.file_);
+
+            if (count == 0)
+            {
+                throw xlnt::exception("failed to read archive entry from temporary file");
+            }
+
+            archive_stream_->write(chunk.data(), static_cast<std::streamsize>(count));
+            remaining -= count;
+        }
+
+        std::fseek(spool.file_, size, SEEK_SET);
+    }
+    else
+    {
+        archive_stream_->write(reinterpret_cast<const char *>(spool.data_.data()),
+            static_cast<std::streamsize>(spool.data_.size()));
+    }
+
+    file_headers_.push_back(header);
+}
+
 izstream::izstream(std::istream &stream)
     : source_stream_(stream)
 {
@@ -494,6 +737,15 @@ izstream::izstream(std::istream &stream)
         throw xlnt::exception("Invalid file handle");
     }
 
+    // streams which can't seek report an invalid position, their local headers
+    // are read as files are asked for instead of reading the central directory
+    if (stream.tellg() == std::streampos(-1))
+    {
+        forward_only_ = true;
+        source_position_ = 0;
+        return;
+    }
+
     read_central_header();
 }
 
@@ -592,18 +844,313 @@ bool izstream::read_central_header()
 
 std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
 {
-    if (!has_file(filename))
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    auto data_offset = std::streamoff(0);
+
+    if (forward_only_)
     {
-        throw xlnt::exception("file not found");
+        read_local_headers(filename.string());
+
+        if (file_headers_.count(filename.string()) == 0)
+        {
+            throw xlnt::exception("file not found");
+        }
+
+        data_offset = data_offsets_.at(filename.string());
     }
+    else
+    {
+        if (file_headers_.count(filename.string()) == 0)
+        {
+            throw xlnt::exception("file not found");
+        }
 
-    auto header = file_headers_.at(filename.string());
-    source_stream_.seekg(header.header_offset);
-    auto buffer = new zip_streambuf_decompress(source_stream_, header);
+        // skip the local header
+        source_stream_.clear();
+        source_stream_.seekg(file_headers_.at(filename.string()).header_offset);
+        read_header(source_stream_, false);
+        data_offset = source_stream_.tellg();
+        source_position_ = data_offset;
+    }
+
+    auto buffer = new zip_streambuf_decompress(*this, file_headers_.at(filename.string()), data_offset);
 
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
+std::size_t izstream::read_source(std::streamoff offset, char *data, std::size_t size) const
+{
+    std::lock_guard<std::mutex> lock(source_mutex_);
+
+    if (forward_only_)
+    {
+        if (size == 0) return 0;
+
+        // data the stream hasn't passed yet goes straight to the caller without being
+        // kept. The caller never asks for more than is left of its file, so this never
+        // reads into the header of the next one.
+        if (offset >= source_position_)
+        {
+            pass_source(offset);
+
+            if (read_forward(data, size) != size)
+            {
+                throw xlnt::exception("unexpected end of archive");
+            }
+
+            return size;
+        }
+
+        auto kept = kept_data_.upper_bound(offset);
+
+        if (kept != kept_data_.begin())
+        {
+            --kept;
+            const auto skip = static_cast<std::size_t>(offset - kept->first);
+
+            if (skip < kept->second.size())
+            {
+                const auto count = std::min(size, kept->second.size() - skip);
+                std::copy_n(kept->second.data() + skip, count, data);
+
+                return count;
+            }
+        }
+
+        throw xlnt::exception("file data not found in forward-only archive");
+    }
+
+    if (source_position_ != offset)
+    {
+        source_stream_.clear();
+        source_stream_.seekg(offset);
+    }
+
+    source_stream_.read(data, static_cast<std::streamsize>(size));
+    auto count = static_cast<std::size_t>(source_stream_.gcount());
+    source_position_ = offset + static_cast<std::streamoff>(count);
+
+    return count;
+}
+
+std::size_t izstream::read_forward(char *data, std::size_t size) const
+{
+    auto count = std::min(size, lookahead_.size());
+    std::copy_n(lookahead_.begin(), count, data);
+    lookahead_.erase(lookahead_.begin(), lookahead_.begin() + static_cast<std::ptrdiff_t>(count));
+
+    if (count < size)
+    {
+        source_stream_.read(data + count, static_cast<std::streamsize>(size - count));
+        count += static_cast<std::size_t>(source_stream_.gcount());
+    }
+
+    source_position_ += static_cast<std::streamoff>(count);
+
+    return count;
+}
+
+void izstream::release_source(std::streamoff offset, std::size_t size) const
+{
+    if (!forward_only_) return;
+
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    kept_data_.erase(kept_data_.lower_bound(offset), kept_data_.lower_bound(offset + static_cast<std::streamoff>(size)));
+}
+
+void izstream::pass_source(std::streamoff offset) const
+{
+    if (offset <= source_position_) return;
+
+    const auto start = source_position_;
+    const auto size = static_cast<std::size_t>(offset - start);
+
+    // bytes right after earlier ones extend them so that reads can span both
+    auto last = kept_data_.rbegin();
+    auto &kept = last != kept_data_.rend() && last->first + static_cast<std::streamoff>(last->second.size()) == start
+        ? last->second
+        : kept_data_[start];
+    const auto kept_size = kept.size();
+    kept.resize(kept_size + size);
+
+    if (read_forward(kept.data() + kept_size, size) != size)
+    {
+        throw xlnt::exception("unexpected end of archive");
+    }
+}
+
+void izstream::pass_described_entry(zheader &header) const
+{
+    if (header.compression_type != 8)
+    {
+        throw xlnt::exception("unsupported data descriptor on a file which isn't deflated");
+    }
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.avail_in = 0;
+    strm.next_in = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    // the end of the data is only known once it was inflated
+    auto &kept = kept_data_[source_position_];
+    std::array<char, output_buffer_size> out;
+    int ret = Z_OK;
+
+    while (ret != Z_STREAM_END)
+    {
+        if (strm.avail_in == 0)
+        {
+            const auto kept_size = kept.size();
+            kept.resize(kept_size + input_buffer_size);
+            const auto count = read_forward(kept.data() + kept_size, input_buffer_size);
+            kept.resize(kept_size + count);
+
+            if (count == 0)
+            {
+                inflateEnd(&strm);
+                throw xlnt::exception("unexpected end of archive");
+            }
+
+            strm.avail_in = static_cast<unsigned int>(count);
+            strm.next_in = reinterpret_cast<Bytef *>(kept.data() + kept_size);
+        }
+
+        strm.avail_out = static_cast<unsigned int>(out.size());
+        strm.next_out = reinterpret_cast<Bytef *>(out.data());
+        ret = inflate(&strm, Z_NO_FLUSH);
+
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+        {
+            inflateEnd(&strm);
+            throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+        }
+    }
+
+    // bytes read past the end of the data belong to the descriptor and what follows
+    const auto unused = static_cast<std::size_t>(strm.avail_in);
+    lookahead_.insert(lookahead_.begin(), kept.end() - static_cast<std::ptrdiff_t>(unused), kept.end());
+    kept.resize(kept.size() - unused);
+    source_position_ -= static_cast<std::streamoff>(unused);
+
+    header.compressed_size = static_cast<std::uint32_t>(kept.size());
+    header.uncompressed_size = static_cast<std::uint32_t>(strm.total_out);
+    inflateEnd(&strm);
+
+    // the descriptor's signature is optional
+    std::array<std::uint32_t, 4> descriptor{};
+    auto descriptor_bytes = reinterpret_cast<char *>(descriptor.data());
+
+    if (read_forward(descriptor_bytes, 4) != 4)
+    {
+        throw xlnt::exception("unexpected end of archive");
+    }
+
+    const auto fields = descriptor[0] == 0x08074b50 ? 1 : 0;
+
+    if (read_forward(descriptor_bytes + 4, fields == 1 ? 12 : 8) != (fields == 1 ? 12u : 8u))
+    {
+        throw xlnt::exception("unexpected end of archive");
+    }
+
+    header.crc = descriptor[static_cast<std::size_t>(fields)];
+}
+
+void izstream::read_local_headers(const std::string &filename) const
+{
+    while (next_header_ >= 0 && (filename.empty() || file_headers_.count(filename) == 0))
+    {
+        // whatever wasn't read yet of the previous file is kept before moving on
+        pass_source(next_header_);
+
+        std::array<char, 30> fixed;
+
+        if (read_forward(fixed.data(), 4) != 4)
+        {
+            throw xlnt::exception(next_header_ == 0 ? "file is empty" : "unexpected end of archive");
+        }
+
+        auto signature = std::uint32_t(0);
+        std::memcpy(&signature, fixed.data(), sizeof(signature));
+
+        if (next_header_ == 0 && signature == 0xe011cfd0)
+        {
+            throw xlnt::exception("encrypted xlsx, password required");
+        }
+
+        if (signature != 0x04034b50)
+        {
+            if (next_header_ == 0)
+            {
+                throw xlnt::exception("failed to find zip header");
+            }
+
+            // the central directory follows the last file
+            next_header_ = -1;
+            break;
+        }
+
+        if (read_forward(fixed.data() + 4, fixed.size() - 4) != fixed.size() - 4)
+        {
+            throw xlnt::exception("unexpected end of archive");
+        }
+
+        zheader header;
+        auto field = fixed.data() + 4;
+        auto next_field = [&field](void *value, std::size_t size) {
+            std::memcpy(value, field, size);
+            field += size;
+        };
+
+        next_field(&header.version, 2);
+        next_field(&header.flags, 2);
+        next_field(&header.compression_type, 2);
+        next_field(&header.stamp_date, 2);
+        next_field(&header.stamp_time, 2);
+        next_field(&header.crc, 4);
+        next_field(&header.compressed_size, 4);
+        next_field(&header.uncompressed_size, 4);
+
+        auto filename_length = std::uint16_t(0);
+        auto extra_length = std::uint16_t(0);
+        next_field(&filename_length, 2);
+        next_field(&extra_length, 2);
+
+        header.filename.resize(filename_length, '\0');
+        header.extra.resize(extra_length, 0);
+        header.header_offset = static_cast<std::uint32_t>(next_header_);
+
+        if (read_forward(&header.filename[0], filename_length) != filename_length
+            || read_forward(reinterpret_cast<char *>(header.extra.data()), extra_length) != extra_length)
+        {
+            throw xlnt::exception("unexpected end of archive");
+        }
+
+        data_offsets_[header.filename] = source_position_;
+
+        if ((header.flags & 0x08) != 0)
+        {
+            pass_described_entry(header);
+            next_header_ = source_position_;
+        }
+        else
+        {
+            next_header_ = source_position_ + static_cast<std::streamoff>(header.compressed_size);
+        }
+
+        file_headers_[header.filename] = header;
+    }
+}
+
 std::string izstream::read(const path &filename) const
 {
     auto buffer = open(filename);
@@ -615,6 +1162,12 @@ std::string izstream::read(const path &filename) const
 
 std::vector<path> izstream::files() const
 {
+    if (forward_only_)
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        read_local_headers(std::string());
+    }
+
     std::vector<path> filenames;
     std::transform(file_headers_.begin(), file_headers_.end(), std::back_inserter(filenames),
         [](const std::pair<std::string, zheader> &h) { return path(h.first); });
@@ -624,8 +1177,22 @@ std::vector<path> izstream::files() const
 
 bool izstream::has_file(const path &filename) const
 {
+    if (forward_only_)
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        read_local_headers(filename.string());
+    }
+
     return file_headers_.count(filename.string()) != 0;
 }
 
+std::size_t izstream::file_size(const path &filename) const
+{
+    if (!has_file(filename)) return 0;
+
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    return static_cast<std::size_t>(file_headers_.at(filename.string()).uncompressed_size);
+}
+
 } // namespace detail
 } // namespace xlnt
@@ -35,8 +35,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #pragma once
 
+#include <cstdio>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -68,6 +71,61 @@ struct XLNT_API zheader
     std::uint32_t header_offset = 0;
 };
 
+/// <summary>
+/// A single compressed file of a ZIP archive held in memory or in a temporary file,
+/// so that it can be written independently of (and concurrently with) the archive it
+/// will later be appended to with ozstream::append.
+/// </summary>
+class XLNT_API zspool
+{
+public:
+    /// <summary>
+    /// Construct an empty spool for the archive entry named file. If temporary_file
+    /// is true, the compressed data is kept in a temporary file instead of in memory.
+    /// </summary>
+    zspool(const path &file, bool temporary_file = false);
+
+    /// <summary>
+    /// Destructor.
+    /// </summary>
+    ~zspool();
+
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives into
+    /// this spool. The spool is complete once the returned streambuf is destroyed.
+    /// It must not outlive this spool.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open();
+
+private:
+    friend class ozstream;
+
+    /// <summary>
+    /// The entry's header, updated with sizes and CRC when the data is complete.
+    /// </summary>
+    zheader header_;
+
+    /// <summary>
+    /// The local header followed by the compressed data, unless they are in file_.
+    /// </summary>
+    std::vector<std::uint8_t> data_;
+
+    /// <summary>
+    /// The temporary file holding the local header and compressed data, or null.
+    /// </summary>
+    std::FILE *file_ = nullptr;
+
+    /// <summary>
+    /// Writes into data_.
+    /// </summary>
+    std::unique_ptr<std::streambuf> data_buffer_;
+
+    /// <summary>
+    /// The stream the compressing streambuf writes to.
+    /// </summary>
+    std::ostream data_stream_;
+};
+
 /// <summary>
 /// Writes a series of uncompressed binary file data as ostreams into another ostream
 /// according to the ZIP format.
@@ -77,6 +135,8 @@ class XLNT_API ozstream
 public:
     /// <summary>
     /// Construct a new zip_file_writer which writes a ZIP archive to the given stream.
+    /// If the stream can't seek, the archive is written front to back with each file's
+    /// CRC and sizes in a data descriptor following its data.
     /// </summary>
     ozstream(std::ostream &stream);
 
@@ -90,14 +150,45 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Copies the completed file in spool into the archive as is, without
+    /// compressing it again.
+    /// </summary>
+    void append(const zspool &spool);
+
 private:
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
+
+    /// <summary>
+    /// Counts the bytes passed on to a destination_stream_ which can't seek.
+    /// </summary>
+    std::unique_ptr<std::streambuf> counting_buffer_;
+
+    /// <summary>
+    /// Writes to counting_buffer_, giving positions in a destination_stream_ which can't seek.
+    /// </summary>
+    std::unique_ptr<std::ostream> counting_stream_;
+
+    /// <summary>
+    /// The stream the archive is written to, destination_stream_ or counting_stream_.
+    /// </summary>
+    std::ostream *archive_stream_;
 };
 
+class zip_streambuf_decompress;
+
 /// <summary>
 /// Reads an archive containing a number of files from an istream and allows them
-/// to be decompressed into an istream.
+/// to be decompressed into an istream. Any number of files may be open at once,
+/// from any number of threads, since each buffer returned by open() remembers its
+/// own position in the archive and reads from the source stream under a lock.
+/// If the source stream can't seek, such as a pipe or a socket, the archive is read
+/// forward only by walking its local headers in archive order as files are asked
+/// for. Since nothing can be read twice from such a stream, the compressed data of
+/// a file the stream moves past before it was opened is kept in memory until the
+/// file was read. A file opened when the stream reaches it is decompressed as its
+/// data arrives without being kept, so each file can only be read once.
 /// </summary>
 class XLNT_API izstream
 {
@@ -132,21 +223,105 @@ public:
     /// </summary>
     bool has_file(const path &filename) const;
 
+    /// <summary>
+    /// Returns the uncompressed size of the file, or zero if the archive doesn't
+    /// record it before the file's data.
+    /// </summary>
+    std::size_t file_size(const path &filename) const;
+
 private:
+    friend class zip_streambuf_decompress;
+
     /// <summary>
     ///
     /// </summary>
     bool read_central_header();
 
+    /// <summary>
+    /// Reads up to size bytes at offset of the source stream into data and
+    /// returns the number of bytes read.
+    /// </summary>
+    std::size_t read_source(std::streamoff offset, char *data, std::size_t size) const;
+
+    /// <summary>
+    /// Walks the local headers of a forward-only archive until filename was found,
+    /// or until the end of the archive if filename is empty. Must be called with
+    /// source_mutex_ held.
+    /// </summary>
+    void read_local_headers(const std::string &filename) const;
+
+    /// <summary>
+    /// Reads up to size bytes of a forward-only archive at source_position_ into data,
+    /// taking lookahead_ first, and returns the number of bytes read. Must be called
+    /// with source_mutex_ held.
+    /// </summary>
+    std::size_t read_forward(char *data, std::size_t size) const;
+
+    /// <summary>
+    /// Moves the forward-only source stream to offset, keeping the bytes it moves
+    /// past in kept_data_. Must be called with source_mutex_ held.
+    /// </summary>
+    void pass_source(std::streamoff offset) const;
+
+    /// <summary>
+    /// Drops the kept bytes of the forward-only file whose size bytes of data start
+    /// at offset once its reader is done with them.
+    /// </summary>
+    void release_source(std::streamoff offset, std::size_t size) const;
+
+    /// <summary>
+    /// Keeps the compressed data of a deflated entry whose sizes follow its data in
+    /// kept_data_ and fills in header from its data descriptor. Must be called with
+    /// source_mutex_ held and source_position_ at the start of the data.
+    /// </summary>
+    void pass_described_entry(zheader &header) const;
+
     /// <summary>
     ///
     /// </summary>
-    std::unordered_map<std::string, zheader> file_headers_;
+    mutable std::unordered_map<std::string, zheader> file_headers_;
 
     /// <summary>
     ///
     /// </summary>
     std::istream &source_stream_;
+
+    /// <summary>
+    /// Serialises access to source_stream_ between open files.
+    /// </summary>
+    mutable std::mutex source_mutex_;
+
+    /// <summary>
+    /// The position of source_stream_ after the last read, or -1 if unknown,
+    /// so that a file read sequentially doesn't seek before every read.
+    /// </summary>
+    mutable std::streamoff source_position_ = -1;
+
+    /// <summary>
+    /// True if source_stream_ can't seek so that the archive is read in a single pass.
+    /// </summary>
+    bool forward_only_ = false;
+
+    /// <summary>
+    /// The offset of the next local header of a forward-only archive, or -1 once
+    /// its central directory was reached.
+    /// </summary>
+    mutable std::streamoff next_header_ = 0;
+
+    /// <summary>
+    /// The offset of each forward-only file's data by filename.
+    /// </summary>
+    mutable std::unordered_map<std::string, std::streamoff> data_offsets_;
+
+    /// <summary>
+    /// The data of forward-only files passed before they were read, by the offset of its first byte.
+    /// </summary>
+    mutable std::map<std::streamoff, std::vector<char>> kept_data_;
+
+    /// <summary>
+    /// Bytes read from a forward-only source_stream_ ahead of source_position_.
+    /// </summary>
+    mutable std::vector<char> lookahead_;
 };
 
 } // namespace detail
@@ -21,6 +21,9 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <ostream>
+#include <sstream>
+
 #include <xlnt/drawing/spreadsheet_drawing.hpp>
 #include <detail/constants.hpp>
 
@@ -86,6 +89,111 @@ std::vector<std::string> copy_and_extract(xml::parser &p, xml::serializer &s)
     }
     return embed_ids;
 }
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_name_end(char c)
+{
+    return is_space(c) || c == '/' || c == '>' || c == '=';
+}
+
+// returns the local part of a qualified name
+std::string local_name(const std::string &name)
+{
+    const auto colon = name.find(':');
+    return colon == std::string::npos ? name : name.substr(colon + 1);
+}
+
+// find the embed attribute of every blip start tag in markup without parsing it
+std::vector<std::string> scan_embed_ids(const std::string &markup)
+{
+    // comments, CDATA sections, processing instructions and declarations hold no tags
+    static const std::vector<std::pair<std::string, std::string>> skipped = {
+        {"<!--", "-->"}, {"<![CDATA[", "]]>"}, {"<?", "?>"}, {"<!", ">"}};
+
+    std::vector<std::string> embed_ids;
+    auto position = markup.find('<');
+
+    while (position != std::string::npos && position + 1 < markup.size())
+    {
+        auto is_skipped = false;
+
+        for (const auto &section : skipped)
+        {
+            if (markup.compare(position, section.first.size(), section.first) != 0) continue;
+
+            const auto section_end = markup.find(section.second, position + section.first.size());
+            if (section_end == std::string::npos) return embed_ids;
+
+            position = markup.find('<', section_end + section.second.size());
+            is_skipped = true;
+            break;
+        }
+
+        if (is_skipped) continue;
+
+        auto name_end = position + 1;
+        while (name_end < markup.size() && !is_name_end(markup[name_end]))
+        {
+            ++name_end;
+        }
+
+        const auto is_blip = local_name(markup.substr(position + 1, name_end - position - 1)) == "blip";
+
+        // walk the attributes as name S? = S? quoted value, where values may contain '>'
+        auto current = name_end;
+        while (current < markup.size() && markup[current] != '>')
+        {
+            if (is_space(markup[current]) || markup[current] == '/')
+            {
+                ++current;
+                continue;
+            }
+
+            const auto attribute_start = current;
+            while (current < markup.size() && !is_name_end(markup[current]))
+            {
+                ++current;
+            }
+
+            const auto attribute = markup.substr(attribute_start, current - attribute_start);
+
+            while (current < markup.size() && is_space(markup[current]))
+            {
+                ++current;
+            }
+
+            if (current >= markup.size() || markup[current] != '=') continue;
+            ++current;
+
+            while (current < markup.size() && is_space(markup[current]))
+            {
+                ++current;
+            }
+
+            if (current >= markup.size()) return embed_ids;
+            if (markup[current] != '"' && markup[current] != '\'') continue;
+
+            const auto value_end = markup.find(markup[current], current + 1);
+            if (value_end == std::string::npos) return embed_ids;
+
+            if (is_blip && local_name(attribute) == "embed")
+            {
+                embed_ids.push_back(markup.substr(current + 1, value_end - current - 1));
+            }
+
+            current = value_end + 1;
+        }
+
+        position = markup.find('<', current);
+    }
+
+    return embed_ids;
+}
+
 } // namespace
 
 namespace xlnt {
@@ -99,6 +207,12 @@ spreadsheet_drawing::spreadsheet_drawing(xml::parser &parser)
     serialized_value_ = serialization_stream.str();
 }
 
+spreadsheet_drawing::spreadsheet_drawing(const std::string &serialized)
+    : serialized_value_(serialized),
+      embed_ids_(scan_embed_ids(serialized))
+{
+}
+
 // void spreadsheet_drawing::serialize(xml::serializer &serializer, const std::string& ns)
 void spreadsheet_drawing::serialize(xml::serializer &serializer)
 {
@@ -107,6 +221,11 @@ void spreadsheet_drawing::serialize(xml::serializer &serializer)
     copy_and_extract(p, serializer);
 }
 
+void spreadsheet_drawing::serialize(std::ostream &stream) const
+{
+    stream.write(serialized_value_.data(), static_cast<std::streamsize>(serialized_value_.size()));
+}
+
 std::vector<std::string> spreadsheet_drawing::get_embed_ids()
 {
     return embed_ids_;
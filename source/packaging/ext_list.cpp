@@ -1,5 +1,7 @@
 #include <xlnt/packaging/ext_list.hpp>
 #include <algorithm>
+#include <ostream>
+#include <sstream>
 
 #include <detail/external/include_libstudxml.hpp>
 
@@ -74,7 +76,12 @@ ext_list::ext::ext(xml::parser &parser, const std::string &ns)
     s.namespace_decl(ns, "");
     extension_ID_ = roundtrip(parser, s);
     s.end_element(xml::qname(ns, "wrap"));
-    serialised_value_ = serialisation_stream.str();
+
+    // keep only the ext element so that it can be written back out as is
+    const auto wrapped = serialisation_stream.str();
+    const auto begin = wrapped.find('>') + 1;
+    const auto end = wrapped.rfind("</");
+    serialised_value_ = wrapped.substr(begin, end - begin);
 }
 
 ext_list::ext::ext(const uri &ID, const std::string &serialised)
@@ -84,13 +91,18 @@ ext_list::ext::ext(const uri &ID, const std::string &serialised)
 
 void ext_list::ext::serialise(xml::serializer &serialiser, const std::string &ns)
 {
-    std::istringstream ser(serialised_value_);
+    std::istringstream ser("<wrap xmlns=\"" + ns + "\">" + serialised_value_ + "</wrap>");
     xml::parser p(ser, "", xml::parser::receive_default);
     p.next_expect(xml::parser::event_type::start_element, xml::qname(ns, "wrap"));
     roundtrip(p, serialiser);
     p.next_expect(xml::parser::event_type::end_element, xml::qname(ns, "wrap"));
 }
 
+void ext_list::ext::serialise(std::ostream &stream) const
+{
+    stream.write(serialised_value_.data(), static_cast<std::streamsize>(serialised_value_.size()));
+}
+
 ext_list::ext_list(xml::parser &parser, const std::string &ns)
 {
     // begin with the start element already parsed
@@ -111,6 +123,16 @@ void ext_list::serialize(xml::serializer &serialiser, const std::string &ns)
     serialiser.end_element();
 }
 
+void ext_list::serialize(std::ostream &stream) const
+{
+    stream << "<extLst>";
+    for (const auto &ext : extensions_)
+    {
+        ext.serialise(stream);
+    }
+    stream << "</extLst>";
+}
+
 void ext_list::add_extension(const uri &ID, const std::string &element)
 {
     extensions_.push_back(ext{ID, element});
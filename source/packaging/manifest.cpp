@@ -35,6 +35,8 @@ void manifest::clear()
     default_content_types_.clear();
     override_content_types_.clear();
     relationships_.clear();
+    next_relationship_indices_.clear();
+    relationship_targets_.clear();
 }
 
 path manifest::canonicalize(const std::vector<xlnt::relationship> &rels) const
@@ -98,6 +100,33 @@ bool manifest::has_relationship(const path &path, const std::string &rel_id) con
     return rels->second.find(rel_id) != rels->second.end();
 }
 
+bool manifest::has_relationship(const path &path, relationship_type type, const uri &target) const
+{
+    auto part_targets = relationship_targets_.find(path);
+    if (part_targets == relationship_targets_.end())
+    {
+        return false;
+    }
+    auto type_targets = part_targets->second.find(type);
+    if (type_targets == part_targets->second.end())
+    {
+        return false;
+    }
+    return type_targets->second.find(target.path().string()) != type_targets->second.end();
+}
+
+relationship manifest::relationship(const path &part, relationship_type type, const uri &target) const
+{
+    if (!has_relationship(part, type, target))
+    {
+        throw key_not_found();
+    }
+
+    const auto &rel_id = relationship_targets_.at(part).at(type).at(target.path().string());
+
+    return relationships_.at(part).at(rel_id);
+}
+
 relationship manifest::relationship(const path &part, relationship_type type) const
 {
     if (relationships_.find(part) == relationships_.end()) throw key_not_found();
@@ -186,20 +215,19 @@ std::vector<relationship> manifest::relationships(const path &part) const
 
 relationship manifest::relationship(const path &part, const std::string &rel_id) const
 {
-    if (relationships_.find(part) == relationships_.end())
+    auto part_rels = relationships_.find(part);
+    if (part_rels == relationships_.end())
     {
         throw key_not_found();
     }
 
-    for (const auto &rel : relationships_.at(part))
+    auto rel = part_rels->second.find(rel_id);
+    if (rel == part_rels->second.end())
     {
-        if (rel.second.id() == rel_id)
-        {
-            return rel.second;
-        }
+        throw key_not_found();
     }
 
-    throw key_not_found();
+    return rel->second;
 }
 
 std::vector<path> manifest::parts() const
@@ -231,10 +259,58 @@ std::string manifest::register_relationship(const uri &source,
 
 std::string manifest::register_relationship(const class relationship &rel)
 {
-    relationships_[rel.source().path()][rel.id()] = rel;
+    auto &part_rels = relationships_[rel.source().path()];
+    auto existing = part_rels.find(rel.id());
+
+    if (existing == part_rels.end())
+    {
+        part_rels.emplace(rel.id(), rel);
+        index_relationship(rel);
+    }
+    else
+    {
+        // Replacing a relationship might invalidate the target index of the part
+        existing->second = rel;
+        reindex_relationships(rel.source().path());
+    }
+
     return rel.id();
 }
 
+void manifest::index_relationship(const class relationship &rel)
+{
+    relationship_targets_[rel.source().path()][rel.type()].emplace(rel.target().path().string(), rel.id());
+}
+
+void manifest::reindex_relationships(const path &part)
+{
+    relationship_targets_.erase(part);
+
+    auto part_rels = relationships_.find(part);
+    if (part_rels == relationships_.end())
+    {
+        return;
+    }
+
+    // Index in ID order so that the lowest ID wins for duplicate targets
+    auto rels = std::vector<const xlnt::relationship *>();
+    rels.reserve(part_rels->second.size());
+
+    for (const auto &rel : part_rels->second)
+    {
+        rels.push_back(&rel.second);
+    }
+
+    std::sort(rels.begin(), rels.end(), [](const xlnt::relationship *a, const xlnt::relationship *b) {
+        return a->id().size() != b->id().size() ? a->id().size() < b->id().size() : a->id() < b->id();
+    });
+
+    for (auto rel : rels)
+    {
+        index_relationship(*rel);
+    }
+}
+
 std::unordered_map<std::string, std::string> manifest::unregister_relationship(const uri &source, const std::string &rel_id)
 {
     // This shouldn't happen, but just in case...
@@ -266,6 +342,15 @@ std::unordered_map<std::string, std::string> manifest::unregister_relationship(c
         part_rels.erase(old_id);
     }
 
+    // Only IDs at or above the deleted one could have been freed
+    auto next_index = next_relationship_indices_.find(source.path());
+    if (next_index != next_relationship_indices_.end())
+    {
+        next_index->second = std::min(next_index->second, rel_index);
+    }
+
+    reindex_relationships(source.path());
+
     return id_map;
 }
 
@@ -306,19 +391,21 @@ void manifest::unregister_default_type(const std::string &extension)
     default_content_types_.erase(extension);
 }
 
-std::string manifest::next_relationship_id(const path &part) const
+std::string manifest::next_relationship_id(const path &part)
 {
-    if (relationships_.find(part) == relationships_.end()) return "rId1";
+    auto part_rels = relationships_.find(part);
+    if (part_rels == relationships_.end()) return "rId1";
 
-    std::size_t index = 1;
-    const auto &part_rels = relationships_.at(part);
+    // Resume probing where the last search stopped since lower IDs are known to be taken
+    auto &index = next_relationship_indices_.emplace(part, std::size_t(1)).first->second;
+    auto id = "rId" + std::to_string(index);
 
-    while (part_rels.find("rId" + std::to_string(index)) != part_rels.end())
+    while (part_rels->second.find(id) != part_rels->second.end())
     {
-        ++index;
+        id = "rId" + std::to_string(++index);
     }
 
-    return "rId" + std::to_string(index);
+    return id;
 }
 
 bool manifest::has_override_type(const xlnt::path &part) const
@@ -67,14 +67,25 @@ condition condition::text_does_not_contain(const std::string &text)
     return c;
 }
 
-conditional_format::conditional_format(detail::conditional_format_impl *d)
-    : d_(d)
+conditional_format::conditional_format(detail::conditional_format_impl *d, const range_reference &range)
+    : d_(d),
+      range_(range)
 {
 }
 
+range_reference conditional_format::range() const
+{
+    return range_;
+}
+
+std::vector<range_reference> conditional_format::ranges() const
+{
+    return d_->target_ranges;
+}
+
 bool conditional_format::operator==(const conditional_format &other) const
 {
-    return d_ == other.d_;
+    return d_ == other.d_ && range_ == other.range_;
 }
 
 bool conditional_format::operator!=(const conditional_format &other) const
@@ -94,7 +105,8 @@ xlnt::border conditional_format::border() const
 
 conditional_format conditional_format::border(const xlnt::border &new_border)
 {
-    d_->border_id = d_->parent->find_or_add(d_->parent->borders, new_border);
+    const auto id = optional<std::size_t>(d_->parent->find_or_add(d_->parent->borders, new_border));
+    d_ = d_->parent->restyle_conditional_format(d_, range_, id, d_->fill_id, d_->font_id);
     return *this;
 }
 
@@ -110,7 +122,8 @@ xlnt::fill conditional_format::fill() const
 
 conditional_format conditional_format::fill(const xlnt::fill &new_fill)
 {
-    d_->fill_id = d_->parent->find_or_add(d_->parent->fills, new_fill);
+    const auto id = optional<std::size_t>(d_->parent->find_or_add(d_->parent->fills, new_fill));
+    d_ = d_->parent->restyle_conditional_format(d_, range_, d_->border_id, id, d_->font_id);
     return *this;
 }
 
@@ -126,7 +139,8 @@ xlnt::font conditional_format::font() const
 
 conditional_format conditional_format::font(const xlnt::font &new_font)
 {
-    d_->font_id = d_->parent->find_or_add(d_->parent->fonts, new_font);
+    const auto id = optional<std::size_t>(d_->parent->find_or_add(d_->parent->fonts, new_font));
+    d_ = d_->parent->restyle_conditional_format(d_, range_, d_->border_id, d_->fill_id, id);
     return *this;
 }
 
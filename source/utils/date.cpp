@@ -20,10 +20,12 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <algorithm>
 #include <cmath>
 #include <ctime>
 
 #include <xlnt/utils/date.hpp>
+#include <detail/serial_date.hpp>
 
 namespace {
 
@@ -39,6 +41,39 @@ std::tm safe_localtime(std::time_t raw_time)
 #endif
 }
 
+/// <summary>
+/// Converts count <= detail::serial_block_size numbers as date::from_number does.
+/// </summary>
+XLNT_SERIAL_KERNEL
+void dates_from_block(const int *days, std::size_t count, xlnt::calendar base_date, xlnt::date *results)
+{
+    xlnt::detail::serial_block block;
+    xlnt::detail::dates_from_serials(days, count, base_date, block);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        results[i] = xlnt::date(block.year[i], block.month[i], block.day[i]);
+    }
+}
+
+/// <summary>
+/// Converts count <= detail::serial_block_size dates as date::to_number does.
+/// </summary>
+XLNT_SERIAL_KERNEL
+void numbers_from_block(const xlnt::date *dates, std::size_t count, xlnt::calendar base_date, int *results)
+{
+    xlnt::detail::serial_block block;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        block.year[i] = dates[i].year;
+        block.month[i] = dates[i].month;
+        block.day[i] = dates[i].day;
+    }
+
+    xlnt::detail::serials_from_dates(block, count, base_date, results);
+}
+
 } // namespace
 
 namespace xlnt {
@@ -84,6 +119,24 @@ date date::from_number(int days_since_base_year, calendar base_date)
     return result;
 }
 
+void date::from_numbers(const int *days_since_base_year, std::size_t count, date *results, calendar base_date)
+{
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+        dates_from_block(days_since_base_year + first, size, base_date, results + first);
+    }
+}
+
+void date::to_numbers(const date *dates, std::size_t count, int *results, calendar base_date)
+{
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+        numbers_from_block(dates + first, size, base_date, results + first);
+    }
+}
+
 bool date::operator==(const date &comparand) const
 {
     return year == comparand.year && month == comparand.month && day == comparand.day;
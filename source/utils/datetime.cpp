@@ -20,12 +20,14 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <algorithm>
 #include <cmath>
 #include <ctime>
 
 #include <xlnt/utils/date.hpp>
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/time.hpp>
+#include <detail/serial_date.hpp>
 
 namespace {
 
@@ -39,6 +41,43 @@ std::string fill(const std::string &string, std::size_t length = 2)
     return std::string(length - string.size(), '0') + string;
 }
 
+const std::int64_t microseconds_per_day = std::int64_t(86400) * 1000000;
+
+/// <summary>
+/// Sets the fields of block from count serial numbers, as datetime::from_number does.
+/// </summary>
+XLNT_SERIAL_KERNEL
+void fields_from_numbers(const double *numbers, std::size_t count, xlnt::calendar base_date,
+    xlnt::detail::serial_block &block)
+{
+    int days[xlnt::detail::serial_block_size];
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        days[i] = static_cast<int>(numbers[i]);
+    }
+
+    xlnt::detail::dates_from_serials(days, count, base_date, block);
+    xlnt::detail::times_from_serials(numbers, count, block);
+}
+
+/// <summary>
+/// Sets count serial numbers from the fields of block, as datetime::to_number does.
+/// </summary>
+XLNT_SERIAL_KERNEL
+void numbers_from_fields(const xlnt::detail::serial_block &block, std::size_t count, xlnt::calendar base_date,
+    double *numbers)
+{
+    int days[xlnt::detail::serial_block_size];
+    xlnt::detail::serials_from_dates(block, count, base_date, days);
+    xlnt::detail::fractions_from_times(block, count, numbers);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        numbers[i] += days[i];
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -52,6 +91,97 @@ datetime datetime::from_number(double raw_time, calendar base_date)
         time_part.microsecond);
 }
 
+void datetime::from_numbers(const double *numbers, std::size_t count, datetime *results, calendar base_date)
+{
+    detail::serial_block block;
+
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+        fields_from_numbers(numbers + first, size, base_date, block);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            results[first + i] = datetime(block.year[i], block.month[i], block.day[i],
+                block.hour[i], block.minute[i], block.second[i], block.microsecond[i]);
+        }
+    }
+}
+
+void datetime::to_numbers(const datetime *datetimes, std::size_t count, double *results, calendar base_date)
+{
+    detail::serial_block block;
+
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const auto &current = datetimes[first + i];
+            block.year[i] = current.year;
+            block.month[i] = current.month;
+            block.day[i] = current.day;
+            block.hour[i] = current.hour;
+            block.minute[i] = current.minute;
+            block.second[i] = current.second;
+            block.microsecond[i] = current.microsecond;
+        }
+
+        numbers_from_fields(block, size, base_date, results + first);
+    }
+}
+
+void datetime::to_unix_microseconds(const double *numbers, std::size_t count, std::int64_t *results, calendar base_date)
+{
+    detail::serial_block block;
+
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+        fields_from_numbers(numbers + first, size, base_date, block);
+        detail::unix_days_from_dates(block, size, results + first);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            results[first + i] = results[first + i] * microseconds_per_day
+                + ((std::int64_t(block.hour[i]) * 60 + block.minute[i]) * 60 + block.second[i]) * 1000000
+                + block.microsecond[i];
+        }
+    }
+}
+
+void datetime::from_unix_microseconds(const std::int64_t *microseconds, std::size_t count, double *results, calendar base_date)
+{
+    detail::serial_block block;
+    std::int64_t days[detail::serial_block_size];
+
+    for (std::size_t first = 0; first < count; first += detail::serial_block_size)
+    {
+        const auto size = std::min(detail::serial_block_size, count - first);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            // floor division so that times before the epoch fall on the previous day
+            const auto value = microseconds[first + i];
+            auto day = value / microseconds_per_day;
+            day -= (value % microseconds_per_day < 0) ? 1 : 0;
+            auto time_of_day = value - day * microseconds_per_day;
+
+            days[i] = day;
+            block.microsecond[i] = static_cast<int>(time_of_day % 1000000);
+            time_of_day /= 1000000;
+            block.second[i] = static_cast<int>(time_of_day % 60);
+            time_of_day /= 60;
+            block.minute[i] = static_cast<int>(time_of_day % 60);
+            block.hour[i] = static_cast<int>(time_of_day / 60);
+        }
+
+        detail::dates_from_unix_days(days, size, block);
+        numbers_from_fields(block, size, base_date, results + first);
+    }
+}
+
 bool datetime::operator==(const datetime &comparand) const
 {
     return year == comparand.year
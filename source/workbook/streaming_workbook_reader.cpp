@@ -27,7 +27,9 @@
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
+#include <xlnt/workbook/streaming_worksheet_cursor.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/row_view.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
@@ -64,6 +66,11 @@ cell streaming_workbook_reader::read_cell()
     return consumer_->read_cell();
 }
 
+bool streaming_workbook_reader::read_row(row_view &row)
+{
+    return consumer_->read_row(row);
+}
+
 bool streaming_workbook_reader::has_worksheet(const std::string &name)
 {
     auto titles = sheet_titles();
@@ -78,42 +85,28 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
     }
 
     worksheet_rel_id_ = workbook_->impl().sheet_title_rel_id_map_.at(title);
-    const auto workbook_rel = workbook_->manifest()
-                                  .relationship(path("/"), relationship_type::office_document);
-    const auto worksheet_rel = workbook_->manifest()
-                                   .relationship(workbook_rel.target().path(), worksheet_rel_id_);
-
-    auto rel_chain = std::vector<relationship>{workbook_rel, worksheet_rel};
-
-    const auto &manifest = consumer_->target_.manifest();
-    const auto part_path = manifest.canonicalize(rel_chain);
-    auto part_stream_buffer = consumer_->archive_->open(part_path);
-    part_stream_buffer_.swap(part_stream_buffer);
-    part_stream_.reset(new std::istream(part_stream_buffer_.get()));
-    parser_.reset(new xml::parser(*part_stream_, part_path.string()));
-    consumer_->parser_ = parser_.get();
-
-    consumer_->current_worksheet_ = nullptr;
+    consumer_->begin_streaming_worksheet(title);
+}
 
-    for (auto &impl : workbook_->impl().worksheets_)
-    {
-        if (impl.title_ == title)
-        {
-            consumer_->current_worksheet_ = &impl;
-        }
-    }
+worksheet streaming_workbook_reader::end_worksheet()
+{
+    return consumer_->read_worksheet_end(worksheet_rel_id_);
+}
 
-    if (consumer_->current_worksheet_ == nullptr)
+streaming_worksheet_cursor streaming_workbook_reader::open_worksheet_cursor(const std::string &title)
+{
+    if (!has_worksheet(title))
     {
         throw xlnt::exception("sheet not found");
     }
 
-    consumer_->read_worksheet_begin(worksheet_rel_id_);
-}
+    std::unique_ptr<detail::xlsx_consumer> consumer(new detail::xlsx_consumer(*workbook_));
+    consumer->archive_ = consumer_->archive_;
+    consumer->streaming_ = true;
+    consumer->shared_string_table_ = consumer_->flat_shared_strings();
+    consumer->begin_streaming_worksheet(title);
 
-worksheet streaming_workbook_reader::end_worksheet()
-{
-    return consumer_->read_worksheet_end(worksheet_rel_id_);
+    return streaming_worksheet_cursor(title, std::move(consumer));
 }
 
 void streaming_workbook_reader::open(const std::vector<std::uint8_t> &data)
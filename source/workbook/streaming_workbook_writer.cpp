@@ -24,16 +24,15 @@
 #include <fstream>
 
 #include <xlnt/cell/cell.hpp>
-#include <xlnt/packaging/manifest.hpp>
-#include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
-#include <detail/implementations/cell_impl.hpp>
-#include <detail/implementations/worksheet_impl.hpp>
+#include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
+#include <detail/serialization/zstream.hpp>
 
 namespace xlnt {
 
@@ -48,21 +47,64 @@ streaming_workbook_writer::~streaming_workbook_writer()
 
 void streaming_workbook_writer::close()
 {
-    if (producer_)
+    if (!workbook_) return;
+
     {
-        producer_.reset(nullptr);
-        stream_buffer_.reset(nullptr);
+        detail::xlsx_producer producer(*workbook_);
+
+        for (auto &worksheet_producer : worksheet_producers_)
+        {
+            worksheet_producer->end_streaming_worksheet();
+            producer.streamed_worksheets_[worksheet_producer->streaming_part_path_.string()] = worksheet_producer.get();
+        }
+
+        // the archive is finished when producer is destroyed
+        producer.write(std::move(archive_));
     }
+
+    current_producer_ = nullptr;
+    worksheet_producers_.clear();
+    workbook_.reset();
+    stream_.reset();
+    stream_buffer_.reset();
 }
 
 cell streaming_workbook_writer::add_cell(const cell_reference &ref)
 {
-    return producer_->add_cell(ref);
+    if (current_producer_ == nullptr)
+    {
+        add_worksheet_writer(workbook_->active_sheet().title());
+    }
+
+    return current_producer_->add_streaming_cell(ref);
 }
 
 worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 {
-    return producer_->add_worksheet(title);
+    return add_worksheet_writer(title).worksheet();
+}
+
+streaming_worksheet_writer streaming_workbook_writer::add_worksheet_writer(const std::string &title)
+{
+    if (!workbook_)
+    {
+        throw xlnt::exception("streaming_workbook_writer isn't open");
+    }
+
+    // handles created earlier may be merging strings and styles into the workbook
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // the default worksheet becomes the first streamed one unless it's already being streamed
+    const auto first = worksheet_producers_.empty();
+    auto ws = first ? workbook_->active_sheet() : workbook_->create_sheet();
+    ws.title(title);
+
+    // only one archive entry can be open at a time, so the others are spooled until close
+    worksheet_producers_.emplace_back(new detail::xlsx_producer(*workbook_));
+    current_producer_ = worksheet_producers_.back().get();
+    current_producer_->begin_streaming_worksheet(ws, mutex_, first ? archive_.get() : nullptr);
+
+    return streaming_worksheet_writer(current_producer_);
 }
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
@@ -98,11 +140,9 @@ void streaming_workbook_writer::open(const xlnt::path &filename)
 void streaming_workbook_writer::open(std::ostream &stream)
 {
     workbook_.reset(new workbook());
-    producer_.reset(new detail::xlsx_producer(*workbook_));
-    producer_->open(stream);
-    producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
-    producer_->current_cell_ = new detail::cell_impl();
-    producer_->current_cell_->parent_ = producer_->current_worksheet_;
+    // format ids handed out to streamed cells must stay valid until the workbook is written
+    workbook_->d_->stylesheet_.get().garbage_collection_enabled = false;
+    archive_.reset(new detail::ozstream(stream));
 }
 
 } // namespace xlnt
@@ -0,0 +1,54 @@
+// Copyright (c) 2017-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <xlnt/workbook/streaming_worksheet_cursor.hpp>
+#include <xlnt/worksheet/row_view.hpp>
+#include <detail/serialization/xlsx_consumer.hpp>
+
+namespace xlnt {
+
+streaming_worksheet_cursor::streaming_worksheet_cursor(const std::string &title,
+    std::unique_ptr<detail::xlsx_consumer> &&consumer)
+    : title_(title), consumer_(std::move(consumer))
+{
+}
+
+streaming_worksheet_cursor::streaming_worksheet_cursor(streaming_worksheet_cursor &&other) = default;
+
+streaming_worksheet_cursor &streaming_worksheet_cursor::operator=(streaming_worksheet_cursor &&other) = default;
+
+streaming_worksheet_cursor::~streaming_worksheet_cursor()
+{
+}
+
+const std::string &streaming_worksheet_cursor::title() const
+{
+    return title_;
+}
+
+bool streaming_worksheet_cursor::read_row(row_view &row)
+{
+    return consumer_->read_row(row);
+}
+
+} // namespace xlnt
@@ -0,0 +1,51 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+// Copyright (c) 2010-2015 openpyxl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+
+#include <xlnt/cell/cell.hpp>
+#include <xlnt/workbook/streaming_worksheet_writer.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+#include <detail/serialization/xlsx_producer.hpp>
+
+namespace xlnt {
+
+streaming_worksheet_writer::streaming_worksheet_writer(detail::xlsx_producer *producer)
+    : producer_(producer)
+{
+}
+
+std::string streaming_worksheet_writer::title() const
+{
+    return worksheet().title();
+}
+
+worksheet streaming_worksheet_writer::worksheet() const
+{
+    return xlnt::worksheet(producer_->current_worksheet_);
+}
+
+cell streaming_worksheet_writer::add_cell(const cell_reference &ref)
+{
+    return producer_->add_streaming_cell(ref);
+}
+
+} // namespace xlnt
@@ -26,6 +26,7 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <set>
 
 #include <xlnt/cell/cell.hpp>
@@ -44,8 +45,10 @@
 #include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/workbook/workbook_diff.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/workbook/worksheet_iterator.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
@@ -53,12 +56,17 @@
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/constants.hpp>
 #include <detail/default_case.hpp>
+#include <detail/fingerprint.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/rich_text_access.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
+#include <detail/parallel.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
 #include <detail/serialization/open_stream.hpp>
+#include <detail/serialization/snapshot.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/xlsb_producer.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 
@@ -551,31 +559,35 @@ void workbook::register_package_part(relationship_type type)
     }
 }
 
-void workbook::register_workbook_part(relationship_type type)
+namespace {
+
+// the parts below are registered in a given manifest so that producers can bring their
+// own copy of a const workbook's manifest up to date
+
+void register_workbook_part(manifest &target, relationship_type type)
 {
-    auto wb_rel = manifest().relationship(path("/"), relationship_type::office_document);
-    auto wb_path = manifest().canonicalize({wb_rel});
+    auto wb_rel = target.relationship(path("/"), relationship_type::office_document);
+    auto wb_path = target.canonicalize({wb_rel});
 
-    if (!manifest().has_relationship(wb_path, type))
+    if (!target.has_relationship(wb_path, type))
     {
-        manifest().register_override_type(default_path(type), content_type(type));
-        manifest().register_relationship(uri(wb_path.string()), type,
+        target.register_override_type(default_path(type), content_type(type));
+        target.register_relationship(uri(wb_path.string()), type,
             uri(default_path(type).relative_to(wb_path.resolve(path("/"))).string()),
             target_mode::internal);
     }
 }
 
-void workbook::register_worksheet_part(worksheet ws, relationship_type type)
+void register_worksheet_part(manifest &target, const std::string &ws_rel_id, relationship_type type)
 {
-    auto wb_rel = manifest().relationship(path("/"),
+    auto wb_rel = target.relationship(path("/"),
         relationship_type::office_document);
-    auto ws_rel = manifest().relationship(wb_rel.target().path(),
-        d_->sheet_title_rel_id_map_.at(ws.title()));
+    auto ws_rel = target.relationship(wb_rel.target().path(), ws_rel_id);
     path ws_path(ws_rel.source().path().parent().append(ws_rel.target().path()));
 
     if (type == relationship_type::comments)
     {
-        if (!manifest().has_relationship(ws_path, relationship_type::vml_drawing))
+        if (!target.has_relationship(ws_path, relationship_type::vml_drawing))
         {
             std::size_t file_number = 1;
             path filename("vmlDrawing1.vml");
@@ -586,13 +598,13 @@ void workbook::register_worksheet_part(worksheet ws, relationship_type type)
                 filename_exists = false;
 
                 for (auto current_ws_rel :
-                    manifest().relationships(wb_rel.target().path(), xlnt::relationship_type::worksheet))
+                    target.relationships(wb_rel.target().path(), xlnt::relationship_type::worksheet))
                 {
                     path current_ws_path(current_ws_rel.source().path().parent().append(current_ws_rel.target().path()));
-                    if (!manifest().has_relationship(current_ws_path, xlnt::relationship_type::vml_drawing)) continue;
+                    if (!target.has_relationship(current_ws_path, xlnt::relationship_type::vml_drawing)) continue;
 
                     for (auto current_ws_child_rel :
-                        manifest().relationships(current_ws_path, xlnt::relationship_type::vml_drawing))
+                        target.relationships(current_ws_path, xlnt::relationship_type::vml_drawing))
                     {
                         if (current_ws_child_rel.target().path() == path("../drawings").append(filename))
                         {
@@ -609,37 +621,62 @@ void workbook::register_worksheet_part(worksheet ws, relationship_type type)
                 }
             }
 
-            manifest().register_default_type("vml", "application/vnd.openxmlformats-officedocument.vmlDrawing");
+            target.register_default_type("vml", "application/vnd.openxmlformats-officedocument.vmlDrawing");
 
             const path relative_path(path("../drawings").append(filename));
-            manifest().register_relationship(
+            target.register_relationship(
                 uri(ws_path.string()), relationship_type::vml_drawing, uri(relative_path.string()), target_mode::internal);
         }
 
-        if (!manifest().has_relationship(ws_path, relationship_type::comments))
+        if (!target.has_relationship(ws_path, relationship_type::comments))
         {
             std::size_t file_number = 1;
             path filename("comments1.xml");
 
             while (true)
             {
-                if (!manifest().has_override_type(constants::package_xl().append(filename))) break;
+                if (!target.has_override_type(constants::package_xl().append(filename))) break;
 
                 file_number++;
                 filename = path("comments" + std::to_string(file_number) + ".xml");
             }
 
             const path absolute_path(constants::package_xl().append(filename));
-            manifest().register_override_type(
+            target.register_override_type(
                 absolute_path, "application/vnd.openxmlformats-officedocument.spreadsheetml.comments+xml");
 
             const path relative_path(path("..").append(filename));
-            manifest().register_relationship(
+            target.register_relationship(
                 uri(ws_path.string()), relationship_type::comments, uri(relative_path.string()), target_mode::internal);
         }
     }
 }
 
+void remove_calculation_chain(manifest &target)
+{
+    auto wb_rel = target.relationship(path("/"), relationship_type::office_document);
+
+    if (target.has_relationship(wb_rel.target().path(), relationship_type::calculation_chain))
+    {
+        auto calc_chain_rel = target.relationship(wb_rel.target().path(), relationship_type::calculation_chain);
+        auto calc_chain_part = target.canonicalize({wb_rel, calc_chain_rel});
+        target.unregister_override_type(calc_chain_part);
+        target.unregister_relationship(wb_rel.target(), calc_chain_rel.id());
+    }
+}
+
+} // namespace
+
+void workbook::register_workbook_part(relationship_type type)
+{
+    xlnt::register_workbook_part(manifest(), type);
+}
+
+void workbook::register_worksheet_part(worksheet ws, relationship_type type)
+{
+    xlnt::register_worksheet_part(manifest(), d_->sheet_title_rel_id_map_.at(ws.title()), type);
+}
+
 const worksheet workbook::sheet_by_title(const std::string &title) const
 {
     for (auto &impl : d_->worksheets_)
@@ -769,6 +806,11 @@ worksheet workbook::create_sheet()
         sheet_id = std::max(sheet_id, ws.id() + 1);
     }
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
+
+    if (d_->max_resident_cells_ != 0)
+    {
+        worksheet(&d_->worksheets_.back()).max_resident_cells(d_->max_resident_cells_);
+    }
     // unique sheet file name
     auto workbook_rel = d_->manifest_.relationship(path("/"), relationship_type::office_document);
     auto workbook_files = d_->manifest_.relationships(workbook_rel.target().path());
@@ -1014,12 +1056,109 @@ void workbook::save(std::ostream &stream) const
     producer.write(stream);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, file_format format) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, format);
+}
+
+void workbook::save(const path &filename, file_format format) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, format);
+}
+
+void workbook::save(std::ostream &stream, file_format format) const
+{
+    if (format == file_format::xlsb)
+    {
+        detail::xlsb_producer producer(*this);
+        producer.write(stream);
+        return;
+    }
+
+    save(stream);
+}
+
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
 
+void workbook::save_snapshot(std::vector<std::uint8_t> &data) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save_snapshot(data_stream);
+}
+
+void workbook::save_snapshot(const std::string &filename) const
+{
+    save_snapshot(path(filename));
+}
+
+void workbook::save_snapshot(const path &filename) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save_snapshot(file_stream);
+}
+
+void workbook::save_snapshot(std::ostream &stream) const
+{
+    detail::snapshot_producer producer(*this);
+    producer.write(stream);
+}
+
+void workbook::load_snapshot(const std::vector<std::uint8_t> &data)
+{
+    // the records are read where they are, so the snapshot is only copied by the caller
+    detail::snapshot_consumer consumer(*this);
+    consumer.read(data.data(), data.size());
+}
+
+void workbook::load_snapshot(const std::string &filename)
+{
+    load_snapshot(path(filename));
+}
+
+void workbook::load_snapshot(const path &filename)
+{
+    std::ifstream file_stream;
+    open_stream(file_stream, filename.string());
+
+    if (!file_stream.good())
+    {
+        throw xlnt::exception("file not found " + filename.string());
+    }
+
+    load_snapshot(file_stream);
+}
+
+void workbook::load_snapshot(std::istream &stream)
+{
+    // one read of the whole snapshot is much cheaper than reading it a section at a time
+    std::vector<std::uint8_t> data;
+    const auto start = stream.tellg();
+
+    if (start != std::istream::pos_type(-1) && stream.seekg(0, std::ios::end))
+    {
+        data.resize(static_cast<std::size_t>(stream.tellg() - start));
+        stream.seekg(start);
+        stream.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    else
+    {
+        stream.clear();
+        data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    load_snapshot(data);
+}
+
 #ifdef _MSC_VER
 void workbook::save(const std::wstring &filename) const
 {
@@ -1104,6 +1243,11 @@ worksheet workbook::create_sheet_with_rel(const std::string &title, const relati
     auto sheet_id = d_->worksheets_.size() + 1;
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
 
+    if (d_->max_resident_cells_ != 0)
+    {
+        worksheet(&d_->worksheets_.back()).max_resident_cells(d_->max_resident_cells_);
+    }
+
     auto workbook_rel = d_->manifest_.relationship(path("/"), relationship_type::office_document);
     auto sheet_absoulute_path = workbook_rel.target().path().parent().append(rel.target().path());
     d_->manifest_.register_override_type(sheet_absoulute_path,
@@ -1176,8 +1320,11 @@ worksheet workbook::operator[](std::size_t index)
 
 void workbook::clear()
 {
+    // how many cells stay in memory applies to whatever is loaded next, so it is kept
+    const auto max_resident_cells = d_->max_resident_cells_;
     *d_ = detail::workbook_impl();
     d_->stylesheet_.clear();
+    d_->max_resident_cells_ = max_resident_cells;
 }
 
 bool workbook::operator==(const workbook &rhs) const
@@ -1190,6 +1337,91 @@ bool workbook::operator!=(const workbook &rhs) const
     return !operator==(rhs);
 }
 
+workbook_diff workbook::diff(const workbook &other, bool parallel) const
+{
+    workbook_diff result;
+
+    result.styles_changed = !detail::styles_equivalent(d_->stylesheet_, other.d_->stylesheet_);
+
+    // worksheets are fingerprinted from their cells in memory
+    for (auto &sheet : d_->worksheets_)
+    {
+        sheet.page_in_all();
+    }
+
+    for (auto &sheet : other.d_->worksheets_)
+    {
+        sheet.page_in_all();
+    }
+
+    auto lhs_titles = std::vector<std::string>();
+    auto rhs_titles = std::vector<std::string>();
+    auto matched = std::vector<std::pair<const detail::worksheet_impl *, const detail::worksheet_impl *>>();
+
+    for (const auto &lhs_sheet : d_->worksheets_)
+    {
+        lhs_titles.push_back(lhs_sheet.title_);
+        auto rhs_sheet = std::find_if(other.d_->worksheets_.begin(), other.d_->worksheets_.end(),
+            [&](const detail::worksheet_impl &ws) { return ws.title_ == lhs_sheet.title_; });
+
+        matched.emplace_back(&lhs_sheet, rhs_sheet == other.d_->worksheets_.end() ? nullptr : &*rhs_sheet);
+    }
+
+    // Sheets are distributed across threads so each one is diffed serially
+    auto sheet_diffs = std::vector<worksheet_diff>(matched.size());
+    const auto threads = parallel ? detail::parallel_block_count(matched.size(), 1) : std::size_t(1);
+
+    detail::parallel_for_blocks(matched.size(), threads, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; ++i)
+        {
+            if (matched[i].second == nullptr)
+            {
+                sheet_diffs[i].title = matched[i].first->title_;
+                sheet_diffs[i].removed = true;
+
+                continue;
+            }
+
+            sheet_diffs[i] = detail::diff_worksheets(*matched[i].first, *matched[i].second,
+                !result.styles_changed, parallel && threads == 1);
+        }
+    });
+
+    for (auto &sheet_diff : sheet_diffs)
+    {
+        if (!sheet_diff.empty())
+        {
+            result.worksheets.push_back(std::move(sheet_diff));
+        }
+    }
+
+    for (const auto &rhs_sheet : other.d_->worksheets_)
+    {
+        rhs_titles.push_back(rhs_sheet.title_);
+
+        if (std::find(lhs_titles.begin(), lhs_titles.end(), rhs_sheet.title_) == lhs_titles.end())
+        {
+            worksheet_diff added;
+            added.title = rhs_sheet.title_;
+            added.added = true;
+            result.worksheets.push_back(added);
+        }
+    }
+
+    result.properties_changed = lhs_titles != rhs_titles
+        || d_->sheet_hidden_ != other.d_->sheet_hidden_
+        || !(d_->base_date_ == other.d_->base_date_)
+        || !(d_->title_ == other.d_->title_)
+        || !(d_->core_properties_ == other.d_->core_properties_)
+        || !(d_->extended_properties_ == other.d_->extended_properties_)
+        || !(d_->custom_properties_ == other.d_->custom_properties_)
+        || !(d_->view_ == other.d_->view_)
+        || !(d_->code_name_ == other.d_->code_name_)
+        || !(d_->calculation_properties_ == other.d_->calculation_properties_);
+
+    return result;
+}
+
 void workbook::swap(workbook &right)
 {
     auto &left = *this;
@@ -1390,25 +1622,70 @@ const std::vector<rich_text> &workbook::shared_strings() const
 
 std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_duplicates)
 {
-    register_workbook_part(relationship_type::shared_string_table);
+    if (d_->shared_strings_values_.empty())
+    {
+        register_workbook_part(relationship_type::shared_string_table);
+    }
+
+    auto &values = d_->shared_strings_values_;
+    auto &ids = d_->shared_strings_ids_;
+
+    // strings loaded in bulk are only indexed once something needs to be looked up
+    if (d_->shared_strings_indexed_ > values.size())
+    {
+        ids.clear();
+        d_->shared_strings_indexed_ = 0;
+    }
+
+    for (auto &index = d_->shared_strings_indexed_; index < values.size(); ++index)
+    {
+        ids[values[index]] = index;
+    }
 
     if (!allow_duplicates)
     {
-        auto it = d_->shared_strings_ids_.find(shared);
+        auto it = ids.find(shared);
 
-        if (it != d_->shared_strings_ids_.end())
+        if (it != ids.end())
         {
             return it->second;
         }
     }
 
-    auto sz = d_->shared_strings_ids_.size();
-    d_->shared_strings_ids_[shared] = sz;
-    d_->shared_strings_values_.push_back(shared);
+    auto sz = values.size();
+    values.push_back(shared);
+    detail::rich_text_access::intern_fonts(values.back(), d_->font_pool_);
+    ids[values.back()] = sz;
+    d_->shared_strings_indexed_ = values.size();
 
     return sz;
 }
 
+void workbook::default_string_storage(string_storage storage)
+{
+    d_->default_string_storage_ = storage;
+}
+
+string_storage workbook::default_string_storage() const
+{
+    return d_->default_string_storage_;
+}
+
+void workbook::max_resident_cells(std::size_t count)
+{
+    d_->max_resident_cells_ = count;
+
+    for (auto ws : *this)
+    {
+        ws.max_resident_cells(count);
+    }
+}
+
+std::size_t workbook::max_resident_cells() const
+{
+    return d_->max_resident_cells_;
+}
+
 bool workbook::contains(const std::string &sheet_title) const
 {
     for (auto ws : *this)
@@ -1574,34 +1851,43 @@ void workbook::calculation_properties(const class calculation_properties &props)
     d_->calculation_properties_ = props;
 }
 
+bool workbook::has_formulae() const
+{
+    // every worksheet keeps a count of its formula cells so this doesn't need to scan them
+    for (const auto &ws : d_->worksheets_)
+    {
+        if (ws.formula_count_ > 0) return true;
+    }
+
+    return false;
+}
+
 void workbook::garbage_collect_formulae()
 {
-    auto any_with_formula = false;
+    if (!has_formulae())
+    {
+        remove_calculation_chain(manifest());
+    }
+}
 
-    for (auto ws : *this)
+void workbook::reconcile_manifest(class manifest &target) const
+{
+    if (!d_->shared_strings_values_.empty())
     {
-        for (auto row : ws.rows(true))
+        xlnt::register_workbook_part(target, relationship_type::shared_string_table);
+    }
+
+    for (const auto &ws : d_->worksheets_)
+    {
+        if (!ws.comments_.empty())
         {
-            for (auto cell : row)
-            {
-                if (cell.has_formula())
-                {
-                    any_with_formula = true;
-                }
-            }
+            xlnt::register_worksheet_part(target, d_->sheet_title_rel_id_map_.at(ws.title_), relationship_type::comments);
         }
     }
 
-    if (any_with_formula) return;
-
-    auto wb_rel = manifest().relationship(path("/"), relationship_type::office_document);
-
-    if (manifest().has_relationship(wb_rel.target().path(), relationship_type::calculation_chain))
+    if (!has_formulae())
     {
-        auto calc_chain_rel = manifest().relationship(wb_rel.target().path(), relationship_type::calculation_chain);
-        auto calc_chain_part = manifest().canonicalize({wb_rel, calc_chain_rel});
-        manifest().unregister_override_type(calc_chain_part);
-        manifest().unregister_relationship(wb_rel.target(), calc_chain_rel.id());
+        remove_calculation_chain(target);
     }
 }
 
@@ -0,0 +1,436 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+
+#include <xlnt/cell/rich_text.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/column_index.hpp>
+#include <detail/fingerprint.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+#include <detail/parallel.hpp>
+
+namespace {
+
+// Key cells that can't be indexed (booleans and errors) poison the row hash
+const std::uint64_t unindexable = ~std::uint64_t(0);
+const std::uint64_t empty_component = 0x9e3779b97f4a7c15ULL;
+
+std::uint64_t hash_number(double number)
+{
+    return xlnt::detail::mix_hash(xlnt::detail::hash_double(number) ^ 0x1ULL);
+}
+
+std::uint64_t hash_text(const std::string &text)
+{
+    return xlnt::detail::mix_hash(xlnt::detail::hash_bytes(text) ^ 0x2ULL);
+}
+
+std::uint64_t hash_key(const xlnt::index_key &key)
+{
+    if (key.is_number()) return hash_number(key.number());
+    if (key.is_text()) return hash_text(key.text());
+    return empty_component;
+}
+
+// Returns the hash component of a single key cell
+std::uint64_t hash_cell(const xlnt::detail::cell_impl &cell, const std::vector<xlnt::rich_text> &shared_strings)
+{
+    switch (cell.type_)
+    {
+    case xlnt::cell_type::empty:
+        return empty_component;
+    case xlnt::cell_type::number:
+    case xlnt::cell_type::date:
+        return hash_number(cell.value_numeric_);
+    case xlnt::cell_type::shared_string:
+        return hash_text(shared_strings.at(static_cast<std::size_t>(cell.value_numeric_)).plain_text());
+    case xlnt::cell_type::inline_string:
+    case xlnt::cell_type::formula_string:
+        return hash_text(cell.value_text_.plain_text());
+    case xlnt::cell_type::boolean:
+    case xlnt::cell_type::error:
+        return unindexable;
+    }
+
+    return unindexable;
+}
+
+// Combines the per-column components of a row into its key hash. 0 is reserved for rows that aren't
+// indexed, which includes rows whose key cells are all empty, so an all-empty key never matches.
+std::uint64_t combine(const std::uint64_t *components, std::size_t count)
+{
+    auto hash = std::uint64_t(0x243f6a8885a308d3ULL);
+    auto all_empty = true;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (components[i] == unindexable) return 0;
+        all_empty = all_empty && components[i] == empty_component;
+        hash = xlnt::detail::mix_hash(hash ^ components[i]) + i;
+    }
+
+    if (all_empty) return 0;
+
+    return hash == 0 ? 1 : hash;
+}
+
+// Blocks smaller than this aren't worth a thread of their own
+const std::size_t index_min_block_size = 65536;
+
+} // namespace
+
+namespace xlnt {
+
+index_key::index_key()
+    : type_(key_type::empty),
+      number_(0.0)
+{
+}
+
+index_key::index_key(double number)
+    : type_(key_type::number),
+      number_(number)
+{
+}
+
+index_key::index_key(int number)
+    : index_key(static_cast<double>(number))
+{
+}
+
+index_key::index_key(const std::string &text)
+    : type_(key_type::text),
+      number_(0.0),
+      text_(text)
+{
+}
+
+index_key::index_key(const char *text)
+    : index_key(std::string(text))
+{
+}
+
+bool index_key::is_empty() const
+{
+    return type_ == key_type::empty;
+}
+
+bool index_key::is_number() const
+{
+    return type_ == key_type::number;
+}
+
+bool index_key::is_text() const
+{
+    return type_ == key_type::text;
+}
+
+double index_key::number() const
+{
+    return number_;
+}
+
+const std::string &index_key::text() const
+{
+    return text_;
+}
+
+column_index::column_index(worksheet ws, column_t key_column, bool parallel)
+    : column_index(ws, std::vector<column_t>{key_column}, parallel)
+{
+}
+
+column_index::column_index(worksheet ws, const std::vector<column_t> &key_columns, bool parallel)
+    : ws_(ws),
+      key_columns_(key_columns),
+      size_(0)
+{
+    if (key_columns_.empty())
+    {
+        throw invalid_parameter();
+    }
+
+    rebuild(parallel);
+}
+
+const std::vector<column_t> &column_index::key_columns() const
+{
+    return key_columns_;
+}
+
+std::size_t column_index::size() const
+{
+    return size_;
+}
+
+void column_index::rebuild(bool parallel)
+{
+    ws_.d_->page_in_all();
+
+    const auto &cells = ws_.d_->cell_map_;
+    const auto &shared_strings = ws_.workbook().shared_strings();
+    const auto key_count = key_columns_.size();
+    const auto blocks = parallel ? detail::parallel_block_count(cells.size(), index_min_block_size) : std::size_t(1);
+
+    // Pass over the cell storage collecting the hash component of every key cell
+    struct component
+    {
+        row_t row;
+        std::size_t key;
+        std::uint64_t hash;
+    };
+
+    std::vector<std::vector<component>> found(blocks);
+    std::vector<row_t> highest_rows(blocks, 0);
+
+    detail::parallel_for_blocks(cells.bucket_count(), blocks, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for (auto bucket = first; bucket < last; ++bucket)
+        {
+            for (auto it = cells.begin(bucket); it != cells.end(bucket); ++it)
+            {
+                const auto column = it->first.column();
+
+                for (auto key = std::size_t(0); key < key_count; ++key)
+                {
+                    if (key_columns_[key] != column) continue;
+
+                    found[block].push_back({it->first.row(), key, hash_cell(it->second, shared_strings)});
+                    highest_rows[block] = std::max(highest_rows[block], it->first.row());
+                }
+            }
+        }
+    });
+
+    const auto highest_row = static_cast<std::size_t>(*std::max_element(highest_rows.begin(), highest_rows.end()));
+
+    // Lay out components by row so that rows can be combined independently
+    std::vector<std::uint64_t> components((highest_row + 1) * key_count, empty_component);
+
+    detail::parallel_for_blocks(blocks, blocks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto block = first; block < last; ++block)
+        {
+            for (const auto &c : found[block])
+            {
+                components[c.row * key_count + c.key] = c.hash;
+            }
+        }
+    });
+
+    found.clear();
+    row_hashes_.assign(highest_row + 1, 0);
+
+    detail::parallel_for_blocks(highest_row + 1, blocks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto row = std::max(first, std::size_t(1)); row < last; ++row)
+        {
+            row_hashes_[row] = combine(&components[row * key_count], key_count);
+        }
+    });
+
+    components.clear();
+
+    // Each thread fills the shard it owns so that no two threads insert into the same map
+    shards_.assign(blocks, std::unordered_multimap<std::uint64_t, row_t>());
+    std::vector<std::size_t> shard_sizes(blocks, 0);
+
+    detail::parallel_for_blocks(blocks, blocks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto shard = first; shard < last; ++shard)
+        {
+            for (auto row = std::size_t(1); row < row_hashes_.size(); ++row)
+            {
+                const auto hash = row_hashes_[row];
+
+                if (hash != 0 && hash % shards_.size() == shard)
+                {
+                    shards_[shard].emplace(hash, static_cast<row_t>(row));
+                    ++shard_sizes[shard];
+                }
+            }
+        }
+    });
+
+    size_ = 0;
+
+    for (auto shard_size : shard_sizes)
+    {
+        size_ += shard_size;
+    }
+}
+
+const std::unordered_multimap<std::uint64_t, row_t> &column_index::shard(std::uint64_t hash) const
+{
+    return shards_[hash % shards_.size()];
+}
+
+std::uint64_t column_index::row_hash(row_t row) const
+{
+    ws_.d_->page_in(row, row, false);
+
+    const auto &cells = ws_.d_->cell_map_;
+    const auto &shared_strings = ws_.workbook().shared_strings();
+    std::vector<std::uint64_t> components(key_columns_.size(), empty_component);
+
+    for (auto key = std::size_t(0); key < key_columns_.size(); ++key)
+    {
+        auto match = cells.find(cell_reference(key_columns_[key], row));
+
+        if (match != cells.end())
+        {
+            components[key] = hash_cell(match->second, shared_strings);
+        }
+    }
+
+    return combine(components.data(), components.size());
+}
+
+void column_index::update(row_t row)
+{
+    const auto new_hash = row_hash(row);
+
+    if (row >= row_hashes_.size())
+    {
+        row_hashes_.resize(static_cast<std::size_t>(row) + 1, 0);
+    }
+
+    const auto old_hash = row_hashes_[row];
+    if (old_hash == new_hash) return;
+
+    if (old_hash != 0)
+    {
+        auto &old_shard = shards_[old_hash % shards_.size()];
+        auto candidates = old_shard.equal_range(old_hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second == row)
+            {
+                old_shard.erase(it);
+                --size_;
+                break;
+            }
+        }
+    }
+
+    if (new_hash != 0)
+    {
+        shards_[new_hash % shards_.size()].emplace(new_hash, row);
+        ++size_;
+    }
+
+    row_hashes_[row] = new_hash;
+}
+
+bool column_index::matches(row_t row, const std::vector<index_key> &keys) const
+{
+    ws_.d_->page_in(row, row, false);
+
+    const auto &cells = ws_.d_->cell_map_;
+    const auto &shared_strings = ws_.workbook().shared_strings();
+
+    for (auto key = std::size_t(0); key < keys.size(); ++key)
+    {
+        auto match = cells.find(cell_reference(key_columns_[key], row));
+        const auto type = match == cells.end() ? cell_type::empty : match->second.type_;
+
+        switch (type)
+        {
+        case cell_type::empty:
+            if (!keys[key].is_empty()) return false;
+            break;
+        case cell_type::number:
+        case cell_type::date:
+            if (!keys[key].is_number() || keys[key].number() != match->second.value_numeric_) return false;
+            break;
+        case cell_type::shared_string:
+            if (!keys[key].is_text()
+                || shared_strings.at(static_cast<std::size_t>(match->second.value_numeric_)).plain_text() != keys[key].text())
+            {
+                return false;
+            }
+            break;
+        case cell_type::inline_string:
+        case cell_type::formula_string:
+            if (!keys[key].is_text() || match->second.value_text_.plain_text() != keys[key].text()) return false;
+            break;
+        case cell_type::boolean:
+        case cell_type::error:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<row_t> column_index::find(const index_key &key) const
+{
+    if (key_columns_.size() != 1)
+    {
+        throw invalid_parameter();
+    }
+
+    return find(std::vector<index_key>{key});
+}
+
+std::vector<row_t> column_index::find(const std::vector<index_key> &keys) const
+{
+    if (keys.size() != key_columns_.size())
+    {
+        throw invalid_parameter();
+    }
+
+    std::vector<std::uint64_t> components;
+    components.reserve(keys.size());
+
+    for (const auto &key : keys)
+    {
+        components.push_back(hash_key(key));
+    }
+
+    std::vector<row_t> rows;
+    const auto hash = combine(components.data(), components.size());
+    if (hash == 0) return rows;
+
+    auto candidates = shard(hash).equal_range(hash);
+
+    for (auto it = candidates.first; it != candidates.second; ++it)
+    {
+        // Hashes can collide so the cells are compared to confirm a match
+        if (matches(it->second, keys))
+        {
+            rows.push_back(it->second);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end());
+
+    return rows;
+}
+
+bool column_index::contains(const index_key &key) const
+{
+    return !find(key).empty();
+}
+
+} // namespace xlnt
@@ -21,13 +21,399 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/style.hpp>
+#include <xlnt/utils/datetime.hpp>
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/range.hpp>
 #include <xlnt/worksheet/range_iterator.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
+#include <detail/font_metrics.hpp>
+#include <detail/implementations/rich_text_access.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+#include <detail/number_format/number_formatter.hpp>
+#include <detail/parallel.hpp>
+
+namespace {
+
+// Blocks smaller than this aren't worth a thread of their own
+const std::size_t statistics_min_block_size = 65536;
+
+struct numeric_summary
+{
+    std::size_t count = 0;
+    double sum = 0.0;
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+};
+
+// Reduces a contiguous buffer of values using four independent lanes so that
+// the loop body has no dependency between iterations and can be vectorised.
+numeric_summary summarise(const double *values, std::size_t count)
+{
+    const auto inf = std::numeric_limits<double>::infinity();
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    double minimum[4] = {inf, inf, inf, inf};
+    double maximum[4] = {-inf, -inf, -inf, -inf};
+
+    const auto unrolled = count - count % 4;
+    std::size_t i = 0;
+
+    for (; i < unrolled; i += 4)
+    {
+        for (std::size_t lane = 0; lane < 4; ++lane)
+        {
+            const auto value = values[i + lane];
+            sum[lane] += value;
+            minimum[lane] = value < minimum[lane] ? value : minimum[lane];
+            maximum[lane] = value > maximum[lane] ? value : maximum[lane];
+        }
+    }
+
+    for (; i < count; ++i)
+    {
+        sum[0] += values[i];
+        minimum[0] = values[i] < minimum[0] ? values[i] : minimum[0];
+        maximum[0] = values[i] > maximum[0] ? values[i] : maximum[0];
+    }
+
+    numeric_summary result;
+    result.count = count;
+    result.sum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    result.minimum = std::min(std::min(minimum[0], minimum[1]), std::min(minimum[2], minimum[3]));
+    result.maximum = std::max(std::max(maximum[0], maximum[1]), std::max(maximum[2], maximum[3]));
+
+    return result;
+}
+
+// Numeric values and the number of non-empty cells gathered from one block of cell storage
+struct gathered_block
+{
+    std::vector<double> values;
+    std::size_t value_count = 0;
+};
+
+void gather(const xlnt::detail::cell_impl &cell, gathered_block &block)
+{
+    if (cell.type_ == xlnt::cell_type::empty) return;
+
+    ++block.value_count;
+
+    if (cell.type_ == xlnt::cell_type::number)
+    {
+        block.values.push_back(cell.value_numeric_);
+    }
+}
+
+// Returns true if the width of numbers rendered with format_string never decreases
+// as their magnitude grows, as long as their sign stays the same. This holds for
+// formats made only of digit placeholders, separators and literals with a fixed
+// number of decimals. Dates, fractions, exponents and conditions are excluded.
+bool has_monotonic_width(const std::string &format_string)
+{
+    auto after_decimal = false;
+
+    for (auto i = std::size_t(0); i < format_string.size(); ++i)
+    {
+        const auto c = format_string[i];
+
+        switch (c)
+        {
+        case '"':
+            i = format_string.find('"', i + 1);
+            if (i == std::string::npos) return false;
+            break;
+        case '\\':
+        case '_':
+        case '*':
+            ++i;
+            break;
+        case '[':
+        {
+            // colors are fine, conditions, locales and elapsed times aren't
+            const auto end = format_string.find(']', i);
+            if (end == std::string::npos) return false;
+            const auto content = format_string.substr(i + 1, end - i - 1);
+            if (content.empty() || !std::all_of(content.begin(), content.end(), [](char x) {
+                    return std::isalnum(static_cast<unsigned char>(x)) != 0; })
+                || std::all_of(content.begin(), content.end(), [](char x) {
+                    return x == 'h' || x == 'H' || x == 'm' || x == 'M' || x == 's' || x == 'S'; }))
+            {
+                return false;
+            }
+            i = end;
+            break;
+        }
+        case ';':
+            after_decimal = false;
+            break;
+        case '.':
+            after_decimal = true;
+            break;
+        case '#':
+        case '?':
+            if (after_decimal) return false;
+            break;
+        case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+        case ',': case '%': case ' ': case '-': case '+': case '(': case ')': case ':': case '$':
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// A number format compiled once per block of cells
+struct compiled_format
+{
+    compiled_format(const std::string &format_string, xlnt::calendar calendar)
+        : formatter(format_string, calendar),
+          general(format_string.empty() || format_string == "General"),
+          monotonic(!general && has_monotonic_width(format_string))
+    {
+    }
+
+    xlnt::detail::number_formatter formatter;
+    bool general;
+    bool monotonic;
+};
+
+// The largest magnitude of each sign among numbers sharing a column, format and font.
+// Only these are rendered since the other numbers can't be any wider.
+struct deferred_numbers
+{
+    std::size_t column;
+    compiled_format *format;
+    const xlnt::detail::font_metrics *metrics;
+    double largest[3];
+    bool seen[3];
+};
+
+// Widest displayed value of each column gathered from one block of cell storage.
+// Compiled number formats and metrics of run fonts are cached per block so that
+// threads never share mutable state.
+struct fitted_block
+{
+    std::vector<double> widths;
+    std::vector<deferred_numbers> deferred;
+    std::vector<std::size_t> last_deferred;
+    std::unordered_map<std::string, std::unique_ptr<compiled_format>> formats;
+    std::unordered_map<std::size_t, compiled_format *> formats_by_id;
+    std::unordered_map<const xlnt::font *, xlnt::detail::font_metrics> run_metrics;
+};
+
+// Values of a sort key are ordered by type first, empty cells always sort last
+enum class sort_class : std::uint8_t
+{
+    number,
+    text,
+    boolean,
+    error,
+    empty
+};
+
+// The comparable value of one key cell. Text is replaced by its rank among all
+// distinct strings of the key so that sorting only compares numbers.
+struct sort_value
+{
+    sort_class type = sort_class::empty;
+    double number = 0.0;
+    const xlnt::rich_text *text = nullptr;
+};
+
+// Parses "YYYY-MM-DD" optionally followed by "THH:MM" or "THH:MM:SS"
+bool parse_iso_datetime(const std::string &s, xlnt::datetime &result)
+{
+    auto digits = [&s](std::size_t offset, std::size_t count, int &value) {
+        if (offset + count > s.size()) return false;
+        value = 0;
+        for (auto i = offset; i < offset + count; ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(s[i]))) return false;
+            value = value * 10 + (s[i] - '0');
+        }
+        return true;
+    };
+
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+
+    if (!digits(0, 4, year) || s.size() < 10 || s[4] != '-' || !digits(5, 2, month)
+        || s[7] != '-' || !digits(8, 2, day) || month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return false;
+    }
+
+    if (s.size() > 10)
+    {
+        if (s[10] != 'T' || s.size() < 16 || !digits(11, 2, hour) || s[13] != ':' || !digits(14, 2, minute))
+        {
+            return false;
+        }
+
+        if (s.size() > 16 && (s[16] != ':' || !digits(17, 2, second)))
+        {
+            return false;
+        }
+    }
+
+    result = xlnt::datetime(year, month, day, hour, minute, second);
+    return true;
+}
+
+std::string fold_case(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    return s;
+}
+
+// Replaces the text pointers of values with ranks. Cells sharing a string
+// point to the same shared string so each distinct string is only compared
+// once no matter how often it is used.
+void rank_text(std::vector<sort_value> &values, xlnt::sort_rule rule)
+{
+    std::vector<const xlnt::rich_text *> distinct;
+
+    for (const auto &value : values)
+    {
+        if (value.type == sort_class::text || value.type == sort_class::error)
+        {
+            distinct.push_back(value.text);
+        }
+    }
+
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    std::vector<std::pair<std::string, const xlnt::rich_text *>> keyed;
+    keyed.reserve(distinct.size());
+
+    for (auto text : distinct)
+    {
+        auto plain = text->plain_text();
+        keyed.emplace_back(rule == xlnt::sort_rule::case_sensitive ? plain : fold_case(plain), text);
+    }
+
+    std::sort(keyed.begin(), keyed.end());
+
+    std::unordered_map<const xlnt::rich_text *, double> ranks;
+    auto rank = 0.0;
+
+    for (auto i = std::size_t(0); i < keyed.size(); ++i)
+    {
+        if (i > 0 && keyed[i].first != keyed[i - 1].first) ++rank;
+        ranks[keyed[i].second] = rank;
+    }
+
+    for (auto &value : values)
+    {
+        if (value.type == sort_class::text || value.type == sort_class::error)
+        {
+            value.number = ranks.at(value.text);
+        }
+    }
+}
+
+// Moves the cells of range in a paged worksheet from row first_row + i to row
+// destination[i]. The cells are first moved, a block at a time, to a scratch worksheet
+// which pages out to a file of its own. The rows of the range are then filled again a
+// chunk at a time, scanning the scratch worksheet once per chunk, so that no more than
+// about the limit of cells needs to be resident at once.
+void move_paged_rows(xlnt::detail::worksheet_impl &ws, const xlnt::range_reference &range,
+    const std::vector<xlnt::row_t> &destination)
+{
+    using xlnt::cell_reference;
+    using xlnt::row_t;
+
+    const auto first_row = range.top_left().row();
+    const auto last_row = range.bottom_right().row();
+    const auto first_column = range.top_left().column_index();
+    const auto last_column = range.bottom_right().column_index();
+    const auto limit = ws.pager_->max_resident_cells();
+
+    auto contained = [&](const xlnt::detail::cell_impl &impl) {
+        return impl.row_ >= first_row && impl.row_ <= last_row
+            && impl.column_ >= first_column && impl.column_ <= last_column;
+    };
+
+    xlnt::detail::worksheet_impl scratch(ws.parent_, 0, std::string());
+    scratch.pager_.reset(new xlnt::detail::cell_pager(limit));
+    std::unordered_map<cell_reference, xlnt::comment> moved_comments;
+
+    ws.pager_->for_each_block(ws, [&](const std::vector<cell_reference> &references) {
+        for (const auto &reference : references)
+        {
+            auto match = ws.cell_map_.find(reference);
+            if (match == ws.cell_map_.end() || !contained(match->second)) continue;
+
+            if (match->second.comment_.is_set())
+            {
+                auto comment = ws.comments_.find(reference.to_string());
+                moved_comments.emplace(reference, comment->second);
+                ws.comments_.erase(comment);
+                match->second.comment_.clear();
+            }
+
+            scratch.cell_map_.emplace(reference, std::move(match->second));
+            ws.cell_map_.erase(match);
+            scratch.pager_->added(scratch, reference);
+        }
+    }, first_row, last_row);
+
+    const auto moved_count = scratch.cell_count();
+    if (moved_count == 0) return;
+
+    const auto height = static_cast<std::size_t>(last_row - first_row + 1);
+    const auto cells_per_row = std::max(std::size_t(1), moved_count / height);
+    const auto rows_per_chunk = std::max(std::size_t(xlnt::detail::cell_pager::rows_per_block),
+        limit / 2 / cells_per_row);
+
+    for (auto chunk = std::size_t(0); chunk < height; chunk += rows_per_chunk)
+    {
+        const auto chunk_first = first_row + static_cast<row_t>(chunk);
+        const auto chunk_last = first_row + static_cast<row_t>(std::min(height, chunk + rows_per_chunk) - 1);
+        ws.page_in(chunk_first, chunk_last);
+
+        scratch.for_each_cell([&](const xlnt::detail::cell_impl &moved) {
+            const auto row = destination[moved.row_ - first_row];
+            if (row < chunk_first || row > chunk_last) return;
+
+            const auto source = cell_reference(moved.column_, moved.row_);
+            const auto target = cell_reference(moved.column_, row);
+            auto &impl = ws.cell_map_.emplace(target, moved).first->second;
+            impl.parent_ = &ws;
+            impl.row_ = row;
+            ws.pager_->record(target);
+
+            auto comment = moved_comments.find(source);
+
+            if (comment != moved_comments.end())
+            {
+                auto &placed = ws.comments_[target.to_string()];
+                placed = comment->second;
+                impl.comment_.set(&placed);
+            }
+        });
+    }
+}
+
+} // namespace
 
 namespace xlnt {
 
@@ -192,6 +578,664 @@ conditional_format range::conditional_format(const condition &when)
     return ws_.conditional_format(ref_, when);
 }
 
+range_statistics range::statistics(bool parallel) const
+{
+    const auto &cells = ws_.d_->cell_map_;
+    const auto first_row = ref_.top_left().row();
+    const auto last_row = ref_.bottom_right().row();
+    const auto first_column = ref_.top_left().column_index();
+    const auto last_column = ref_.bottom_right().column_index();
+    const auto height = ref_.height();
+    const auto width = ref_.width();
+
+    // Probe the range cell by cell when it is smaller than the sheet, otherwise
+    // walk the storage once, splitting the work by rows or by hash buckets.
+    const auto probe = height * width <= cells.size();
+    const auto units = probe ? height : cells.bucket_count();
+    const auto blocks = parallel
+        ? detail::parallel_block_count(probe ? height * width : cells.size(), statistics_min_block_size)
+        : std::size_t(1);
+
+    std::vector<gathered_block> gathered(std::max(std::size_t(1), std::min(blocks, units)));
+
+    auto gather_units = [&](std::size_t block, std::size_t first, std::size_t last) {
+        auto &result = gathered[block];
+
+        if (probe)
+        {
+            result.values.reserve((last - first) * width);
+
+            for (auto row = first_row + static_cast<row_t>(first); row < first_row + static_cast<row_t>(last); ++row)
+            {
+                for (auto column = first_column; column <= last_column; ++column)
+                {
+                    auto match = cells.find(cell_reference(column, row));
+
+                    if (match != cells.end())
+                    {
+                        gather(match->second, result);
+                    }
+                }
+            }
+        }
+        else
+        {
+            auto gather_if_contained = [&](const std::pair<const cell_reference, detail::cell_impl> &entry) {
+                const auto &ref = entry.first;
+
+                if (ref.row() >= first_row && ref.row() <= last_row
+                    && ref.column_index() >= first_column && ref.column_index() <= last_column)
+                {
+                    gather(entry.second, result);
+                }
+            };
+
+            // Following the node list is cheaper than visiting every bucket in turn
+            if (gathered.size() == 1)
+            {
+                std::for_each(cells.begin(), cells.end(), gather_if_contained);
+                return;
+            }
+
+            for (auto bucket = first; bucket < last; ++bucket)
+            {
+                std::for_each(cells.begin(bucket), cells.end(bucket), gather_if_contained);
+            }
+        }
+    };
+
+    if (ws_.d_->pager_)
+    {
+        // Paged out cells are read from the file rather than paged in, so the limit is kept
+        gathered.resize(1);
+        ws_.d_->for_each_cell(first_row, last_row, [&](const detail::cell_impl &cell) {
+            if (cell.column_ >= first_column && cell.column_ <= last_column)
+            {
+                gather(cell, gathered.front());
+            }
+        });
+    }
+    else
+    {
+        detail::parallel_for_blocks(units, gathered.size(), gather_units);
+    }
+
+    range_statistics result;
+    auto summary = numeric_summary();
+    auto total_values = std::size_t(0);
+
+    for (const auto &block : gathered)
+    {
+        const auto partial = summarise(block.values.data(), block.values.size());
+
+        summary.count += partial.count;
+        summary.sum += partial.sum;
+        summary.minimum = std::min(summary.minimum, partial.minimum);
+        summary.maximum = std::max(summary.maximum, partial.maximum);
+        result.value_count += block.value_count;
+        total_values += block.values.size();
+    }
+
+    result.count = summary.count;
+    result.sum = summary.sum;
+
+    if (summary.count == 0)
+    {
+        return result;
+    }
+
+    result.minimum = summary.minimum;
+    result.maximum = summary.maximum;
+
+    // Distinct values are counted by sorting one contiguous buffer of all values
+    auto &all_values = gathered.front().values;
+    all_values.reserve(total_values);
+
+    for (auto block = std::size_t(1); block < gathered.size(); ++block)
+    {
+        all_values.insert(all_values.end(), gathered[block].values.begin(), gathered[block].values.end());
+    }
+
+    // NaN compares unequal to everything so it would break the ordering std::sort
+    // relies on. All NaN values are moved out first and counted as one value.
+    const auto numbers_end = std::partition(all_values.begin(), all_values.end(),
+        [](double value) { return !std::isnan(value); });
+    const auto has_nan = numbers_end != all_values.end();
+
+    std::sort(all_values.begin(), numbers_end);
+    result.distinct_count = static_cast<std::size_t>(std::distance(all_values.begin(),
+        std::unique(all_values.begin(), numbers_end)));
+    result.distinct_count += has_nan ? 1 : 0;
+
+    return result;
+}
+
+void range::sort(const std::vector<sort_key> &keys, bool parallel)
+{
+    const auto first_row = ref_.top_left().row();
+    const auto first_column = ref_.top_left().column_index();
+    const auto last_column = ref_.bottom_right().column_index();
+    const auto height = ref_.height();
+
+    for (const auto &key : keys)
+    {
+        if (key.column < first_column || key.column > last_column)
+        {
+            throw invalid_parameter();
+        }
+    }
+
+    for (const auto &merged : ws_.d_->merged_cells_)
+    {
+        if (merged.top_left().column_index() <= last_column && merged.bottom_right().column_index() >= first_column
+            && merged.top_left().row() <= ref_.bottom_right().row() && merged.bottom_right().row() >= first_row)
+        {
+            throw invalid_parameter();
+        }
+    }
+
+    if (keys.empty() || height < 2) return;
+
+    auto &cells = ws_.d_->cell_map_;
+    const auto last_row = ref_.bottom_right().row();
+    const auto &shared_strings = ws_.workbook().shared_strings();
+    const auto base_date = ws_.workbook().base_date();
+    const auto blocks = parallel ? detail::parallel_block_count(height * keys.size(), 16384) : std::size_t(1);
+
+    // Extract the comparable value of every key cell, one vector per key
+    std::vector<std::vector<sort_value>> key_values(keys.size(), std::vector<sort_value>(height));
+
+    auto extract = [&](const detail::cell_impl &impl, const sort_key &key, sort_value &value) {
+        switch (impl.type_)
+        {
+        case cell_type::number:
+        case cell_type::date:
+            value.type = sort_class::number;
+            value.number = impl.value_numeric_;
+            break;
+        case cell_type::boolean:
+            value.type = sort_class::boolean;
+            value.number = impl.value_numeric_;
+            break;
+        case cell_type::error:
+            value.type = sort_class::error;
+            value.text = &impl.value_text_;
+            break;
+        case cell_type::shared_string:
+            value.type = sort_class::text;
+            value.text = &shared_strings.at(static_cast<std::size_t>(impl.value_numeric_));
+            break;
+        case cell_type::inline_string:
+        case cell_type::formula_string:
+            value.type = sort_class::text;
+            value.text = &impl.value_text_;
+            break;
+        case cell_type::empty:
+            break;
+        }
+
+        xlnt::datetime parsed(1900, 1, 1);
+
+        if (value.type == sort_class::text && key.rule == sort_rule::dates
+            && parse_iso_datetime(value.text->plain_text(), parsed))
+        {
+            value.type = sort_class::number;
+            value.number = parsed.to_number(base_date);
+        }
+    };
+
+    // Text of paged out cells is copied since the cells passed to extract are temporary
+    std::deque<rich_text> paged_text;
+
+    if (ws_.d_->pager_)
+    {
+        ws_.d_->for_each_cell(first_row, last_row, [&](const detail::cell_impl &impl) {
+            for (auto k = std::size_t(0); k < keys.size(); ++k)
+            {
+                if (impl.column_ != keys[k].column) continue;
+
+                auto &value = key_values[k][impl.row_ - first_row];
+                extract(impl, keys[k], value);
+
+                if (value.text == &impl.value_text_)
+                {
+                    paged_text.push_back(impl.value_text_);
+                    value.text = &paged_text.back();
+                }
+            }
+        });
+    }
+    else
+    {
+        detail::parallel_for_blocks(height, blocks, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (auto k = std::size_t(0); k < keys.size(); ++k)
+            {
+                for (auto i = first; i < last; ++i)
+                {
+                    auto match = cells.find(cell_reference(keys[k].column, first_row + static_cast<row_t>(i)));
+
+                    if (match != cells.end())
+                    {
+                        extract(match->second, keys[k], key_values[k][i]);
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto k = std::size_t(0); k < keys.size(); ++k)
+    {
+        rank_text(key_values[k], keys[k].rule);
+    }
+
+    auto less = [&](std::uint32_t a, std::uint32_t b) {
+        for (auto k = std::size_t(0); k < keys.size(); ++k)
+        {
+            const auto &lhs = key_values[k][a];
+            const auto &rhs = key_values[k][b];
+
+            if (lhs.type != rhs.type)
+            {
+                // Empty cells are last in either direction
+                if (lhs.type == sort_class::empty || rhs.type == sort_class::empty)
+                {
+                    return rhs.type == sort_class::empty;
+                }
+
+                return (lhs.type < rhs.type) == (keys[k].direction == sort_direction::ascending);
+            }
+
+            if (lhs.number != rhs.number)
+            {
+                // NaN compares unequal to itself, so it is ordered after the other numbers in
+                // either direction and NaN values are equal to each other
+                const auto lhs_nan = std::isnan(lhs.number);
+                const auto rhs_nan = std::isnan(rhs.number);
+
+                if (lhs_nan || rhs_nan)
+                {
+                    if (lhs_nan == rhs_nan) continue;
+                    return rhs_nan;
+                }
+
+                return (lhs.number < rhs.number) == (keys[k].direction == sort_direction::ascending);
+            }
+        }
+
+        return false;
+    };
+
+    // Stable sort of row indices: sort blocks independently then merge them pairwise
+    std::vector<std::uint32_t> permutation(height);
+    std::iota(permutation.begin(), permutation.end(), std::uint32_t(0));
+
+    const auto sort_blocks = std::max(std::size_t(1), std::min(blocks, height));
+    const auto block_size = (height + sort_blocks - 1) / sort_blocks;
+
+    detail::parallel_for_blocks(height, sort_blocks, [&](std::size_t, std::size_t first, std::size_t last) {
+        std::stable_sort(permutation.begin() + static_cast<std::ptrdiff_t>(first),
+            permutation.begin() + static_cast<std::ptrdiff_t>(last), less);
+    });
+
+    for (auto width = block_size; width < height; width *= 2)
+    {
+        for (auto first = std::size_t(0); first + width < height; first += 2 * width)
+        {
+            auto middle = permutation.begin() + static_cast<std::ptrdiff_t>(first + width);
+            auto last = permutation.begin() + static_cast<std::ptrdiff_t>(std::min(height, first + 2 * width));
+            std::inplace_merge(permutation.begin() + static_cast<std::ptrdiff_t>(first), middle, last, less);
+        }
+    }
+
+    // Move every cell of the range to its new row in one pass. All cells are taken
+    // out of storage before any is put back so that no row is overwritten early.
+    std::vector<row_t> destination(height);
+
+    for (auto i = std::size_t(0); i < height; ++i)
+    {
+        destination[permutation[i]] = first_row + static_cast<row_t>(i);
+    }
+
+    if (ws_.d_->pager_)
+    {
+        move_paged_rows(*ws_.d_, ref_, destination);
+        return;
+    }
+
+    struct moved_cell
+    {
+        cell_reference source;
+        detail::cell_impl impl;
+        optional<xlnt::comment> comment;
+    };
+
+    std::vector<moved_cell> moved;
+    auto &comments = ws_.d_->comments_;
+
+    for (auto i = std::size_t(0); i < height; ++i)
+    {
+        if (destination[i] == first_row + static_cast<row_t>(i)) continue;
+
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            auto source = cell_reference(column, first_row + static_cast<row_t>(i));
+            auto match = cells.find(source);
+            if (match == cells.end()) continue;
+
+            moved.push_back({source, std::move(match->second), optional<xlnt::comment>()});
+            cells.erase(match);
+
+            if (moved.back().impl.comment_.is_set())
+            {
+                auto comment = comments.find(source.to_string());
+                moved.back().comment = comment->second;
+                comments.erase(comment);
+            }
+        }
+    }
+
+    for (auto &cell : moved)
+    {
+        const auto row = destination[cell.source.row() - first_row];
+        auto target = cell_reference(cell.source.column(), row);
+
+        cell.impl.row_ = row;
+        auto &impl = cells.emplace(target, std::move(cell.impl)).first->second;
+
+        if (cell.comment.is_set())
+        {
+            auto &comment = comments[target.to_string()];
+            comment = cell.comment.get();
+            impl.comment_.set(&comment);
+        }
+    }
+}
+
+void range::auto_fit_columns(bool parallel)
+{
+    const auto &cells = ws_.d_->cell_map_;
+    const auto &workbook = *ws_.d_->parent_->d_;
+    const auto first_row = ref_.top_left().row();
+    const auto last_row = ref_.bottom_right().row();
+    const auto first_column = ref_.top_left().column_index();
+    const auto last_column = ref_.bottom_right().column_index();
+    const auto height = ref_.height();
+    const auto width = ref_.width();
+    const auto calendar = ws_.workbook().base_date();
+
+    const auto empty_stylesheet = detail::stylesheet();
+    const auto &stylesheet = workbook.stylesheet_.is_set() ? workbook.stylesheet_.get() : empty_stylesheet;
+
+    // The first font is the one of the Normal style which defines the unit of column widths
+    auto default_font = stylesheet.fonts.empty() ? xlnt::font().name("Calibri").size(11) : stylesheet.fonts.front();
+    const auto default_metrics = detail::font_metrics(default_font, default_font);
+    const auto padding = detail::font_metrics::column_padding(default_font);
+
+    std::vector<detail::font_metrics> font_metrics;
+    font_metrics.reserve(stylesheet.fonts.size());
+
+    for (const auto &f : stylesheet.fonts)
+    {
+        font_metrics.emplace_back(f, default_font);
+    }
+
+    // Formats are compiled once per distinct format string since cells often get their
+    // own copy of a custom format with a new id
+    std::unordered_map<std::size_t, std::string> custom_formats;
+
+    for (const auto &nf : stylesheet.number_formats)
+    {
+        if (nf.has_id())
+        {
+            custom_formats.emplace(nf.id(), nf.format_string());
+        }
+    }
+
+    auto compiled = [&](fitted_block &block, std::size_t id) -> compiled_format & {
+        auto &by_id = block.formats_by_id[id];
+
+        if (by_id == nullptr)
+        {
+            auto format_string = std::string("General");
+            auto custom = custom_formats.find(id);
+
+            if (custom != custom_formats.end())
+            {
+                format_string = custom->second;
+            }
+            else if (number_format::is_builtin_format(id))
+            {
+                format_string = number_format::from_builtin_id(id).format_string();
+            }
+
+            auto &format = block.formats[format_string];
+
+            if (!format)
+            {
+                format.reset(new compiled_format(format_string, calendar));
+            }
+
+            by_id = format.get();
+        }
+
+        return *by_id;
+    };
+
+    // Numbers whose width only depends on their magnitude are collected and rendered
+    // once per block, everything else is rendered as it is found
+    auto measure_number = [&](fitted_block &block, std::size_t column, compiled_format &format,
+                              const detail::font_metrics &metrics, double number) {
+        const auto magnitude = std::fabs(number);
+
+        if (!format.monotonic && !(format.general && magnitude < 1E11 && std::floor(magnitude) == magnitude))
+        {
+            return metrics.text_width(format.formatter.format_number(number));
+        }
+
+        auto slot = block.last_deferred[column];
+
+        if (slot == 0 || block.deferred[slot - 1].format != &format || block.deferred[slot - 1].metrics != &metrics)
+        {
+            auto match = std::find_if(block.deferred.begin(), block.deferred.end(), [&](const deferred_numbers &d) {
+                return d.column == column && d.format == &format && d.metrics == &metrics;
+            });
+
+            if (match == block.deferred.end())
+            {
+                block.deferred.push_back(deferred_numbers{column, &format, &metrics, {0, 0, 0}, {false, false, false}});
+                match = block.deferred.end() - 1;
+            }
+
+            slot = static_cast<std::size_t>(match - block.deferred.begin()) + 1;
+            block.last_deferred[column] = slot;
+        }
+
+        auto &deferred = block.deferred[slot - 1];
+        const auto sign = number < 0 ? 0 : (number == 0 ? 1 : 2);
+        deferred.largest[sign] = std::max(deferred.largest[sign], magnitude);
+        deferred.seen[sign] = true;
+
+        return 0.0;
+    };
+
+    auto measure = [&](const detail::cell_impl &cell, fitted_block &block) {
+        if (cell.type_ == cell_type::empty || cell.is_merged_) return;
+
+        const auto format = cell.format_.is_set() ? cell.format_.get() : nullptr;
+
+        if (format != nullptr && format->alignment_id.is_set()
+            && format->alignment_id.get() < stylesheet.alignments.size()
+            && stylesheet.alignments[format->alignment_id.get()].wrap())
+        {
+            return;
+        }
+
+        const auto &metrics = format != nullptr && format->font_id.is_set()
+                && format->font_id.get() < font_metrics.size()
+            ? font_metrics[format->font_id.get()]
+            : default_metrics;
+
+        auto text_width = 0.0;
+
+        switch (cell.type_)
+        {
+        case cell_type::number:
+        case cell_type::date:
+        {
+            const auto id = format != nullptr && format->number_format_id.is_set()
+                ? format->number_format_id.get()
+                : std::size_t(0);
+            text_width = measure_number(block, cell.column_.index - first_column, compiled(block, id), metrics,
+                cell.value_numeric_);
+            break;
+        }
+        case cell_type::boolean:
+            text_width = metrics.text_width(cell.value_numeric_ != 0.0 ? "TRUE" : "FALSE");
+            break;
+        default:
+        {
+            const auto &text = cell.type_ == cell_type::shared_string
+                ? workbook.shared_strings_values_.at(static_cast<std::size_t>(cell.value_numeric_))
+                : cell.value_text_;
+
+            xlnt::detail::rich_text_access::for_each_run(text, [&](const std::string &run_text, const xlnt::font *run_font, bool) {
+                if (run_font == nullptr)
+                {
+                    text_width += metrics.text_width(run_text);
+                    return;
+                }
+
+                auto cached = block.run_metrics.find(run_font);
+
+                if (cached == block.run_metrics.end())
+                {
+                    cached = block.run_metrics.emplace(run_font, detail::font_metrics(*run_font, default_font)).first;
+                }
+
+                text_width += cached->second.text_width(run_text);
+            });
+            break;
+        }
+        }
+
+        auto &widest = block.widths[cell.column_.index - first_column];
+        widest = std::max(widest, text_width);
+    };
+
+    // Cells are visited the same way as in statistics()
+    const auto probe = height * width <= cells.size();
+    const auto units = probe ? height : cells.bucket_count();
+    const auto blocks = parallel
+        ? detail::parallel_block_count(probe ? height * width : cells.size(), statistics_min_block_size)
+        : std::size_t(1);
+
+    std::vector<fitted_block> fitted(std::max(std::size_t(1), std::min(blocks, units)));
+
+    // Numbers deferred while measuring a block are rendered once at its end
+    auto measure_deferred = [&](fitted_block &result) {
+        for (const auto &deferred : result.deferred)
+        {
+            for (auto sign = 0; sign < 3; ++sign)
+            {
+                if (!deferred.seen[sign]) continue;
+
+                const auto number = sign == 0 ? -deferred.largest[sign] : deferred.largest[sign];
+                const auto text = deferred.format->formatter.format_number(number);
+                auto &widest = result.widths[deferred.column];
+                widest = std::max(widest, deferred.metrics->text_width(text));
+            }
+        }
+    };
+
+    auto measure_units = [&](std::size_t block, std::size_t first, std::size_t last) {
+        auto &result = fitted[block];
+        result.widths.assign(width, 0.0);
+        result.last_deferred.assign(width, 0);
+
+        if (probe)
+        {
+            for (auto row = first_row + static_cast<row_t>(first); row < first_row + static_cast<row_t>(last); ++row)
+            {
+                for (auto column = first_column; column <= last_column; ++column)
+                {
+                    auto match = cells.find(cell_reference(column, row));
+
+                    if (match != cells.end())
+                    {
+                        measure(match->second, result);
+                    }
+                }
+            }
+        }
+        else
+        {
+            auto measure_if_contained = [&](const std::pair<const cell_reference, detail::cell_impl> &entry) {
+                const auto &ref = entry.first;
+
+                if (ref.row() >= first_row && ref.row() <= last_row
+                    && ref.column_index() >= first_column && ref.column_index() <= last_column)
+                {
+                    measure(entry.second, result);
+                }
+            };
+
+            if (fitted.size() == 1)
+            {
+                std::for_each(cells.begin(), cells.end(), measure_if_contained);
+            }
+            else
+            {
+                for (auto bucket = first; bucket < last; ++bucket)
+                {
+                    std::for_each(cells.begin(bucket), cells.end(bucket), measure_if_contained);
+                }
+            }
+        }
+
+        measure_deferred(result);
+    };
+
+    if (ws_.d_->pager_)
+    {
+        // Paged out cells are read from the file rather than paged in, so the limit is kept
+        fitted.resize(1);
+        auto &result = fitted.front();
+        result.widths.assign(width, 0.0);
+        result.last_deferred.assign(width, 0);
+
+        ws_.d_->for_each_cell(first_row, last_row, [&](const detail::cell_impl &cell) {
+            if (cell.column_ >= first_column && cell.column_ <= last_column)
+            {
+                measure(cell, result);
+            }
+        });
+
+        measure_deferred(result);
+    }
+    else
+    {
+        detail::parallel_for_blocks(units, fitted.size(), measure_units);
+    }
+
+    for (auto column = first_column; column <= last_column; ++column)
+    {
+        auto widest = 0.0;
+
+        for (const auto &block : fitted)
+        {
+            widest = std::max(widest, block.widths[column - first_column]);
+        }
+
+        if (widest <= 0.0) continue;
+
+        // Widths are stored in 1/256ths of a character
+        auto &props = ws_.column_properties(column);
+        props.width = std::ceil((widest + padding) * 256.0) / 256.0;
+        props.custom_width = true;
+        props.best_fit = true;
+    }
+}
+
 void range::apply(std::function<void(class cell)> f)
 {
     for (auto row : *this)
@@ -20,8 +20,10 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <algorithm>
 #include <locale>
 
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
 
 namespace xlnt {
@@ -61,8 +63,9 @@ range_reference::range_reference(const std::string &range_string)
 
     if (colon_index != std::string::npos)
     {
-        top_left_ = cell_reference(range_string.substr(0, colon_index));
-        bottom_right_ = cell_reference(range_string.substr(colon_index + 1));
+        const auto colon = range_string.data() + colon_index;
+        top_left_ = cell_reference::from_chars(range_string.data(), colon);
+        bottom_right_ = cell_reference::from_chars(colon + 1, range_string.data() + range_string.size());
     }
     else
     {
@@ -112,7 +115,25 @@ bool range_reference::is_single_cell() const
 
 std::string range_reference::to_string() const
 {
-    return top_left_.to_string() + ":" + bottom_right_.to_string();
+    char buffer[max_string_length];
+    return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)));
+}
+
+const std::size_t range_reference::max_string_length;
+
+char *range_reference::to_chars(char *first, char *last) const
+{
+    char buffer[max_string_length];
+    auto end = top_left_.to_chars(buffer, buffer + sizeof(buffer));
+    *end++ = ':';
+    end = bottom_right_.to_chars(end, buffer + sizeof(buffer));
+
+    if (last - first < end - buffer)
+    {
+        throw invalid_parameter();
+    }
+
+    return std::copy(buffer, end, first);
 }
 
 bool range_reference::operator==(const range_reference &comparand) const
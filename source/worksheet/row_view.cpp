@@ -0,0 +1,253 @@
+// Copyright (c) 2016-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+
+#include <xlnt/utils/date.hpp>
+#include <xlnt/utils/datetime.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/numeric.hpp>
+#include <xlnt/utils/time.hpp>
+#include <xlnt/utils/timedelta.hpp>
+#include <xlnt/worksheet/row_view.hpp>
+
+namespace xlnt {
+
+cell_reference cell_view::reference() const
+{
+    return cell_reference(column_, row_);
+}
+
+column_t cell_view::column() const
+{
+    return column_;
+}
+
+row_t cell_view::row() const
+{
+    return row_;
+}
+
+cell_type cell_view::data_type() const
+{
+    return type_;
+}
+
+bool cell_view::has_value() const
+{
+    return type_ != cell_type::empty;
+}
+
+string_view cell_view::raw_value() const
+{
+    return raw_value_;
+}
+
+bool cell_view::has_formula() const
+{
+    return has_formula_;
+}
+
+string_view cell_view::formula() const
+{
+    return formula_;
+}
+
+bool cell_view::has_format() const
+{
+    return has_format_;
+}
+
+std::size_t cell_view::format_id() const
+{
+    if (!has_format_)
+    {
+        throw invalid_attribute();
+    }
+
+    return format_id_;
+}
+
+bool cell_view::phonetics_visible() const
+{
+    return phonetics_visible_;
+}
+
+double cell_view::number() const
+{
+    if ((type_ != cell_type::number && type_ != cell_type::boolean) || raw_value_.empty())
+    {
+        throw invalid_data_type();
+    }
+
+    return detail::number_serialiser().deserialise(raw_value_.data(), raw_value_.size());
+}
+
+template <>
+XLNT_API bool cell_view::value() const
+{
+    return number() != 0.0;
+}
+
+template <>
+XLNT_API int cell_view::value() const
+{
+    return static_cast<int>(number());
+}
+
+template <>
+XLNT_API long long int cell_view::value() const
+{
+    return static_cast<long long int>(number());
+}
+
+template <>
+XLNT_API unsigned int cell_view::value() const
+{
+    return static_cast<unsigned int>(number());
+}
+
+template <>
+XLNT_API unsigned long long cell_view::value() const
+{
+    return static_cast<unsigned long long>(number());
+}
+
+template <>
+XLNT_API float cell_view::value() const
+{
+    return static_cast<float>(number());
+}
+
+template <>
+XLNT_API double cell_view::value() const
+{
+    return number();
+}
+
+template <>
+XLNT_API time cell_view::value() const
+{
+    if (type_ == cell_type::date)
+    {
+        auto iso = datetime::from_iso_string(raw_value_.to_string());
+        return time(iso.hour, iso.minute, iso.second, iso.microsecond);
+    }
+
+    return time::from_number(number());
+}
+
+template <>
+XLNT_API datetime cell_view::value() const
+{
+    if (type_ == cell_type::date)
+    {
+        return datetime::from_iso_string(raw_value_.to_string());
+    }
+
+    return datetime::from_number(number(), base_date_);
+}
+
+template <>
+XLNT_API date cell_view::value() const
+{
+    if (type_ == cell_type::date)
+    {
+        auto iso = datetime::from_iso_string(raw_value_.to_string());
+        return date(iso.year, iso.month, iso.day);
+    }
+
+    return date::from_number(static_cast<int>(number()), base_date_);
+}
+
+template <>
+XLNT_API timedelta cell_view::value() const
+{
+    return timedelta::from_number(number());
+}
+
+template <>
+XLNT_API string_view cell_view::value() const
+{
+    return text_;
+}
+
+template <>
+XLNT_API std::string cell_view::value() const
+{
+    return text_.to_string();
+}
+
+row_t row_view::row() const
+{
+    return row_;
+}
+
+std::size_t row_view::size() const
+{
+    return cells_.size();
+}
+
+bool row_view::empty() const
+{
+    return cells_.empty();
+}
+
+const cell_view &row_view::operator[](std::size_t index) const
+{
+    return cells_[index];
+}
+
+std::vector<cell_view>::const_iterator row_view::begin() const
+{
+    return cells_.begin();
+}
+
+std::vector<cell_view>::const_iterator row_view::end() const
+{
+    return cells_.end();
+}
+
+bool row_view::has_cell(column_t column) const
+{
+    auto match = std::lower_bound(cells_.begin(), cells_.end(), column.index,
+        [](const cell_view &cell, column_t::index_t index) { return cell.column_ < index; });
+
+    return match != cells_.end() && match->column_ == column.index;
+}
+
+const cell_view &row_view::cell(column_t column) const
+{
+    // cells are stored in ascending column order as Excel requires
+    auto match = std::lower_bound(cells_.begin(), cells_.end(), column.index,
+        [](const cell_view &cell, column_t::index_t index) { return cell.column_ < index; });
+
+    if (match == cells_.end() || match->column_ != column.index)
+    {
+        throw key_not_found();
+    }
+
+    return *match;
+}
+
+} // namespace xlnt
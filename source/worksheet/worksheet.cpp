@@ -35,6 +35,7 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/numeric.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/worksheet_iterator.hpp>
 #include <xlnt/worksheet/cell_iterator.hpp>
@@ -47,6 +48,7 @@
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/constants.hpp>
 #include <detail/default_case.hpp>
+#include <detail/fingerprint.hpp>
 #include <detail/implementations/cell_impl.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
@@ -201,6 +203,24 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
+    if (d_->pager_)
+    {
+        // paged worksheets are collected a block of rows at a time to stay within their limit
+        d_->pager_->for_each_block(*d_, [this](const std::vector<cell_reference> &references) {
+            for (const auto &reference : references)
+            {
+                auto match = d_->cell_map_.find(reference);
+
+                if (match != d_->cell_map_.end() && xlnt::cell(&match->second).garbage_collectible())
+                {
+                    d_->cell_map_.erase(match);
+                }
+            }
+        });
+
+        return;
+    }
+
     auto cell_iter = d_->cell_map_.begin();
 
     while (cell_iter != d_->cell_map_.end())
@@ -382,6 +402,8 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
+    d_->page_in(reference.row(), reference.row());
+
     auto match = d_->cell_map_.find(reference);
     if (match == d_->cell_map_.end())
     {
@@ -391,12 +413,18 @@ cell worksheet::cell(const cell_reference &reference)
         impl.row_ = reference.row();
 
         match = d_->cell_map_.emplace(reference, impl).first;
+
+        if (d_->pager_)
+        {
+            d_->pager_->added(*d_, reference);
+        }
     }
     return xlnt::cell(&match->second);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
+    d_->page_in(reference.row(), reference.row(), false);
     return xlnt::cell(&d_->cell_map_.at(reference));
 }
 
@@ -412,8 +440,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->find_cell(reference) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -453,7 +480,7 @@ const range worksheet::named_range(const std::string &name) const
 
 column_t worksheet::lowest_column() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cell_count() == 0)
     {
         return constants::min_column();
     }
@@ -465,6 +492,11 @@ column_t worksheet::lowest_column() const
         lowest = std::min(lowest, cell.first.column());
     }
 
+    if (d_->pager_)
+    {
+        lowest = std::min(lowest, d_->pager_->paged_bounds().min_column);
+    }
+
     return lowest;
 }
 
@@ -472,7 +504,7 @@ column_t worksheet::lowest_column_or_props() const
 {
     auto lowest = lowest_column();
 
-    if (d_->cell_map_.empty() && !d_->column_properties_.empty())
+    if (d_->cell_count() == 0 && !d_->column_properties_.empty())
     {
         lowest = d_->column_properties_.begin()->first;
     }
@@ -487,7 +519,7 @@ column_t worksheet::lowest_column_or_props() const
 
 row_t worksheet::lowest_row() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cell_count() == 0)
     {
         return constants::min_row();
     }
@@ -499,6 +531,11 @@ row_t worksheet::lowest_row() const
         lowest = std::min(lowest, cell.first.row());
     }
 
+    if (d_->pager_)
+    {
+        lowest = std::min(lowest, d_->pager_->paged_bounds().min_row);
+    }
+
     return lowest;
 }
 
@@ -506,7 +543,7 @@ row_t worksheet::lowest_row_or_props() const
 {
     auto lowest = lowest_row();
 
-    if (d_->cell_map_.empty() && !d_->row_properties_.empty())
+    if (d_->cell_count() == 0 && !d_->row_properties_.empty())
     {
         lowest = d_->row_properties_.begin()->first;
     }
@@ -528,6 +565,11 @@ row_t worksheet::highest_row() const
         highest = std::max(highest, cell.first.row());
     }
 
+    if (d_->pager_)
+    {
+        highest = std::max(highest, d_->pager_->paged_bounds().max_row);
+    }
+
     return highest;
 }
 
@@ -535,7 +577,7 @@ row_t worksheet::highest_row_or_props() const
 {
     auto highest = highest_row();
 
-    if (d_->cell_map_.empty() && !d_->row_properties_.empty())
+    if (d_->cell_count() == 0 && !d_->row_properties_.empty())
     {
         highest = d_->row_properties_.begin()->first;
     }
@@ -557,6 +599,11 @@ column_t worksheet::highest_column() const
         highest = std::max(highest, cell.first.column());
     }
 
+    if (d_->pager_)
+    {
+        highest = std::max(highest, d_->pager_->paged_bounds().max_column);
+    }
+
     return highest;
 }
 
@@ -564,7 +611,7 @@ column_t worksheet::highest_column_or_props() const
 {
     auto highest = highest_column();
 
-    if (d_->cell_map_.empty() && !d_->column_properties_.empty())
+    if (d_->cell_count() == 0 && !d_->column_properties_.empty())
     {
         highest = d_->column_properties_.begin()->first;
     }
@@ -583,7 +630,7 @@ range_reference worksheet::calculate_dimension() const
     // return range_reference(lowest_column(), lowest_row_or_props(),
     //                        highest_column(), highest_row_or_props());
     //
-    if (d_->cell_map_.empty() && d_->row_properties_.empty())
+    if (d_->cell_count() == 0 && d_->row_properties_.empty())
     {
         return range_reference(constants::min_column(), constants::min_row(),
             constants::min_column(), constants::min_row());
@@ -595,7 +642,7 @@ range_reference worksheet::calculate_dimension() const
         min_row_prop = std::min(min_row_prop, row_prop.first);
         max_row_prop = std::max(max_row_prop, row_prop.first);
     }
-    if (d_->cell_map_.empty())
+    if (d_->cell_count() == 0)
     {
         return range_reference(constants::min_column(), min_row_prop,
             constants::min_column(), max_row_prop);
@@ -612,6 +659,14 @@ range_reference worksheet::calculate_dimension() const
         min_row = std::min(min_row, c.second.row_);
         max_row = std::max(max_row, c.second.row_);
     }
+    if (d_->pager_)
+    {
+        const auto paged = d_->pager_->paged_bounds();
+        min_col = std::min(min_col, paged.min_column);
+        max_col = std::max(max_col, paged.max_column);
+        min_row = std::min(min_row, paged.min_row);
+        max_row = std::max(max_row, paged.max_row);
+    }
     return range_reference(min_col, min_row, max_col, max_row);
 }
 
@@ -707,7 +762,7 @@ row_t worksheet::next_row() const
 {
     auto row = highest_row() + 1;
 
-    if (row == 2 && d_->cell_map_.size() == 0)
+    if (row == 2 && d_->cell_count() == 0)
     {
         row = 1;
     }
@@ -753,16 +808,32 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.erase(ref);
+    d_->page_in(ref.row(), ref.row());
+
+    auto match = d_->cell_map_.find(ref);
+    if (match == d_->cell_map_.end()) return;
+
+    if (match->second.formula_.is_set())
+    {
+        --d_->formula_count_;
+    }
+
+    d_->cell_map_.erase(match);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
 void worksheet::clear_row(row_t row)
 {
+    d_->page_in(row, row);
+
     for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
     {
         if (it->first.row() == row)
         {
+            if (it->second.formula_.is_set())
+            {
+                --d_->formula_count_;
+            }
             it = d_->cell_map_.erase(it);
         }
         else
@@ -806,6 +877,9 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         throw xlnt::exception("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
     }
 
+    // cells move between blocks of rows, so a paged worksheet is brought into memory first
+    d_->page_in_all();
+
     std::vector<detail::cell_impl> cells_to_move;
 
     auto cell_iter = d_->cell_map_.cbegin();
@@ -841,6 +915,10 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         }
         else if (reverse && current_index >= min_index - amount) // delete destination cells
         {
+            if (cell_iter->second.formula_.is_set())
+            {
+                --d_->formula_count_;
+            }
             cell_iter = d_->cell_map_.erase(cell_iter);
         }
         else // skip other cells
@@ -854,6 +932,11 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
     }
 
+    if (d_->pager_)
+    {
+        d_->pager_->reindex(*d_);
+    }
+
     if (row_or_col == row_or_col_t::row)
     {
         std::vector<std::pair<row_t, xlnt::row_properties>> properties_to_move;
@@ -960,6 +1043,9 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     if (d_->parent_ != other.d_->parent_) return false;
 
+    d_->page_in_all();
+    other.d_->page_in_all();
+
     for (auto &cell : d_->cell_map_)
     {
         if (other.d_->cell_map_.find(cell.first) == other.d_->cell_map_.end())
@@ -998,6 +1084,36 @@ bool worksheet::operator!=(const worksheet &other) const
     return !(*this == other);
 }
 
+worksheet_fingerprint worksheet::fingerprint(bool parallel) const
+{
+    d_->page_in_all();
+
+    return detail::fingerprint_worksheet(*d_, parallel);
+}
+
+worksheet_diff worksheet::diff(const worksheet &other, bool parallel) const
+{
+    const auto same_styles = detail::styles_equivalent(
+        d_->parent_->d_->stylesheet_, other.d_->parent_->d_->stylesheet_);
+
+    d_->page_in_all();
+    other.d_->page_in_all();
+
+    return detail::diff_worksheets(*d_, *other.d_, same_styles, parallel);
+}
+
+worksheet_diff worksheet::diff(const worksheet &other, const worksheet_fingerprint &this_fingerprint,
+    const worksheet_fingerprint &other_fingerprint, bool parallel) const
+{
+    const auto same_styles = detail::styles_equivalent(
+        d_->parent_->d_->stylesheet_, other.d_->parent_->d_->stylesheet_);
+
+    d_->page_in_all();
+    other.d_->page_in_all();
+
+    return detail::diff_worksheets(*d_, *other.d_, this_fingerprint, other_fingerprint, same_styles, parallel);
+}
+
 bool worksheet::operator==(std::nullptr_t) const
 {
     return d_ == nullptr;
@@ -1038,6 +1154,29 @@ void worksheet::reserve(std::size_t n)
     d_->cell_map_.reserve(n);
 }
 
+void worksheet::max_resident_cells(std::size_t count)
+{
+    if (count == 0)
+    {
+        d_->page_in_all();
+        d_->pager_.reset();
+    }
+    else if (d_->pager_)
+    {
+        d_->pager_->max_resident_cells(*d_, count);
+    }
+    else
+    {
+        d_->pager_.reset(new detail::cell_pager(count));
+        d_->pager_->reindex(*d_);
+    }
+}
+
+std::size_t worksheet::max_resident_cells() const
+{
+    return d_->pager_ ? d_->pager_->max_resident_cells() : 0;
+}
+
 class header_footer worksheet::header_footer() const
 {
     return d_->header_footer_.get();
@@ -1275,6 +1414,33 @@ double worksheet::column_width(column_t column) const
     }
 }
 
+void worksheet::auto_fit_columns(bool parallel)
+{
+    if (d_->cell_count() == 0) return;
+
+    range(calculate_dimension()).auto_fit_columns(parallel);
+}
+
+void worksheet::column_string_storage(column_t column, string_storage storage)
+{
+    d_->column_string_storage_[column] = storage;
+}
+
+string_storage worksheet::column_string_storage(column_t column) const
+{
+    if (!d_->column_string_storage_.empty())
+    {
+        auto match = d_->column_string_storage_.find(column);
+
+        if (match != d_->column_string_storage_.end())
+        {
+            return match->second;
+        }
+    }
+
+    return d_->parent_->d_->default_string_storage_;
+}
+
 double worksheet::row_height(row_t row) const
 {
     static const auto DefaultRowHeight = 15.0;
@@ -1289,11 +1455,6 @@ double worksheet::row_height(row_t row) const
     }
 }
 
-void worksheet::garbage_collect_formulae()
-{
-    workbook().garbage_collect_formulae();
-}
-
 void worksheet::parent(xlnt::workbook &wb)
 {
     d_->parent_ = &wb;
@@ -1337,7 +1498,7 @@ bool worksheet::has_drawing() const
 
 bool worksheet::is_empty() const
 {
-    return d_->cell_map_.empty();
+    return d_->cell_count() == 0;
 }
 
 } // namespace xlnt
@@ -0,0 +1,46 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <xlnt/worksheet/worksheet_diff.hpp>
+
+namespace xlnt {
+
+const row_t worksheet_fingerprint::rows_per_block = 256;
+
+std::uint64_t worksheet_fingerprint::row(row_t row) const
+{
+    return row < rows.size() ? rows[row] : 0;
+}
+
+std::uint64_t worksheet_fingerprint::block(std::size_t block) const
+{
+    return block < blocks.size() ? blocks[block] : 0;
+}
+
+bool worksheet_diff::empty() const
+{
+    return !added && !removed && !properties_changed && changed_cells.empty();
+}
+
+} // namespace xlnt
@@ -78,8 +78,10 @@ public:
         register_test(test_print);
         register_test(test_values);
         register_test(test_reference);
+        register_test(test_reference_chars);
         register_test(test_anchor);
         register_test(test_hyperlink);
+        register_test(test_hyperlink_shared_target);
         register_test(test_comment);
         register_test(test_copy_and_compare);
         register_test(test_cell_phonetic_properties);
@@ -680,6 +682,38 @@ private:
         xlnt_assert(xlnt::cell_reference("A1") != "A2");
     }
 
+    void test_reference_chars()
+    {
+        char buffer[xlnt::range_reference::max_string_length];
+
+        for (auto text : {"A1", "$B$12", "$XFD1048576", "ZZZ$4294967295"})
+        {
+            auto ref = xlnt::cell_reference(text);
+            auto end = ref.to_chars(buffer, buffer + sizeof(buffer));
+            xlnt_assert_equals(std::string(buffer, end), text);
+            xlnt_assert_equals(ref.to_string(), text);
+            xlnt_assert_equals(xlnt::cell_reference::from_chars(buffer, end), ref);
+        }
+
+        auto lower = xlnt::cell_reference::from_chars(&"$ab$3"[0], &"$ab$3"[5]);
+        xlnt_assert_equals(lower.column_index(), 28);
+        xlnt_assert_equals(lower.row(), 3);
+        xlnt_assert(lower.column_absolute() && lower.row_absolute());
+
+        auto range = xlnt::range_reference("$A$1:C3");
+        auto end = range.to_chars(buffer, buffer + sizeof(buffer));
+        xlnt_assert_equals(std::string(buffer, end), "$A$1:C3");
+        xlnt_assert_throws(range.to_chars(buffer, buffer + 6), xlnt::invalid_parameter);
+        xlnt_assert_throws(xlnt::cell_reference("B12").to_chars(buffer, buffer + 2), xlnt::invalid_parameter);
+
+        for (auto bad : {"", "$", "1", "A1B", "A$", "A$$1", "A4294967296", "A 1"})
+        {
+            xlnt_assert_throws(xlnt::cell_reference(std::string(bad)), xlnt::invalid_cell_reference);
+        }
+
+        xlnt_assert_throws(xlnt::cell_reference("ABCD1"), xlnt::invalid_column_index);
+    }
+
     void test_anchor()
     {
         xlnt::workbook wb;
@@ -776,6 +810,31 @@ private:
         cell.clear_value();
     }
 
+    void test_hyperlink_shared_target()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const std::string link1("http://example.com");
+        const std::string link2("http://example2.com");
+
+        ws.cell("A1").hyperlink(link1);
+        ws.cell("A2").hyperlink(link2);
+        ws.cell("A3").hyperlink(link1);
+
+        xlnt_assert_equals(ws.cell("A1").hyperlink().relationship().id(), "rId1");
+        xlnt_assert_equals(ws.cell("A2").hyperlink().relationship().id(), "rId2");
+        xlnt_assert_equals(ws.cell("A3").hyperlink().relationship().id(), "rId1");
+        xlnt_assert_equals(wb.manifest().relationships(ws.path(), xlnt::relationship_type::hyperlink).size(), 2);
+
+        wb.manifest().unregister_relationship(xlnt::uri(ws.path().string()), "rId1");
+        xlnt_assert(!wb.manifest().has_relationship(ws.path(), xlnt::relationship_type::hyperlink, xlnt::uri(link1)));
+        xlnt_assert_equals(wb.manifest().relationship(ws.path(),
+            xlnt::relationship_type::hyperlink, xlnt::uri(link2)).id(), "rId1");
+
+        ws.cell("A4").hyperlink(link1);
+        xlnt_assert_equals(ws.cell("A4").hyperlink().relationship().id(), "rId2");
+    }
+
     void test_comment()
     {
         xlnt::workbook wb;
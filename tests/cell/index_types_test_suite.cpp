@@ -36,6 +36,8 @@ public:
         register_test(test_bad_string_numbers);
         register_test(test_bad_index_zero);
         register_test(test_column_operators);
+        register_test(test_column_chars_round_trip);
+        register_test(test_column_chars_bad_input);
     }
 
     void test_bad_string_empty()
@@ -100,6 +102,52 @@ public:
         xlnt_assert(3 <= c1);
         xlnt_assert(!(4 <= c1));
     }
+
+    void test_column_chars_round_trip()
+    {
+        char buffer[xlnt::column_t::max_string_length];
+
+        for (xlnt::column_t::index_t index = 1; index <= 18279; ++index)
+        {
+            // reference implementation
+            std::string expected;
+
+            for (auto remaining = index; remaining > 0; remaining = (remaining - 1) / 26)
+            {
+                expected.insert(expected.begin(), static_cast<char>('A' + (remaining - 1) % 26));
+            }
+
+            auto end = xlnt::column_t::to_chars(index, buffer, buffer + sizeof(buffer));
+            xlnt_assert_equals(std::string(buffer, end), expected);
+            xlnt_assert_equals(xlnt::column_t::column_string_from_index(index), expected);
+
+            if (expected.size() <= 3)
+            {
+                xlnt_assert_equals(xlnt::column_t::column_index_from_chars(buffer, end), index);
+            }
+        }
+
+        xlnt_assert_equals(xlnt::column_t::column_string_from_index(18279), "AAAA");
+        xlnt_assert_equals(xlnt::column_t::column_string_from_index(4294967295u), "MWLQKWU");
+        xlnt_assert_equals(xlnt::column_t::column_index_from_string("xfd"), 16384);
+    }
+
+    void test_column_chars_bad_input()
+    {
+        char buffer[2];
+        xlnt_assert_throws(xlnt::column_t::to_chars(703, buffer, buffer + sizeof(buffer)),
+            xlnt::invalid_parameter);
+        xlnt_assert_throws(xlnt::column_t::to_chars(0, buffer, buffer + sizeof(buffer)),
+            xlnt::invalid_column_index);
+
+        const std::string bad = "A[@`{";
+
+        for (auto i = std::size_t(1); i < bad.size(); ++i)
+        {
+            xlnt_assert_throws(xlnt::column_t::column_index_from_chars(&bad[i], &bad[i] + 1),
+                xlnt::invalid_column_index);
+        }
+    }
 };
 
 static index_types_test_suite x{};
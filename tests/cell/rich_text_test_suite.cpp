@@ -27,7 +27,10 @@
 
 #include <helpers/test_suite.hpp>
 
+#include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/rich_text.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
 
 class rich_text_test_suite : public test_suite
 {
@@ -38,6 +41,7 @@ public:
         register_test(test_runs);
         register_test(test_phonetic_runs);
         register_test(test_phonetic_properties);
+        register_test(test_compact_runs);
     }
 
     void test_operators()
@@ -142,5 +146,63 @@ public:
         xlnt_assert_equals(rt.phonetic_properties().has_type(), true);
         xlnt_assert_equals(rt.phonetic_properties().has_alignment(), true);
     }
+
+    void test_compact_runs()
+    {
+        // a single unformatted run is the same text however it was built
+        xlnt::rich_text from_string("abc");
+        xlnt::rich_text from_run;
+        from_run.add_run(xlnt::rich_text_run{"abc", {}, false});
+        xlnt_assert_equals(from_string, from_run);
+        xlnt_assert_equals(from_run, std::string("abc"));
+        xlnt_assert_equals(xlnt::rich_text_hash()(from_string), xlnt::rich_text_hash()(from_run));
+        xlnt_assert_equals(from_run.runs().size(), 1);
+        xlnt_assert(!from_run.runs().front().second.is_set());
+
+        // appending to plain text keeps the first run in front
+        xlnt::font bold;
+        bold.bold(true);
+        from_run.add_run(xlnt::rich_text_run{"def", bold, false});
+        xlnt_assert_differs(from_string, from_run);
+        xlnt_assert_equals(from_run.plain_text(), "abcdef");
+        xlnt_assert_equals(from_run.runs().size(), 2);
+        xlnt_assert(!from_run.runs()[0].second.is_set());
+        xlnt_assert_equals(from_run.runs()[1].second.get(), bold);
+
+        // copies share fonts but stay independent
+        auto copy = from_run;
+        xlnt_assert_equals(copy, from_run);
+        copy.plain_text("xyz", false);
+        xlnt_assert_equals(copy, std::string("xyz"));
+        xlnt_assert_equals(from_run.runs().size(), 2);
+
+        xlnt::rich_text empty;
+        xlnt::rich_text empty_string("");
+        xlnt_assert_differs(empty, empty_string);
+
+        // formatted strings survive a round trip with shared fonts
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1; row <= 10; ++row)
+        {
+            xlnt::rich_text text;
+            text.add_run(xlnt::rich_text_run{"plain ", {}, true});
+            text.add_run(xlnt::rich_text_run{std::to_string(row), bold, false});
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(text);
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        auto loaded_text = loaded.active_sheet().cell("A3").value<xlnt::rich_text>();
+        xlnt_assert_equals(loaded_text.plain_text(), "plain 3");
+        xlnt_assert_equals(loaded_text.runs().size(), 2);
+        xlnt_assert(loaded_text.runs()[1].second.get().bold());
+        xlnt_assert_equals(loaded.active_sheet().cell("A7").value<xlnt::rich_text>().runs()[1].second.get(),
+            loaded_text.runs()[1].second.get());
+    }
 };
 static rich_text_test_suite x{};
@@ -22,9 +22,13 @@
 // @author: see AUTHORS file
 
 #include <iostream>
+#include <sstream>
 
 
+#include <detail/external/include_libstudxml.hpp>
 #include <helpers/test_suite.hpp>
+#include <xlnt/drawing/spreadsheet_drawing.hpp>
+#include <xlnt/packaging/ext_list.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/utils/path.hpp>
@@ -35,6 +39,7 @@ public:
     drawing_test_suite()
     {
         register_test(test_load_save);
+        register_test(test_verbatim_markup);
     }
 
     void test_load_save()
@@ -55,5 +60,48 @@ public:
         auto ws3 = wb3.active_sheet();
         xlnt_assert_equals(ws3.has_drawing(), true);
     }
+
+    void test_verbatim_markup()
+    {
+        const std::string markup = "<?xml version=\"1.0\"?>"
+            "<xdr:wsDr xmlns:xdr=\"d\" xmlns:a=\"a\" xmlns:rel=\"r\">"
+            "<xdr:pic><xdr:nvPicPr><xdr:cNvPr id=\"1\" descr=\"a > b\" embed=\"not a blip\"/></xdr:nvPicPr>"
+            "<xdr:blipFill><a:blip descr='x>y' rel:embed='rId3'/></xdr:blipFill></xdr:pic>"
+            "<a:blip\nrel:link=\"rId9\" rel:embed=\"rId4\"></a:blip><a:blipFill/>"
+            "</xdr:wsDr>";
+
+        xlnt::drawing::spreadsheet_drawing drawing(markup);
+        xlnt_assert_equals(drawing.get_embed_ids(), std::vector<std::string>({"rId3", "rId4"}));
+
+        std::ostringstream out;
+        drawing.serialize(out);
+        xlnt_assert_equals(out.str(), markup);
+
+        // whitespace may surround '=' and blips in comments, CDATA or processing instructions aren't tags
+        const std::string spaced = "<?xml version=\"1.0\"?><?pi <a:blip r:embed=\"rId1\"/>?>"
+            "<xdr:wsDr xmlns:xdr=\"d\" xmlns:a=\"a\" xmlns:r=\"r\">"
+            "<!-- <a:blip r:embed=\"rId2\"/> -->"
+            "<xdr:sp><![CDATA[<a:blip r:embed=\"rId3\"/>]]></xdr:sp>"
+            "<a:blip r:link = \"rId8\" r:embed =\n'rId5' cstate=\"print\"/>"
+            "<a:blip r:embed\t=  \"rId6\"/>"
+            "</xdr:wsDr>";
+
+        xlnt::drawing::spreadsheet_drawing spaced_drawing(spaced);
+        xlnt_assert_equals(spaced_drawing.get_embed_ids(), std::vector<std::string>({"rId5", "rId6"}));
+
+        // extensions keep the namespace declarations they need apart from the default one
+        std::istringstream in("<extLst xmlns=\"main\"><ext uri=\"{X}\" xmlns:mx=\"m\"><mx:PLV Mode=\"1\"/>"
+                              "<other/></ext></extLst>");
+        xml::parser parser(in, "extLst");
+        parser.next_expect(xml::parser::start_element, "main", "extLst");
+        xlnt::ext_list extensions(parser, "main");
+        xlnt_assert_equals(extensions.extension(xlnt::uri("{X}")).serialised_value_,
+            "<ext xmlns:mx=\"m\" uri=\"{X}\"><mx:PLV Mode=\"1\"/><other/></ext>");
+
+        std::ostringstream list_out;
+        extensions.serialize(list_out);
+        xlnt_assert_equals(list_out.str(),
+            "<extLst><ext xmlns:mx=\"m\" uri=\"{X}\"><mx:PLV Mode=\"1\"/><other/></ext></extLst>");
+    }
 };
 static drawing_test_suite x{};
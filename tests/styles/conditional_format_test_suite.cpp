@@ -22,6 +22,8 @@
 // @author: see AUTHORS file
 
 #include <xlnt/styles/conditional_format.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <helpers/test_suite.hpp>
 #include <xlnt/xlnt.hpp>
 
@@ -31,6 +33,7 @@ public:
     conditional_format_test_suite()
     {
         register_test(test_all);
+        register_test(test_rule_grouping);
     }
 
     void test_all()
@@ -60,5 +63,77 @@ public:
         auto format_copy(format);
         xlnt_assert_equals(format, format_copy);
     }
+
+    void test_rule_grouping()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        const std::vector<std::string> colours = {"FF0000", "FF0000", "00FF00", "0000FF"};
+
+        // one rule per cell, as img2xlsx and heat maps do
+        for (auto row = xlnt::row_t(1); row <= 4; ++row)
+        {
+            for (auto column = xlnt::column_t::index_t(1); column <= 4; ++column)
+            {
+                const auto &colour = colours[column - 1];
+                auto ref = xlnt::cell_reference(column, row);
+                ws.conditional_format(xlnt::range_reference(ref, ref), xlnt::condition::text_contains(colour))
+                    .fill(xlnt::pattern_fill().background(xlnt::rgb_color(colour)));
+            }
+        }
+
+        // rules with the same condition and format are kept once with every range they were added to
+        auto red = ws.conditional_format(xlnt::range_reference("F1:F1"), xlnt::condition::text_contains("FF0000"));
+        xlnt_assert_equals(red.ranges(), std::vector<xlnt::range_reference>({xlnt::range_reference("F1:F1")}));
+        red.fill(xlnt::pattern_fill().background(xlnt::rgb_color("FF0000")));
+        xlnt_assert_equals(red.range(), xlnt::range_reference("F1:F1"));
+        xlnt_assert_equals(red.ranges().size(), 9);
+        xlnt_assert_equals(red.ranges().front(), xlnt::range_reference("A1:A1"));
+
+        // changing the format of one range leaves the others as they were
+        red.font(xlnt::font().bold(true));
+        xlnt_assert_equals(red.ranges(), std::vector<xlnt::range_reference>({xlnt::range_reference("F1:F1")}));
+        xlnt_assert(red.has_font());
+        auto other_red = ws.conditional_format(xlnt::range_reference("F2:F2"), xlnt::condition::text_contains("FF0000"))
+            .fill(xlnt::pattern_fill().background(xlnt::rgb_color("FF0000")));
+        xlnt_assert_equals(other_red.ranges().size(), 9);
+        xlnt_assert(!other_red.has_font());
+        other_red.font(xlnt::font().bold(true));
+        xlnt_assert_equals(other_red.ranges().size(), 2);
+        xlnt_assert_equals(other_red, ws.conditional_format(xlnt::range_reference("F2:F2"),
+            xlnt::condition::text_contains("FF0000")).fill(xlnt::pattern_fill().background(xlnt::rgb_color("FF0000"))).font(xlnt::font().bold(true)));
+
+        // a different condition with an existing fill shares its dxf and block
+        ws.conditional_format(xlnt::range_reference("A1:B4"), xlnt::condition::text_contains("x"))
+            .fill(xlnt::pattern_fill().background(xlnt::rgb_color("FF0000")));
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::detail::vector_istreambuf buffer(data);
+        std::istream stream(&buffer);
+        xlnt::detail::izstream archive(stream);
+
+        const auto styles = archive.read(xlnt::path("xl/styles.xml"));
+        xlnt_assert(styles.find("<dxfs count=\"4\">") != std::string::npos);
+
+        const auto sheet = archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+        auto count = [&sheet](const std::string &text) {
+            std::size_t found = 0;
+            for (auto i = sheet.find(text); i != std::string::npos; i = sheet.find(text, i + 1))
+            {
+                ++found;
+            }
+            return found;
+        };
+
+        xlnt_assert_equals(count("<conditionalFormatting "), 4);
+        xlnt_assert_equals(count("<cfRule "), 5);
+        xlnt_assert_equals(count("sqref=\"F1:F2\""), 1);
+        xlnt_assert_equals(count("sqref=\"A1:B4\""), 1);
+        xlnt_assert_equals(count("sqref=\"C1:C4\""), 1);
+        xlnt_assert_equals(count("sqref=\"D1:D4\""), 1);
+        xlnt_assert_equals(count("SEARCH(\"0000FF\",D1)"), 1);
+    }
 };
 static conditional_format_test_suite x;
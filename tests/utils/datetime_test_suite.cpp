@@ -21,7 +21,9 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 #include <helpers/test_suite.hpp>
 #include <xlnt/utils/date.hpp>
@@ -41,6 +43,8 @@ public:
         register_test(test_mac_calendar);
         register_test(test_operators);
         register_test(test_weekday);
+        register_test(test_bulk_conversion);
+        register_test(test_unix_conversion);
     }
 
     void test_from_string()
@@ -121,5 +125,88 @@ public:
         xlnt_assert_equals(xlnt::date(2016, 7, 15).weekday(), 5);
         xlnt_assert_equals(xlnt::date(2018, 10, 29).weekday(), 1);
     }
+
+    void test_bulk_conversion()
+    {
+        // more than one block, covering both sides of the 1900 leap year bug
+        std::vector<double> numbers;
+
+        for (auto i = 0; i < 1000; ++i)
+        {
+            numbers.push_back(i * 0.37);
+            numbers.push_back(40000 + i * 11.123456789);
+        }
+
+        numbers.push_back(60.0);
+        numbers.push_back(59.999999999);
+        numbers.push_back(61.5);
+
+        for (auto base_date : {xlnt::calendar::windows_1900, xlnt::calendar::mac_1904})
+        {
+            std::vector<xlnt::datetime> datetimes(numbers.size(), xlnt::datetime(1900, 1, 1));
+            xlnt::datetime::from_numbers(numbers.data(), numbers.size(), datetimes.data(), base_date);
+
+            std::vector<double> round_trip(numbers.size());
+            xlnt::datetime::to_numbers(datetimes.data(), datetimes.size(), round_trip.data(), base_date);
+
+            std::vector<int> days;
+            std::vector<xlnt::date> dates;
+
+            for (std::size_t i = 0; i < numbers.size(); ++i)
+            {
+                const auto expected = xlnt::datetime::from_number(numbers[i], base_date);
+                xlnt_assert_equals(datetimes[i], expected);
+
+                const auto expected_number = expected.to_number(base_date);
+                xlnt_assert(std::memcmp(&round_trip[i], &expected_number, sizeof(double)) == 0);
+
+                days.push_back(static_cast<int>(numbers[i]));
+                dates.push_back(xlnt::date(expected.year, expected.month, expected.day));
+            }
+
+            std::vector<xlnt::date> bulk_dates(days.size(), xlnt::date(1900, 1, 1));
+            xlnt::date::from_numbers(days.data(), days.size(), bulk_dates.data(), base_date);
+            std::vector<int> bulk_days(dates.size());
+            xlnt::date::to_numbers(dates.data(), dates.size(), bulk_days.data(), base_date);
+
+            for (std::size_t i = 0; i < days.size(); ++i)
+            {
+                xlnt_assert_equals(bulk_dates[i], xlnt::date::from_number(days[i], base_date));
+                xlnt_assert_equals(bulk_days[i], dates[i].to_number(base_date));
+            }
+        }
+
+        const auto leap_day = xlnt::datetime(1900, 2, 29);
+        auto leap_number = 0.0;
+        xlnt::datetime::to_numbers(&leap_day, 1, &leap_number, xlnt::calendar::windows_1900);
+        xlnt_assert_equals(leap_number, 60.0);
+    }
+
+    void test_unix_conversion()
+    {
+        const std::vector<double> numbers = {25569.0, 25569.5, 25568.25, 44000.123456, 1.0, 61.0};
+        const std::vector<std::int64_t> expected = {0, 43200000000, -64800000000,
+            1592449066598400, -2208988800000000, -2203891200000000};
+
+        std::vector<std::int64_t> microseconds(numbers.size());
+        xlnt::datetime::to_unix_microseconds(numbers.data(), numbers.size(), microseconds.data(),
+            xlnt::calendar::windows_1900);
+
+        std::vector<double> round_trip(numbers.size());
+        xlnt::datetime::from_unix_microseconds(microseconds.data(), microseconds.size(), round_trip.data(),
+            xlnt::calendar::windows_1900);
+
+        for (std::size_t i = 0; i < numbers.size(); ++i)
+        {
+            xlnt_assert_equals(microseconds[i], expected[i]);
+
+            const auto datetime = xlnt::datetime::from_number(numbers[i], xlnt::calendar::windows_1900);
+            xlnt_assert_equals(round_trip[i], datetime.to_number(xlnt::calendar::windows_1900));
+        }
+
+        auto mac_number = 0.0;
+        xlnt::datetime::from_unix_microseconds(microseconds.data(), 1, &mac_number, xlnt::calendar::mac_1904);
+        xlnt_assert_equals(mac_number, 25569.0 - 1462);
+    }
 };
 static datetime_test_suite x;
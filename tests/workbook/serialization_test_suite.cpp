@@ -21,11 +21,14 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cstring>
 #include <iostream>
+#include <thread>
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/hyperlink.hpp>
+#include <xlnt/styles/alignment.hpp>
 #include <xlnt/styles/border.hpp>
 #include <xlnt/styles/fill.hpp>
 #include <xlnt/styles/font.hpp>
@@ -37,17 +40,24 @@
 #include <xlnt/utils/time.hpp>
 #include <xlnt/utils/timedelta.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/file_format.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
+#include <xlnt/workbook/streaming_worksheet_cursor.hpp>
+#include <xlnt/workbook/streaming_worksheet_writer.hpp>
+#include <xlnt/workbook/string_storage.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
 #include <xlnt/worksheet/row_properties.hpp>
+#include <xlnt/worksheet/row_view.hpp>
 #include <xlnt/worksheet/sheet_format_properties.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/cryptography/xlsx_crypto_consumer.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <helpers/path_helper.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
@@ -89,12 +99,24 @@ public:
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_read_rows);
+        register_test(test_streaming_worksheet_cursors);
         register_test(test_streaming_write);
+        register_test(test_streaming_worksheet_writers);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
         register_test(test_Issue492_stream_empty_row);
+        register_test(test_Issue492_stream_empty_row_rows);
         register_test(test_Issue503_external_link_load);
+        register_test(test_cached_parts);
+        register_test(test_shared_string_scanner);
+        register_test(test_string_storage);
+        register_test(test_forward_only_read);
+        register_test(test_forward_only_write);
+        register_test(test_snapshot);
+        register_test(test_xlsb);
+        register_test(test_read_xlsb_file);
     }
 
     bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -697,6 +719,163 @@ public:
         }
     }
 
+    void test_streaming_read_rows()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("rows");
+        ws.cell("A1").value("text");
+        ws.cell("B1").value(42);
+        ws.cell("C1").value(true);
+        ws.cell("E1").value(-1.5);
+        ws.cell("A2").value("text");
+        ws.cell("B2").formula("B1*2");
+        ws.cell("C2").value(xlnt::date(2020, 2, 29));
+        ws.cell("D2").error("#N/A");
+        ws.cell("A4").value("other");
+        ws.cell("A4").font(xlnt::font().bold(true));
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet("rows");
+
+        xlnt::row_view row;
+
+        xlnt_assert(reader.read_row(row));
+        xlnt_assert_equals(row.row(), 1);
+        xlnt_assert_equals(row.size(), 4);
+        xlnt_assert_equals(row[0].data_type(), xlnt::cell_type::shared_string);
+        xlnt_assert_equals(row[0].value<std::string>(), "text");
+        xlnt_assert_equals(row[0].raw_value(), xlnt::string_view("0"));
+        xlnt_assert_equals(row.cell("B").value<int>(), 42);
+        xlnt_assert_equals(row.cell("C").data_type(), xlnt::cell_type::boolean);
+        xlnt_assert(row.cell("C").value<bool>());
+        xlnt_assert(!row.has_cell("D"));
+        xlnt_assert_equals(row.cell("E").value<double>(), -1.5);
+        xlnt_assert_equals(row.cell("E").reference(), xlnt::cell_reference("E1"));
+        xlnt_assert_throws(row.cell("D"), xlnt::key_not_found);
+        xlnt_assert_throws(row[0].value<double>(), xlnt::invalid_data_type);
+        xlnt_assert(!row[0].has_format());
+
+        xlnt_assert(reader.read_row(row));
+        xlnt_assert_equals(row.row(), 2);
+        xlnt_assert_equals(row.cell("A").value<xlnt::string_view>(), xlnt::string_view("text"));
+        xlnt_assert(row.cell("B").has_formula());
+        xlnt_assert_equals(row.cell("B").formula(), xlnt::string_view("B1*2"));
+        xlnt_assert(!row.cell("B").has_value());
+        xlnt_assert_equals(row.cell("C").value<xlnt::date>(), xlnt::date(2020, 2, 29));
+        xlnt_assert(row.cell("C").has_format());
+        xlnt_assert_equals(row.cell("D").data_type(), xlnt::cell_type::error);
+        xlnt_assert_equals(row.cell("D").value<std::string>(), "#N/A");
+
+        xlnt_assert(reader.read_row(row));
+        xlnt_assert_equals(row.row(), 4);
+        xlnt_assert_equals(row.size(), 1);
+        xlnt_assert_equals(row[0].value<std::string>(), "other");
+        xlnt_assert(wb.format(row[0].format_id()).font().bold());
+
+        xlnt_assert(!reader.read_row(row));
+        xlnt_assert(row.empty());
+        xlnt_assert(!reader.read_row(row));
+    }
+
+    void test_streaming_worksheet_cursors()
+    {
+        const auto rows = xlnt::row_t(5000);
+
+        xlnt::workbook wb;
+        wb.active_sheet().title("s0");
+        wb.create_sheet().title("s1");
+        wb.create_sheet().title("s2");
+
+        for (auto sheet = std::size_t(0); sheet < 3; ++sheet)
+        {
+            auto ws = wb.sheet_by_index(sheet);
+
+            for (auto row = xlnt::row_t(1); row <= rows; ++row)
+            {
+                ws.cell(1, row).value(static_cast<int>(row * (sheet + 1)));
+                ws.cell(2, row).value("sheet " + std::to_string(sheet) + " row " + std::to_string(row));
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        auto check_row = [](const xlnt::row_view &row, std::size_t sheet) {
+            return row.size() == 2
+                && row[0].value<int>() == static_cast<int>(row.row() * (sheet + 1))
+                && row[1].value<std::string>() == "sheet " + std::to_string(sheet) + " row " + std::to_string(row.row());
+        };
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+
+        // interleaved on one thread, alongside the reader's own worksheet
+        {
+            std::vector<xlnt::streaming_worksheet_cursor> cursors;
+            cursors.push_back(reader.open_worksheet_cursor("s0"));
+            cursors.push_back(reader.open_worksheet_cursor("s1"));
+            cursors.push_back(reader.open_worksheet_cursor("s2"));
+            xlnt_assert_equals(cursors[1].title(), "s1");
+            xlnt_assert_throws(reader.open_worksheet_cursor("missing"), xlnt::exception);
+
+            reader.begin_worksheet("s2");
+            xlnt::row_view row;
+            auto matches = std::size_t(0);
+
+            for (auto i = xlnt::row_t(1); i <= rows; ++i)
+            {
+                for (auto sheet = std::size_t(0); sheet < 3; ++sheet)
+                {
+                    matches += cursors[sheet].read_row(row) && row.row() == i && check_row(row, sheet);
+                }
+
+                matches += reader.has_cell() && reader.read_cell().value<int>() == static_cast<int>(i * 3);
+                matches += reader.has_cell() && reader.read_cell().reference() == xlnt::cell_reference(2, i);
+            }
+
+            xlnt_assert_equals(matches, rows * 5);
+            xlnt_assert(!cursors[0].read_row(row));
+            xlnt_assert(!reader.has_cell());
+            reader.end_worksheet();
+        }
+
+        // one thread per worksheet
+        {
+            std::vector<xlnt::streaming_worksheet_cursor> cursors;
+            std::vector<std::size_t> matches(3, 0);
+            std::vector<std::thread> threads;
+
+            for (auto sheet = std::size_t(0); sheet < 3; ++sheet)
+            {
+                cursors.push_back(reader.open_worksheet_cursor("s" + std::to_string(sheet)));
+            }
+
+            for (auto sheet = std::size_t(0); sheet < 3; ++sheet)
+            {
+                threads.emplace_back([&, sheet]() {
+                    xlnt::row_view row;
+
+                    while (cursors[sheet].read_row(row))
+                    {
+                        matches[sheet] += check_row(row, sheet);
+                    }
+                });
+            }
+
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+
+            xlnt_assert_equals(matches, std::vector<std::size_t>(3, rows));
+        }
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -714,6 +893,125 @@ public:
         c3.value("C3!");
     }
 
+    void test_streaming_worksheet_writers()
+    {
+        const auto rows = xlnt::row_t(2000);
+        const auto bold = xlnt::font().bold(true);
+        const auto percent = xlnt::number_format::percentage_00();
+        const auto custom = xlnt::number_format("0.000");
+
+        std::vector<std::uint8_t> data;
+
+        // a cell handle stops writing to its cell once the next cell is added
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(data);
+            writer.add_worksheet("stream");
+
+            auto b2 = writer.add_cell("B2");
+            b2.value("B2!");
+
+            auto c3 = writer.add_cell("C3");
+            b2.value("should not change");
+            c3.value("C3!");
+        }
+
+        {
+            xlnt::workbook streamed;
+            streamed.load(data);
+            auto ws = streamed.sheet_by_title("stream");
+            xlnt_assert_equals(ws.cell("B2").value<std::string>(), "B2!");
+            xlnt_assert_equals(ws.cell("C3").value<std::string>(), "C3!");
+        }
+
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(data);
+
+            std::vector<xlnt::streaming_worksheet_writer> sheets;
+
+            for (auto sheet = std::size_t(0); sheet < 2; ++sheet)
+            {
+                sheets.push_back(writer.add_worksheet_writer("s" + std::to_string(sheet)));
+            }
+
+            sheets[1].worksheet().column_properties("B").width = 30.0;
+
+            // assertions throw, so the workers only record whether out of order cells were rejected
+            std::vector<int> rejected(3, 0);
+
+            auto fill = [&](xlnt::streaming_worksheet_writer sheet, std::size_t index) {
+                for (auto row = xlnt::row_t(1); row <= rows; ++row)
+                {
+                    auto number = sheet.add_cell(xlnt::cell_reference(1, row));
+                    number.value(static_cast<int>(row * (index + 1)));
+                    number.number_format(row % 2 == 0 ? percent : custom);
+
+                    auto text = sheet.add_cell(xlnt::cell_reference(2, row));
+                    text.value("row " + std::to_string(row % 100));
+
+                    if (row % 3 == 0)
+                    {
+                        text.font(bold);
+                    }
+                }
+
+                try
+                {
+                    sheet.add_cell("A1");
+                }
+                catch (const xlnt::invalid_parameter &)
+                {
+                    rejected[index] = 1;
+                }
+            };
+
+            std::vector<std::thread> threads;
+
+            for (auto sheet = std::size_t(0); sheet < sheets.size(); ++sheet)
+            {
+                threads.emplace_back(fill, sheets[sheet], sheet);
+            }
+
+            // a sheet can be added while the others are being filled
+            sheets.push_back(writer.add_worksheet_writer("s2"));
+            threads.emplace_back(fill, sheets[2], 2);
+
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+
+            xlnt_assert(rejected == std::vector<int>(3, 1));
+        }
+
+        xlnt::workbook wb;
+        wb.load(data);
+        xlnt_assert_equals(wb.sheet_count(), 3);
+        xlnt_assert(wb.sheet_by_index(1).has_column_properties("B"));
+
+        for (auto sheet = std::size_t(0); sheet < 3; ++sheet)
+        {
+            auto ws = wb.sheet_by_index(sheet);
+            xlnt_assert_equals(ws.title(), "s" + std::to_string(sheet));
+            xlnt_assert_equals(ws.highest_row(), rows);
+
+            for (auto row = xlnt::row_t(1); row <= rows; ++row)
+            {
+                auto number = ws.cell(1, row);
+                xlnt_assert_equals(number.value<int>(), static_cast<int>(row * (sheet + 1)));
+                xlnt_assert_equals(number.number_format().format_string(),
+                    (row % 2 == 0 ? percent : custom).format_string());
+
+                auto text = ws.cell(2, row);
+                xlnt_assert_equals(text.value<std::string>(), "row " + std::to_string(row % 100));
+                xlnt_assert_equals(text.has_format() && text.font().bold(), row % 3 == 0);
+            }
+        }
+
+        xlnt_assert_equals(wb.shared_strings().size(), 100);
+    }
+
     void test_load_save_german_locale()
     {
         /* std::locale current(std::locale::global(std::locale("de-DE")));
@@ -756,6 +1054,26 @@ public:
         xlnt_assert(!wbr.has_cell());
     }
 
+    void test_Issue492_stream_empty_row_rows()
+    {
+        xlnt::streaming_workbook_reader wbr;
+        wbr.open(path_helper::test_file("Issue492_empty_row.xlsx"));
+        wbr.begin_worksheet("BLS Data Series");
+
+        xlnt::row_view row;
+        std::vector<std::string> references;
+
+        while (wbr.read_row(row))
+        {
+            for (const auto &cell : row)
+            {
+                references.push_back(cell.reference().to_string());
+            }
+        }
+
+        xlnt_assert_equals(references, std::vector<std::string>({"A1", "A2", "A4", "B4"}));
+    }
+
     void test_Issue503_external_link_load()
     {
         xlnt::workbook wb;
@@ -764,6 +1082,768 @@ public:
         auto cell = ws.cell("A1");
         xlnt_assert_equals(cell.value<std::string>(), std::string("WDG_IC_00000003.aut"));
     }
+
+    void test_cached_parts()
+    {
+        // repeated saves share the cached theme and stay byte for byte equal
+        std::vector<std::uint8_t> first;
+        xlnt::workbook().save(first);
+        std::vector<std::uint8_t> second;
+        xlnt::workbook().save(second);
+        xlnt_assert(first == second);
+
+        // changed styles and properties must not be served from an earlier save
+        xlnt::workbook wb;
+        wb.active_sheet().cell("A1").value("styled");
+        wb.active_sheet().cell("A1").font(xlnt::font().name("Arial").bold(true));
+        wb.core_property(xlnt::core_property::title, "cached");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        xlnt_assert_equals(loaded.active_sheet().cell("A1").font().name(), "Arial");
+        xlnt_assert(loaded.active_sheet().cell("A1").font().bold());
+        xlnt_assert_equals(loaded.core_property(xlnt::core_property::title).get<std::string>(), "cached");
+
+        xlnt::workbook().save(second);
+        xlnt_assert(first == second);
+
+        // properties are written from the workbook on every save
+        for (auto title = 0; title < 100; ++title)
+        {
+            xlnt::workbook unique;
+            unique.core_property(xlnt::core_property::title, "title " + std::to_string(title));
+            unique.save(data);
+
+            loaded.load(data);
+            xlnt_assert_equals(loaded.core_property(xlnt::core_property::title).get<std::string>(),
+                "title " + std::to_string(title));
+        }
+
+        xlnt::workbook().save(second);
+        xlnt_assert(first == second);
+    }
+
+    // Returns a copy of the archive in data with the shared strings part replaced by shared_strings
+    std::vector<std::uint8_t> replace_shared_strings(const std::vector<std::uint8_t> &data, const std::string &shared_strings)
+    {
+        xlnt::detail::vector_istreambuf source_buffer(data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream source(source_stream);
+
+        std::vector<std::uint8_t> result;
+        {
+            xlnt::detail::vector_ostreambuf result_buffer(result);
+            std::ostream result_stream(&result_buffer);
+            xlnt::detail::ozstream archive(result_stream);
+
+            for (const auto &file : source.files())
+            {
+                const auto content = file.string() == "xl/sharedStrings.xml" ? shared_strings : source.read(file);
+                auto file_buffer = archive.open(file);
+                file_buffer->sputn(content.data(), static_cast<std::streamsize>(content.size()));
+            }
+        }
+
+        return result;
+    }
+
+    void test_shared_string_scanner()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().cell("A1").value("placeholder");
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        const std::string entries =
+            "<si><t>a &lt;b&gt; &amp; &quot;c&quot; &apos;d&apos;</t></si>"
+            "<si><t xml:space=\"preserve\"> padded </t></si>"
+            "<si><t>line1\r\nline2\rline3</t></si>"
+            "<si><t>&#65;&#x42;&#x20AC;&#x1F600;</t></si>"
+            "<si><r><rPr><b/><sz val=\"11\"/></rPr><t>bold</t></r><r><t xml:space=\"preserve\"> plain</t></r></si>"
+            "<si><t/></si>"
+            "<si>\n  <t>spaced</t>\n</si>"
+            "<si><t><![CDATA[<cdata>]]></t></si>"
+            "<si><t>\xe5\x8f\x96\xe5\xbc\x95</t><rPh sb=\"0\" eb=\"2\"><t>\xe3\x83\x88\xe3\x83\xaa</t></rPh></si>"
+            "<si><t>last</t></si>";
+        const std::string sst = "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+                                " count=\"10\" uniqueCount=\"10\">" + entries + "</sst>";
+
+        // the comment before the root element is not handled by the scanner, so this goes through the parser
+        xlnt::workbook parsed;
+        parsed.load(replace_shared_strings(data, "<!-- parser -->" + sst));
+
+        xlnt::workbook scanned;
+        scanned.load(replace_shared_strings(data,
+            "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n" + sst));
+
+        const auto &expected = parsed.shared_strings();
+        const auto &actual = scanned.shared_strings();
+        xlnt_assert_equals(actual.size(), 10);
+        xlnt_assert_equals(expected.size(), 10);
+
+        for (auto i = std::size_t(0); i < expected.size(); ++i)
+        {
+            xlnt_assert_equals(actual[i], expected[i]);
+        }
+
+        xlnt_assert_equals(actual[0].plain_text(), "a <b> & \"c\" 'd'");
+        xlnt_assert_equals(actual[1].runs().front().preserve_space, true);
+        xlnt_assert_equals(actual[2].plain_text(), "line1\nline2\nline3");
+        xlnt_assert_equals(actual[3].plain_text(), "AB\xe2\x82\xac\xf0\x9f\x98\x80");
+        xlnt_assert_equals(actual[4].runs().size(), 2);
+        xlnt_assert(actual[4].runs()[0].second.get().bold());
+        xlnt_assert_equals(actual[5], std::string());
+        xlnt_assert_equals(actual[6], std::string("spaced"));
+        xlnt_assert_equals(actual[7], std::string("<cdata>"));
+        xlnt_assert_equals(actual[8].phonetic_runs().size(), 1);
+
+        // strings read in bulk are still found when adding more
+        xlnt_assert_equals(scanned.add_shared_string(xlnt::rich_text("last")), 9);
+        xlnt_assert_equals(scanned.add_shared_string(xlnt::rich_text("new")), 10);
+
+        xlnt_assert_throws(scanned.load(replace_shared_strings(data,
+                               "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+                               " uniqueCount=\"11\">" + entries + "</sst>")),
+            xlnt::invalid_file);
+
+        // a count far larger than the part can hold is reported without reserving for it
+        xlnt_assert_throws(scanned.load(replace_shared_strings(data,
+                               "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+                               " uniqueCount=\"999999999999999\">" + entries + "</sst>")),
+            xlnt::invalid_file);
+    }
+
+    void test_string_storage()
+    {
+        const auto rows = xlnt::row_t(2000);
+
+        auto shared_strings_part = [](const std::vector<std::uint8_t> &data) {
+            xlnt::detail::vector_istreambuf buffer(data);
+            std::istream stream(&buffer);
+            return xlnt::detail::izstream(stream).read(xlnt::path("xl/sharedStrings.xml"));
+        };
+
+        auto check_values = [&](const xlnt::worksheet &ws) {
+            for (auto row = xlnt::row_t(1); row <= rows; ++row)
+            {
+                xlnt_assert_equals(ws.cell(1, row).value<std::string>(), "id-" + std::to_string(row));
+                xlnt_assert_equals(ws.cell(2, row).value<std::string>(), "category " + std::to_string(row % 3));
+                xlnt_assert_equals(ws.cell(2, row).data_type(), xlnt::cell_type::shared_string);
+            }
+        };
+
+        {
+            xlnt::workbook wb;
+            wb.default_string_storage(xlnt::string_storage::adaptive);
+            auto ws = wb.active_sheet();
+            ws.column_string_storage("C", xlnt::string_storage::inline_string);
+            xlnt_assert_equals(ws.column_string_storage("A"), xlnt::string_storage::adaptive);
+            xlnt_assert_equals(ws.column_string_storage("C"), xlnt::string_storage::inline_string);
+
+            // the storage of a column is part of what makes two worksheets equal
+            xlnt::detail::worksheet_impl original(&wb, 1, "storage");
+            original.column_string_storage_[xlnt::column_t("C")] = xlnt::string_storage::inline_string;
+            xlnt::detail::worksheet_impl copy(original);
+            xlnt_assert(copy == original);
+            copy.column_string_storage_[xlnt::column_t("C")] = xlnt::string_storage::shared;
+            xlnt_assert(!(copy == original));
+
+            // strings assigned before a column is made inline are still written inline
+            ws.cell("D1").value("before");
+            ws.column_string_storage("D", xlnt::string_storage::inline_string);
+
+            for (auto row = xlnt::row_t(1); row <= rows; ++row)
+            {
+                ws.cell(1, row).value("id-" + std::to_string(row));
+                ws.cell(2, row).value("category " + std::to_string(row % 3));
+            }
+
+            ws.cell("C1").value("direct");
+            xlnt_assert_equals(ws.cell("C1").data_type(), xlnt::cell_type::inline_string);
+            xlnt_assert_equals(ws.cell("D1").data_type(), xlnt::cell_type::shared_string);
+
+            std::vector<std::uint8_t> data;
+            wb.save(data);
+
+            // only the repetitive column is left in the shared string table
+            const auto shared_strings = shared_strings_part(data);
+            xlnt_assert(shared_strings.find("uniqueCount=\"3\"") != std::string::npos);
+            xlnt_assert(shared_strings.find("count=\"2000\"") != std::string::npos);
+            xlnt_assert(shared_strings.find("id-") == std::string::npos);
+
+            xlnt::workbook loaded;
+            loaded.load(data);
+            check_values(loaded.active_sheet());
+            xlnt_assert_equals(loaded.active_sheet().cell("A1").data_type(), xlnt::cell_type::inline_string);
+            xlnt_assert_equals(loaded.active_sheet().cell("C1").value<std::string>(), "direct");
+            xlnt_assert_equals(loaded.active_sheet().cell("D1").value<std::string>(), "before");
+        }
+
+        {
+            // the streaming writer samples adaptive columns before moving them out of the table
+            std::vector<std::uint8_t> data;
+
+            {
+                xlnt::streaming_workbook_writer writer;
+                writer.open(data);
+                auto ws = writer.add_worksheet("stream");
+                ws.workbook().default_string_storage(xlnt::string_storage::adaptive);
+
+                for (auto row = xlnt::row_t(1); row <= rows; ++row)
+                {
+                    writer.add_cell(xlnt::cell_reference(1, row)).value("id-" + std::to_string(row));
+                    writer.add_cell(xlnt::cell_reference(2, row)).value("category " + std::to_string(row % 3));
+                }
+            }
+
+            xlnt::workbook loaded;
+            loaded.load(data);
+            check_values(loaded.active_sheet());
+            xlnt_assert_equals(loaded.active_sheet().cell(1, rows).data_type(), xlnt::cell_type::inline_string);
+            xlnt_assert(loaded.shared_strings().size() < 1100);
+        }
+    }
+
+    // A streambuf over bytes which, like a pipe or a socket, can't seek
+    class forward_only_streambuf : public std::streambuf
+    {
+    public:
+        forward_only_streambuf(const std::vector<std::uint8_t> &data)
+        {
+            auto begin = reinterpret_cast<char *>(const_cast<std::uint8_t *>(data.data()));
+            setg(begin, begin, begin + data.size());
+        }
+    };
+
+    // Returns a copy of the archive in data whose files keep their CRC and sizes in
+    // data descriptors after their data, as written by streaming ZIP writers
+    std::vector<std::uint8_t> with_data_descriptors(const std::vector<std::uint8_t> &data)
+    {
+        auto field = [&data](std::size_t offset, std::size_t size) {
+            auto value = std::uint32_t(0);
+            std::memcpy(&value, data.data() + offset, size);
+            return value;
+        };
+
+        std::vector<std::uint8_t> result;
+        auto offset = std::size_t(0);
+        auto signed_descriptor = true;
+
+        while (field(offset, 4) == 0x04034b50)
+        {
+            const auto compressed_size = field(offset + 18, 4);
+            const auto header_size = 30 + field(offset + 26, 2) + field(offset + 28, 2);
+            std::vector<std::uint8_t> descriptor(data.begin() + static_cast<std::ptrdiff_t>(offset + 14),
+                data.begin() + static_cast<std::ptrdiff_t>(offset + 26));
+
+            result.insert(result.end(), data.begin() + static_cast<std::ptrdiff_t>(offset),
+                data.begin() + static_cast<std::ptrdiff_t>(offset + header_size + compressed_size));
+
+            auto local_header = result.end() - static_cast<std::ptrdiff_t>(header_size + compressed_size);
+            local_header[6] |= 0x08;
+            std::fill(local_header + 14, local_header + 26, std::uint8_t(0));
+
+            // the descriptor's signature is optional, so alternate between both forms
+            if (signed_descriptor)
+            {
+                const std::uint8_t signature[] = {0x50, 0x4b, 0x07, 0x08};
+                result.insert(result.end(), signature, signature + 4);
+            }
+
+            result.insert(result.end(), descriptor.begin(), descriptor.end());
+            signed_descriptor = !signed_descriptor;
+            offset += header_size + compressed_size;
+        }
+
+        // the central directory isn't read forward only, an empty one ends the archive
+        std::vector<std::uint8_t> end_of_directory(22, 0);
+        end_of_directory[0] = 0x50;
+        end_of_directory[1] = 0x4b;
+        end_of_directory[2] = 0x05;
+        end_of_directory[3] = 0x06;
+        result.insert(result.end(), end_of_directory.begin(), end_of_directory.end());
+
+        return result;
+    }
+
+    void test_forward_only_read()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("first");
+        wb.create_sheet().title("second");
+
+        for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+            ws.cell(2, row).value(static_cast<int>(row));
+        }
+
+        wb.sheet_by_title("second").cell("B2").value("second B2");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        auto check = [](const xlnt::workbook &loaded) {
+            const auto first = loaded.sheet_by_title("first");
+
+            for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+            {
+                xlnt_assert_equals(first.cell(1, row).value<std::string>(), "row " + std::to_string(row));
+                xlnt_assert_equals(first.cell(2, row).value<int>(), static_cast<int>(row));
+            }
+
+            xlnt_assert_equals(loaded.sheet_by_title("second").cell("B2").value<std::string>(), "second B2");
+        };
+
+        for (const auto &archive : {data, with_data_descriptors(data)})
+        {
+            forward_only_streambuf buffer(archive);
+            std::istream stream(&buffer);
+            xlnt_assert_equals(stream.tellg(), std::streampos(-1));
+
+            xlnt::workbook loaded;
+            loaded.load(stream);
+            check(loaded);
+
+            forward_only_streambuf streaming_buffer(archive);
+            std::istream streaming_stream(&streaming_buffer);
+            xlnt::streaming_workbook_reader reader;
+            reader.open(streaming_stream);
+            reader.begin_worksheet("second");
+            xlnt_assert(reader.has_cell());
+            xlnt_assert_equals(reader.read_cell().value<std::string>(), "second B2");
+            xlnt_assert(!reader.has_cell());
+            reader.end_worksheet();
+        }
+
+        // files are the same whether read directly, after being passed or from a seekable archive
+        xlnt::detail::vector_istreambuf seekable_buffer(data);
+        std::istream seekable_stream(&seekable_buffer);
+        xlnt::detail::izstream seekable(seekable_stream);
+
+        forward_only_streambuf buffer(data);
+        std::istream stream(&buffer);
+        xlnt::detail::izstream archive(stream);
+
+        const auto workbook_xml = archive.read(xlnt::path("xl/workbook.xml"));
+        xlnt_assert_equals(workbook_xml, seekable.read(xlnt::path("xl/workbook.xml")));
+        xlnt_assert_equals(archive.read(xlnt::path("[Content_Types].xml")),
+            seekable.read(xlnt::path("[Content_Types].xml")));
+        xlnt_assert(archive.has_file(xlnt::path("xl/worksheets/sheet2.xml")));
+        xlnt_assert(!archive.has_file(xlnt::path("xl/missing.xml")));
+        xlnt_assert_equals(archive.files().size(), seekable.files().size());
+        xlnt_assert_throws(archive.open(xlnt::path("xl/missing.xml")), xlnt::exception);
+
+        // passed files are only kept until they were read and files read as they arrive aren't kept
+        xlnt_assert_throws(archive.read(xlnt::path("xl/workbook.xml")), xlnt::exception);
+
+        forward_only_streambuf direct_buffer(data);
+        std::istream direct_stream(&direct_buffer);
+        xlnt::detail::izstream direct(direct_stream);
+        xlnt_assert_equals(direct.read(xlnt::path("[Content_Types].xml")),
+            seekable.read(xlnt::path("[Content_Types].xml")));
+        xlnt_assert_equals(direct.read(xlnt::path("xl/workbook.xml")), workbook_xml);
+        xlnt_assert_throws(direct.read(xlnt::path("[Content_Types].xml")), xlnt::exception);
+    }
+
+    // A streambuf which, like a pipe or a socket, appends what it is given and can't seek
+    class forward_only_sink : public std::streambuf
+    {
+    public:
+        std::vector<std::uint8_t> data;
+
+    protected:
+        int overflow(int c) override
+        {
+            if (c != traits_type::eof())
+            {
+                data.push_back(static_cast<std::uint8_t>(c));
+            }
+
+            return traits_type::not_eof(c);
+        }
+    };
+
+    void test_forward_only_write()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("first");
+
+        for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+            ws.cell(2, row).value(static_cast<int>(row));
+        }
+
+        auto check = [](const std::vector<std::uint8_t> &data) {
+            // every file is flagged as followed by a data descriptor
+            xlnt_assert_equals(data[6] & 0x08, 0x08);
+
+            xlnt::workbook loaded;
+            loaded.load(data);
+            const auto first = loaded.sheet_by_title("first");
+            xlnt_assert_equals(first.cell(1, 1000).value<std::string>(), "row 1000");
+            xlnt_assert_equals(first.cell(2, 1000).value<int>(), 1000);
+
+            forward_only_streambuf buffer(data);
+            std::istream stream(&buffer);
+            xlnt::workbook forward;
+            forward.load(stream);
+            xlnt_assert_equals(forward.sheet_by_title("first").cell(1, 500).value<std::string>(), "row 500");
+        };
+
+        forward_only_sink sink;
+        std::ostream destination(&sink);
+        xlnt_assert_equals(destination.tellp(), std::streampos(-1));
+        wb.save(destination);
+        xlnt_assert(destination.good());
+        check(sink.data);
+
+        forward_only_sink streaming_sink;
+
+        {
+            std::ostream streaming_destination(&streaming_sink);
+            xlnt::streaming_workbook_writer writer;
+            writer.open(streaming_destination);
+            writer.add_worksheet("first");
+
+            for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+            {
+                writer.add_cell(xlnt::cell_reference(1, row)).value("row " + std::to_string(row));
+                writer.add_cell(xlnt::cell_reference(2, row)).value(static_cast<int>(row));
+            }
+        }
+
+        check(streaming_sink.data);
+    }
+
+    void test_snapshot()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("first");
+
+        for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+            ws.cell(2, row).value(static_cast<int>(row));
+        }
+
+        ws.cell("C1").value(true);
+        ws.cell("C2").value(xlnt::date(2020, 1, 2));
+        ws.cell("C3").formula("=SUM(B1:B1000)");
+        ws.cell("C4").value("trailing ");
+        ws.cell("C5").value(xlnt::rich_text("bold", xlnt::font().bold(true)));
+        ws.cell("C6").comment(xlnt::comment("only a comment", "author"));
+        ws.cell("C7").hyperlink("https://example.com/");
+        ws.cell("C8").font(xlnt::font().italic(true));
+        ws.merge_cells("D1:E2");
+        ws.row_properties(3).height = 30.0;
+
+        auto second = wb.create_sheet();
+        second.title("second");
+        second.cell("A1").value(xlnt::rich_text("shared bold", xlnt::font().bold(true)));
+        wb.add_shared_string(xlnt::rich_text("shared plain"));
+
+        const auto strings = wb.shared_strings();
+
+        auto check = [&strings](xlnt::workbook &loaded) {
+            auto first = loaded.sheet_by_title("first");
+            xlnt_assert_equals(first.cell(1, 1000).value<std::string>(), "row 1000");
+            xlnt_assert_equals(first.cell(2, 1000).value<int>(), 1000);
+            xlnt_assert_equals(first.cell("C1").data_type(), xlnt::cell::type::boolean);
+            xlnt_assert_equals(first.cell("C2").value<xlnt::date>(), xlnt::date(2020, 1, 2));
+            xlnt_assert_equals(first.cell("C3").formula(), "SUM(B1:B1000)");
+            xlnt_assert_equals(first.cell("C4").value<std::string>(), "trailing ");
+            xlnt_assert(first.cell("C5").value<xlnt::rich_text>().runs().front().second.get().bold());
+            xlnt_assert_equals(first.cell("C6").data_type(), xlnt::cell::type::empty);
+            xlnt_assert_equals(first.cell("C6").comment().plain_text(), "only a comment");
+            xlnt_assert_equals(first.cell("C7").hyperlink().url(), "https://example.com/");
+            xlnt_assert_equals(first.cell("C7").hyperlink().display(), "https://example.com/");
+            xlnt_assert(first.cell("C8").font().italic());
+            xlnt_assert(first.cell("E2").is_merged());
+            xlnt_assert_equals(first.merged_ranges().size(), 1);
+            xlnt_assert_equals(first.row_properties(3).height.get(), 30.0);
+            xlnt_assert(!first.has_row_properties(6));
+            xlnt_assert(loaded.sheet_by_title("second").cell("A1").value<xlnt::rich_text>().runs().front().second.get().bold());
+            xlnt_assert_equals(loaded.shared_strings().size(), strings.size());
+            xlnt_assert_equals(loaded.shared_strings().back(), strings.back());
+        };
+
+        std::vector<std::uint8_t> data;
+        wb.save_snapshot(data);
+
+        // taking a snapshot only reads the workbook, so several can be taken at once
+        const auto &const_wb = wb;
+        std::vector<std::uint8_t> concurrent;
+        std::thread other([&const_wb, &concurrent]() { const_wb.save_snapshot(concurrent); });
+        std::vector<std::uint8_t> alongside;
+        const_wb.save_snapshot(alongside);
+        other.join();
+        xlnt_assert(concurrent == data);
+        xlnt_assert(alongside == data);
+        xlnt_assert_equals(ws.cell(1, 1000).value<std::string>(), "row 1000");
+        xlnt_assert(ws.cell("C6").has_comment());
+        xlnt_assert_equals(wb.shared_strings(), strings);
+
+        xlnt::workbook loaded;
+        loaded.load_snapshot(data);
+        check(loaded);
+
+        xlnt::workbook paged;
+        paged.max_resident_cells(256);
+        paged.load_snapshot(data);
+        check(paged);
+
+        // a snapshot of a snapshot reads back the same
+        std::vector<std::uint8_t> again;
+        loaded.save_snapshot(again);
+        xlnt::workbook reloaded;
+        reloaded.load_snapshot(again);
+        check(reloaded);
+        xlnt_assert(reloaded.sheet_by_title("first").diff(loaded.sheet_by_title("first")).empty());
+
+        auto corrupt = data;
+        corrupt[corrupt.size() / 2] ^= 0xff;
+        xlnt_assert_throws(xlnt::workbook().load_snapshot(corrupt), xlnt::invalid_file);
+
+        std::vector<std::uint8_t> xlsx;
+        wb.save(xlsx);
+        xlnt_assert_throws(xlnt::workbook().load_snapshot(xlsx), xlnt::invalid_file);
+    }
+
+    void test_xlsb()
+    {
+        xlnt::workbook wb;
+        wb.base_date(xlnt::calendar::mac_1904);
+        auto ws = wb.active_sheet();
+        ws.title("first");
+
+        for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("row " + std::to_string(row));
+            ws.cell(2, row).value(static_cast<int>(row) - 500);
+        }
+
+        ws.cell("C1").value(true);
+        ws.cell("C2").value(3.14159265358979);
+        ws.cell("C3").value(12.34);
+        ws.cell("C4").value(1e300);
+        ws.cell("C5").error("#DIV/0!");
+        ws.cell("C6").value(u8"été 日本");
+        ws.cell("C7").formula("=SUM(B1:B1000)");
+        ws.cell("C7").value(500);
+        ws.cell("C8").font(xlnt::font().italic(true).bold(true).name("Arial").size(14));
+        ws.cell("C9").fill(xlnt::fill::solid(xlnt::rgb_color(0xff, 0, 0)));
+        ws.cell("C10").border(xlnt::border().side(xlnt::border_side::bottom,
+            xlnt::border::border_property().style(xlnt::border_style::thick)));
+        ws.cell("C11").value(xlnt::date(2020, 1, 2));
+        ws.cell("C12").number_format(xlnt::number_format("0.000%"));
+        ws.cell("C12").value(0.5);
+        ws.merge_cells("D1:E2");
+        ws.row_properties(3).height = 30.0;
+        ws.row_properties(3).custom_height = true;
+        ws.row_properties(2000).hidden = true;
+        ws.column_properties(xlnt::column_t("B")).width = 20.0;
+        ws.column_properties(xlnt::column_t("B")).custom_width = true;
+
+        auto second = wb.create_sheet();
+        second.title("second");
+        second.cell("A1").value("row 1");
+        xlnt::page_setup setup;
+        setup.sheet_state(xlnt::sheet_state::hidden);
+        second.page_setup(setup);
+
+        auto check = [](xlnt::workbook &loaded) {
+            xlnt_assert_equals(loaded.base_date(), xlnt::calendar::mac_1904);
+            xlnt_assert_equals(loaded.sheet_titles(), std::vector<std::string>({"first", "second"}));
+
+            auto first = loaded.sheet_by_title("first");
+            xlnt_assert_equals(first.cell(1, 1000).value<std::string>(), "row 1000");
+            xlnt_assert_equals(first.cell(2, 1).value<int>(), -499);
+            xlnt_assert_equals(first.cell(2, 1000).value<int>(), 500);
+            xlnt_assert_equals(first.cell("C1").data_type(), xlnt::cell::type::boolean);
+            xlnt_assert(first.cell("C1").value<bool>());
+            xlnt_assert_equals(first.cell("C2").value<double>(), 3.14159265358979);
+            xlnt_assert_equals(first.cell("C3").value<double>(), 12.34);
+            xlnt_assert_equals(first.cell("C4").value<double>(), 1e300);
+            xlnt_assert_equals(first.cell("C5").error(), "#DIV/0!");
+            xlnt_assert_equals(first.cell("C6").value<std::string>(), u8"été 日本");
+            // formulas are compiled in XLSB, so only their values come back
+            xlnt_assert(!first.cell("C7").has_formula());
+            xlnt_assert_equals(first.cell("C7").value<int>(), 500);
+            xlnt_assert(first.cell("C8").font().italic());
+            xlnt_assert(first.cell("C8").font().bold());
+            xlnt_assert_equals(first.cell("C8").font().name(), "Arial");
+            xlnt_assert_equals(first.cell("C8").font().size(), 14.0);
+            xlnt_assert_equals(first.cell("C9").fill().pattern_fill().type(), xlnt::pattern_fill_type::solid);
+            xlnt_assert_equals(first.cell("C9").fill().pattern_fill().foreground().get().rgb().hex_string(), "FFFF0000");
+            xlnt_assert_equals(first.cell("C10").border().side(xlnt::border_side::bottom).get().style().get(),
+                xlnt::border_style::thick);
+            xlnt_assert_equals(first.cell("C11").value<xlnt::date>(), xlnt::date(2020, 1, 2));
+            xlnt_assert_equals(first.cell("C12").number_format().format_string(), "0.000%");
+            xlnt_assert_equals(first.cell("C12").value<double>(), 0.5);
+            xlnt_assert(first.cell("E2").is_merged());
+            xlnt_assert_equals(first.merged_ranges().size(), 1);
+            xlnt_assert_equals(first.row_properties(3).height.get(), 30.0);
+            xlnt_assert(first.row_properties(2000).hidden);
+            xlnt_assert(!first.has_row_properties(6));
+            xlnt_assert_delta(first.column_properties(xlnt::column_t("B")).width.get(), 20.0, 1.0 / 256);
+            xlnt_assert(first.column_properties(xlnt::column_t("B")).custom_width);
+
+            auto second = loaded.sheet_by_title("second");
+            xlnt_assert_equals(second.cell("A1").value<std::string>(), "row 1");
+            xlnt_assert(loaded.sheet_hidden_by_index(1));
+            xlnt_assert_equals(second.page_setup().sheet_state(), xlnt::sheet_state::hidden);
+        };
+
+        std::vector<std::uint8_t> data;
+        wb.save(data, xlnt::file_format::xlsb);
+
+        // the binary parts are records rather than XML
+        {
+            xlnt::detail::vector_istreambuf buffer(data);
+            std::istream stream(&buffer);
+            xlnt::detail::izstream archive(stream);
+            xlnt_assert(archive.has_file(xlnt::path("xl/workbook.bin")));
+            xlnt_assert(archive.has_file(xlnt::path("xl/worksheets/sheet1.bin")));
+            xlnt_assert(!archive.has_file(xlnt::path("xl/workbook.xml")));
+        }
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+        check(loaded);
+
+        xlnt::workbook paged;
+        paged.max_resident_cells(256);
+        paged.load(data);
+        check(paged);
+
+        // an XLSB file is written again as XLSX
+        std::vector<std::uint8_t> xlsx;
+        loaded.save(xlsx);
+        xlnt::workbook converted;
+        converted.load(xlsx);
+        xlnt_assert_equals(converted.sheet_by_title("first").cell(1, 1000).value<std::string>(), "row 1000");
+        xlnt_assert(converted.sheet_by_title("first").cell("C8").font().italic());
+        xlnt_assert_equals(converted.sheet_by_title("second").cell("A1").value<std::string>(), "row 1");
+
+        // paged worksheets are written a block of rows at a time
+        std::vector<std::uint8_t> from_paged;
+        paged.save(from_paged, xlnt::file_format::xlsb);
+        xlnt::workbook reloaded;
+        reloaded.load(from_paged);
+        check(reloaded);
+
+        // XLSB is only written when asked for, not because of the extension of a file name
+        const auto filename = xlnt::path("temp.xlsb");
+        wb.save(filename, xlnt::file_format::xlsb);
+        xlnt::workbook from_file;
+        from_file.load(filename);
+        check(from_file);
+        xlnt_assert_throws(xlnt::streaming_workbook_reader().open(filename), xlnt::invalid_file);
+
+        wb.save(filename);
+        xlnt::streaming_workbook_reader().open(filename);
+        std::remove(filename.string().c_str());
+
+        xlnt_assert_throws(xlnt::streaming_workbook_reader().open(data), xlnt::invalid_file);
+    }
+
+    void test_read_xlsb_file()
+    {
+        // laid out as Excel writes XLSB, with records xlnt doesn't write itself
+        const auto path = path_helper::test_file("17_binary.xlsb");
+
+        auto check = [](xlnt::workbook &wb) {
+            xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"Data", "Hidden"}));
+            xlnt_assert(!wb.sheet_hidden_by_index(0));
+            xlnt_assert(wb.sheet_hidden_by_index(1));
+            xlnt_assert_equals(wb.base_date(), xlnt::calendar::windows_1900);
+            xlnt_assert_equals(wb.sheet_by_index(1).cell("A1").value<std::string>(), "secret");
+
+            auto ws = wb.sheet_by_title("Data");
+
+            xlnt_assert_equals(ws.cell("A1").value<std::string>(), "Name");
+            xlnt_assert(ws.cell("A1").font().bold());
+            xlnt_assert_equals(ws.cell("A1").font().color().rgb().hex_string(), "FFFF0000");
+            xlnt_assert_equals(ws.cell("B1").value<std::string>(), u8"Ångström λ");
+            xlnt_assert_equals(ws.cell("C1").value<std::string>(), "rich");
+            xlnt_assert_equals(ws.cell("D1").value<std::string>(), "bold plain");
+
+            xlnt_assert_equals(ws.cell("A2").value<int>(), 42);
+            xlnt_assert_equals(ws.cell("B2").value<double>(), 1.25);
+            xlnt_assert_equals(ws.cell("B2").number_format().format_string(), "0.000%");
+            xlnt_assert_equals(ws.cell("B2").fill().pattern_fill().type(), xlnt::pattern_fill_type::solid);
+            xlnt_assert_equals(ws.cell("B2").fill().pattern_fill().foreground().get().rgb().hex_string(), "FFFFFF00");
+            xlnt_assert_equals(ws.cell("B2").border().side(xlnt::border_side::top).get().style().get(),
+                xlnt::border_style::thin);
+            xlnt_assert_equals(ws.cell("B2").border().side(xlnt::border_side::top).get().color().get().rgb().hex_string(),
+                "FF0000FF");
+            xlnt_assert_equals(ws.cell("B2").border().side(xlnt::border_side::bottom).get().style().get(),
+                xlnt::border_style::medium);
+            xlnt_assert_equals(ws.cell("B2").border().side(xlnt::border_side::bottom).get().color().get().theme().index(), 4);
+            xlnt_assert_equals(ws.cell("C2").value<double>(), 3.14159);
+            xlnt_assert_equals(ws.cell("D2").value<int>(), 84);
+            xlnt_assert(!ws.cell("D2").has_formula());
+
+            xlnt_assert(ws.cell("A3").value<bool>());
+            xlnt_assert_equals(ws.cell("B3").error(), "#DIV/0!");
+            xlnt_assert_equals(ws.cell("C3").value<std::string>(), "inline text");
+            xlnt_assert_equals(ws.cell("C3").alignment().horizontal().get(), xlnt::horizontal_alignment::center);
+            xlnt_assert_equals(ws.cell("C3").alignment().vertical().get(), xlnt::vertical_alignment::center);
+            xlnt_assert(ws.cell("C3").alignment().wrap());
+            xlnt_assert_equals(ws.cell("D3").value<std::string>(), "x");
+
+            xlnt_assert(ws.cell("A4").is_date());
+            xlnt_assert_equals(ws.cell("A4").value<xlnt::date>(), xlnt::date(2023, 3, 15));
+            xlnt_assert_equals(ws.cell("A4").number_format().format_string(), "yyyy\\-mm\\-dd");
+            xlnt_assert_equals(ws.cell("A4").font().name(), "Arial");
+            xlnt_assert_equals(ws.cell("A4").font().size(), 14.0);
+            xlnt_assert(ws.cell("A4").font().italic());
+            xlnt_assert_equals(ws.cell("A4").font().underline(), xlnt::font::underline_style::single);
+            xlnt_assert_equals(ws.cell("B4").data_type(), xlnt::cell::type::boolean);
+            xlnt_assert(!ws.cell("B4").value<bool>());
+            xlnt_assert_equals(ws.cell("C4").error(), "#N/A");
+
+            xlnt_assert(!ws.cell("A5").has_value());
+            xlnt_assert_equals(ws.cell("A5").fill().pattern_fill().type(), xlnt::pattern_fill_type::solid);
+            xlnt_assert_equals(ws.cell("B5").value<double>(), -0.5);
+            xlnt_assert_equals(ws.merged_ranges().size(), 1);
+            xlnt_assert_equals(ws.merged_ranges().front().to_string(), "C5:D6");
+
+            xlnt_assert_equals(ws.row_properties(3).height.get(), 30.0);
+            xlnt_assert(ws.row_properties(3).custom_height);
+            xlnt_assert(ws.row_properties(4).hidden);
+            xlnt_assert_delta(ws.column_properties("B").width.get(), (20.0 * 7 - 5) / 7, 1.0 / 256);
+            xlnt_assert(ws.column_properties("B").custom_width);
+            xlnt_assert_equals(ws.page_margins().top(), 0.75);
+            xlnt_assert_equals(ws.page_margins().header(), 0.3);
+        };
+
+        xlnt::workbook wb;
+        wb.load(path);
+        check(wb);
+
+        // writing it as XLSB and as XLSX keeps what was read
+        std::vector<std::uint8_t> xlsb;
+        wb.save(xlsb, xlnt::file_format::xlsb);
+        xlnt::workbook from_xlsb;
+        from_xlsb.load(xlsb);
+        check(from_xlsb);
+
+        std::vector<std::uint8_t> xlsx;
+        wb.save(xlsx);
+        xlnt::workbook from_xlsx;
+        from_xlsx.load(xlsx);
+        xlnt_assert_equals(from_xlsx.sheet_by_title("Data").cell("B1").value<std::string>(), u8"Ångström λ");
+        xlnt_assert_equals(from_xlsx.sheet_by_title("Data").cell("B2").number_format().format_string(), "0.000%");
+    }
 };
 
 static serialization_test_suite x;
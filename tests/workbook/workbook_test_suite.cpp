@@ -71,6 +71,8 @@ public:
         register_test(test_Issue279);
         register_test(test_Issue353);
         register_test(test_Issue494);
+        register_test(test_diff);
+        register_test(test_calc_chain_bookkeeping);
     }
 
     void test_active_sheet()
@@ -538,5 +540,115 @@ public:
         xlnt_assert_equals(ws.cell(2, 1).to_string(), "V1.00");
         xlnt_assert_equals(ws.cell(2, 2).to_string(), "V1.00");
     }
+
+    void test_diff()
+    {
+        xlnt::workbook wb1;
+        wb1.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+        xlnt::workbook wb2;
+        wb2.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+
+        for (auto parallel : {false, true})
+        {
+            xlnt_assert(wb1.diff(wb2, parallel).empty());
+        }
+
+        auto title = wb1.sheet_by_index(0).title();
+        wb2.sheet_by_index(0).cell("Z99").value("changed");
+        wb2.create_sheet().title("Added");
+        wb1.create_sheet().title("Removed");
+
+        auto diff = wb1.diff(wb2);
+        xlnt_assert(!diff.styles_changed);
+        xlnt_assert(diff.properties_changed); // sheet order differs
+        xlnt_assert_equals(diff.worksheets.size(), 3);
+        xlnt_assert_equals(diff.worksheets[0].title, title);
+        xlnt_assert_equals(diff.worksheets[0].changed_cells.size(), 1);
+        xlnt_assert_equals(diff.worksheets[0].changed_cells[0].reference, xlnt::cell_reference("Z99"));
+        xlnt_assert_equals(diff.worksheets[1].title, "Removed");
+        xlnt_assert(diff.worksheets[1].removed);
+        xlnt_assert_equals(diff.worksheets[2].title, "Added");
+        xlnt_assert(diff.worksheets[2].added);
+
+        // a format added to only one stylesheet makes formats compare by content
+        xlnt::workbook wb3;
+        wb3.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+        wb3.create_format().font(xlnt::font().bold(true), true);
+        wb3.core_property(xlnt::core_property::title, "Other title");
+
+        auto styled = wb1.diff(wb3);
+        xlnt_assert(styled.styles_changed);
+        xlnt_assert(styled.properties_changed);
+        xlnt_assert_equals(styled.worksheets.size(), 1);
+        xlnt_assert(styled.worksheets[0].removed);
+    }
+
+    void test_calc_chain_bookkeeping()
+    {
+        xlnt::workbook wb;
+        auto has_calc_chain = [](const xlnt::workbook &target) {
+            // the calcChain part is only dropped from the manifest as it is written
+            const auto unchanged = target.manifest();
+            std::vector<std::uint8_t> data;
+            target.save(data);
+            xlnt_assert(target.manifest() == unchanged);
+            xlnt::workbook written;
+            written.load(data);
+            auto wb_rel = written.manifest().relationship(xlnt::path("/"), xlnt::relationship_type::office_document);
+            return written.manifest().has_relationship(wb_rel.target().path(), xlnt::relationship_type::calculation_chain);
+        };
+
+        auto ws1 = wb.active_sheet();
+        auto ws2 = wb.create_sheet();
+        xlnt_assert(!has_calc_chain(wb));
+
+        for (auto row = xlnt::row_t(1); row <= 10; ++row)
+        {
+            ws1.cell(1, row).formula("=B1");
+        }
+        ws1.cell("A1").formula("=B2"); // replacing a formula isn't counted twice
+        ws2.cell("A1").formula("=1+1");
+        xlnt_assert(has_calc_chain(wb));
+
+        // copying a cell with a formula over one without and back again
+        ws1.cell("C1").value(ws1.cell("A1"));
+        ws1.cell("C1").value(ws1.cell("D1"));
+
+        for (auto row = xlnt::row_t(1); row <= 5; ++row)
+        {
+            ws1.cell(1, row).clear_formula();
+        }
+        ws1.clear_cell("A6");
+        ws1.clear_row(7);
+        ws1.delete_rows(8, 2);
+        xlnt_assert(has_calc_chain(wb));
+
+        ws1.cell("A8").clear_formula();
+        xlnt_assert(has_calc_chain(wb)); // still referenced from the second sheet
+        ws2.cell("A1").clear_formula();
+        xlnt_assert(!has_calc_chain(wb));
+
+        ws2.cell("B2").formula("=A1");
+        wb.copy_sheet(ws2);
+        ws2.clear_cell("B2");
+        xlnt_assert(has_calc_chain(wb)); // the copy still has its formula
+
+        // loaded formulae are counted too
+        xlnt::workbook loaded;
+        loaded.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"));
+        loaded.active_sheet().cell("Z1").formula("=1");
+        xlnt_assert(has_calc_chain(loaded));
+        for (auto ws : loaded)
+        {
+            for (auto row : ws.rows(true))
+            {
+                for (auto cell : row)
+                {
+                    cell.clear_formula();
+                }
+            }
+        }
+        xlnt_assert(!has_calc_chain(loaded));
+    }
 };
 static workbook_test_suite x;
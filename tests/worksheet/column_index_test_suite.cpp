@@ -0,0 +1,135 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <helpers/test_suite.hpp>
+#include <xlnt/cell/cell.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/column_index.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+
+class column_index_test_suite : public test_suite
+{
+public:
+    column_index_test_suite()
+    {
+        register_test(test_single_column);
+        register_test(test_multiple_columns);
+        register_test(test_update);
+    }
+
+    void test_single_column()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, row).value("key" + std::to_string(row % 100));
+            ws.cell(2, row).value(static_cast<int>(row));
+        }
+
+        ws.cell("A1001").value(true);
+        ws.cell("C5").value("not a key");
+
+        for (auto parallel : {false, true})
+        {
+            xlnt::column_index by_text(ws, xlnt::column_t("A"), parallel);
+            xlnt_assert_equals(by_text.size(), 1000);
+            xlnt_assert_equals(by_text.find("key7").size(), 10);
+            xlnt_assert_equals(by_text.find("key7").front(), 7);
+            xlnt_assert_equals(by_text.find("key7").back(), 907);
+            xlnt_assert(by_text.find("KEY7").empty());
+            xlnt_assert(!by_text.contains("not a key"));
+            xlnt_assert(!by_text.contains(7));
+
+            xlnt::column_index by_number(ws, xlnt::column_t("B"), parallel);
+            xlnt_assert_equals(by_number.find(500), std::vector<xlnt::row_t>{500});
+            xlnt_assert_equals(by_number.find(500.0), std::vector<xlnt::row_t>{500});
+            xlnt_assert(by_number.find(1001).empty());
+            xlnt_assert(!by_number.contains("500"));
+        }
+    }
+
+    void test_multiple_columns()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").value("north");
+        ws.cell("B1").value(2020);
+        ws.cell("A2").value("north");
+        ws.cell("B2").value(2021);
+        ws.cell("A3").value("south");
+        ws.cell("B3").value(2020);
+        ws.cell("A4").value("north");
+        ws.cell("B5").value(2020);
+
+        xlnt::column_index index(ws, {xlnt::column_t("A"), xlnt::column_t("B")});
+        xlnt_assert_equals(index.find({"north", 2020}), std::vector<xlnt::row_t>{1});
+        xlnt_assert_equals(index.find({"south", 2020}), std::vector<xlnt::row_t>{3});
+        xlnt_assert_equals(index.find({"north", xlnt::index_key()}), std::vector<xlnt::row_t>{4});
+        xlnt_assert_equals(index.find({xlnt::index_key(), 2020}), std::vector<xlnt::row_t>{5});
+        xlnt_assert(index.find({"south", 2021}).empty());
+
+        // rows without any key values aren't indexed, so an all-empty key never matches
+        ws.cell("C6").value("not a key");
+        index.rebuild();
+        xlnt_assert_equals(index.size(), 5);
+        xlnt_assert(index.find({xlnt::index_key(), xlnt::index_key()}).empty());
+        xlnt::column_index single(ws, xlnt::column_t("B"));
+        xlnt_assert(!single.contains(xlnt::index_key()));
+        xlnt_assert_throws(index.find("north"), xlnt::invalid_parameter);
+        xlnt_assert_throws(xlnt::column_index(ws, std::vector<xlnt::column_t>()), xlnt::invalid_parameter);
+    }
+
+    void test_update()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").value("a");
+        ws.cell("A2").value("b");
+
+        xlnt::column_index index(ws, xlnt::column_t("A"));
+        xlnt_assert_equals(index.size(), 2);
+
+        ws.cell("A2").value("a");
+        index.update(2);
+        ws.cell("A10").value("c");
+        index.update(10);
+        xlnt_assert_equals(index.find("a"), (std::vector<xlnt::row_t>{1, 2}));
+        xlnt_assert(index.find("b").empty());
+        xlnt_assert_equals(index.find("c"), std::vector<xlnt::row_t>{10});
+
+        ws.cell("A1").clear_value();
+        index.update(1);
+        xlnt_assert_equals(index.find("a"), std::vector<xlnt::row_t>{2});
+        xlnt_assert_equals(index.size(), 2);
+
+        ws.cell("A3").value("a");
+        index.rebuild();
+        xlnt_assert_equals(index.find("a"), (std::vector<xlnt::row_t>{2, 3}));
+    }
+};
+static column_index_test_suite x;
@@ -21,16 +21,25 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 
 #include <helpers/test_suite.hpp>
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/cell/comment.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <xlnt/styles/alignment.hpp>
 #include <xlnt/styles/font.hpp>
+#include <xlnt/styles/number_format.hpp>
+#include <xlnt/utils/date.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
 #include <xlnt/worksheet/range.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
+#include <detail/parallel.hpp>
 
 class range_test_suite : public test_suite
 {
@@ -40,6 +49,12 @@ public:
         register_test(test_construction);
         register_test(test_batch_formatting);
         register_test(test_clear_cells);
+        register_test(test_statistics);
+        register_test(test_statistics_blocks);
+        register_test(test_sort);
+        register_test(test_sort_rules);
+        register_test(test_sort_nan);
+        register_test(test_auto_fit_columns);
     }
 
     void test_construction()
@@ -114,5 +129,275 @@ public:
         range.clear_cells();
         xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference(1, 1, 1, 3));
     }
+
+    void test_statistics()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1; row <= 100; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row % 10);
+        }
+
+        ws.cell("A101").value("text");
+        ws.cell("A102").value(true);
+        ws.cell("A103").error("#N/A");
+        ws.cell("A104").value(-5.5);
+        ws.cell("B1").value(1000);
+
+        // small range over a larger sheet probes cell by cell
+        auto small = ws.range("A1:A4").statistics();
+        xlnt_assert_equals(small.count, 4);
+        xlnt_assert_equals(small.sum, 10.0);
+        xlnt_assert_equals(small.mean(), 2.5);
+
+        // large range walks the cell storage
+        for (auto parallel : {false, true})
+        {
+            auto stats = ws.range("A1:A200").statistics(parallel);
+            xlnt_assert_equals(stats.count, 101);
+            xlnt_assert_equals(stats.value_count, 104);
+            xlnt_assert_equals(stats.distinct_count, 11);
+            xlnt_assert_delta(stats.sum, 444.5, 1E-9);
+            xlnt_assert_equals(stats.minimum.get(), -5.5);
+            xlnt_assert_equals(stats.maximum.get(), 9.0);
+        }
+
+        auto empty = ws.range("D1:D10").statistics();
+        xlnt_assert_equals(empty.count, 0);
+        xlnt_assert(!empty.minimum.is_set());
+        xlnt_assert_throws(empty.mean(), xlnt::invalid_attribute);
+    }
+
+    void test_statistics_blocks()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+
+        for (auto row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row % 7 == 0 ? nan : static_cast<double>(row % 50));
+            ws.cell(2, static_cast<xlnt::row_t>(row)).value(row);
+        }
+
+        // split even small ranges into several blocks so that merging the blocks is covered
+        for (auto reference : {"A1:A1000", "A1:B1000", "A1:C2000"})
+        {
+            const auto serial = ws.range(reference).statistics();
+            xlnt::detail::scoped_parallel_block_count blocks(4);
+            const auto parallel = ws.range(reference).statistics(true);
+
+            xlnt_assert_equals(parallel.count, serial.count);
+            xlnt_assert_equals(parallel.value_count, serial.value_count);
+            xlnt_assert_equals(parallel.distinct_count, serial.distinct_count);
+            xlnt_assert_equals(parallel.minimum.get(), serial.minimum.get());
+            xlnt_assert_equals(parallel.maximum.get(), serial.maximum.get());
+        }
+
+        // NaN is skipped by minimum and maximum and counted once among the distinct values
+        const auto stats = ws.range("A1:A1000").statistics();
+        xlnt_assert_equals(stats.count, 1000);
+        xlnt_assert_equals(stats.distinct_count, 51);
+        xlnt_assert_equals(stats.minimum.get(), 0.0);
+        xlnt_assert_equals(stats.maximum.get(), 49.0);
+    }
+
+    void test_sort()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        const std::vector<std::pair<std::string, int>> data = {
+            {"banana", 3}, {"apple", 2}, {"cherry", 1}, {"apple", 1}, {"banana", 1}};
+
+        ws.cell("A1").value("header");
+
+        for (auto i = std::size_t(0); i < data.size(); ++i)
+        {
+            auto row = static_cast<xlnt::row_t>(i + 2);
+            ws.cell(1, row).value(data[i].first);
+            ws.cell(2, row).value(data[i].second);
+            ws.cell(3, row).value(static_cast<int>(i));
+        }
+
+        ws.cell("C4").font(xlnt::font().bold(true));
+        ws.cell("C4").comment(xlnt::comment("third", "author"));
+        ws.cell("C4").hyperlink("http://example.com");
+        ws.cell("D2").value("outside");
+
+        ws.range("A2:C6").sort({xlnt::sort_key("A"), xlnt::sort_key("B", xlnt::sort_direction::descending)});
+
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "header");
+        xlnt_assert_equals(ws.cell("C2").value<int>(), 1);
+        xlnt_assert_equals(ws.cell("C3").value<int>(), 3);
+        xlnt_assert_equals(ws.cell("C4").value<int>(), 0);
+        xlnt_assert_equals(ws.cell("C5").value<int>(), 4);
+        xlnt_assert_equals(ws.cell("C6").value<int>(), 2);
+        xlnt_assert_equals(ws.cell("A6").value<std::string>(), "cherry");
+
+        // formats, comments and hyperlinks move with their cells
+        xlnt_assert(ws.cell("C6").font().bold());
+        xlnt_assert(ws.cell("C6").has_comment());
+        xlnt_assert_equals(ws.cell("C6").comment().plain_text(), "third");
+        xlnt_assert(ws.cell("C6").has_hyperlink());
+        xlnt_assert(!ws.cell("C4").has_comment());
+        xlnt_assert(!ws.cell("C4").has_hyperlink());
+        xlnt_assert_equals(ws.cell("D2").value<std::string>(), "outside");
+
+        // stable and parallel sorts agree
+        ws.range("A2:C6").sort({xlnt::sort_key("B")}, true);
+        xlnt_assert_equals(ws.cell("C2").value<int>(), 3);
+        xlnt_assert_equals(ws.cell("C3").value<int>(), 4);
+        xlnt_assert_equals(ws.cell("C4").value<int>(), 2);
+        xlnt_assert_equals(ws.cell("C5").value<int>(), 1);
+        xlnt_assert_equals(ws.cell("C6").value<int>(), 0);
+
+        xlnt_assert_throws(ws.range("A2:C6").sort({xlnt::sort_key("D")}), xlnt::invalid_parameter);
+        ws.merge_cells("B7:C8");
+        xlnt_assert_throws(ws.range("A2:C8").sort({xlnt::sort_key("A")}), xlnt::invalid_parameter);
+    }
+
+    void test_sort_rules()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").value("b");
+        ws.cell("A2").value(true);
+        ws.cell("A3").value(10);
+        ws.cell("A5").value("B");
+        ws.cell("A6").value("a");
+        ws.cell("A7").value(-1);
+        ws.cell("A8").value(xlnt::date(2020, 1, 2));
+        ws.cell("A9").value("2020-01-01");
+
+        ws.range("A1:A9").sort({xlnt::sort_key("A", xlnt::sort_direction::descending, xlnt::sort_rule::dates)});
+
+        xlnt_assert_equals(ws.cell("A1").value<bool>(), true);
+        xlnt_assert_equals(ws.cell("A2").value<std::string>(), "b");
+        xlnt_assert_equals(ws.cell("A3").value<std::string>(), "B");
+        xlnt_assert_equals(ws.cell("A4").value<std::string>(), "a");
+        xlnt_assert_equals(ws.cell("A5").value<xlnt::date>(), xlnt::date(2020, 1, 2));
+        xlnt_assert_equals(ws.cell("A6").value<std::string>(), "2020-01-01");
+        xlnt_assert_equals(ws.cell("A7").value<int>(), 10);
+        xlnt_assert_equals(ws.cell("A8").value<int>(), -1);
+        xlnt_assert(!ws.has_cell("A9"));
+
+        ws.range("A1:A8").sort({xlnt::sort_key("A", xlnt::sort_direction::ascending, xlnt::sort_rule::case_sensitive)});
+
+        xlnt_assert_equals(ws.cell("A1").value<int>(), -1);
+        xlnt_assert_equals(ws.cell("A2").value<int>(), 10);
+        xlnt_assert_equals(ws.cell("A3").value<xlnt::date>(), xlnt::date(2020, 1, 2));
+        xlnt_assert_equals(ws.cell("A4").value<std::string>(), "2020-01-01");
+        xlnt_assert_equals(ws.cell("A5").value<std::string>(), "B");
+        xlnt_assert_equals(ws.cell("A6").value<std::string>(), "a");
+        xlnt_assert_equals(ws.cell("A7").value<std::string>(), "b");
+        xlnt_assert_equals(ws.cell("A8").value<bool>(), true);
+    }
+
+    void test_sort_nan()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+
+        for (auto row = 1; row <= 300; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row % 3 == 0 ? nan : static_cast<double>((row * 37) % 101));
+            ws.cell(2, static_cast<xlnt::row_t>(row)).value(row);
+        }
+
+        ws.cell("A301").value("text");
+
+        for (auto direction : {xlnt::sort_direction::ascending, xlnt::sort_direction::descending})
+        {
+            xlnt::detail::scoped_parallel_block_count blocks(4);
+            ws.range("A1:B301").sort({xlnt::sort_key("A", direction)}, true);
+
+            const auto ascending = direction == xlnt::sort_direction::ascending;
+            xlnt_assert_equals(ws.cell(1, ascending ? 301 : 1).value<std::string>(), "text");
+
+            // numbers are ordered, NaN follows them and keeps the original order of its rows
+            auto previous = ascending ? -1.0 : 1000.0;
+            auto previous_nan_row = 0;
+            const auto first = ascending ? 1 : 2;
+
+            for (auto row = first; row < first + 300; ++row)
+            {
+                const auto value = ws.cell(1, static_cast<xlnt::row_t>(row)).value<double>();
+
+                if (row < first + 200)
+                {
+                    xlnt_assert(ascending ? value >= previous : value <= previous);
+                    previous = value;
+                }
+                else
+                {
+                    xlnt_assert(std::isnan(value));
+                    const auto original_row = ws.cell(2, static_cast<xlnt::row_t>(row)).value<int>();
+                    xlnt_assert(original_row > previous_nan_row);
+                    previous_nan_row = original_row;
+                }
+            }
+        }
+    }
+
+    void test_auto_fit_columns()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // digits of the default font are the unit of column widths, plus five pixels of padding
+        ws.cell("A1").value(12345);
+        ws.cell("A2").value(1.5);
+        ws.cell("B1").value("header");
+        ws.cell("B2").value("header");
+        ws.cell("B2").font(xlnt::font().bold(true));
+        ws.cell("C1").value(0.5);
+        ws.cell("C1").number_format(xlnt::number_format::percentage_00());
+        ws.cell("D1").value("a long wrapped value");
+        ws.cell("D1").alignment(xlnt::alignment().wrap(true));
+        ws.cell("E1").value(true);
+
+        xlnt::rich_text large;
+        large.add_run(xlnt::rich_text_run{"00", xlnt::font().size(22)});
+        ws.cell("F1").value(large);
+        ws.cell("F2").value("000");
+
+        ws.range("A1:F2").auto_fit_columns();
+
+        // the default 12pt Calibri has eight pixel wide digits at 96 dpi
+        const auto padding = 5.0 / 8.0;
+        xlnt_assert_delta(ws.column_properties("A").width.get(), 5 + padding, 1.0 / 256);
+        xlnt_assert(ws.column_properties("A").custom_width);
+        xlnt_assert(ws.column_properties("A").best_fit);
+        xlnt_assert_delta(ws.column_properties("C").width.get(), 6.0 + padding, 1.0);
+        xlnt_assert(!ws.has_column_properties("D"));
+        xlnt_assert_delta(ws.column_properties("F").width.get(), 2 * 22.0 / 12.0 + padding, 1.0 / 256);
+        // bold glyphs are wider than regular ones
+        ws.cell("B2").clear_value();
+        ws.range("B1:B2").auto_fit_columns();
+        const auto regular_width = ws.column_properties("B").width.get();
+        ws.cell("B2").value("header");
+        ws.range("B1:B2").auto_fit_columns();
+        xlnt_assert(ws.column_properties("B").width.get() > regular_width);
+
+        // the serial, parallel and whole-sheet fits agree with each other
+        for (auto row = 3; row <= 2000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row * 1000);
+        }
+
+        ws.range("A1:F2000").auto_fit_columns();
+        const auto serial = ws.column_properties("A").width.get();
+        ws.range("A1:F2000").auto_fit_columns(true);
+        xlnt_assert_equals(ws.column_properties("A").width.get(), serial);
+        ws.column_properties("A").width = 1.0;
+        ws.auto_fit_columns();
+        xlnt_assert_equals(ws.column_properties("A").width.get(), serial);
+        xlnt_assert_delta(serial, 7 + padding, 1.0 / 256);
+    }
 };
 static range_test_suite x;
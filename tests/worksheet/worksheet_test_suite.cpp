@@ -24,7 +24,9 @@
 #include <iostream>
 
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/hyperlink.hpp>
+#include <xlnt/styles/font.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
@@ -113,6 +115,9 @@ public:
         register_test(test_insert_too_many);
         register_test(test_insert_delete_moves_merges);
         register_test(test_hidden_sheet);
+        register_test(test_fingerprint);
+        register_test(test_diff);
+        register_test(test_max_resident_cells);
     }
 
     void test_new_worksheet()
@@ -1590,5 +1595,237 @@ public:
         wb.load(path_helper::test_file("16_hidden_sheet.xlsx"));
         xlnt_assert_equals(wb.sheet_hidden_by_index(1), true);
     }
+
+    void test_fingerprint()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("B1").value("text");
+        ws.cell("C600").value(2.5);
+
+        auto fingerprint = ws.fingerprint();
+        xlnt_assert_equals(fingerprint.rows.size(), 601);
+        xlnt_assert_equals(fingerprint.blocks.size(), 3);
+        xlnt_assert_equals(fingerprint.highest_column, 3);
+        xlnt_assert_differs(fingerprint.row(1), 0);
+        xlnt_assert_equals(fingerprint.row(2), 0);
+        xlnt_assert_equals(fingerprint.row(1000), 0);
+        xlnt_assert_equals(fingerprint.block(3), 0);
+
+        auto parallel = ws.fingerprint(true);
+        xlnt_assert(parallel.rows == fingerprint.rows);
+        xlnt_assert(parallel.blocks == fingerprint.blocks);
+
+        // cell order within a row doesn't matter but the column does
+        xlnt::workbook other;
+        auto other_ws = other.active_sheet();
+        other_ws.cell("B1").value("text");
+        other_ws.cell("A1").value(1);
+        xlnt_assert_equals(other_ws.fingerprint().row(1), fingerprint.row(1));
+        other_ws.cell("B1").clear_value();
+        other_ws.cell("D1").value("text");
+        xlnt_assert_differs(other_ws.fingerprint().row(1), fingerprint.row(1));
+    }
+
+    void test_diff()
+    {
+        auto fill = [](xlnt::worksheet ws) {
+            for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+            {
+                ws.cell(1, row).value(static_cast<int>(row));
+                ws.cell(2, row).value("row " + std::to_string(row));
+            }
+        };
+
+        xlnt::workbook wb1;
+        auto ws1 = wb1.active_sheet();
+        fill(ws1);
+
+        xlnt::workbook wb2;
+        auto ws2 = wb2.active_sheet();
+        fill(ws2);
+
+        for (auto parallel : {false, true})
+        {
+            xlnt_assert(ws1.diff(ws2, parallel).empty());
+        }
+
+        ws2.cell("A300").value(-1);
+        ws2.cell("C700").value("new");
+        ws2.cell("B900").font(xlnt::font().bold(true));
+        ws1.cell("B900").font(xlnt::font().italic(true));
+        ws2.cell("A1").comment(xlnt::comment("note", "author"));
+
+        for (auto parallel : {false, true})
+        {
+            auto diff = ws1.diff(ws2, parallel);
+            xlnt_assert(!diff.empty());
+            xlnt_assert(!diff.properties_changed);
+            xlnt_assert_equals(diff.title, ws1.title());
+            xlnt_assert_equals(diff.changed_rows, std::vector<xlnt::row_t>({1, 300, 700, 900}));
+            xlnt_assert_equals(diff.changed_cells.size(), 4);
+
+            xlnt_assert_equals(diff.changed_cells[0].reference, xlnt::cell_reference("A1"));
+            xlnt_assert(diff.changed_cells[0].annotation_changed);
+            xlnt_assert(!diff.changed_cells[0].value_changed);
+
+            xlnt_assert_equals(diff.changed_cells[1].reference, xlnt::cell_reference("A300"));
+            xlnt_assert(diff.changed_cells[1].value_changed);
+
+            xlnt_assert_equals(diff.changed_cells[2].reference, xlnt::cell_reference("C700"));
+            xlnt_assert(diff.changed_cells[2].added);
+
+            xlnt_assert_equals(diff.changed_cells[3].reference, xlnt::cell_reference("B900"));
+            xlnt_assert(diff.changed_cells[3].format_changed);
+            xlnt_assert(!diff.changed_cells[3].value_changed);
+        }
+
+        auto reverse = ws2.diff(ws1);
+        xlnt_assert(reverse.changed_cells[2].removed);
+
+        // kept fingerprints give the same result
+        auto kept = ws1.diff(ws2, ws1.fingerprint(), ws2.fingerprint());
+        xlnt_assert_equals(kept.changed_rows, std::vector<xlnt::row_t>({1, 300, 700, 900}));
+
+        ws1.merge_cells("D1:E2");
+        xlnt_assert(ws1.diff(ws2).properties_changed);
+    }
+
+    void test_max_resident_cells()
+    {
+        const auto rows = xlnt::row_t(5000);
+
+        auto fill = [rows](xlnt::worksheet ws) {
+            for (auto row = xlnt::row_t(1); row <= rows; ++row)
+            {
+                ws.cell(1, row).value("text " + std::to_string(row));
+                ws.cell(2, row).value(static_cast<int>(row));
+            }
+
+            ws.cell("C10").formula("=B10*2");
+            ws.cell("C20").font(xlnt::font().bold(true));
+            ws.cell("C30").value(xlnt::rich_text("formatted", xlnt::font().italic(true)));
+            ws.cell("C40").hyperlink("https://example.com/");
+            ws.cell("C50").value("commented");
+            ws.cell("C50").comment(xlnt::comment("note", "author"));
+        };
+
+        auto check = [rows](xlnt::worksheet ws) {
+            xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("A1:C" + std::to_string(rows)));
+
+            for (auto row = xlnt::row_t(rows); row >= 1; --row)
+            {
+                xlnt_assert_equals(ws.cell(1, row).value<std::string>(), "text " + std::to_string(row));
+                xlnt_assert_equals(ws.cell(2, row).value<int>(), static_cast<int>(row));
+            }
+
+            xlnt_assert_equals(ws.cell("C10").formula(), "B10*2");
+            xlnt_assert(ws.cell("C20").font().bold());
+            xlnt_assert_equals(ws.cell("C30").value<xlnt::rich_text>().runs().size(), 1);
+            xlnt_assert(ws.cell("C30").value<xlnt::rich_text>().runs()[0].second.is_set());
+            xlnt_assert_equals(ws.cell("C40").hyperlink().url(), "https://example.com/");
+            xlnt_assert_equals(ws.cell("C50").comment().plain_text(), "note");
+            xlnt_assert(!ws.has_cell("D1"));
+        };
+
+        xlnt::workbook expected;
+        fill(expected.active_sheet());
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.max_resident_cells(1000);
+        xlnt_assert_equals(ws.max_resident_cells(), 1000);
+        fill(ws);
+        check(ws);
+
+        // written out cells keep their format while the stylesheet renumbers its formats
+        ws.cell("D1").font(xlnt::font().size(20));
+        ws.cell("D4000").font(xlnt::font().size(30));
+
+        for (auto row = xlnt::row_t(1); row <= 1000; ++row)
+        {
+            xlnt_assert_equals(ws.cell(2, row).value<int>(), static_cast<int>(row));
+        }
+
+        ws.cell("D1").font(xlnt::font().size(21));
+        xlnt_assert_equals(ws.cell("D4000").font().size(), 30);
+        ws.clear_cell("D1");
+        ws.clear_cell("D4000");
+
+        // cells in memory and paged out are compared, copied and changed alike
+        xlnt_assert(ws.diff(expected.active_sheet()).empty());
+        auto copy = wb.copy_sheet(ws);
+        check(copy);
+        ws.cell("B4000").value(-1);
+        xlnt_assert_equals(ws.cell("B4000").value<int>(), -1);
+        ws.cell("B4000").value(4000);
+        ws.clear_cell("C10");
+        xlnt_assert(!ws.has_cell("C10"));
+        ws.cell("C10").formula("=B10*2");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.max_resident_cells(1000);
+        loaded.load(data);
+        xlnt_assert_equals(loaded.active_sheet().max_resident_cells(), 1000);
+        check(loaded.active_sheet());
+
+        std::vector<std::uint8_t> resaved;
+        loaded.save(resaved);
+        xlnt::workbook reloaded;
+        reloaded.load(resaved);
+        check(reloaded.active_sheet());
+
+        std::vector<std::uint8_t> expected_data;
+        expected.save(expected_data);
+        xlnt::workbook expected_loaded;
+        expected_loaded.load(expected_data);
+        xlnt_assert(reloaded.active_sheet().diff(expected_loaded.active_sheet()).empty());
+
+        // without a limit every cell comes back into memory
+        ws.max_resident_cells(0);
+        xlnt_assert_equals(ws.max_resident_cells(), 0);
+        check(ws);
+
+        ws.max_resident_cells(100);
+        ws.insert_rows(1, 1);
+        xlnt_assert_equals(ws.cell(1, 2).value<std::string>(), "text 1");
+        ws.delete_rows(1, 1);
+        check(ws);
+
+        // a cell object keeps its rows in memory while other rows are used
+        auto a1 = ws.cell("A1");
+
+        for (auto row = xlnt::row_t(300); row <= 2000; ++row)
+        {
+            xlnt_assert_equals(ws.cell(2, row).value<int>(), static_cast<int>(row));
+        }
+
+        a1.value("changed");
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "changed");
+        a1.value("text 1");
+
+        // range operations read cells where they are rather than making them all resident
+        const auto all_rows = "A1:C" + std::to_string(rows);
+        const auto stats = ws.range(all_rows).statistics();
+        xlnt_assert_equals(stats.count, rows);
+        xlnt_assert_equals(stats.sum, rows * (rows + 1) / 2.0);
+        xlnt_assert_equals(stats.value_count, expected.active_sheet().range(all_rows).statistics().value_count);
+
+        ws.range(all_rows).auto_fit_columns();
+        expected.active_sheet().range(all_rows).auto_fit_columns();
+        xlnt_assert_equals(ws.column_properties("A").width.get(),
+            expected.active_sheet().column_properties("A").width.get());
+
+        ws.range(all_rows).sort({xlnt::sort_key("B", xlnt::sort_direction::descending)});
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "text " + std::to_string(rows));
+        xlnt_assert_equals(ws.cell(2, rows).value<int>(), 1);
+        xlnt_assert_equals(ws.cell(3, rows - 49).comment().plain_text(), "note");
+        ws.range(all_rows).sort({xlnt::sort_key("B")});
+        check(ws);
+    }
 };
 static worksheet_test_suite x;
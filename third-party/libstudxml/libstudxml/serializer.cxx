@@ -3,7 +3,7 @@
 // license   : MIT; see accompanying LICENSE file
 
 #include <new>     // std::bad_alloc
-#include <cstring> // std::strlen
+#include <cstring> // std::memcpy
 
 #include <libstudxml/serializer.hxx>
 
@@ -26,6 +26,20 @@ namespace xml
     what_ += description_;
   }
 
+  // genx_output
+  //
+  bool details::genx_output::
+  flush ()
+  {
+    if (size != 0)
+    {
+      os->write (data, static_cast<streamsize> (size));
+      size = 0;
+    }
+
+    return os->good ();
+  }
+
   // serializer
   //
   extern "C" genxStatus
@@ -34,33 +48,77 @@ namespace xml
     // It would have been easier to throw the exception directly,
     // however, the Genx code is most likely not exception safe.
     //
-    ostream* os (static_cast<ostream*> (p));
+    // The string is copied as it is scanned for its terminator so
+    // that it is only traversed once.
+    //
+    details::genx_output* out (static_cast<details::genx_output*> (p));
     const char* s (reinterpret_cast<const char*> (us));
-    os->write (s, static_cast<streamsize> (strlen (s)));
-    return os->good () ? GENX_SUCCESS : GENX_IO_ERROR;
+
+    for (;;)
+    {
+      char* b (out->data + out->size);
+      char* e (out->data + details::genx_output::capacity);
+      char* i (b);
+
+      for (; i != e && *s != '\0'; ++i, ++s)
+        *i = *s;
+
+      out->size += static_cast<size_t> (i - b);
+
+      if (*s == '\0')
+        return GENX_SUCCESS;
+
+      if (!out->flush ())
+        return GENX_IO_ERROR;
+    }
   }
 
   extern "C" genxStatus
   genx_write_bound (void* p, constUtf8 start, constUtf8 end)
   {
-    ostream* os (static_cast<ostream*> (p));
+    details::genx_output* out (static_cast<details::genx_output*> (p));
     const char* s (reinterpret_cast<const char*> (start));
-    streamsize n (static_cast<streamsize> (end - start));
-    os->write (s, n);
-    return os->good () ? GENX_SUCCESS : GENX_IO_ERROR;
+    size_t n (static_cast<size_t> (end - start));
+
+    if (out->size + n > details::genx_output::capacity)
+    {
+      if (!out->flush ())
+        return GENX_IO_ERROR;
+
+      // Blocks as large as the buffer go straight to the stream.
+      //
+      if (n >= details::genx_output::capacity)
+      {
+        out->os->write (s, static_cast<streamsize> (n));
+        return out->os->good () ? GENX_SUCCESS : GENX_IO_ERROR;
+      }
+    }
+
+    memcpy (out->data + out->size, s, n);
+    out->size += n;
+    return GENX_SUCCESS;
   }
 
   extern "C" genxStatus
   genx_flush (void* p)
   {
-    ostream* os (static_cast<ostream*> (p));
-    os->flush ();
-    return os->good () ? GENX_SUCCESS : GENX_IO_ERROR;
+    details::genx_output* out (static_cast<details::genx_output*> (p));
+
+    if (!out->flush ())
+      return GENX_IO_ERROR;
+
+    out->os->flush ();
+    return out->os->good () ? GENX_SUCCESS : GENX_IO_ERROR;
   }
 
   serializer::
   ~serializer ()
   {
+    // Output of an unfinished document is written as far as it went.
+    //
+    out_.flush ();
+    delete[] out_.data;
+
     if (s_ != 0)
       genxDispose (s_);
   }
@@ -69,6 +127,10 @@ namespace xml
   serializer (ostream& os, const string& oname, unsigned short ind)
       : os_ (os), os_state_ (os.exceptions ()), oname_ (oname), depth_ (0)
   {
+    out_.os = &os_;
+    out_.data = new char[details::genx_output::capacity];
+    out_.size = 0;
+
     // Temporarily disable exceptions on the stream.
     //
     os_.exceptions (ostream::goodbit);
@@ -79,9 +141,12 @@ namespace xml
     s_ = genxNew (0, 0, 0);
 
     if (s_ == 0)
+    {
+      delete[] out_.data;
       throw bad_alloc ();
+    }
 
-    genxSetUserData (s_, &os_);
+    genxSetUserData (s_, &out_);
 
     if (ind != 0)
       genxSetPrettyPrint (s_, ind);
@@ -94,10 +159,18 @@ namespace xml
     {
       string m (genxGetErrorMessage (s_, e));
       genxDispose (s_);
+      delete[] out_.data;
       throw serialization (oname, m);
     }
   }
 
+  void serializer::
+  flush ()
+  {
+    if (!out_.flush ())
+      handle_error (GENX_IO_ERROR);
+  }
+
   void serializer::
   handle_error (genxStatus e) const
   {
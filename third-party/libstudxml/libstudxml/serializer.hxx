@@ -22,6 +22,25 @@
 
 namespace xml
 {
+  namespace details
+  {
+    // Staging buffer between Genx and the output stream. Genx produces
+    // output as many small tokens; they are copied here and written to
+    // the stream in large blocks.
+    //
+    struct genx_output
+    {
+      static const std::size_t capacity = 32 * 1024;
+
+      std::ostream* os;
+      char* data;
+      std::size_t size;
+
+      bool
+      flush ();
+    };
+  }
+
   class serialization: public exception
   {
   public:
@@ -276,6 +295,13 @@ namespace xml
     std::size_t
     indentation_suspended () const;
 
+    // Write any buffered output to the stream. This is only necessary
+    // before writing to the stream directly while the document is still
+    // open; the output is flushed at the end of the document.
+    //
+    void
+    flush ();
+
   private:
     void
     handle_error (genxStatus) const;
@@ -285,6 +311,8 @@ namespace xml
     std::ostream::iostate os_state_; // Original exception state.
     const std::string oname_;
 
+    details::genx_output out_;
+
     genxWriter s_;
     genxSender sender_;
     std::size_t depth_;